@@ -25,6 +25,7 @@
 #include "config.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #ifdef HAVE_COMPLEX_H
 #include <complex.h>
@@ -700,15 +701,9 @@ static void fastsum_precompute_kernel(fastsum_plan *ths)
   int j, k, t;
   INT N[ths->d];
   int n_total;
-#ifdef MEASURE_TIME
-  ticks t0, t1;
-#endif
-
-  ths->MEASURE_TIME_t[0] = K(0.0);
+  /* runs within the initialisation, before the statistics can be enabled */
+  const double t0 = NFFT(stats_seconds)();
 
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
   /** precompute spline values for near field */
   if (ths->eps_I > 0.0 && !(ths->flags & EXACT_NEARFIELD))
   {
@@ -728,14 +723,7 @@ static void fastsum_precompute_kernel(fastsum_plan *ths)
         ths->Add[k] = regkern3(ths->k, ths->eps_I * (R) k / (R)(ths->Ad), ths->p,
             ths->kernel_param, ths->eps_I, ths->eps_B);
   }
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[0] += NFFT(elapsed_seconds)(t1,t0);
-#endif
 
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
   /** precompute Fourier coefficients of regularised kernel*/
   n_total = 1;
   for (t = 0; t < ths->d; t++)
@@ -770,10 +758,8 @@ static void fastsum_precompute_kernel(fastsum_plan *ths)
   NFFT(fftshift_complex)(ths->b, (int)(ths->d), N);
   FFTW(execute)(ths->fft_plan);
   NFFT(fftshift_complex)(ths->b, (int)(ths->d), N);
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[0] += nfft_elapsed_seconds(t1,t0);
-#endif
+  NFFT(stats_add)(&ths->stats, FASTSUM_STATS_KERNEL,
+    NFFT(stats_seconds)() - t0);
 }
 
 void fastsum_init_guru_kernel(fastsum_plan *ths, int d, kernel k, R *param,
@@ -787,6 +773,7 @@ void fastsum_init_guru_kernel(fastsum_plan *ths, int d, kernel k, R *param,
 #endif
 
   ths->d = d;
+  memset(&ths->stats, 0, sizeof(ths->stats));
 
   ths->k = k;
   ths->kernel_param = param;
@@ -1085,16 +1072,10 @@ void fastsum_exact(fastsum_plan *ths)
 /** precomputation for fastsum */
 void fastsum_precompute_source_nodes(fastsum_plan *ths)
 {
-#ifdef MEASURE_TIME
-  ticks t0, t1;
-#endif
+  double t0 = 0.0;
 
-  ths->MEASURE_TIME_t[1] = K(0.0);
-  ths->MEASURE_TIME_t[3] = K(0.0);
-
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
+  if (ths->stats.enabled)
+    t0 = NFFT(stats_seconds)();
 
   if (ths->eps_I > 0.0)
   {
@@ -1105,14 +1086,12 @@ void fastsum_precompute_source_nodes(fastsum_plan *ths)
       BuildTree(ths->d, 0, ths->x, ths->alpha, ths->permutation_x_alpha, ths->N_total);
   } /* eps_I > 0 */
 
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[3] += nfft_elapsed_seconds(t1,t0);
-#endif
+  if (ths->stats.enabled)
+    NFFT(stats_add)(&ths->stats, FASTSUM_STATS_SOURCE_TREE,
+      NFFT(stats_seconds)() - t0);
 
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
+  if (ths->stats.enabled)
+    t0 = NFFT(stats_seconds)();
   /** init NFFT plan for transposed transform in first step*/
 //  for (k = 0; k < ths->mv1.M_total; k++)
 //    for (t = 0; t < ths->mv1.d; t++)
@@ -1127,10 +1106,9 @@ void fastsum_precompute_source_nodes(fastsum_plan *ths)
 
   if (ths->mv1.flags & PRE_FULL_PSI)
     NFFT(precompute_full_psi)(&(ths->mv1));
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[1] += nfft_elapsed_seconds(t1,t0);
-#endif
+  if (ths->stats.enabled)
+    NFFT(stats_add)(&ths->stats, FASTSUM_STATS_SOURCE_PSI,
+      NFFT(stats_seconds)() - t0);
 
 //  /** init Fourier coefficients */
 //  for (k = 0; k < ths->mv1.M_total; k++)
@@ -1140,15 +1118,10 @@ void fastsum_precompute_source_nodes(fastsum_plan *ths)
 /** precomputation for fastsum */
 void fastsum_precompute_target_nodes(fastsum_plan *ths)
 {
-#ifdef MEASURE_TIME
-  ticks t0, t1;
-#endif
+  double t0 = 0.0;
 
-  ths->MEASURE_TIME_t[2] = K(0.0);
-
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
+  if (ths->stats.enabled)
+    t0 = NFFT(stats_seconds)();
   /** init NFFT plan for transform in third step*/
 //  for (j = 0; j < ths->mv2.M_total; j++)
 //    for (t = 0; t < ths->mv2.d; t++)
@@ -1163,10 +1136,9 @@ void fastsum_precompute_target_nodes(fastsum_plan *ths)
 
   if (ths->mv2.flags & PRE_FULL_PSI)
     NFFT(precompute_full_psi)(&(ths->mv2));
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[2] += NFFT(elapsed_seconds)(t1,t0);
-#endif
+  if (ths->stats.enabled)
+    NFFT(stats_add)(&ths->stats, FASTSUM_STATS_TARGET_PSI,
+      NFFT(stats_seconds)() - t0);
 }
 
 /** precomputation for fastsum */
@@ -1180,52 +1152,38 @@ void fastsum_precompute(fastsum_plan *ths)
 void fastsum_trafo(fastsum_plan *ths)
 {
   int j, k, t;
-#ifdef MEASURE_TIME
-  ticks t0, t1;
-#endif
+  double t0 = 0.0;
 
-  ths->MEASURE_TIME_t[4] = K(0.0);
-  ths->MEASURE_TIME_t[5] = K(0.0);
-  ths->MEASURE_TIME_t[6] = K(0.0);
-  ths->MEASURE_TIME_t[7] = K(0.0);
-
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
+  if (ths->stats.enabled)
+    t0 = NFFT(stats_seconds)();
   /** first step of algorithm */
   NFFT(adjoint)(&(ths->mv1));
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[4] += NFFT(elapsed_seconds)(t1,t0);
-#endif
+  if (ths->stats.enabled)
+    NFFT(stats_add)(&ths->stats, FASTSUM_STATS_ADJOINT,
+      NFFT(stats_seconds)() - t0);
 
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
+  if (ths->stats.enabled)
+    t0 = NFFT(stats_seconds)();
   /** second step of algorithm */
 #ifdef _OPENMP
   #pragma omp parallel for default(shared) private(k)
 #endif
   for (k = 0; k < ths->mv2.N_total; k++)
     ths->mv2.f_hat[k] = ths->b[k] * ths->mv1.f_hat[k];
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[5] += nfft_elapsed_seconds(t1,t0);
-#endif
+  if (ths->stats.enabled)
+    NFFT(stats_add)(&ths->stats, FASTSUM_STATS_MULTIPLY,
+      NFFT(stats_seconds)() - t0);
 
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
+  if (ths->stats.enabled)
+    t0 = NFFT(stats_seconds)();
   /** third step of algorithm */
   NFFT(trafo)(&(ths->mv2));
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[6] += nfft_elapsed_seconds(t1,t0);
-#endif
+  if (ths->stats.enabled)
+    NFFT(stats_add)(&ths->stats, FASTSUM_STATS_TRAFO,
+      NFFT(stats_seconds)() - t0);
 
-#ifdef MEASURE_TIME
-  t0 = getticks();
-#endif
+  if (ths->stats.enabled)
+    t0 = NFFT(stats_seconds)();
 
   /** write far field to output */
 #ifdef _OPENMP
@@ -1260,10 +1218,9 @@ void fastsum_trafo(fastsum_plan *ths)
     }
   }
 
-#ifdef MEASURE_TIME
-  t1 = getticks();
-  ths->MEASURE_TIME_t[7] += NFFT(elapsed_seconds)(t1,t0);
-#endif
+  if (ths->stats.enabled)
+    NFFT(stats_add)(&ths->stats, FASTSUM_STATS_NEARFIELD,
+      NFFT(stats_seconds)() - t0);
 }
 /* \} */
 
@@ -78,6 +78,18 @@ typedef C (*kernel)(R , int , const R *);
  * then the vector permutation_x_alpha is stored. */
 #define STORE_PERMUTATION_X_ALPHA (1U<< 2)
 
+/** Steps of the fast summation in the statistics of a plan. The precomputation
+ * of the kernel runs within fastsum_init_guru_kernel and is recorded even if
+ * the statistics are disabled. */
+#define FASTSUM_STATS_KERNEL 0
+#define FASTSUM_STATS_SOURCE_PSI 1
+#define FASTSUM_STATS_TARGET_PSI 2
+#define FASTSUM_STATS_SOURCE_TREE 3
+#define FASTSUM_STATS_ADJOINT 4
+#define FASTSUM_STATS_MULTIPLY 5
+#define FASTSUM_STATS_TRAFO 6
+#define FASTSUM_STATS_NEARFIELD 7
+
 /** plan for fast summation algorithm */
 typedef struct fastsum_plan_
 {
@@ -131,7 +143,7 @@ typedef struct fastsum_plan_
   
   int *permutation_x_alpha;    /**< permutation vector of source nodes if STORE_PERMUTATION_X_ALPHA is set */
 
-  R MEASURE_TIME_t[8]; /**< Measured time for each step if MEASURE_TIME is set */
+  nfft_stats stats; /**< statistics of the steps, see FASTSUM_STATS_KERNEL */
 
 } fastsum_plan;
 
@@ -705,7 +705,6 @@ void test1(int *nthreads_array, int n_threads_array_size)
 {
   s_testset testsets[1];
 
-#if defined MEASURE_TIME && defined MEASURE_TIME_FFTW
   run_testset(&testsets[0], 3, 100000, 100000, 128, 4, 7, "one_over_x", K(0.0), K(0.03125), K(0.03125), nthreads_array, n_threads_array_size);
 
   fastsum_print_output_speedup_total_minus_indep(file_out_tex, testsets, 1);
@@ -715,7 +714,6 @@ void test1(int *nthreads_array, int n_threads_array_size)
   nfft_adjoint_print_output_histo_DFBRT(file_out_tex, testsets[0]);
 
   nfft_trafo_print_output_histo_DFBRT(file_out_tex, testsets[0]);
-#endif
 }
 
 int main(int argc, char** argv)
@@ -724,14 +722,6 @@ int main(int argc, char** argv)
   int n_threads_array_size = get_nthreads_array(&nthreads_array);
   int k;
 
-#if !(defined MEASURE_TIME && defined MEASURE_TIME_FFTW)
-  fprintf(stderr, "WARNING: Detailed time measurements are not activated.\n");
-  fprintf(stderr, "Please re-run the configure script with options\n");
-  fprintf(stderr,
-      "--enable-measure-time --enable-measure-time-fftw --enable-openmp\n");
-  fprintf(stderr, "and run \"make clean all\"\n\n");
-#endif
-
   for (k = 0; k < n_threads_array_size; k++)
     fprintf(stderr, "%d ", nthreads_array[k]);
   fprintf(stderr, "\n");
@@ -58,6 +58,10 @@ int bench_openmp(FILE *infile, int n, int m, int p,
   FFTW(export_wisdom_to_filename)("fastsum_benchomp_detail_single.plan");
 #endif
 
+  NFFT(stats_enable)(&my_fastsum_plan.stats, 1);
+  NFFT(stats_enable)(&my_fastsum_plan.mv1.stats, 1);
+  NFFT(stats_enable)(&my_fastsum_plan.mv2.stats, 1);
+
   for (j = 0; j < L; j++)
   {
     for (t = 0; t < d; t++)
@@ -93,45 +97,26 @@ int bench_openmp(FILE *infile, int n, int m, int p,
   t1 = getticks();
   tt_total = NFFT(elapsed_seconds)(t1, t0);
 
-#ifndef MEASURE_TIME
-  my_fastsum_plan.MEASURE_TIME_t[0] = K(0.0);
-  my_fastsum_plan.MEASURE_TIME_t[1] = K(0.0);
-  my_fastsum_plan.MEASURE_TIME_t[2] = K(0.0);
-  my_fastsum_plan.MEASURE_TIME_t[3] = K(0.0);
-  my_fastsum_plan.MEASURE_TIME_t[4] = K(0.0);
-  my_fastsum_plan.MEASURE_TIME_t[5] = K(0.0);
-  my_fastsum_plan.MEASURE_TIME_t[6] = K(0.0);
-  my_fastsum_plan.MEASURE_TIME_t[7] = K(0.0);
-  my_fastsum_plan.mv1.MEASURE_TIME_t[0] = K(0.0);
-  my_fastsum_plan.mv1.MEASURE_TIME_t[2] = K(0.0);
-  my_fastsum_plan.mv2.MEASURE_TIME_t[0] = K(0.0);
-  my_fastsum_plan.mv2.MEASURE_TIME_t[2] = K(0.0);
-#endif
-#ifndef MEASURE_TIME_FFTW
-  my_fastsum_plan.mv1.MEASURE_TIME_t[1] = K(0.0);
-  my_fastsum_plan.mv2.MEASURE_TIME_t[1] = K(0.0);
-#endif
-
   printf(
       "%.6" __FES__ " %.6" __FES__ " %.6" __FES__ " %6" __FES__ " %.6" __FES__ " %.6" __FES__ " %.6" __FES__ " %.6" __FES__ " %.6" __FES__ " %6" __FES__ " %.6" __FES__ " %.6" __FES__ " %6" __FES__ " %.6" __FES__ " %.6" __FES__ " %6" __FES__ "\n",
-      my_fastsum_plan.MEASURE_TIME_t[0], my_fastsum_plan.MEASURE_TIME_t[1],
-      my_fastsum_plan.MEASURE_TIME_t[2], my_fastsum_plan.MEASURE_TIME_t[3],
-      my_fastsum_plan.MEASURE_TIME_t[4], my_fastsum_plan.MEASURE_TIME_t[5],
-      my_fastsum_plan.MEASURE_TIME_t[6], my_fastsum_plan.MEASURE_TIME_t[7],
-      tt_total - my_fastsum_plan.MEASURE_TIME_t[0]
-          - my_fastsum_plan.MEASURE_TIME_t[1]
-          - my_fastsum_plan.MEASURE_TIME_t[2]
-          - my_fastsum_plan.MEASURE_TIME_t[3]
-          - my_fastsum_plan.MEASURE_TIME_t[4]
-          - my_fastsum_plan.MEASURE_TIME_t[5]
-          - my_fastsum_plan.MEASURE_TIME_t[6]
-          - my_fastsum_plan.MEASURE_TIME_t[7], tt_total,
-      my_fastsum_plan.mv1.MEASURE_TIME_t[0],
-      my_fastsum_plan.mv1.MEASURE_TIME_t[1],
-      my_fastsum_plan.mv1.MEASURE_TIME_t[2],
-      my_fastsum_plan.mv2.MEASURE_TIME_t[0],
-      my_fastsum_plan.mv2.MEASURE_TIME_t[1],
-      my_fastsum_plan.mv2.MEASURE_TIME_t[2]);
+      my_fastsum_plan.stats.time[0], my_fastsum_plan.stats.time[1],
+      my_fastsum_plan.stats.time[2], my_fastsum_plan.stats.time[3],
+      my_fastsum_plan.stats.time[4], my_fastsum_plan.stats.time[5],
+      my_fastsum_plan.stats.time[6], my_fastsum_plan.stats.time[7],
+      tt_total - my_fastsum_plan.stats.time[0]
+          - my_fastsum_plan.stats.time[1]
+          - my_fastsum_plan.stats.time[2]
+          - my_fastsum_plan.stats.time[3]
+          - my_fastsum_plan.stats.time[4]
+          - my_fastsum_plan.stats.time[5]
+          - my_fastsum_plan.stats.time[6]
+          - my_fastsum_plan.stats.time[7], tt_total,
+      my_fastsum_plan.mv1.stats.time[NFFT_STATS_D],
+      my_fastsum_plan.mv1.stats.time[NFFT_STATS_FFT],
+      my_fastsum_plan.mv1.stats.time[NFFT_STATS_B],
+      my_fastsum_plan.mv2.stats.time[NFFT_STATS_D],
+      my_fastsum_plan.mv2.stats.time[NFFT_STATS_FFT],
+      my_fastsum_plan.mv2.stats.time[NFFT_STATS_B]);
 
   fastsum_finalize(&my_fastsum_plan);
 
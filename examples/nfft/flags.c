@@ -43,18 +43,6 @@
   unsigned test_fg=0;
 #endif
 
-#ifdef MEASURE_TIME_FFTW
-  unsigned test_fftw=1;
-#else
-  unsigned test_fftw=0;
-#endif
-
-#ifdef MEASURE_TIME
-  unsigned test=1;
-#else
-  unsigned test=0;
-#endif
-
 static void flags_cp(NFFT(plan) *dst, NFFT(plan) *src)
 {
   dst->x = src->x;
@@ -71,6 +59,7 @@ static void time_accuracy(int d, int N, int M, int n, int m, unsigned test_ndft,
 {
   int r, NN[d], nn[d];
   R t_ndft, t, e;
+  R t_fg_psi, t_pre_fg_psi, t_pre_full_psi;
   C *swapndft = NULL;
   ticks t0, t1;
 
@@ -98,40 +87,47 @@ static void time_accuracy(int d, int N, int M, int n, int m, unsigned test_ndft,
   MALLOC_X | MALLOC_F_HAT | MALLOC_F |
   FFTW_INIT | FFT_OUT_OF_PLACE,
   FFTW_MEASURE | FFTW_DESTROY_INPUT);
+  NFFT(stats_enable)(&p.stats, 1);
 
   /** init pseudo random nodes */
   NFFT(vrand_shifted_unit_double)(p.x, p.d * p.M_total);
 
   NFFT(init_guru)(&p_pre_phi_hut, d, NN, M, nn, m, PRE_PHI_HUT, 0);
   flags_cp(&p_pre_phi_hut, &p);
+  NFFT(stats_enable)(&p_pre_phi_hut.stats, 1);
   NFFT(precompute_one_psi)(&p_pre_phi_hut);
 
   if (test_fg)
   {
     NFFT(init_guru)(&p_fg_psi, d, NN, M, nn, m, FG_PSI, 0);
     flags_cp(&p_fg_psi, &p);
+    NFFT(stats_enable)(&p_fg_psi.stats, 1);
     NFFT(precompute_one_psi)(&p_fg_psi);
   }
 
   NFFT(init_guru)(&p_pre_lin_psi, d, NN, M, nn, m, PRE_LIN_PSI, 0);
   flags_cp(&p_pre_lin_psi, &p);
+  NFFT(stats_enable)(&p_pre_lin_psi.stats, 1);
   NFFT(precompute_one_psi)(&p_pre_lin_psi);
 
   if (test_fg)
   {
     NFFT(init_guru)(&p_pre_fg_psi, d, NN, M, nn, m, PRE_FG_PSI, 0);
     flags_cp(&p_pre_fg_psi, &p);
+    NFFT(stats_enable)(&p_pre_fg_psi.stats, 1);
     NFFT(precompute_one_psi)(&p_pre_fg_psi);
   }
 
   NFFT(init_guru)(&p_pre_psi, d, NN, M, nn, m, PRE_PSI, 0);
   flags_cp(&p_pre_psi, &p);
+  NFFT(stats_enable)(&p_pre_psi.stats, 1);
   NFFT(precompute_one_psi)(&p_pre_psi);
 
   if (test_pre_full_psi)
   {
     NFFT(init_guru)(&p_pre_full_psi, d, NN, M, nn, m, PRE_FULL_PSI, 0);
     flags_cp(&p_pre_full_psi, &p);
+    NFFT(stats_enable)(&p_pre_full_psi.stats, 1);
     NFFT(precompute_one_psi)(&p_pre_full_psi);
   }
 
@@ -165,22 +161,28 @@ static void time_accuracy(int d, int N, int M, int n, int m, unsigned test_ndft,
   NFFT(trafo)(&p);
   NFFT(trafo)(&p_pre_phi_hut);
   if (test_fg)
+  {
     NFFT(trafo)(&p_fg_psi);
+    t_fg_psi = (R)p_fg_psi.stats.time[NFFT_STATS_B];
+  }
   else
-    p_fg_psi.MEASURE_TIME_t[2] = MKNAN("");
+    t_fg_psi = MKNAN("");
   NFFT(trafo)(&p_pre_lin_psi);
   if (test_fg)
+  {
     NFFT(trafo)(&p_pre_fg_psi);
+    t_pre_fg_psi = (R)p_pre_fg_psi.stats.time[NFFT_STATS_B];
+  }
   else
-    p_pre_fg_psi.MEASURE_TIME_t[2] = MKNAN("");
+    t_pre_fg_psi = MKNAN("");
   NFFT(trafo)(&p_pre_psi);
   if (test_pre_full_psi)
+  {
     NFFT(trafo)(&p_pre_full_psi);
+    t_pre_full_psi = (R)p_pre_full_psi.stats.time[NFFT_STATS_B];
+  }
   else
-    p_pre_full_psi.MEASURE_TIME_t[2] = MKNAN("");
-
-  if (test_fftw == 0)
-    p.MEASURE_TIME_t[1] = MKNAN("");
+    t_pre_full_psi = MKNAN("");
 
   if (test_ndft)
     e = NFFT(error_l_2_complex)(swapndft, p.f, p.M_total);
@@ -189,10 +191,11 @@ static void time_accuracy(int d, int N, int M, int n, int m, unsigned test_ndft,
 
   printf(
       "%.2" __FES__ "\t%d\t%.2" __FES__ "\t%.2" __FES__ "\t%.2" __FES__ "\t%.2" __FES__ "\t%.2" __FES__ "\t%.2" __FES__ "\t%.2" __FES__ "\t%.2" __FES__ "\t%.2" __FES__ "\t%.2" __FES__ "\n",
-      t_ndft, m, e, p.MEASURE_TIME_t[0], p_pre_phi_hut.MEASURE_TIME_t[0],
-      p.MEASURE_TIME_t[1], p.MEASURE_TIME_t[2], p_fg_psi.MEASURE_TIME_t[2],
-      p_pre_lin_psi.MEASURE_TIME_t[2], p_pre_fg_psi.MEASURE_TIME_t[2],
-      p_pre_psi.MEASURE_TIME_t[2], p_pre_full_psi.MEASURE_TIME_t[2]);
+      t_ndft, m, e, (R)p.stats.time[NFFT_STATS_D],
+      (R)p_pre_phi_hut.stats.time[NFFT_STATS_D], (R)p.stats.time[NFFT_STATS_FFT],
+      (R)p.stats.time[NFFT_STATS_B], t_fg_psi,
+      (R)p_pre_lin_psi.stats.time[NFFT_STATS_B], t_pre_fg_psi,
+      (R)p_pre_psi.stats.time[NFFT_STATS_B], t_pre_full_psi);
 
   fflush(stdout);
 
@@ -278,12 +281,6 @@ int main(int argc, char **argv)
     return EXIT_FAILURE;
   }
 
-  if ((test == 0) && (atoi(argv[1]) < 2))
-  {
-    fprintf(stderr, "MEASURE_TIME in infft.h not set\n");
-    return EXIT_FAILURE;
-  }
-
   fprintf(stderr, "Testing different precomputation schemes for the nfft.\n");
   fprintf(stderr, "Columns: d, N=M, t_ndft, e_nfft, t_D, t_pre_phi_hut, ");
   fprintf(stderr, "t_fftw, t_B, t_fg_psi, t_pre_lin_psi, t_pre_fg_psi, ");
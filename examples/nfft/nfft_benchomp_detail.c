@@ -16,6 +16,7 @@
  * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#define _GNU_SOURCE /* sched_getcpu */
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
@@ -27,6 +28,9 @@
 #ifdef _OPENMP
 #include <omp.h>
 #endif
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
 
 void bench_openmp(FILE *infile, int m, int psi_flag)
 {
@@ -69,6 +73,8 @@ void bench_openmp(FILE *infile, int m, int psi_flag)
   FFTW(export_wisdom_to_filename)("nfft_benchomp_detail_single.plan");
 #endif
 
+  NFFT(stats_enable)(&p.stats, 1);
+
   for (j=0; j < p.M_total; j++)
   {
     for (t=0; t < p.d; t++)
@@ -106,16 +112,7 @@ void bench_openmp(FILE *infile, int m, int psi_flag)
   t1 = getticks();
   tt_total = NFFT(elapsed_seconds)(t1,t0);
 
-#ifndef MEASURE_TIME
-  p.MEASURE_TIME_t[0] = 0.0;
-  p.MEASURE_TIME_t[2] = 0.0;
-#endif
-
-#ifndef MEASURE_TIME_FFTW
-  p.MEASURE_TIME_t[1] = 0.0;
-#endif
-
-  printf("%.6e %.6e %6e %.6e %.6e %.6e\n", tt_preonepsi, p.MEASURE_TIME_t[0], p.MEASURE_TIME_t[1], p.MEASURE_TIME_t[2], tt_total-tt_preonepsi-p.MEASURE_TIME_t[0]-p.MEASURE_TIME_t[1]-p.MEASURE_TIME_t[2], tt_total);
+  printf("%.6e %.6e %6e %.6e %.6e %.6e\n", tt_preonepsi, p.stats.time[NFFT_STATS_D], p.stats.time[NFFT_STATS_FFT], p.stats.time[NFFT_STATS_B], tt_total-tt_preonepsi-p.stats.time[NFFT_STATS_D]-p.stats.time[NFFT_STATS_FFT]-p.stats.time[NFFT_STATS_B], tt_total);
 //  printf("%.6e\n", tt);
 
   free(N);
@@ -125,12 +122,125 @@ void bench_openmp(FILE *infile, int m, int psi_flag)
   NFFT(finalize)(&p);
 }
 
+#ifdef _OPENMP
+#define NUMA_MAX_SOCKETS 64
+
+/** Socket of the CPU the calling thread runs on, 0 if unknown. */
+static int current_socket(void)
+{
+  int socket = 0;
+#ifdef HAVE_SCHED_GETCPU
+  char name[128];
+  FILE *f;
+  int cpu = sched_getcpu();
+
+  if (cpu < 0)
+    return 0;
+
+  snprintf(name, sizeof(name),
+    "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+  f = fopen(name, "r");
+  if (f)
+  {
+    if (fscanf(f, "%d", &socket) != 1 || socket < 0)
+      socket = 0;
+    fclose(f);
+  }
+#endif
+  return socket % NUMA_MAX_SOCKETS;
+}
+
+/**
+ * Streams through a vector of n complex numbers, every thread through its part
+ * of a static schedule as in the B and D steps, and prints the read bandwidth
+ * reached by the threads of each socket. The vector is first touched either
+ * by the master thread alone, which puts all pages on its socket, or by
+ * NFFT(zero_omp). Pin the threads, e.g. by OMP_PROC_BIND=spread, to see the
+ * difference.
+ */
+static void bench_numa_one(INT n, int parallel_first_touch)
+{
+  C *g = (C*) NFFT(malloc)((size_t)(n) * sizeof(C));
+  double bytes[NUMA_MAX_SOCKETS], seconds[NUMA_MAX_SOCKETS];
+  int nthreads[NUMA_MAX_SOCKETS];
+  const int repeat = 10;
+  double sum = 0.0;
+  int s;
+
+  if (parallel_first_touch)
+    NFFT(zero_omp)(g, n, sizeof(C));
+  else
+    memset(g, 0, (size_t)(n) * sizeof(C));
+
+  for (s = 0; s < NUMA_MAX_SOCKETS; s++)
+  {
+    bytes[s] = seconds[s] = 0.0;
+    nthreads[s] = 0;
+  }
+
+  #pragma omp parallel default(shared) reduction(+:sum)
+  {
+    const int socket = current_socket();
+    double t0, t;
+    INT j;
+    int r;
+
+    #pragma omp barrier
+    t0 = omp_get_wtime();
+    for (r = 0; r < repeat; r++)
+    {
+      #pragma omp for schedule(static)
+      for (j = 0; j < n; j++)
+        sum += creal(g[j]);
+    }
+    t = omp_get_wtime() - t0;
+
+    #pragma omp critical (nfft_benchomp_numa)
+    {
+      const INT id = omp_get_thread_num(), nt = omp_get_num_threads();
+      const INT len = n / nt + (id < n % nt ? 1 : 0);
+      bytes[socket] += (double)(repeat) * (double)(len) * sizeof(C);
+      seconds[socket] = seconds[socket] > t ? seconds[socket] : t;
+      nthreads[socket]++;
+    }
+  }
+
+  printf("%s first touch:\n", parallel_first_touch ? "parallel" : "serial");
+  for (s = 0; s < NUMA_MAX_SOCKETS; s++)
+    if (nthreads[s] > 0)
+      printf("  socket %2d, %3d threads: %8.2f GB/s\n", s, nthreads[s],
+        bytes[s] / seconds[s] * 1.0e-9);
+
+  if (sum != 0.0)
+    printf("  (checksum %e)\n", sum);
+
+  NFFT(free)(g);
+}
+
+static void bench_numa(INT n)
+{
+  printf("%d threads, vector of %.0f MiB\n", (int)NFFT(get_num_threads)(),
+    (double)(n) * sizeof(C) / 1048576.0);
+  bench_numa_one(n, 0);
+  bench_numa_one(n, 1);
+}
+#endif
+
 int main(int argc, char **argv)
 {
   int m, psi_flag;
 #ifdef _OPENMP
   int nthreads;
 
+  /* nfft_benchomp_detail_threads numa <nthreads> [MiB] */
+  if (argc >= 3 && strcmp(argv[1], "numa") == 0)
+  {
+    double mib = argc >= 4 ? atof(argv[3]) : 1024.0;
+    omp_set_num_threads(atoi(argv[2]));
+    bench_numa((INT)(mib * 1048576.0 / sizeof(C)));
+    return 0;
+  }
+
   if (argc != 4)
     return 1;
 
@@ -978,6 +978,64 @@ static void measure_time_nfft_XXX7(int d, int N, unsigned test_ndft)
   NFFT(finalize)(&p);
 }
 
+/** Times NFFT(trafo) for the Kaiser-Bessel and the exponential of semicircle
+ *  window, with the window evaluated on the fly and with PRE_PSI. */
+static void measure_time_nfft_window(int d, int N)
+{
+  const unsigned window[4] = {NFFT_WINDOW_KAISER_BESSEL,
+    NFFT_WINDOW_KAISER_BESSEL, NFFT_WINDOW_EXP_SEMICIRCLE,
+    NFFT_WINDOW_EXP_SEMICIRCLE};
+  const unsigned flags[4] = {0U, PRE_PSI, 0U, PRE_PSI};
+  int i, r, M, NN[d], nn[d];
+  R t, t_nfft;
+  ticks t0, t1;
+
+  NFFT(plan) p;
+
+  printf("\\verb+%ld+&\t", LRINT(LOG((R)(N)) / LOG((R)(2)) * (R)(d) + K(0.5)));
+
+  for (r = 0, M = 1; r < d; r++)
+  {
+    M = N * M;
+    NN[r] = N;
+    nn[r] = 2 * N;
+  }
+
+  for (i = 0; i < 4; i++)
+  {
+    NFFT(init_guru_window)(&p, d, NN, M, nn,
+      (int)NFFT(get_default_window_cut_off_of)(window[i]),
+      PRE_PHI_HUT | flags[i] | MALLOC_F_HAT | MALLOC_X | MALLOC_F |
+      FFTW_INIT | FFT_OUT_OF_PLACE,
+      FFTW_MEASURE | FFTW_DESTROY_INPUT, window[i]);
+
+    /** init pseudo random nodes */
+    NFFT(vrand_shifted_unit_double)(p.x, p.d * p.M_total);
+
+    NFFT(precompute_one_psi)(&p);
+
+    /** init pseudo random Fourier coefficients */
+    NFFT(vrand_unit_complex)(p.f_hat, p.N_total);
+
+    t_nfft = K(0.0);
+    r = 0;
+    while (t_nfft < K(1.0))
+    {
+      r++;
+      t0 = getticks();
+      NFFT(trafo)(&p);
+      t1 = getticks();
+      t = NFFT(elapsed_seconds)(t1, t0);
+      t_nfft += t;
+    }
+    t_nfft /= (R)(r);
+
+    printf("\\verb+%.1" __FES__ "+%s", t_nfft, (i < 3) ? " &\t" : "\\\\\n");
+
+    NFFT(finalize)(&p);
+  }
+}
+
 //static int main(void)
 //{
 //  int l, d, logIN;
@@ -1057,5 +1115,17 @@ int main(void)
     fflush(stdout);
   }
 
+  printf("\\hline $l_N$ & KB & KB (PRE\\_PSI) & ES & ES (PRE\\_PSI)\\\\\n");
+  printf("\\hline \\hline \\multicolumn{5}{|c|}{$d=2$} \\\\ \\hline\n");
+  for (l = 3; l <= 11; l++)
+  {
+    d = 2;
+    logIN = d * l;
+    int N = (int)(1U << (logIN / d));
+    measure_time_nfft_window(d, N);
+
+    fflush(stdout);
+  }
+
   return 1;
 }
@@ -112,6 +112,7 @@ void bench_openmp(int trafo_adjoint, int N, int M, double *x, C *f_hat, C *f, in
   nfsft_init_guru(&plan, N, M, nfsft_flags | NFSFT_MALLOC_X | NFSFT_MALLOC_F |
     NFSFT_MALLOC_F_HAT | NFSFT_NORMALIZED | NFSFT_PRESERVE_F_HAT,
     PRE_PHI_HUT | psi_flags | FFTW_INIT | FFT_OUT_OF_PLACE, m);
+  nfft_stats_enable(&plan.stats, 1);
 
 /*#ifdef _OPENMP
   fftw_export_wisdom_to_filename("nfsft_benchomp_detail_threads.plan");
@@ -162,16 +163,7 @@ void bench_openmp(int trafo_adjoint, int N, int M, double *x, C *f_hat, C *f, in
   t1 = getticks();
   tt_total = nfft_elapsed_seconds(t1,t0);
 
-#ifndef MEASURE_TIME
-  plan.MEASURE_TIME_t[0] = 0.0;
-  plan.MEASURE_TIME_t[2] = 0.0;
-#endif
-
-#ifndef MEASURE_TIME_FFTW
-  plan.MEASURE_TIME_t[1] = 0.0;
-#endif
-
-  printf("%.6e %.6e %6e %.6e %.6e %.6e\n", tt_pre, plan.MEASURE_TIME_t[0], plan.MEASURE_TIME_t[1], plan.MEASURE_TIME_t[2], tt_total-tt_pre-plan.MEASURE_TIME_t[0]-plan.MEASURE_TIME_t[1]-plan.MEASURE_TIME_t[2], tt_total);
+  printf("%.6e %.6e %6e %.6e %.6e %.6e\n", tt_pre, plan.stats.time[NFSFT_STATS_FPT], plan.stats.time[NFSFT_STATS_C2E], plan.stats.time[NFSFT_STATS_NFFT], tt_total-tt_pre-plan.stats.time[NFSFT_STATS_FPT]-plan.stats.time[NFSFT_STATS_C2E]-plan.stats.time[NFSFT_STATS_NFFT], tt_total);
 
   /** finalise the one dimensional plan */
   nfsft_finalize(&plan);
@@ -145,25 +145,14 @@ typedef ptrdiff_t INT;
 
 /* macros for window functions */
 
+/* The window function is selected per plan by the field window (one of the
+ * NFFT_WINDOW_* constants). The window chosen at configure time is used for
+ * NFFT_WINDOW_DEFAULT. */
 #if defined(DIRAC_DELTA)
-  #define PHI_HUT(n,k,d) K(1.0)
-  #define PHI(n,x,d) IF(FABS((x)) < K(10E-8),K(1.0),K(0.0))
-  #define WINDOW_HELP_INIT(d)
-  #define WINDOW_HELP_FINALIZE
+  #define WINDOW_DEFAULT NFFT_WINDOW_DIRAC_DELTA
   #define WINDOW_HELP_ESTIMATE_m 0
 #elif defined(GAUSSIAN)
-  #define PHI_HUT(n,k,d) ((R)EXP(-(POW(KPI*(k)/n,K(2.0))*ths->b[d])))
-  #define PHI(n,x,d) ((R)EXP(-POW((x)*((R)n),K(2.0)) / \
-    ths->b[d])/SQRT(KPI*ths->b[d]))
-  #define WINDOW_HELP_INIT \
-    { \
-      int WINDOW_idx; \
-      ths->b = (R*) Y(malloc)(ths->d*sizeof(R)); \
-      for (WINDOW_idx = 0; WINDOW_idx < ths->d; WINDOW_idx++) \
-        ths->b[WINDOW_idx]=(K(2.0)*ths->sigma[WINDOW_idx]) / \
-          (K(2.0)*ths->sigma[WINDOW_idx] - K(1.0)) * (((R)ths->m) / KPI); \
-    }
-  #define WINDOW_HELP_FINALIZE {Y(free)(ths->b);}
+  #define WINDOW_DEFAULT NFFT_WINDOW_GAUSSIAN
 #if defined(NFFT_LDOUBLE)
   #define WINDOW_HELP_ESTIMATE_m 17
 #elif defined(NFFT_SINGLE)
@@ -172,55 +161,26 @@ typedef ptrdiff_t INT;
   #define WINDOW_HELP_ESTIMATE_m 13
 #endif
 #elif defined(B_SPLINE)
-  #define PHI_HUT(n,k,d) ((R)(((k) == 0) ? K(1.0) / n : \
-    POW(SIN((k) * KPI / n) / ((k) * KPI / n), \
-      K(2.0) * ths->m)/n))
-  #define PHI(n,x,d) (Y(bsplines)(2*ths->m,((x)*n) + \
-    (R)ths->m) / n)
-  #define WINDOW_HELP_INIT
-  #define WINDOW_HELP_FINALIZE
-#if defined(NFFT_LDOUBLE)
-  #define WINDOW_HELP_ESTIMATE_m 11
-#elif defined(NFFT_SINGLE)
+  #define WINDOW_DEFAULT NFFT_WINDOW_B_SPLINE
   #define WINDOW_HELP_ESTIMATE_m 11
-#else
-  #define WINDOW_HELP_ESTIMATE_m 11
-#endif
 #elif defined(SINC_POWER)
-  #define PHI_HUT(n,k,d) (Y(bsplines)(2 * ths->m, (K(2.0) * ths->m*(k)) / \
-    ((K(2.0) * ths->sigma[(d)] - 1) * n / \
-      ths->sigma[(d)]) + (R)ths->m))
-  #define PHI(n,x,d) ((R)(n / ths->sigma[(d)] * \
-    (K(2.0) * ths->sigma[(d)] - K(1.0))/ (K(2.0)*ths->m) * \
-    POW(Y(sinc)(KPI * n / ths->sigma[(d)] * (x) * \
-    (K(2.0) * ths->sigma[(d)] - K(1.0)) / (K(2.0)*ths->m)) , 2*ths->m) / \
-    n))
-  #define WINDOW_HELP_INIT
-  #define WINDOW_HELP_FINALIZE
+  #define WINDOW_DEFAULT NFFT_WINDOW_SINC_POWER
 #if defined(NFFT_LDOUBLE)
   #define WINDOW_HELP_ESTIMATE_m 13
-#elif defined(NFFT_SINGLE)
-  #define WINDOW_HELP_ESTIMATE_m 11
 #else
   #define WINDOW_HELP_ESTIMATE_m 11
 #endif
+#elif defined(EXP_SEMICIRCLE)
+  #define WINDOW_DEFAULT NFFT_WINDOW_EXP_SEMICIRCLE
+  #if defined(NFFT_LDOUBLE)
+    #define WINDOW_HELP_ESTIMATE_m 9
+  #elif defined(NFFT_SINGLE)
+    #define WINDOW_HELP_ESTIMATE_m 4
+  #else
+    #define WINDOW_HELP_ESTIMATE_m 8
+  #endif
 #else /* Kaiser-Bessel is the default. */
-  #define PHI_HUT(n,k,d) (Y(bessel_i0)((R)(ths->m) * SQRT(ths->b[d] * ths->b[d] - (K(2.0) * KPI * (R)(k) / (R)(n)) * (K(2.0) * KPI * (R)(k) / (R)(n)))))
-  #define PHI(n,x,d) (  (((R)(ths->m) * (R)(ths->m) - (x) * (R)(n) * (x) * (R)(n)) > K(0.0)) \
-                      ?   SINH(ths->b[d] * SQRT((R)(ths->m) * (R)(ths->m) - (x) * (R)(n) * (x) * (R)(n))) \
-                        / (KPI * SQRT((R)(ths->m) * (R)(ths->m) - (x) * (R)(n) * (x) * (R)(n))) \
-                      :   ((((R)(ths->m) * (R)(ths->m) - (x) * (R)(n) * (x) * (R)(n)) < K(0.0)) \
-                        ?   SIN(ths->b[d] * SQRT((x) * (R)(n) * (x) * (R)(n) - (R)(ths->m) * (R)(ths->m))) \
-                          / (KPI * SQRT((x) * (R)(n) * (x) * (R)(n) - (R)(ths->m) * (R)(ths->m))) \
-                        : ths->b[d] / KPI))
-  #define WINDOW_HELP_INIT \
-    { \
-      int WINDOW_idx; \
-      ths->b = (R*) Y(malloc)((size_t)(ths->d) * sizeof(R)); \
-      for (WINDOW_idx = 0; WINDOW_idx < ths->d; WINDOW_idx++) \
-        ths->b[WINDOW_idx] = (KPI * (K(2.0) - K(1.0) / ths->sigma[WINDOW_idx])); \
-  }
-  #define WINDOW_HELP_FINALIZE {Y(free)(ths->b);}
+  #define WINDOW_DEFAULT NFFT_WINDOW_KAISER_BESSEL
   #if defined(NFFT_LDOUBLE)
     #define WINDOW_HELP_ESTIMATE_m 9
   #elif defined(NFFT_SINGLE)
@@ -230,8 +190,60 @@ typedef ptrdiff_t INT;
   #endif
 #endif
 
+/* The macros below expect a plan ths with fields window, m, b, sigma and
+ * spline_coeffs; WINDOW_HELP_INIT sets spline_coeffs_size once, so that the
+ * evaluations need not look it up. */
+#define WINDOW_COEFFS(d) ((ths->spline_coeffs == NULL) ? NULL : \
+  ths->spline_coeffs + (d) * ths->spline_coeffs_size)
+#define PHI_HUT(n,k,d) (Y(window_phi_hut)(ths->window, (INT)(n), (R)(k), \
+  (INT)(ths->m), ths->b[d], ths->sigma[d]))
+#define PHI(n,x,d) (Y(window_phi)(ths->window, (INT)(n), (R)(x), \
+  (INT)(ths->m), ths->b[d], ths->sigma[d], WINDOW_COEFFS(d)))
+/** Evaluates psi[l] = PHI(n, x - (u+l)/n, d) for l = 0,...,2m+1. */
+#define PHI_ROW(n,x,u,d,psi) (Y(window_phi_row)(ths->window, (INT)(n), (R)(x), \
+  (INT)(u), (INT)(ths->m), ths->b[d], ths->sigma[d], WINDOW_COEFFS(d), (psi)))
+/* Allocation of the window parameters by WINDOW_HELP_INIT; a module may
+ * redefine these to place them with the other buffers of its plan. */
+#define WINDOW_MALLOC(n) Y(malloc)(n)
+#define WINDOW_FREE(p) Y(free)(p)
+#define WINDOW_HELP_INIT \
+  { \
+    int WINDOW_idx; \
+    const INT WINDOW_size = Y(window_coeffs_size)(ths->window, (INT)(ths->m)); \
+    ths->b = (R*) WINDOW_MALLOC((size_t)(ths->d) * sizeof(R)); \
+    for (WINDOW_idx = 0; WINDOW_idx < ths->d; WINDOW_idx++) \
+      ths->b[WINDOW_idx] = Y(window_b)(ths->window, (INT)(ths->m), \
+        ths->sigma[WINDOW_idx]); \
+    ths->spline_coeffs = NULL; \
+    ths->spline_coeffs_size = WINDOW_size; \
+    if (WINDOW_size > 0) \
+    { \
+      ths->spline_coeffs = (R*) WINDOW_MALLOC((size_t)(ths->d * WINDOW_size) \
+        * sizeof(R)); \
+      for (WINDOW_idx = 0; WINDOW_idx < ths->d; WINDOW_idx++) \
+        Y(window_coeffs_init)(ths->window, (INT)(ths->m), ths->b[WINDOW_idx], \
+          ths->spline_coeffs + WINDOW_idx * WINDOW_size); \
+    } \
+  }
+#define WINDOW_HELP_FINALIZE {WINDOW_FREE(ths->b); \
+  if (ths->spline_coeffs != NULL) WINDOW_FREE(ths->spline_coeffs);}
+
 /* window.c */
-INT Y(m2K)(const INT m);
+INT Y(m2K)(const unsigned window, const INT m);
+unsigned Y(window_resolve)(const unsigned window);
+R Y(window_b)(const unsigned window, const INT m, const R sigma);
+R Y(window_error)(const unsigned window, const INT m, const R sigma);
+R Y(window_amplification)(const unsigned window, const INT m, const R sigma);
+INT Y(window_m)(const unsigned window, const R sigma, R eps);
+INT Y(window_coeffs_size)(const unsigned window, const INT m);
+void Y(window_coeffs_init)(const unsigned window, const INT m, const R b,
+  R *coeffs);
+R Y(window_phi)(const unsigned window, const INT n, const R x, const INT m,
+  const R b, const R sigma, const R *coeffs);
+R Y(window_phi_hut)(const unsigned window, const INT n, const R k,
+  const INT m, const R b, const R sigma);
+void Y(window_phi_row)(const unsigned window, const INT n, const R x,
+  const INT u, const INT m, const R b, const R sigma, const R *coeffs, R *psi);
 
 #if defined(NFFT_LDOUBLE)
 #if HAVE_DECL_COPYSIGNL == 0
@@ -1318,6 +1330,9 @@ extern double _Complex catanh(double _Complex z);
 /** Dummy use of unused parameters to silence compiler warnings */
 #define UNUSED(x) (void)x
 
+/** Alignment of the blocks of an arena, one cache line. */
+#define ARENA_ALIGN 64
+
 #ifdef HAVE_ALLOCA
   /* Use alloca if available. */
   #ifndef alloca
@@ -1367,47 +1382,77 @@ R Y(elapsed_seconds)(ticks t1, ticks t0);
 /** Dummy use of unused parameters to silence compiler warnings */
 #define UNUSED(x) (void)x
 
-/** Timing, method works since the inaccurate timer is updated mostly in the
- *  measured function. For small times not every call of the measured function
- *  will also produce a 'unit' time step.
- *  Measuring the fftw might cause a wrong output vector due to the repeated
- *  ffts.
+/* thread.c */
+/** Zeroes the n blocks of size bytes at p, each by the thread that gets the
+ *  block in a static OpenMP schedule. Done right after the allocation, this
+ *  first touch places the pages of the block on the NUMA node of that thread.
  */
-#ifdef MEASURE_TIME
- int MEASURE_TIME_r;
- double MEASURE_TIME_tt;
- ticks MEASURE_TIME_t0, MEASURE_TIME_t1;
-
-#define TIC(a)                                                                \
-  ths->MEASURE_TIME_t[(a)]=0;                                                 \
-  MEASURE_TIME_r=0;                                                           \
-  /* DISABLED LOOP due to code blocks causing segfault when repeatedly run */ \
-  /*while(ths->MEASURE_TIME_t[(a)]<0.01)*/                                    \
-    {                                                                         \
-      MEASURE_TIME_r++;                                                       \
-      MEASURE_TIME_t0 = getticks();                                           \
-
-/* THE MEASURED FUNCTION IS CALLED REPEATEDLY */
-
-#define TOC(a)                                                                \
-      MEASURE_TIME_t1 = getticks();                                           \
-      MEASURE_TIME_tt = Y(elapsed_seconds)(MEASURE_TIME_t1,MEASURE_TIME_t0);\
-      ths->MEASURE_TIME_t[(a)]+=MEASURE_TIME_tt;                              \
-    }                                                                         \
-  ths->MEASURE_TIME_t[(a)]/=MEASURE_TIME_r;                                   \
+void Y(zero_omp)(void *p, const INT n, const size_t size);
+
+/* stats.c */
+/** Monotonic wall clock in seconds. */
+double Y(stats_seconds)(void);
+/** Adds a run of the phase that took seconds to s, and the busy times its
+ *  threads reported by Y(stats_thread_add) during the run. */
+struct nfft_stats_s;
+void Y(stats_add)(struct nfft_stats_s *s, const int phase,
+  const double seconds);
+/** Adds the time the calling OpenMP thread spent on its share of a loop of
+ *  the phase to the current run of the phase. */
+void Y(stats_thread_add)(struct nfft_stats_s *s, const int phase,
+  const double seconds);
+
+/* trace.c */
+/** Passes an event to the trace hook, if one is still installed. */
+void Y(trace_emit)(const int begin, const int phase, const void *plan,
+  const double size0, const double size1);
+
+/** Begin and end events of the phase a of plan p. TRACE_BEGIN opens a block
+ *  that TRACE_END closes; the end event is only sent if the begin event was. */
+#define TRACE_BEGIN(a, p, size0, size1) \
+  { \
+    const int trace_on = Y(trace_hook) != 0; \
+    if (trace_on) \
+      Y(trace_emit)(1, (a), (p), (double)(size0), (double)(size1));
 
+#define TRACE_END(a, p, size0, size1) \
+    if (trace_on) \
+      Y(trace_emit)(0, (a), (p), (double)(size0), (double)(size1)); \
+  }
+
+/** Timing and tracing of the phase a of the plan ths. TIC opens a block that
+ *  TOC closes. */
+#define TIC(a) \
+  TRACE_BEGIN(a, ths, ths->M_total, ths->N_total) \
+  { \
+    const int stats_on = ths->stats.enabled; \
+    const double stats_t0 = stats_on ? Y(stats_seconds)() : 0.0;
+
+#define TOC(a) \
+    if (stats_on) \
+      Y(stats_add)(&ths->stats, (a), Y(stats_seconds)() - stats_t0); \
+  } \
+  TRACE_END(a, ths, ths->M_total, ths->N_total)
+
+/** Busy time of a thread in a parallel loop of the phase a of the plan ths.
+ *  The loop is a "#pragma omp for nowait" inside a parallel region that
+ *  starts with STATS_THREAD_BEGIN and ends with STATS_THREAD_END, so that
+ *  the time of each thread ends with its share of the loop and not after the
+ *  barrier. Without OpenMP both are empty. */
+#ifdef _OPENMP
+#define STATS_THREAD_BEGIN \
+  const double stats_thread_t0 = ths->stats.enabled ? Y(stats_seconds)() : 0.0;
+
+#define STATS_THREAD_END(a) \
+  if (ths->stats.enabled) \
+    Y(stats_thread_add)(&ths->stats, (a), Y(stats_seconds)() - stats_thread_t0);
 #else
-#define TIC(a)
-#define TOC(a)
+#define STATS_THREAD_BEGIN
+#define STATS_THREAD_END(a)
 #endif
 
-#ifdef MEASURE_TIME_FFTW
 #define TIC_FFTW(a) TIC(a)
 #define TOC_FFTW(a) TOC(a)
-#else
-#define TIC_FFTW(a)
-#define TOC_FFTW(a)
-#endif
 
 /* sinc.c: */
 
@@ -1501,6 +1546,38 @@ void Y(upd_axpwy_complex)(C *x, R a, R *w, C *y, INT n);
 /** Updates \f$x \leftarrow a x +  w\odot y\f$. */
 void Y(upd_axpwy_double)(R *x, R a, R *w, R *y, INT n);
 
+/* ndft.c */
+#define NDFT_COS 0
+#define NDFT_SIN 1
+/** Computes \f$f_j = \sum_k \hat f_k {\rm e}^{2\pi{\rm i}\,s\,kx_j}\f$ for the
+ *  frequencies \f$k_t = k0_t,\dots,k0_t+L_t-1\f$ and the sign s. */
+void Y(ndft_trafo)(const INT d, const INT *L, const INT *k0, const INT M,
+  const R *x, const C *f_hat, C *f, const R sign);
+/** Computes \f$\hat f_k = \sum_j f_j {\rm e}^{2\pi{\rm i}\,s\,kx_j}\f$. */
+void Y(ndft_adjoint)(const INT d, const INT *L, const INT *k0, const INT M,
+  const R *x, const C *f, C *f_hat, const R sign);
+/** Like Y(ndft_trafo) with the products of cos or sin (NDFT_COS, NDFT_SIN)
+ *  of \f$2\pi k_tx_{j,t}\f$ in place of the exponential. */
+void Y(ndft_trafo_real)(const INT d, const INT *L, const INT *k0,
+  const INT M, const R *x, const R *f_hat, R *f, const int basis);
+void Y(ndft_adjoint_real)(const INT d, const INT *L, const INT *k0,
+  const INT M, const R *x, const R *f, R *f_hat, const int basis);
+
+/* simd.c */
+#define SIMD_NONE   0
+#define SIMD_SSE2   1
+#define SIMD_AVX2   2
+#define SIMD_AVX512 3
+/** Restricts the B step kernels to at most the given SIMD_* level; not while
+ *  a transform runs. */
+int Y(simd_set_level)(const int level);
+/** Returns the SIMD_* level of the B step kernels. */
+int Y(simd_level)(void);
+/** Computes \f$\sum_k w_k x_k\f$ for real w and complex x. */
+C Y(sum_wx_complex)(const R *w, const C *x, const INT n);
+/** Updates \f$x \leftarrow x + a w\f$ for real w and complex x and a. */
+void Y(upd_xpaw_complex)(C *x, const C a, const R *w, const INT n);
+
 /* voronoi.c */
 void Y(voronoi_weights_1d)(R *w, R *x, const INT M);
 
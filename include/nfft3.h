@@ -79,13 +79,119 @@ typedef void  (*X(free_type_function)) (void *p); \
 typedef void  (*X(die_type_function)) (const char *errString); \
 NFFT_EXTERN X(malloc_type_function) X(malloc_hook); \
 NFFT_EXTERN X(free_type_function) X(free_hook); \
-NFFT_EXTERN X(die_type_function) X(die_hook);
+NFFT_EXTERN X(die_type_function) X(die_hook); \
+\
+/* Arena: one aligned slab from which a bump pointer hands out blocks. Blocks */ \
+/* are released all at once by X(arena_reset), so that plans can be created */ \
+/* and destroyed in the arena without malloc/free churn. Requests that do */ \
+/* not fit into the slab are passed on to X(malloc). An arena must not be */ \
+/* used by several threads at once. */ \
+typedef struct X(arena_s) X(arena); \
+/** Creates an arena of size bytes; flags NFFT_ARENA_HUGE_PAGES maps the */ \
+/** slab with transparent huge pages where the system supports them. */ \
+NFFT_EXTERN X(arena) *X(arena_create)(size_t size, unsigned flags); \
+NFFT_EXTERN void *X(arena_malloc)(X(arena) *a, size_t n); \
+/** Frees blocks passed on to X(malloc); slab blocks are only reclaimed if */ \
+/** p is the most recent one, all others by X(arena_reset). */ \
+NFFT_EXTERN void X(arena_free)(X(arena) *a, void *p); \
+NFFT_EXTERN void X(arena_reset)(X(arena) *a); \
+/** Largest number of bytes requested from the arena between two resets, */ \
+/** including the alignment padding and the requests passed on to X(malloc). */ \
+NFFT_EXTERN size_t X(arena_peak)(const X(arena) *a); \
+NFFT_EXTERN void X(arena_destroy)(X(arena) *a);
 
 /* Nfft module API. */
 NFFT_DEFINE_MALLOC_API(NFFT_MANGLE_FLOAT)
 NFFT_DEFINE_MALLOC_API(NFFT_MANGLE_DOUBLE)
 NFFT_DEFINE_MALLOC_API(NFFT_MANGLE_LONG_DOUBLE)
 
+/* Statistics of the transforms. Every plan has a member stats that records
+ * the wall time of the phases of its transforms once it is enabled by
+ * X(stats_enable). The times are summed up until X(stats_reset). */
+#define NFFT_STATS_D          0 /**< multiplication with the diagonal matrix D */
+#define NFFT_STATS_FFT        1 /**< FFT of the oversampled vector */
+#define NFFT_STATS_B          2 /**< multiplication with the sparse matrix B */
+#define NFFT_STATS_PRECOMPUTE 3 /**< node-dependent precomputation of psi */
+#define NFFT_STATS_SORT       4 /**< sorting of the nodes */
+#define NFFT_STATS_TRAFO      5 /**< whole transform or adjoint */
+#define NFFT_STATS_PHASES     8 /**< number of phases, the last ones are free */
+#define NFFT_STATS_THREADS   64 /**< OpenMP threads whose busy times are kept
+  apart, further threads share their slots */
+
+typedef struct nfft_stats_s
+{
+  int enabled; /**< Nonzero if the plan records statistics. */
+  unsigned long calls[NFFT_STATS_PHASES]; /**< Runs of each phase. */
+  double time[NFFT_STATS_PHASES]; /**< Wall time of each phase in seconds. */
+  double busy_max[NFFT_STATS_PHASES]; /**< Sum over the runs of the largest
+    time an OpenMP thread spent on its share of the loops of the phase. */
+  double busy_mean[NFFT_STATS_PHASES]; /**< Sum over the runs of the mean
+    time the OpenMP threads spent on their shares of the loops. */
+  double busy[NFFT_STATS_PHASES][NFFT_STATS_THREADS]; /**< Busy times of the
+    threads in the current run of each phase, internal. */
+  int busy_threads[NFFT_STATS_PHASES]; /**< Threads of the current run of each
+    phase, internal. */
+  double nodes; /**< Nodes processed by the transforms. */
+  double bytes; /**< Estimated bytes read and written by the transforms. */
+} nfft_stats;
+
+#define NFFT_DEFINE_STATS_API(X) \
+NFFT_EXTERN void X(stats_enable)(nfft_stats *s, int on); \
+/** Clears the counters, but keeps s enabled or disabled. */ \
+NFFT_EXTERN void X(stats_reset)(nfft_stats *s); \
+/** Ratio of the largest to the mean time the OpenMP threads spent on their */ \
+/** shares of the loops of a phase, at least 1, and 0 if the phase ran no */ \
+/** parallel loop, e.g. without OpenMP. Only the B and D steps of nfft */ \
+/** plans are measured. */ \
+NFFT_EXTERN double X(stats_imbalance)(const nfft_stats *s, int phase); \
+/** Nodes per second of the phases D, FFT and B. */ \
+NFFT_EXTERN double X(stats_nodes_per_second)(const nfft_stats *s);
+
+NFFT_DEFINE_STATS_API(NFFT_MANGLE_FLOAT)
+NFFT_DEFINE_STATS_API(NFFT_MANGLE_DOUBLE)
+NFFT_DEFINE_STATS_API(NFFT_MANGLE_LONG_DOUBLE)
+
+/* Tracing. A hook installed in X(trace_hook) is called at the begin and at
+ * the end of every phase of the transforms, so that external profilers can
+ * show them in their own timelines. The phases of the statistics above are
+ * traced with the same ids. Without a hook a phase costs one test. */
+#define NFFT_TRACE_FPT    6 /**< one fast polynomial transform of an fpt_set */
+#define NFFT_TRACE_SOLVER 7 /**< one iteration of a solver plan */
+
+typedef struct nfft_trace_event_s
+{
+  int begin; /**< 1 at the begin of a phase, 0 at its end. */
+  int phase; /**< NFFT_STATS_D, ..., NFFT_TRACE_SOLVER. */
+  const void *plan; /**< Plan, fpt_set or solver plan running the phase. */
+  int thread; /**< OpenMP thread number of the caller, 0 without OpenMP. */
+  double time; /**< Monotonic wall clock in seconds. */
+  double size0; /**< M_total of the plan or of the plan of the solver, the */
+                /**< order m of an FPT. */
+  double size1; /**< N_total of the plan or of the plan of the solver, the */
+                /**< degree k_end of an FPT. */
+} nfft_trace_event;
+
+#define NFFT_DEFINE_TRACE_API(X) \
+typedef void (*X(trace_type_function))(const nfft_trace_event *e, void *data); \
+/** Called for every event with X(trace_data) if not 0. The hook may be */ \
+/** called by several threads at once. Install and remove it only while no */ \
+/** transform runs; the transforms read it without synchronization. */ \
+NFFT_EXTERN X(trace_type_function) X(trace_hook); \
+NFFT_EXTERN void *X(trace_data); \
+/** Name of a phase of the events. */ \
+NFFT_EXTERN const char *X(trace_phase_name)(int phase); \
+/** Installs a hook that writes the events to filename in the Chrome trace */ \
+/** event format, as read by chrome://tracing and Perfetto. Returns 1 on */ \
+/** success and 0 if the file cannot be opened. */ \
+NFFT_EXTERN int X(trace_chrome_open)(const char *filename); \
+/** Removes the hook and completes the file, like the hook only while no */ \
+/** transform runs. */ \
+NFFT_EXTERN void X(trace_chrome_close)(void);
+
+NFFT_DEFINE_TRACE_API(NFFT_MANGLE_FLOAT)
+NFFT_DEFINE_TRACE_API(NFFT_MANGLE_DOUBLE)
+NFFT_DEFINE_TRACE_API(NFFT_MANGLE_LONG_DOUBLE)
+
 /* Macro to define prototypes for all NFFT API functions.
  * We expand this macro for each supported precision.
  *   X: NFFT name-mangling macro
@@ -125,6 +231,7 @@ typedef struct\
   R *b; /**< Shape parameter for window function */\
   NFFT_INT K; /**< Number of equispaced samples of window function. Used for flag
              PRE_LIN_PSI. */\
+  unsigned window; /**< Window function, one of the NFFT_WINDOW_* constants. */\
 \
   unsigned flags; /**< Flags for precomputation, (de)allocation, and FFTW
                        usage, default setting is PRE_PHI_HUT | PRE_PSI
@@ -133,15 +240,24 @@ typedef struct\
 \
   unsigned fftw_flags; /**< Flags for the FFTW, default is
                             FFTW_ESTIMATE | FFTW_DESTROY_INPUT */\
+\
+  NFFT_INT howmany; /**< Number of vectors transformed at once by trafo_many and
+                      adjoint_many, default is 1 */\
 \
   R *x; /**< Nodes in time/spatial domain, size is \f$dM\f$ R ## s */\
+  unsigned nodes_changed; /**< Nonzero if the nodes were changed by set_nodes
+                               and the precomputation of psi is pending */\
 \
-  R MEASURE_TIME_t[3]; /**< Measured time for each step if MEASURE_TIME is
-    set */\
+  nfft_stats stats; /**< Statistics of the transforms, see stats_enable */\
 \
   /* internal use only */\
   Y(plan) my_fftw_plan1; /**< Forward FFTW plan */\
   Y(plan) my_fftw_plan2; /**< Backward FFTW plan */\
+  Y(plan) my_fftw_plan1_many; /**< Forward FFTW plan for howmany vectors */\
+  Y(plan) my_fftw_plan2_many; /**< Backward FFTW plan for howmany vectors */\
+  Y(plan) *my_fftw_plan1_pruned; /**< Forward FFTW plans per axis for NFFT_PRUNED_FFT */\
+  Y(plan) *my_fftw_plan2_pruned; /**< Backward FFTW plans per axis for NFFT_PRUNED_FFT */\
+  int fftw_nthreads; /**< Threads the FFTW plans were created with */\
 \
   R **c_phi_inv; /**< Precomputed data for the diagonal matrix \f$D\f$, size \
     is \f$N_0+\dots+N_{d-1}\f$ doubles*/\
@@ -149,15 +265,24 @@ typedef struct\
                     on precomputation scheme */\
   NFFT_INT *psi_index_g; /**< Indices in source/target vector for \ref PRE_FULL_PSI */\
   NFFT_INT *psi_index_f; /**< Indices in source/target vector for \ref PRE_FULL_PSI */\
+  float *psi_float; /**< Window values of \ref PRE_FULL_PSI in single precision, see \ref NFFT_FULL_PSI_FLOAT */\
+  int *psi_index_g32; /**< 32-bit psi_index_g for \ref NFFT_FULL_PSI_FLOAT */\
+  R psi_float_scale; /**< psi_float holds psi divided by this factor */\
 \
   C *g; /**< Oversampled vector of samples, size is \ref n_total double complex */\
   C *g_hat; /**< Zero-padded vector of Fourier coefficients, size is \ref n_total fftw_complex */\
-  C *g1; /**< Input of fftw */\
-  C *g2; /**< Output of fftw */\
+  C *g1; /**< Input of fftw, size is howmany * n_total */\
+  C *g2; /**< Output of fftw, size is howmany * n_total */\
 \
-  R *spline_coeffs; /**< Input for de Boor algorithm if B_SPLINE or SINC_POWER is defined */\
+  R *spline_coeffs; /**< Piecewise polynomial coefficients of the window function, used by NFFT_WINDOW_EXP_SEMICIRCLE */\
+  NFFT_INT spline_coeffs_size; /**< Length of the coefficients of one dimension in spline_coeffs */\
 \
   NFFT_INT *index_x; /**< Index array for nodes x used when flag \ref NFFT_SORT_NODES is set. */\
+  NFFT_INT *index_x_tmp; /**< Workspace of the radix sort of index_x, size is 2*M_total. */\
+  void *map; /**< Read-only mapping of the file the plan was restored from by load_plan, or NULL */\
+  size_t map_size; /**< Size of map in bytes */\
+  X(arena) *arena; /**< Arena of all plan buffers, or NULL. Owned by the plan
+                      if flag \ref NFFT_ARENA is set. */\
 } X(plan); \
 \
 NFFT_EXTERN void X(trafo_direct)(const X(plan) *ths);\
@@ -170,21 +295,114 @@ NFFT_EXTERN void X(adjoint)(X(plan) *ths);\
 NFFT_EXTERN void X(adjoint_1d)(X(plan) *ths);\
 NFFT_EXTERN void X(adjoint_2d)(X(plan) *ths);\
 NFFT_EXTERN void X(adjoint_3d)(X(plan) *ths);\
+NFFT_EXTERN void X(trafo_many)(X(plan) *ths, int howmany, C *f_hat, \
+  int f_hat_dist, C *f, int f_dist);\
+NFFT_EXTERN void X(adjoint_many)(X(plan) *ths, int howmany, C *f_hat, \
+  int f_hat_dist, C *f, int f_dist);\
+/** Like trafo_many and adjoint_many, with the stages D, FFT and B of */\
+/** consecutive vectors overlapped on depth (1 to 3) workspaces. If not NULL, */\
+/** occupancy[0..2] returns the fraction of the time in which D, the FFT and */\
+/** B were busy. */\
+NFFT_EXTERN void X(trafo_pipeline)(X(plan) *ths, int howmany, C *f_hat, \
+  int f_hat_dist, C *f, int f_dist, int depth, R *occupancy);\
+NFFT_EXTERN void X(adjoint_pipeline)(X(plan) *ths, int howmany, C *f_hat, \
+  int f_hat_dist, C *f, int f_dist, int depth, R *occupancy);\
+NFFT_EXTERN void X(adjoint_stream_begin)(X(plan) *ths);\
+NFFT_EXTERN void X(adjoint_stream_chunk)(X(plan) *ths, int M, const R *x, \
+  const C *f);\
+NFFT_EXTERN void X(adjoint_stream_end)(X(plan) *ths);\
+NFFT_EXTERN void X(trafo_stream_begin)(X(plan) *ths);\
+NFFT_EXTERN void X(trafo_stream_chunk)(X(plan) *ths, int M, const R *x, \
+  C *f);\
+NFFT_EXTERN void X(interp)(X(plan) *ths, const C *g, C *f);\
+NFFT_EXTERN void X(spread)(X(plan) *ths, const C *f, C *g);\
 NFFT_EXTERN void X(init_1d)(X(plan) *ths, int N1, int M);\
 NFFT_EXTERN void X(init_2d)(X(plan) *ths, int N1, int N2, int M);\
 NFFT_EXTERN void X(init_3d)(X(plan) *ths, int N1, int N2, int N3, int M);\
 NFFT_EXTERN void X(init)(X(plan) *ths, int d, int *N, int M);\
+NFFT_EXTERN void X(oversampling_params)(int d, int *N, R sigma, int *n, \
+  int *m);\
+NFFT_EXTERN void X(init_sigma)(X(plan) *ths, int d, int *N, int M, R sigma);\
 NFFT_EXTERN void X(init_guru)(X(plan) *ths, int d, int *N, int M, int *n, \
   int m, unsigned flags, unsigned fftw_flags);\
+NFFT_EXTERN void X(init_guru_window)(X(plan) *ths, int d, int *N, int M, \
+  int *n, int m, unsigned flags, unsigned fftw_flags, unsigned window);\
+NFFT_EXTERN void X(init_guru_many)(X(plan) *ths, int d, int *N, int M, \
+  int *n, int m, int howmany, unsigned flags, unsigned fftw_flags, \
+  unsigned window);\
 NFFT_EXTERN void X(init_lin)(X(plan) *ths, int d, int *N, int M, int *n, \
   int m, int K, unsigned flags, unsigned fftw_flags); \
+NFFT_EXTERN void X(init_guru_arena)(X(plan) *ths, int d, int *N, int M, \
+  int *n, int m, unsigned flags, unsigned fftw_flags, X(arena) *arena);\
+NFFT_EXTERN size_t X(estimate_memory)(int d, int *N, int M, int *n, int m, \
+  unsigned flags);\
+NFFT_EXTERN unsigned X(budget_flags)(int d, int *N, int M, int *n, int m, \
+  unsigned flags, size_t max_bytes);\
+NFFT_EXTERN void X(init_guru_budget)(X(plan) *ths, int d, int *N, int M, \
+  int *n, int m, unsigned flags, unsigned fftw_flags, size_t max_bytes);\
+NFFT_EXTERN int X(tune)(int d, int *N, int M, R eps, size_t max_bytes, \
+  int *n, int *m, unsigned *flags, unsigned *fftw_flags);\
+NFFT_EXTERN void X(init_tune)(X(plan) *ths, int d, int *N, int M, R eps);\
+NFFT_EXTERN int X(export_tune_wisdom_to_filename)(const char *filename);\
+NFFT_EXTERN int X(import_tune_wisdom_from_filename)(const char *filename);\
+NFFT_EXTERN void X(forget_tune_wisdom)(void);\
 NFFT_EXTERN void X(precompute_one_psi)(X(plan) *ths);\
+NFFT_EXTERN int X(save_plan)(X(plan) *ths, const char *filename);\
+NFFT_EXTERN int X(load_plan)(X(plan) *ths, const char *filename, \
+  const R *x);\
 NFFT_EXTERN void X(precompute_psi)(X(plan) *ths);\
 NFFT_EXTERN void X(precompute_full_psi)(X(plan) *ths);\
 NFFT_EXTERN void X(precompute_fg_psi)(X(plan) *ths); \
 NFFT_EXTERN void X(precompute_lin_psi)(X(plan) *ths);\
+NFFT_EXTERN void X(set_nodes)(X(plan) *ths, const R *x);\
+NFFT_EXTERN size_t X(workspace_size)(const X(plan) *ths);\
+/** Reentrant trafo and adjoint on the given vectors and a workspace of */\
+/** workspace_size bytes from nfft_malloc; ths is only read. Abort if */\
+/** set_nodes was called since the last transform on ths itself. The stats */\
+/** and trace events of the call go to a private copy of the plan, not to */\
+/** ths->stats. */\
+NFFT_EXTERN void X(execute_trafo)(const X(plan) *ths, const C *f_hat, C *f, \
+  void *work);\
+NFFT_EXTERN void X(execute_adjoint)(const X(plan) *ths, C *f_hat, const C *f, \
+  void *work);\
 NFFT_EXTERN const char* X(check)(X(plan) *ths);\
-NFFT_EXTERN void X(finalize)(X(plan) *ths);
+NFFT_EXTERN void X(finalize)(X(plan) *ths);\
+\
+/** data structure for a real-valued NFFT plan with R precision. The samples f \
+ *  are real and the Fourier coefficients f_hat are the half spectrum \
+ *  k_{d-1} = 0,...,N_{d-1}-N_{d-1}/2-1 of the index set of X(plan), stored as \
+ *  interleaved complex numbers. The transform is \
+ *  f_j = Re sum_k f_hat_k exp(-2 pi i k x_j) over the half spectrum, its \
+ *  adjoint is the half spectrum of the complex adjoint. N_total counts the \
+ *  R entries of f_hat, so the plan can be used as a Y(mv_plan_double). */ \
+typedef struct\
+{\
+  MACRO_MV_PLAN(R)\
+\
+  NFFT_INT d; /**< Dimension (rank). */\
+  R *x; /**< Nodes, shared with plan_nfft */\
+  unsigned flags; /**< Flags for precomputation, (de)allocation and FFTW usage */\
+  unsigned fftw_flags; /**< Flags for the FFTW */\
+\
+  /* internal use only */\
+  X(plan) plan_nfft; /**< Internal NFFT plan for the nodes and the window */\
+  NFFT_INT N_half; /**< Length of the half spectrum in the last dimension */\
+  NFFT_INT n_hat_total; /**< Size of g_hat, n_0...n_{d-2}(n_{d-1}/2+1) */\
+  Y(plan) my_fftw_c2r_plan; /**< Complex to real FFTW plan, g_hat to g */\
+  Y(plan) my_fftw_r2c_plan; /**< Real to complex FFTW plan, g to g_hat */\
+  R *g; /**< Real oversampled vector of samples, size is n_total */\
+  C *g_hat; /**< Half spectrum of the oversampled vector */\
+} X(real_plan); \
+\
+NFFT_EXTERN void X(real_trafo_direct)(const X(real_plan) *ths);\
+NFFT_EXTERN void X(real_adjoint_direct)(const X(real_plan) *ths);\
+NFFT_EXTERN void X(real_trafo)(X(real_plan) *ths);\
+NFFT_EXTERN void X(real_adjoint)(X(real_plan) *ths);\
+NFFT_EXTERN void X(real_init)(X(real_plan) *ths, int d, int *N, int M);\
+NFFT_EXTERN void X(real_init_guru)(X(real_plan) *ths, int d, int *N, int M, \
+  int *n, int m, unsigned flags, unsigned fftw_flags);\
+NFFT_EXTERN void X(real_precompute_one_psi)(X(real_plan) *ths);\
+NFFT_EXTERN void X(real_finalize)(X(real_plan) *ths);
 
 /* Nfft module API. */
 NFFT_DEFINE_API(NFFT_MANGLE_FLOAT,FFTW_MANGLE_FLOAT,float,fftwf_complex)
@@ -205,8 +423,24 @@ NFFT_DEFINE_API(NFFT_MANGLE_LONG_DOUBLE,FFTW_MANGLE_LONG_DOUBLE,long double,fftw
 #define FFTW_INIT                  (1U<<10)
 #define NFFT_SORT_NODES            (1U<<11)
 #define NFFT_OMP_BLOCKWISE_ADJOINT (1U<<12)
+#define NFFT_OMP_TILED_ADJOINT     (1U<<13)
+#define NFFT_PRUNED_FFT            (1U<<14)
+#define NFFT_FULL_PSI_FLOAT        (1U<<15)
+#define NFFT_ARENA                 (1U<<16)
+#define NFFT_ARENA_HUGE_PAGES      (1U<<17)
 #define PRE_ONE_PSI (PRE_LIN_PSI| PRE_FG_PSI| PRE_PSI| PRE_FULL_PSI)
 
+/* Window functions for the init_guru_window routines. NFFT_WINDOW_DEFAULT
+ * selects the window chosen at configure time (--with-window). FG_PSI and
+ * PRE_FG_PSI require NFFT_WINDOW_GAUSSIAN. */
+#define NFFT_WINDOW_DEFAULT        (0U)
+#define NFFT_WINDOW_KAISER_BESSEL  (1U)
+#define NFFT_WINDOW_GAUSSIAN       (2U)
+#define NFFT_WINDOW_B_SPLINE       (3U)
+#define NFFT_WINDOW_SINC_POWER     (4U)
+#define NFFT_WINDOW_DIRAC_DELTA    (5U)
+#define NFFT_WINDOW_EXP_SEMICIRCLE (6U)
+
 /* nfct */
 
 /* name mangling macros */
@@ -238,13 +472,14 @@ typedef struct\
   R *b; /**< shape parameters */\
   NFFT_INT K; /**< Number of equispaced samples of window function. Used for flag
                PRE_LIN_PSI. */\
+  unsigned window; /**< window function, one of the NFFT_WINDOW_* constants */\
 \
   unsigned flags; /**< flags for precomputation, malloc */\
   unsigned fftw_flags; /**< flags for the fftw */\
 \
   R *x; /**< nodes (in time/spatial domain)   */\
 \
-  double MEASURE_TIME_t[3]; /**< measured time for each step */\
+  nfft_stats stats; /**< statistics of the transforms */\
 \
   /* internal use only */\
   Y(plan)  my_fftw_r2r_plan; /**< fftw_plan */\
@@ -261,7 +496,8 @@ typedef struct\
   R *g1; /**< input of fftw */\
   R *g2; /**< output of fftw */\
 \
-  R *spline_coeffs; /**< input for de Boor algorithm, if B_SPLINE or SINC_2m is defined   */\
+  R *spline_coeffs; /**< piecewise polynomial coefficients of the window function, used by NFFT_WINDOW_EXP_SEMICIRCLE */\
+  NFFT_INT spline_coeffs_size; /**< Length of the coefficients of one dimension in spline_coeffs */\
 } X(plan);\
 \
 NFFT_EXTERN void X(init_1d)(X(plan) *ths_plan, int N0, int M_total); \
@@ -270,6 +506,10 @@ NFFT_EXTERN void X(init_3d)(X(plan) *ths_plan, int N0, int N1, int N2, int M_tot
 NFFT_EXTERN void X(init)(X(plan) *ths_plan, int d, int *N, int M_total); \
 NFFT_EXTERN void X(init_guru)(X(plan) *ths_plan, int d, int *N, int M_total, int *n, \
   int m, unsigned flags, unsigned fftw_flags); \
+NFFT_EXTERN void X(init_guru_window)(X(plan) *ths_plan, int d, int *N, int M_total, \
+  int *n, int m, unsigned flags, unsigned fftw_flags, unsigned window); \
+NFFT_EXTERN size_t X(estimate_memory)(int d, int *N, int M_total, int *n, \
+  int m, unsigned flags); \
 NFFT_EXTERN void X(precompute_one_psi)(X(plan) *ths);\
 NFFT_EXTERN void X(precompute_psi)(X(plan) *ths);\
 NFFT_EXTERN void X(precompute_full_psi)(X(plan) *ths);\
@@ -318,13 +558,14 @@ typedef struct\
   R *b; /**< shape parameters */\
   NFFT_INT K; /**< Number of equispaced samples of window function. Used for flag
                PRE_LIN_PSI. */\
+  unsigned window; /**< window function, one of the NFFT_WINDOW_* constants */\
 \
   unsigned flags; /**< flags for precomputation, malloc */\
   unsigned fftw_flags; /**< flags for the fftw */\
 \
   R *x; /**< nodes (in time/spatial domain) */\
 \
-  double MEASURE_TIME_t[3]; /**< measured time for each step */\
+  nfft_stats stats; /**< statistics of the transforms */\
 \
   /* internal use only */\
   Y(plan)  my_fftw_r2r_plan; /**< fftw_plan forward */\
@@ -341,7 +582,8 @@ typedef struct\
   R *g1; /**< input of fftw */\
   R *g2; /**< output of fftw */\
 \
-  R *spline_coeffs; /**< input for de Boor algorithm, if B_SPLINE or SINC_2m is defined */\
+  R *spline_coeffs; /**< piecewise polynomial coefficients of the window function, used by NFFT_WINDOW_EXP_SEMICIRCLE */\
+  NFFT_INT spline_coeffs_size; /**< Length of the coefficients of one dimension in spline_coeffs */\
 \
   R X(full_psi_eps);\
 } X(plan);\
@@ -352,6 +594,10 @@ NFFT_EXTERN void X(init_3d)(X(plan) *ths_plan, int N0, int N1, int N2, int M_tot
 NFFT_EXTERN void X(init)(X(plan) *ths_plan, int d, int *N, int M_total); \
 NFFT_EXTERN void X(init_guru)(X(plan) *ths_plan, int d, int *N, int M_total, int *n, \
   int m, unsigned flags, unsigned fftw_flags); \
+NFFT_EXTERN void X(init_guru_window)(X(plan) *ths_plan, int d, int *N, int M_total, \
+  int *n, int m, unsigned flags, unsigned fftw_flags, unsigned window); \
+NFFT_EXTERN size_t X(estimate_memory)(int d, int *N, int M_total, int *n, \
+  int m, unsigned flags); \
 NFFT_EXTERN void X(precompute_one_psi)(X(plan) *ths);\
 NFFT_EXTERN void X(precompute_psi)(X(plan) *ths);\
 NFFT_EXTERN void X(precompute_full_psi)(X(plan) *ths);\
@@ -399,6 +645,7 @@ typedef struct\
   int *aN1; /**< sigma*a*N */\
   int m; /**< cut-off parameter in time-domain*/\
   R *b; /**< shape parameters */\
+  unsigned window; /**< window function, one of the NFFT_WINDOW_* constants */\
   int K; /**< number of precomp. uniform psi */\
   int aN1_total; /**< aN1_total=aN1[0]* ... *aN1[d-1] */\
   Z(plan) *direct_plan; /**< plan for the nfft */\
@@ -407,18 +654,24 @@ typedef struct\
   R *x; /**< nodes (in time/spatial domain) */\
   R *v; /**< nodes (in fourier domain) */\
   R *c_phi_inv; /**< precomputed data, matrix D */\
+  nfft_stats stats; /**< statistics of the transforms */\
   R *psi; /**< precomputed data, matrix B */\
   int size_psi; /**< only for thin B */\
   int *psi_index_g; /**< only for thin B */\
   int *psi_index_f; /**< only for thin B */\
   C *F;\
-  R *spline_coeffs; /**< input for de Boor algorithm, if B_SPLINE or SINC_2m is defined */\
+  R *spline_coeffs; /**< piecewise polynomial coefficients of the window function, used by NFFT_WINDOW_EXP_SEMICIRCLE */\
+  NFFT_INT spline_coeffs_size; /**< Length of the coefficients of one dimension in spline_coeffs */\
 } X(plan);\
 \
 NFFT_EXTERN void X(init)(X(plan) *ths_plan, int d, int N_total, int M_total, int *N); \
 NFFT_EXTERN void X(init_1d)(X(plan) *ths_plan, int N, int M_total); \
 NFFT_EXTERN void X(init_guru)(X(plan) *ths_plan, int d, int N_total, int M_total, \
   int *N, int *N1, int m, unsigned nnfft_flags); \
+NFFT_EXTERN void X(init_guru_window)(X(plan) *ths_plan, int d, int N_total, \
+  int M_total, int *N, int *N1, int m, unsigned nnfft_flags, unsigned window); \
+NFFT_EXTERN size_t X(estimate_memory)(int d, int N_total, int M_total, int *N, \
+  int *N1, int m, unsigned nnfft_flags); \
 NFFT_EXTERN void X(trafo_direct)(X(plan) *ths_plan); \
 NFFT_EXTERN void X(adjoint_direct)(X(plan) *ths_plan); \
 NFFT_EXTERN void X(trafo)(X(plan) *ths_plan); \
@@ -474,6 +727,7 @@ typedef struct\
   Z(plan) *set_nfft_plan_2d; /**< nfft plans for short nffts */\
   R *x_transposed; /**< coordinate exchanged nodes, d = 2 */\
   R *x_102,*x_201,*x_120,*x_021; /**< coordinate exchanged nodes, d=3 */\
+  nfft_stats stats; /**< statistics of the transforms */\
 } X(plan);\
 \
 NFFT_EXTERN void X(trafo_direct)(X(plan) *ths); \
@@ -573,8 +827,7 @@ typedef struct\
   Z(plan) plan_nfft; /**< the internal NFFT plan */\
   C *f_hat_intern; /**< Internally used pointer to spherical Fourier
     coefficients */\
-  double MEASURE_TIME_t[3]; /**< Measured time for each step if MEASURE_TIME is
-    set */\
+  nfft_stats stats; /**< Statistics of the transforms, phases NFSFT_STATS_* */\
 } X(plan);\
 \
 NFFT_EXTERN void X(init)(X(plan) *plan, int N, int M); \
@@ -617,6 +870,11 @@ NFSFT_DEFINE_API(NFSFT_MANGLE_LONG_DOUBLE,NFFT_MANGLE_LONG_DOUBLE,long double,ff
 #define NFSFT_NO_FAST_ALGORITHM   (1U << 14)
 #define NFSFT_ZERO_F_HAT          (1U << 16)
 
+/* phases of the statistics */
+#define NFSFT_STATS_FPT  0 /**< fast polynomial transform */
+#define NFSFT_STATS_C2E  1 /**< Chebyshev to Fourier coefficients */
+#define NFSFT_STATS_NFFT 2 /**< nonequispaced FFT */
+
 /* helper macros */
 #define NFSFT_INDEX(k,n,plan) ((2*(plan)->N+2)*((plan)->N-n+1)+(plan)->N+k+1)
 #define NFSFT_F_HAT_SIZE(N) ((2*N+2)*(2*N+2))
@@ -696,6 +954,7 @@ typedef struct X(plan_)\
   Y(plan) p_nfft; /**< the internal NFFT plan */\
   Z(set) *internal_fpt_set; /**< the internal FPT plan */\
   int nthreads; /**< the number of threads */\
+  nfft_stats stats; /**< statistics of the transforms */\
 } X(plan);\
 \
 NFFT_EXTERN void X(precompute)(X(plan) *plan); \
@@ -870,6 +1129,7 @@ R Y(error_l_infty_1_complex)(const C *x, const C *y, const NFFT_INT n, \
 /* int.c: */ \
 NFFT_INT Y(exp2i)(const NFFT_INT a); \
 NFFT_INT Y(next_power_of_2)(const NFFT_INT N); \
+NFFT_INT Y(next_fft_size)(const NFFT_INT N); \
 /* vector1.c */ \
 /** Computes the inner/dot product \f$x^H x\f$. */ \
 R Y(dot_complex)(C *x, NFFT_INT n); \
@@ -884,10 +1144,14 @@ void Y(get_version)(unsigned *major, unsigned *minor, unsigned *patch); \
 /** \
  * Return name of window function. \
  * \
- * The window function to be used is configured at compile time. \
+ * The default window function is configured at compile time. \
  */ \
 const char *Y(get_window_name)(); \
-NFFT_INT Y(get_default_window_cut_off)();
+NFFT_INT Y(get_default_window_cut_off)(); \
+/** Return name of the window function NFFT_WINDOW_*. */ \
+const char *Y(get_window_name_of)(unsigned window); \
+/** Return the default cut-off m for the window function NFFT_WINDOW_*. */ \
+NFFT_INT Y(get_default_window_cut_off_of)(unsigned window);
 
 NFFT_DEFINE_UTIL_API(NFFT_MANGLE_FLOAT,float,fftwf_complex)
 NFFT_DEFINE_UTIL_API(NFFT_MANGLE_DOUBLE,double,fftw_complex)
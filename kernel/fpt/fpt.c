@@ -1332,6 +1332,8 @@ void fpt_trafo_direct(fpt_set set, const int m, const double _Complex *x, double
     return;
   }
 
+  TRACE_BEGIN(NFFT_TRACE_FPT, set, m, k_end)
+
   if (flags & FPT_FUNCTION_VALUES)
   {
     /* Fill array with Chebyshev nodes. */
@@ -1370,6 +1372,7 @@ void fpt_trafo_direct(fpt_set set, const int m, const double _Complex *x, double
 
     memcpy(y,set->result,(k_end+1)*sizeof(double _Complex));
   }
+  TRACE_END(NFFT_TRACE_FPT, set, m, k_end)
 }
 
 void fpt_trafo(fpt_set set, const int m, const double _Complex *x, double _Complex *y,
@@ -1428,6 +1431,8 @@ void fpt_trafo(fpt_set set, const int m, const double _Complex *x, double _Compl
   if (set->flags & FPT_NO_FAST_ALGORITHM)
     return;
 
+  TRACE_BEGIN(NFFT_TRACE_FPT, set, m, k_end)
+
   if (flags & FPT_FUNCTION_VALUES)
   {
 #ifdef _OPENMP
@@ -1678,6 +1683,7 @@ void fpt_trafo(fpt_set set, const int m, const double _Complex *x, double _Compl
       y[k] *= 0.5;
     }
   }
+  TRACE_END(NFFT_TRACE_FPT, set, m, k_end)
 }
 
 void fpt_transposed_direct(fpt_set set, const int m, double _Complex *x,
@@ -1697,6 +1703,8 @@ void fpt_transposed_direct(fpt_set set, const int m, double _Complex *x,
     return;
   }
 
+  TRACE_BEGIN(NFFT_TRACE_FPT, set, m, k_end)
+
   if (flags & FPT_FUNCTION_VALUES)
   {
     for (j = 0; j <= k_end; j++)
@@ -1735,6 +1743,7 @@ void fpt_transposed_direct(fpt_set set, const int m, double _Complex *x,
 
     memcpy(x,&set->temp[data->k_start],(k_end-data->k_start+1)*sizeof(double _Complex));
   }
+  TRACE_END(NFFT_TRACE_FPT, set, m, k_end)
 }
 
 void fpt_transposed(fpt_set set, const int m, double _Complex *x,
@@ -1791,6 +1800,8 @@ void fpt_transposed(fpt_set set, const int m, double _Complex *x,
     return;
   }
 
+  TRACE_BEGIN(NFFT_TRACE_FPT, set, m, k_end)
+
   if (flags & FPT_FUNCTION_VALUES)
   {
 #ifdef _OPENMP
@@ -1974,6 +1985,7 @@ void fpt_transposed(fpt_set set, const int m, double _Complex *x,
       + data->betaN[tk-2] *set->work[2*(Nk-1)]
       + data->alphaN[tk-2]*set->work[2*(Nk-1)+1];
   }
+  TRACE_END(NFFT_TRACE_FPT, set, m, k_end)
 }
 
 void fpt_finalize(fpt_set set)
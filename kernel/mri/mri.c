@@ -34,17 +34,22 @@
 typedef struct window_funct_plan_ {
   int d;
 	int m;
+	unsigned window;
 	int n[1];
 	double sigma[1];
 	double *b;
+	double *spline_coeffs;
+	NFFT_INT spline_coeffs_size;
 } window_funct_plan;
 
 /**
  * init the window_funct_plan
  */
-static void window_funct_init(window_funct_plan* ths, int m, int n, double sigma) {
+static void window_funct_init(window_funct_plan* ths, int m, int n, double sigma,
+  unsigned window) {
 	ths->d=1;
 	ths->m=m;
+	ths->window=window;
 	ths->n[0]=n;
 	ths->sigma[0]=sigma;
   WINDOW_HELP_INIT
@@ -60,7 +65,7 @@ void mri_inh_2d1d_trafo(mri_inh_2d1d_plan *that) {
   double _Complex *f_hat = (double _Complex*) nfft_malloc(that->N_total*sizeof(double _Complex));
 
   window_funct_plan *ths = (window_funct_plan*) nfft_malloc(sizeof(window_funct_plan));
-	window_funct_init(ths,that->plan.m,that->N3,that->sigma3);
+	window_funct_init(ths,that->plan.m,that->N3,that->sigma3,that->plan.window);
 
 	/* the pointers that->f and that->f_hat have been modified by the solver */
 	that->plan.f = that->f;
@@ -107,7 +112,7 @@ void mri_inh_2d1d_adjoint(mri_inh_2d1d_plan *that) {
   double _Complex *f_hat = (double _Complex*) nfft_malloc(that->N_total*sizeof(double _Complex));
 
   window_funct_plan *ths = (window_funct_plan*) nfft_malloc(sizeof(window_funct_plan));
-	window_funct_init(ths,that->plan.m,that->N3,that->sigma3);
+	window_funct_init(ths,that->plan.m,that->N3,that->sigma3,that->plan.window);
 
 	memset(f_hat,0,that->N_total*sizeof(double _Complex));
 
@@ -189,7 +194,7 @@ void mri_inh_2d1d_finalize(mri_inh_2d1d_plan *ths) {
 void mri_inh_3d_trafo(mri_inh_3d_plan *that) {
   int l,j;
   window_funct_plan *ths = (window_funct_plan*) nfft_malloc(sizeof(window_funct_plan));
-	window_funct_init(ths,that->plan.m,that->N3,that->sigma3);
+	window_funct_init(ths,that->plan.m,that->N3,that->sigma3,that->plan.window);
 
 	/* the pointers that->f has been modified by the solver */
   that->plan.f =that->f ;
@@ -221,7 +226,7 @@ void mri_inh_3d_trafo(mri_inh_3d_plan *that) {
 void mri_inh_3d_adjoint(mri_inh_3d_plan *that) {
   int l,j;
   window_funct_plan *ths = (window_funct_plan*) nfft_malloc(sizeof(window_funct_plan));
-	window_funct_init(ths,that->plan.m,that->N3,that->sigma3);
+	window_funct_init(ths,that->plan.m,that->N3,that->sigma3,that->plan.window);
 
 	/* the pointers that->f has been modified by the solver */
   that->plan.f =that->f ;
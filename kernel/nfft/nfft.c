@@ -32,10 +32,23 @@
 #include "nfft3.h"
 #include "infft.h"
 
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_FCNTL_H) && defined(HAVE_UNISTD_H) \
+  && defined(HAVE_SYS_STAT_H) && defined(HAVE_MMAP) && defined(HAVE_MUNMAP)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NFFT_PLAN_MMAP
+#endif
+
 #ifdef OMP_ASSERT
 #include <assert.h>
 #endif
@@ -69,29 +82,29 @@ static inline INT intprod(const INT *vec, const INT a, const INT d)
  * \arg local_x_num number of nodes
  * \arg local_x nodes array
  * \arg ar_x resulting index array
+ * \arg ar_x_temp workspace of size 2*local_x_num
  *
  * \author Toni Volkmer
  */
 static inline void sort0(const INT d, const INT *n, const INT m,
-    const INT local_x_num, const R *local_x, INT *ar_x)
+    const INT local_x_num, const R *local_x, INT *ar_x, INT *ar_x_temp)
 {
-  INT u_j[d], i, j, help, rhigh;
-  INT *ar_x_temp;
+  INT i, j, rhigh;
   INT nprod;
 
+#ifdef _OPENMP
+  #pragma omp parallel for default(shared) private(i, j)
+#endif
   for (i = 0; i < local_x_num; i++)
   {
-    ar_x[2 * i] = 0;
-    ar_x[2 *i + 1] = i;
+    INT key = 0;
     for (j = 0; j < d; j++)
     {
-      help = (INT) LRINT(FLOOR((R)(n[j]) * local_x[d * i + j] - (R)(m)));
-      u_j[j] = (help % n[j] + n[j]) % n[j];
-
-      ar_x[2 * i] += u_j[j];
-      if (j + 1 < d)
-        ar_x[2 * i] *= n[j + 1];
+      INT help = (INT) LRINT(FLOOR((R)(n[j]) * local_x[d * i + j] - (R)(m)));
+      key = key * n[j] + (help % n[j] + n[j]) % n[j];
     }
+    ar_x[2 * i] = key;
+    ar_x[2 * i + 1] = i;
   }
 
   for (j = 0, nprod = 1; j < d; j++)
@@ -99,13 +112,11 @@ static inline void sort0(const INT d, const INT *n, const INT m,
 
   rhigh = (INT) LRINT(CEIL(LOG2((R)nprod))) - 1;
 
-  ar_x_temp = (INT*) Y(malloc)(2 * (size_t)(local_x_num) * sizeof(INT));
   Y(sort_node_indices_radix_lsdf)(local_x_num, ar_x, ar_x_temp, rhigh);
 #ifdef OMP_ASSERT
   for (i = 1; i < local_x_num; i++)
     assert(ar_x[2 * (i - 1)] <= ar_x[2 * i]);
 #endif
-  Y(free)(ar_x_temp);
 }
 
 /**
@@ -116,10 +127,120 @@ static inline void sort0(const INT d, const INT *n, const INT m,
  *
  * \arg ths nfft_plan
  */
-static inline void sort(const X(plan) *ths)
+static inline void sort(X(plan) *ths)
 {
-  if (ths->flags & NFFT_SORT_NODES)
-    sort0(ths->d, ths->n, ths->m, ths->M_total, ths->x, ths->index_x);
+  /* index_x of a plan restored by X(load_plan) is read from the file */
+  if ((ths->flags & NFFT_SORT_NODES) && ths->map == NULL)
+  {
+    TIC(NFFT_STATS_SORT)
+    sort0(ths->d, ths->n, ths->m, ths->M_total, ths->x, ths->index_x,
+      ths->index_x_tmp);
+    TOC(NFFT_STATS_SORT)
+  }
+}
+
+/** Redoes the node-dependent precomputation if the nodes were changed by
+ *  X(set_nodes) since. FFTW plans, c_phi_inv and PRE_LIN_PSI tables do not
+ *  depend on the nodes and are kept. */
+static inline void update_nodes(X(plan) *ths)
+{
+  if (!ths->nodes_changed)
+    return;
+
+  if (ths->flags & PRE_FG_PSI)
+    X(precompute_fg_psi)(ths);
+  if (ths->flags & PRE_PSI)
+    X(precompute_psi)(ths);
+  if (ths->flags & PRE_FULL_PSI)
+    X(precompute_full_psi)(ths);
+
+  ths->nodes_changed = 0;
+}
+
+/** Number of window values per node, \f$(2m+2)^d\f$. */
+static inline size_t plan_lprod(const X(plan) *ths)
+{
+  size_t lprod = 1;
+  INT t;
+
+  for (t = 0; t < ths->d; t++)
+    lprod *= (size_t)(2 * ths->m + 2);
+
+  return lprod;
+}
+
+/** Allocates a plan buffer from the arena of the plan, if any. */
+static void *plan_malloc(const X(plan) *ths, const size_t n)
+{
+  return ths->arena != NULL ? Y(arena_malloc)(ths->arena, n) : Y(malloc)(n);
+}
+
+static void plan_free(const X(plan) *ths, void *p)
+{
+  if (ths->arena != NULL)
+    Y(arena_free)(ths->arena, p);
+  else
+    Y(free)(p);
+}
+
+#undef WINDOW_MALLOC
+#undef WINDOW_FREE
+#define WINDOW_MALLOC(n) plan_malloc(ths, n)
+#define WINDOW_FREE(p) plan_free(ths, p)
+
+/* The precomputed tables written by X(save_plan) and mapped by X(load_plan),
+ * listed as TABLE(field, type, count, condition). */
+#define PLAN_TABLES(TABLE) \
+  TABLE(psi, R, (size_t)((ths->K + 1) * ths->d), ths->flags & PRE_LIN_PSI) \
+  TABLE(psi, R, (size_t)(2 * ths->M_total * ths->d), ths->flags & PRE_FG_PSI) \
+  TABLE(psi, R, (size_t)(ths->M_total * ths->d * (2 * ths->m + 2)), \
+    ths->flags & PRE_PSI) \
+  TABLE(psi, R, (size_t)(ths->M_total) * plan_lprod(ths), \
+    (ths->flags & PRE_FULL_PSI) && !(ths->flags & NFFT_FULL_PSI_FLOAT)) \
+  TABLE(psi_index_g, INT, (size_t)(ths->M_total) * plan_lprod(ths), \
+    (ths->flags & PRE_FULL_PSI) && !(ths->flags & NFFT_FULL_PSI_FLOAT)) \
+  TABLE(psi_float, float, (size_t)(ths->M_total) * plan_lprod(ths), \
+    (ths->flags & PRE_FULL_PSI) && (ths->flags & NFFT_FULL_PSI_FLOAT)) \
+  TABLE(psi_index_g32, int, (size_t)(ths->M_total) * plan_lprod(ths), \
+    (ths->flags & PRE_FULL_PSI) && (ths->flags & NFFT_FULL_PSI_FLOAT)) \
+  TABLE(psi_index_f, INT, (size_t)(ths->M_total), ths->flags & PRE_FULL_PSI) \
+  TABLE(index_x, INT, 2 * (size_t)(ths->M_total), \
+    ths->flags & NFFT_SORT_NODES)
+
+/** Releases the file mapping of a plan restored by X(load_plan). */
+static void plan_unmap(X(plan) *ths)
+{
+  if (ths->map == NULL)
+    return;
+
+#ifdef NFFT_PLAN_MMAP
+  munmap(ths->map, ths->map_size);
+#else
+  Y(free)(ths->map);
+#endif
+
+  ths->map = NULL;
+  ths->map_size = 0;
+}
+
+/** Copies the tables of a plan restored by X(load_plan) from the read-only
+ *  mapping to own memory before they are recomputed. */
+static void plan_own_tables(X(plan) *ths)
+{
+  if (ths->map == NULL)
+    return;
+
+#define PLAN_OWN(field, type, count, cond) \
+  if (cond) \
+  { \
+    type *table = (type*) plan_malloc(ths, (count) * sizeof(type)); \
+    memcpy(table, ths->field, (count) * sizeof(type)); \
+    ths->field = table; \
+  }
+  PLAN_TABLES(PLAN_OWN)
+#undef PLAN_OWN
+
+  plan_unmap(ths);
 }
 
 /** direct computation of non equispaced fourier transforms
@@ -141,159 +262,30 @@ static inline void sort(const X(plan) *ths)
  * ndft_transposed:
  * for k in I_N^d
  *  f_hat[k] = sum_{j=0}^{M_total-1} f[j] * exp(-2(pi) k x[j])
+ *
+ * The sums are evaluated by Y(ndft_trafo) and Y(ndft_adjoint), which
+ * replace the exponentials by recurrences along each dimension.
  */
 void X(trafo_direct)(const X(plan) *ths)
 {
-  C *f_hat = (C*)ths->f_hat, *f = (C*)ths->f;
-
-  memset(f, 0, (size_t)(ths->M_total) * sizeof(C));
-
-  if (ths->d == 1)
-  {
-    /* specialize for univariate case, rationale: faster */
-    INT j;
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(j)
-#endif
-    for (j = 0; j < ths->M_total; j++)
-    {
-      INT k_L;
-      for (k_L = 0; k_L < ths->N_total; k_L++)
-      {
-        R omega = K2PI * ((R)(k_L - ths->N_total/2)) * ths->x[j];
-        f[j] += f_hat[k_L] * BASE(-II * omega);
-      }
-    }
-  }
-  else
-  {
-    /* multivariate case */
-    INT j;
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(j)
-#endif
-    for (j = 0; j < ths->M_total; j++)
-    {
-      R x[ths->d], omega, Omega[ths->d + 1];
-      INT t, t2, k_L, k[ths->d];
-      Omega[0] = K(0.0);
-      for (t = 0; t < ths->d; t++)
-      {
-        k[t] = -ths->N[t]/2;
-        x[t] = K2PI * ths->x[j * ths->d + t];
-        Omega[t+1] = ((R)k[t]) * x[t] + Omega[t];
-      }
-      omega = Omega[ths->d];
-
-      for (k_L = 0; k_L < ths->N_total; k_L++)
-      {
-        f[j] += f_hat[k_L] * BASE(-II * omega);
-        {
-          for (t = ths->d - 1; (t >= 1) && (k[t] == ths->N[t]/2 - 1); t--)
-            k[t]-= ths->N[t]-1;
+  INT k0[ths->d], t;
 
-          k[t]++;
-
-          for (t2 = t; t2 < ths->d; t2++)
-            Omega[t2+1] = ((R)k[t2]) * x[t2] + Omega[t2];
+  for (t = 0; t < ths->d; t++)
+    k0[t] = -ths->N[t] / 2;
 
-          omega = Omega[ths->d];
-        }
-      }
-    }
-  }
+  Y(ndft_trafo)(ths->d, ths->N, k0, ths->M_total, ths->x, ths->f_hat, ths->f,
+    K(-1.0));
 }
 
 void X(adjoint_direct)(const X(plan) *ths)
 {
-  C *f_hat = (C*)ths->f_hat, *f = (C*)ths->f;
-
-  memset(f_hat, 0, (size_t)(ths->N_total) * sizeof(C));
-
-  if (ths->d == 1)
-  {
-    /* specialize for univariate case, rationale: faster */
-#ifdef _OPENMP
-      INT k_L;
-      #pragma omp parallel for default(shared) private(k_L)
-      for (k_L = 0; k_L < ths->N_total; k_L++)
-      {
-        INT j;
-        for (j = 0; j < ths->M_total; j++)
-        {
-          R omega = K2PI * ((R)(k_L - (ths->N_total/2))) * ths->x[j];
-          f_hat[k_L] += f[j] * BASE(II * omega);
-        }
-      }
-#else
-      INT j;
-      for (j = 0; j < ths->M_total; j++)
-      {
-        INT k_L;
-        for (k_L = 0; k_L < ths->N_total; k_L++)
-        {
-          R omega = K2PI * ((R)(k_L - ths->N_total / 2)) * ths->x[j];
-          f_hat[k_L] += f[j] * BASE(II * omega);
-        }
-      }
-#endif
-  }
-  else
-  {
-    /* multivariate case */
-    INT j, k_L;
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(j, k_L)
-    for (k_L = 0; k_L < ths->N_total; k_L++)
-    {
-      INT k[ths->d], k_temp, t;
-
-      k_temp = k_L;
-
-      for (t = ths->d - 1; t >= 0; t--)
-      {
-        k[t] = k_temp % ths->N[t] - ths->N[t]/2;
-        k_temp /= ths->N[t];
-      }
-
-      for (j = 0; j < ths->M_total; j++)
-      {
-        R omega = K(0.0);
-        for (t = 0; t < ths->d; t++)
-          omega += k[t] * K2PI * ths->x[j * ths->d + t];
-        f_hat[k_L] += f[j] * BASE(II * omega);
-      }
-    }
-#else
-    for (j = 0; j < ths->M_total; j++)
-    {
-      R x[ths->d], omega, Omega[ths->d+1];
-      INT t, t2, k[ths->d];
-      Omega[0] = K(0.0);
-      for (t = 0; t < ths->d; t++)
-      {
-        k[t] = -ths->N[t]/2;
-        x[t] = K2PI * ths->x[j * ths->d + t];
-        Omega[t+1] = ((R)k[t]) * x[t] + Omega[t];
-      }
-      omega = Omega[ths->d];
-      for (k_L = 0; k_L < ths->N_total; k_L++)
-      {
-        f_hat[k_L] += f[j] * BASE(II * omega);
+  INT k0[ths->d], t;
 
-        for (t = ths->d-1; (t >= 1) && (k[t] == ths->N[t]/2-1); t--)
-          k[t]-= ths->N[t]-1;
-
-        k[t]++;
-
-        for (t2 = t; t2 < ths->d; t2++)
-          Omega[t2+1] = ((R)k[t2]) * x[t2] + Omega[t2];
+  for (t = 0; t < ths->d; t++)
+    k0[t] = -ths->N[t] / 2;
 
-        omega = Omega[ths->d];
-      }
-    }
-#endif
-  }
+  Y(ndft_adjoint)(ths->d, ths->N, k0, ths->M_total, ths->x, ths->f,
+    ths->f_hat, K(1.0));
 }
 
 /** fast computation of non-equispaced fourier transforms
@@ -339,6 +331,242 @@ static inline void uo2(INT *u, INT *o, const R x, const INT n, const INT m)
   *o = (c + 1 + m + n) % n;
 }
 
+/**
+ * Fixed cut-off B-step kernels.
+ *
+ * For the common values NFFT_B_M_MIN <= m <= NFFT_B_M_MAX the window of one
+ * node covers the compile-time constant number 2m+2 of grid points per
+ * dimension. The kernels below are instantiated once per such m, so that the
+ * compiler unrolls and vectorises the tap loops completely. They only handle
+ * nodes whose window does not wrap around in any dimension; all other nodes
+ * and cut-off parameters take the generic path.
+ *
+ * The rows are too short for a call of the dispatched kernels of simd.c to
+ * pay off, neither here nor on the generic path, which inlines its tap loops
+ * as well. The per node kernels of two and three dimensions are cloned for
+ * AVX2 and AVX-512 instead and the loader picks the clone for the running
+ * CPU once.
+ */
+#define NFFT_B_M_MIN 2
+#define NFFT_B_M_MAX 12
+
+#define NFFT_B_FIXED(m) ((m) >= NFFT_B_M_MIN && (m) <= NFFT_B_M_MAX)
+
+#if defined(HAVE_SIMD_DISPATCH)
+#define NFFT_B_SIMD_CLONES \
+  __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define NFFT_B_SIMD_CLONES
+#endif
+
+/**
+ * Sum of w[l] x[l], l=0,...,n-1, over a window row of any length. Inlined, so
+ * the compiler vectorises it for the kernel it ends up in, like the loops of
+ * the fixed cut-off kernels below.
+ */
+static inline C nfft_sum_wx(const R *w, const C *x, const INT n)
+{
+  C s = K(0.0);
+  INT l;
+  for (l = 0; l < n; l++)
+    s += w[l] * x[l];
+  return s;
+}
+
+/** Adds a w[l] to x[l], l=0,...,n-1, see nfft_sum_wx. */
+static inline void nfft_upd_xpaw(C *x, const C a, const R *w, const INT n)
+{
+  INT l;
+  for (l = 0; l < n; l++)
+    x[l] += w[l] * a;
+}
+
+#define NFFT_B_FOR_EACH_M(MACRO) \
+  MACRO(2) MACRO(3) MACRO(4) MACRO(5) MACRO(6) MACRO(7) MACRO(8) MACRO(9) \
+  MACRO(10) MACRO(11) MACRO(12)
+
+#define MACRO_B_FIXED_KERNELS(MM) \
+static inline C nfft_sum_row_##MM(const R *psij, const C *gj) \
+{ \
+  C s = K(0.0); \
+  INT l; \
+  for (l = 0; l < 2*MM+2; l++) \
+    s += psij[l] * gj[l]; \
+  return s; \
+} \
+\
+static inline void nfft_upd_row_##MM(C *gj, const C a, const R *psij) \
+{ \
+  INT l; \
+  for (l = 0; l < 2*MM+2; l++) \
+    gj[l] += psij[l] * a; \
+} \
+\
+NFFT_B_SIMD_CLONES \
+static void nfft_trafo_2d_compute_##MM(C *fj, const C *g, const R *psij0, \
+  const R *psij1, const INT u0, const INT u1, const INT n1) \
+{ \
+  C s = K(0.0); \
+  INT l0; \
+  for (l0 = 0; l0 < 2*MM+2; l0++) \
+    s += psij0[l0] * nfft_sum_row_##MM(psij1, g + (u0+l0)*n1 + u1); \
+  *fj = s; \
+} \
+\
+NFFT_B_SIMD_CLONES \
+static void nfft_trafo_3d_compute_##MM(C *fj, const C *g, const R *psij0, \
+  const R *psij1, const R *psij2, const INT u0, const INT u1, const INT u2, \
+  const INT n1, const INT n2) \
+{ \
+  C s = K(0.0); \
+  INT l0, l1; \
+  for (l0 = 0; l0 < 2*MM+2; l0++) \
+  { \
+    C t = K(0.0); \
+    for (l1 = 0; l1 < 2*MM+2; l1++) \
+      t += psij1[l1] * nfft_sum_row_##MM(psij2, \
+        g + ((u0+l0)*n1 + u1+l1)*n2 + u2); \
+    s += psij0[l0] * t; \
+  } \
+  *fj = s; \
+}
+
+#define MACRO_B_FIXED_KERNELS_ADJOINT(MM) \
+NFFT_B_SIMD_CLONES \
+static void nfft_adjoint_2d_compute_##MM(const C f, C *g, const R *psij0, \
+  const R *psij1, const INT u0, const INT u1, const INT n1) \
+{ \
+  INT l0; \
+  for (l0 = 0; l0 < 2*MM+2; l0++) \
+    nfft_upd_row_##MM(g + (u0+l0)*n1 + u1, psij0[l0] * f, psij1); \
+} \
+\
+NFFT_B_SIMD_CLONES \
+static void nfft_adjoint_3d_compute_##MM(const C f, C *g, const R *psij0, \
+  const R *psij1, const R *psij2, const INT u0, const INT u1, const INT u2, \
+  const INT n1, const INT n2) \
+{ \
+  INT l0, l1; \
+  for (l0 = 0; l0 < 2*MM+2; l0++) \
+  { \
+    const C a = psij0[l0] * f; \
+    for (l1 = 0; l1 < 2*MM+2; l1++) \
+      nfft_upd_row_##MM(g + ((u0+l0)*n1 + u1+l1)*n2 + u2, psij1[l1] * a, \
+        psij2); \
+  } \
+}
+
+NFFT_B_FOR_EACH_M(MACRO_B_FIXED_KERNELS)
+NFFT_B_FOR_EACH_M(MACRO_B_FIXED_KERNELS_ADJOINT)
+
+#define MACRO_B_FIXED_CASE_SUM_ROW(MM) \
+  case MM: return nfft_sum_row_##MM(psij, gj);
+#define MACRO_B_FIXED_CASE_UPD_ROW(MM) \
+  case MM: nfft_upd_row_##MM(gj, a, psij); return;
+#define MACRO_B_FIXED_CASE_TRAFO_2D(MM) \
+  case MM: nfft_trafo_2d_compute_##MM(fj, g, psij0, psij1, u0, u1, n1); return;
+#define MACRO_B_FIXED_CASE_TRAFO_3D(MM) \
+  case MM: nfft_trafo_3d_compute_##MM(fj, g, psij0, psij1, psij2, u0, u1, u2, \
+    n1, n2); return;
+#define MACRO_B_FIXED_CASE_ADJOINT_2D(MM) \
+  case MM: nfft_adjoint_2d_compute_##MM(f, g, psij0, psij1, u0, u1, n1); \
+    return;
+#define MACRO_B_FIXED_CASE_ADJOINT_3D(MM) \
+  case MM: nfft_adjoint_3d_compute_##MM(f, g, psij0, psij1, psij2, u0, u1, \
+    u2, n1, n2); return;
+
+/** Sum of psij[l]*gj[l] over one unwrapped window row, fixed cut-off m. */
+static inline C nfft_sum_row_fixed(const R *psij, const C *gj, const INT m)
+{
+  switch (m)
+  {
+    NFFT_B_FOR_EACH_M(MACRO_B_FIXED_CASE_SUM_ROW)
+    default: return nfft_sum_wx(psij, gj, 2*m+2);
+  }
+}
+
+/** Adds a*psij[l] to gj[l] over one unwrapped window row, fixed cut-off m. */
+static inline void nfft_upd_row_fixed(C *gj, const C a, const R *psij,
+  const INT m)
+{
+  switch (m)
+  {
+    NFFT_B_FOR_EACH_M(MACRO_B_FIXED_CASE_UPD_ROW)
+    default: nfft_upd_xpaw(gj, a, psij, 2*m+2);
+  }
+}
+
+static inline void nfft_trafo_2d_compute_fixed(C *fj, const C *g,
+  const R *psij0, const R *psij1, const INT u0, const INT u1, const INT n1,
+  const INT m)
+{
+  switch (m)
+  {
+    NFFT_B_FOR_EACH_M(MACRO_B_FIXED_CASE_TRAFO_2D)
+    default: break;
+  }
+}
+
+static inline void nfft_trafo_3d_compute_fixed(C *fj, const C *g,
+  const R *psij0, const R *psij1, const R *psij2, const INT u0, const INT u1,
+  const INT u2, const INT n1, const INT n2, const INT m)
+{
+  switch (m)
+  {
+    NFFT_B_FOR_EACH_M(MACRO_B_FIXED_CASE_TRAFO_3D)
+    default: break;
+  }
+}
+
+static inline void nfft_adjoint_2d_compute_fixed(const C f, C *g,
+  const R *psij0, const R *psij1, const INT u0, const INT u1, const INT n1,
+  const INT m)
+{
+  switch (m)
+  {
+    NFFT_B_FOR_EACH_M(MACRO_B_FIXED_CASE_ADJOINT_2D)
+    default: break;
+  }
+}
+
+static inline void nfft_adjoint_3d_compute_fixed(const C f, C *g,
+  const R *psij0, const R *psij1, const R *psij2, const INT u0, const INT u1,
+  const INT u2, const INT n1, const INT n2, const INT m)
+{
+  switch (m)
+  {
+    NFFT_B_FOR_EACH_M(MACRO_B_FIXED_CASE_ADJOINT_3D)
+    default: break;
+  }
+}
+
+/**
+ * Adds a psij[l] to the 2m+2 entries row[(u+l)%n] that the window of one node
+ * covers in the last dimension, wrapping around at o < u.
+ */
+static inline void nfft_upd_row(C *row, const C a, const R *psij, const INT u,
+  const INT o, const INT m)
+{
+  if (u < o)
+    nfft_upd_row_fixed(row + u, a, psij, m);
+  else
+  {
+    nfft_upd_xpaw(row + u, a, psij, 2*m+1-o);
+    nfft_upd_xpaw(row, a, psij + 2*m+1-o, o+1);
+  }
+}
+
+/** Sum of psij[l] row[(u+l)%n] over the window of one node, see nfft_upd_row. */
+static inline C nfft_sum_row(const C *row, const R *psij, const INT u,
+  const INT o, const INT m)
+{
+  if (u < o)
+    return nfft_sum_row_fixed(psij, row + u, m);
+
+  return nfft_sum_wx(psij, row + u, 2*m+1-o)
+    + nfft_sum_wx(psij + 2*m+1-o, row, o+1);
+}
+
 #define MACRO_D_compute_A \
 { \
   g_hat[k_plain[ths->d]] = f_hat[ks_plain[ths->d]] * c_phi_inv_k[ths->d]; \
@@ -447,73 +675,83 @@ static inline void D_openmp_A(X(plan) *ths)
 
   if (ths->flags & PRE_PHI_HUT)
   {
-    #pragma omp parallel for default(shared) private(k_L)
-    for (k_L = 0; k_L < ths->N_total; k_L++)
+    #pragma omp parallel default(shared) private(k_L)
     {
-      INT kp[ths->d];                       /**< multi index (simple)           */ //0..N-1
-      INT k[ths->d];                        /**< multi index in g_hat           */
-      INT ks[ths->d];                       /**< multi index in f_hat, c_phi_inv*/
-      R c_phi_inv_k_val = K(1.0);
-      INT k_plain_val = 0;
-      INT ks_plain_val = 0;
-      INT t;
-      INT k_temp = k_L;
-
-      for (t = ths->d-1; t >= 0; t--)
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k_L = 0; k_L < ths->N_total; k_L++)
       {
-        kp[t] = k_temp % ths->N[t];
-        if (kp[t] >= ths->N[t]/2)
-          k[t] = ths->n[t] - ths->N[t] + kp[t];
-        else
-          k[t] = kp[t];
-        ks[t] = (kp[t] + ths->N[t]/2) % ths->N[t];
-        k_temp /= ths->N[t];
-      }
+        INT kp[ths->d];                       /**< multi index (simple)           */ //0..N-1
+        INT k[ths->d];                        /**< multi index in g_hat           */
+        INT ks[ths->d];                       /**< multi index in f_hat, c_phi_inv*/
+        R c_phi_inv_k_val = K(1.0);
+        INT k_plain_val = 0;
+        INT ks_plain_val = 0;
+        INT t;
+        INT k_temp = k_L;
+
+        for (t = ths->d-1; t >= 0; t--)
+        {
+          kp[t] = k_temp % ths->N[t];
+          if (kp[t] >= ths->N[t]/2)
+            k[t] = ths->n[t] - ths->N[t] + kp[t];
+          else
+            k[t] = kp[t];
+          ks[t] = (kp[t] + ths->N[t]/2) % ths->N[t];
+          k_temp /= ths->N[t];
+        }
 
-      for (t = 0; t < ths->d; t++)
-      {
-        c_phi_inv_k_val *= ths->c_phi_inv[t][ks[t]];
-        ks_plain_val = ks_plain_val*ths->N[t] + ks[t];
-        k_plain_val = k_plain_val*ths->n[t] + k[t];
-      }
+        for (t = 0; t < ths->d; t++)
+        {
+          c_phi_inv_k_val *= ths->c_phi_inv[t][ks[t]];
+          ks_plain_val = ks_plain_val*ths->N[t] + ks[t];
+          k_plain_val = k_plain_val*ths->n[t] + k[t];
+        }
 
-      g_hat[k_plain_val] = f_hat[ks_plain_val] * c_phi_inv_k_val;
-    } /* for(k_L) */
+        g_hat[k_plain_val] = f_hat[ks_plain_val] * c_phi_inv_k_val;
+      } /* for(k_L) */
+      STATS_THREAD_END(NFFT_STATS_D)
+    }
   } /* if(PRE_PHI_HUT) */
   else
   {
-    #pragma omp parallel for default(shared) private(k_L)
-    for (k_L = 0; k_L < ths->N_total; k_L++)
+    #pragma omp parallel default(shared) private(k_L)
     {
-      INT kp[ths->d];                       /**< multi index (simple)           */ //0..N-1
-      INT k[ths->d];                        /**< multi index in g_hat           */
-      INT ks[ths->d];                       /**< multi index in f_hat, c_phi_inv*/
-      R c_phi_inv_k_val = K(1.0);
-      INT k_plain_val = 0;
-      INT ks_plain_val = 0;
-      INT t;
-      INT k_temp = k_L;
-
-      for (t = ths->d-1; t >= 0; t--)
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k_L = 0; k_L < ths->N_total; k_L++)
       {
-        kp[t] = k_temp % ths->N[t];
-        if (kp[t] >= ths->N[t]/2)
-          k[t] = ths->n[t] - ths->N[t] + kp[t];
-        else
-          k[t] = kp[t];
-        ks[t] = (kp[t] + ths->N[t]/2) % ths->N[t];
-        k_temp /= ths->N[t];
-      }
+        INT kp[ths->d];                       /**< multi index (simple)           */ //0..N-1
+        INT k[ths->d];                        /**< multi index in g_hat           */
+        INT ks[ths->d];                       /**< multi index in f_hat, c_phi_inv*/
+        R c_phi_inv_k_val = K(1.0);
+        INT k_plain_val = 0;
+        INT ks_plain_val = 0;
+        INT t;
+        INT k_temp = k_L;
+
+        for (t = ths->d-1; t >= 0; t--)
+        {
+          kp[t] = k_temp % ths->N[t];
+          if (kp[t] >= ths->N[t]/2)
+            k[t] = ths->n[t] - ths->N[t] + kp[t];
+          else
+            k[t] = kp[t];
+          ks[t] = (kp[t] + ths->N[t]/2) % ths->N[t];
+          k_temp /= ths->N[t];
+        }
 
-      for (t = 0; t < ths->d; t++)
-      {
-        c_phi_inv_k_val /= (PHI_HUT(ths->n[t],ks[t]-(ths->N[t]/2),t));
-        ks_plain_val = ks_plain_val*ths->N[t] + ks[t];
-        k_plain_val = k_plain_val*ths->n[t] + k[t];
-      }
+        for (t = 0; t < ths->d; t++)
+        {
+          c_phi_inv_k_val /= (PHI_HUT(ths->n[t],ks[t]-(ths->N[t]/2),t));
+          ks_plain_val = ks_plain_val*ths->N[t] + ks[t];
+          k_plain_val = k_plain_val*ths->n[t] + k[t];
+        }
 
-      g_hat[k_plain_val] = f_hat[ks_plain_val] * c_phi_inv_k_val;
-    } /* for(k_L) */
+        g_hat[k_plain_val] = f_hat[ks_plain_val] * c_phi_inv_k_val;
+      } /* for(k_L) */
+      STATS_THREAD_END(NFFT_STATS_D)
+    }
   } /* else(PRE_PHI_HUT) */
 }
 #endif
@@ -542,73 +780,83 @@ static void D_openmp_T(X(plan) *ths)
 
   if (ths->flags & PRE_PHI_HUT)
   {
-    #pragma omp parallel for default(shared) private(k_L)
-    for (k_L = 0; k_L < ths->N_total; k_L++)
+    #pragma omp parallel default(shared) private(k_L)
     {
-      INT kp[ths->d];                       /**< multi index (simple)           */ //0..N-1
-      INT k[ths->d];                        /**< multi index in g_hat           */
-      INT ks[ths->d];                       /**< multi index in f_hat, c_phi_inv*/
-      R c_phi_inv_k_val = K(1.0);
-      INT k_plain_val = 0;
-      INT ks_plain_val = 0;
-      INT t;
-      INT k_temp = k_L;
-
-      for (t = ths->d - 1; t >= 0; t--)
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k_L = 0; k_L < ths->N_total; k_L++)
       {
-        kp[t] = k_temp % ths->N[t];
-        if (kp[t] >= ths->N[t]/2)
-          k[t] = ths->n[t] - ths->N[t] + kp[t];
-        else
-          k[t] = kp[t];
-        ks[t] = (kp[t] + ths->N[t]/2) % ths->N[t];
-        k_temp /= ths->N[t];
-      }
+        INT kp[ths->d];                       /**< multi index (simple)           */ //0..N-1
+        INT k[ths->d];                        /**< multi index in g_hat           */
+        INT ks[ths->d];                       /**< multi index in f_hat, c_phi_inv*/
+        R c_phi_inv_k_val = K(1.0);
+        INT k_plain_val = 0;
+        INT ks_plain_val = 0;
+        INT t;
+        INT k_temp = k_L;
+
+        for (t = ths->d - 1; t >= 0; t--)
+        {
+          kp[t] = k_temp % ths->N[t];
+          if (kp[t] >= ths->N[t]/2)
+            k[t] = ths->n[t] - ths->N[t] + kp[t];
+          else
+            k[t] = kp[t];
+          ks[t] = (kp[t] + ths->N[t]/2) % ths->N[t];
+          k_temp /= ths->N[t];
+        }
 
-      for (t = 0; t < ths->d; t++)
-      {
-        c_phi_inv_k_val *= ths->c_phi_inv[t][ks[t]];
-        ks_plain_val = ks_plain_val*ths->N[t] + ks[t];
-        k_plain_val = k_plain_val*ths->n[t] + k[t];
-      }
+        for (t = 0; t < ths->d; t++)
+        {
+          c_phi_inv_k_val *= ths->c_phi_inv[t][ks[t]];
+          ks_plain_val = ks_plain_val*ths->N[t] + ks[t];
+          k_plain_val = k_plain_val*ths->n[t] + k[t];
+        }
 
-      f_hat[ks_plain_val] = g_hat[k_plain_val] * c_phi_inv_k_val;
-    } /* for(k_L) */
+        f_hat[ks_plain_val] = g_hat[k_plain_val] * c_phi_inv_k_val;
+      } /* for(k_L) */
+      STATS_THREAD_END(NFFT_STATS_D)
+    }
   } /* if(PRE_PHI_HUT) */
   else
   {
-    #pragma omp parallel for default(shared) private(k_L)
-    for (k_L = 0; k_L < ths->N_total; k_L++)
+    #pragma omp parallel default(shared) private(k_L)
     {
-      INT kp[ths->d];                       /**< multi index (simple)           */ //0..N-1
-      INT k[ths->d];                        /**< multi index in g_hat           */
-      INT ks[ths->d];                       /**< multi index in f_hat, c_phi_inv*/
-      R c_phi_inv_k_val = K(1.0);
-      INT k_plain_val = 0;
-      INT ks_plain_val = 0;
-      INT t;
-      INT k_temp = k_L;
-
-      for (t = ths->d-1; t >= 0; t--)
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k_L = 0; k_L < ths->N_total; k_L++)
       {
-        kp[t] = k_temp % ths->N[t];
-        if (kp[t] >= ths->N[t]/2)
-          k[t] = ths->n[t] - ths->N[t] + kp[t];
-        else
-          k[t] = kp[t];
-        ks[t] = (kp[t] + ths->N[t]/2) % ths->N[t];
-        k_temp /= ths->N[t];
-      }
+        INT kp[ths->d];                       /**< multi index (simple)           */ //0..N-1
+        INT k[ths->d];                        /**< multi index in g_hat           */
+        INT ks[ths->d];                       /**< multi index in f_hat, c_phi_inv*/
+        R c_phi_inv_k_val = K(1.0);
+        INT k_plain_val = 0;
+        INT ks_plain_val = 0;
+        INT t;
+        INT k_temp = k_L;
+
+        for (t = ths->d-1; t >= 0; t--)
+        {
+          kp[t] = k_temp % ths->N[t];
+          if (kp[t] >= ths->N[t]/2)
+            k[t] = ths->n[t] - ths->N[t] + kp[t];
+          else
+            k[t] = kp[t];
+          ks[t] = (kp[t] + ths->N[t]/2) % ths->N[t];
+          k_temp /= ths->N[t];
+        }
 
-      for (t = 0; t < ths->d; t++)
-      {
-        c_phi_inv_k_val /= (PHI_HUT(ths->n[t],ks[t]-(ths->N[t]/2),t));
-        ks_plain_val = ks_plain_val*ths->N[t] + ks[t];
-        k_plain_val = k_plain_val*ths->n[t] + k[t];
-      }
+        for (t = 0; t < ths->d; t++)
+        {
+          c_phi_inv_k_val /= (PHI_HUT(ths->n[t],ks[t]-(ths->N[t]/2),t));
+          ks_plain_val = ks_plain_val*ths->N[t] + ks[t];
+          k_plain_val = k_plain_val*ths->n[t] + k[t];
+        }
 
-      f_hat[ks_plain_val] = g_hat[k_plain_val] * c_phi_inv_k_val;
-    } /* for(k_L) */
+        f_hat[ks_plain_val] = g_hat[k_plain_val] * c_phi_inv_k_val;
+      } /* for(k_L) */
+      STATS_THREAD_END(NFFT_STATS_D)
+    }
   } /* else(PRE_PHI_HUT) */
 }
 #endif
@@ -626,18 +874,229 @@ static void D_T(X(plan) *ths)
 #endif
 }
 
+/* Pruned FFT for flag NFFT_PRUNED_FFT. After D_A only the N_total entries of
+ * g_hat with k_t in [0,N_t/2) or [n_t-N_t+N_t/2,n_t) are nonzero. The
+ * d-variate FFT is computed axis by axis, starting with the last one, and the
+ * transform along axis t only runs over the lines whose indices along the axes
+ * 0,...,t-1 lie in this set, the others still vanish. The backward FFT is
+ * pruned the same way in reverse order, since D_T only reads the nonzero set.
+ * Axes with N_t close to n_t are not pruned. */
+
+/**
+ * Dims of the step of the pruned FFT along axis t. The lines run over all
+ * indices of the axes t+1,...,d-1 and over the nonzero set of the axes
+ * 0,...,t-1. Returns the number of howmany dims.
+ */
+static int nfft_pruned_fft_dims(const X(plan) *ths, const int t,
+  FFTW(iodim) *dim, FFTW(iodim) *howmany)
+{
+  int s, r = 0;
+  INT stride = 1;
+
+  for (s = (int)(ths->d) - 1; s > t; s--)
+    stride *= ths->n[s];
+
+  dim->n = (int)(ths->n[t]);
+  dim->is = dim->os = (int)(stride);
+
+  if (stride > 1)
+  {
+    howmany[r].n = (int)(stride);
+    howmany[r].is = howmany[r].os = 1;
+    r++;
+  }
+
+  for (s = t - 1; s >= 0; s--)
+  {
+    const INT hi = ths->N[s] - ths->N[s] / 2;
+
+    stride *= ths->n[s + 1];
+
+    if (2 * hi < ths->n[s])
+    {
+      howmany[r].n = 2;
+      howmany[r].is = howmany[r].os = (int)((ths->n[s] - hi) * stride);
+      r++;
+      howmany[r].n = (int)(hi);
+    }
+    else
+      howmany[r].n = (int)(ths->n[s]);
+
+    howmany[r].is = howmany[r].os = (int)(stride);
+    r++;
+  }
+
+  return r;
+}
+
+static void nfft_pruned_fft_destroy(const X(plan) *ths, FFTW(plan) **p)
+{
+  INT t;
+
+  for (t = 0; t < ths->d; t++)
+    FFTW(destroy_plan)((*p)[t]);
+  plan_free(ths, *p);
+  *p = NULL;
+}
+
+static inline void F_A(X(plan) *ths);
+static inline void F_T(X(plan) *ths);
+
+/** Timed runs of the full and the pruned FFTs, after one untimed run each. */
+#define NFFT_PRUNED_FFT_RUNS 5
+
+/** Shortest time of NFFT_PRUNED_FFT_RUNS runs of fft after a warm-up run. */
+static R nfft_fft_seconds(X(plan) *ths, void (*fft)(X(plan) *))
+{
+  R tt = K(0.0);
+  int i;
+
+  fft(ths);
+
+  for (i = 0; i < NFFT_PRUNED_FFT_RUNS; i++)
+  {
+    const ticks t0 = getticks();
+    R t;
+
+    fft(ths);
+    t = Y(elapsed_seconds)(getticks(), t0);
+    if (i == 0 || t < tt)
+      tt = t;
+  }
+
+  return tt;
+}
+
+/**
+ * Creates the d forward and d backward plans of the pruned FFT. Unless the
+ * FFTW plans are only estimated, the full and the pruned FFT are timed per
+ * direction by nfft_fft_seconds and the pruned plans are kept only if they are
+ * faster.
+ */
+static void nfft_pruned_fft_init(X(plan) *ths)
+{
+  const int d = (int)(ths->d);
+  FFTW(iodim) dim, howmany[2 * d];
+  R tt_full;
+  int t, r;
+
+  ths->my_fftw_plan1_pruned = (FFTW(plan)*) plan_malloc(ths, (size_t)(d)
+    * sizeof(FFTW(plan)));
+  ths->my_fftw_plan2_pruned = (FFTW(plan)*) plan_malloc(ths, (size_t)(d)
+    * sizeof(FFTW(plan)));
+
+  for (t = 0; t < d; t++)
+  {
+    r = nfft_pruned_fft_dims(ths, t, &dim, howmany);
+    ths->my_fftw_plan1_pruned[t] = FFTW(plan_guru_dft)(1, &dim, r, howmany,
+      ths->g1, t == 0 ? ths->g2 : ths->g1, FFTW_FORWARD, ths->fftw_flags);
+    ths->my_fftw_plan2_pruned[t] = FFTW(plan_guru_dft)(1, &dim, r, howmany,
+      t == 0 ? ths->g2 : ths->g1, ths->g1, FFTW_BACKWARD, ths->fftw_flags);
+  }
+
+  if (!(ths->fftw_flags & FFTW_ESTIMATE))
+  {
+    FFTW(plan) *pruned;
+
+    memset(ths->g1, 0, (size_t)(ths->n_total) * sizeof(C));
+    memset(ths->g2, 0, (size_t)(ths->n_total) * sizeof(C));
+
+    pruned = ths->my_fftw_plan1_pruned;
+    ths->my_fftw_plan1_pruned = NULL;
+    tt_full = nfft_fft_seconds(ths, F_A);
+    ths->my_fftw_plan1_pruned = pruned;
+    if (nfft_fft_seconds(ths, F_A) >= tt_full)
+      nfft_pruned_fft_destroy(ths, &ths->my_fftw_plan1_pruned);
+
+    pruned = ths->my_fftw_plan2_pruned;
+    ths->my_fftw_plan2_pruned = NULL;
+    tt_full = nfft_fft_seconds(ths, F_T);
+    ths->my_fftw_plan2_pruned = pruned;
+    if (nfft_fft_seconds(ths, F_T) >= tt_full)
+      nfft_pruned_fft_destroy(ths, &ths->my_fftw_plan2_pruned);
+  }
+}
+
+/** Forward FFT from g1 to g2. */
+static inline void F_A(X(plan) *ths)
+{
+  INT t;
+
+  if (!ths->my_fftw_plan1_pruned)
+  {
+    FFTW(execute_dft)(ths->my_fftw_plan1, ths->g1, ths->g2);
+    return;
+  }
+
+  for (t = ths->d - 1; t > 0; t--)
+    FFTW(execute_dft)(ths->my_fftw_plan1_pruned[t], ths->g1, ths->g1);
+  FFTW(execute_dft)(ths->my_fftw_plan1_pruned[0], ths->g1, ths->g2);
+}
+
+/** Backward FFT from g2 to g1. */
+static inline void F_T(X(plan) *ths)
+{
+  INT t;
+
+  if (!ths->my_fftw_plan2_pruned)
+  {
+    FFTW(execute_dft)(ths->my_fftw_plan2, ths->g2, ths->g1);
+    return;
+  }
+
+  FFTW(execute_dft)(ths->my_fftw_plan2_pruned[0], ths->g2, ths->g1);
+  for (t = 1; t < ths->d; t++)
+    FFTW(execute_dft)(ths->my_fftw_plan2_pruned[t], ths->g1, ths->g1);
+}
+
 /* sub routines for the fast transforms matrix vector multiplication with B, B^T */
 #define MACRO_B_init_result_A memset(ths->f, 0, (size_t)(ths->M_total) * sizeof(C));
 #define MACRO_B_init_result_T memset(ths->g, 0, (size_t)(ths->n_total) * sizeof(C));
 
-#define MACRO_B_PRE_FULL_PSI_compute_A \
+/* f_j = sum_l psi[j*lprod+l] g[psi_index_g[j*lprod+l]] for PRE_FULL_PSI. The
+ * float tables of NFFT_FULL_PSI_FLOAT hold psi / psi_float_scale, the products
+ * are accumulated in C in both cases. */
+#ifdef _OPENMP
+#define MACRO_B_PRE_FULL_PSI_A_PRAGMA _Pragma("omp parallel default(shared) private(k)")
+#define MACRO_B_PRE_FULL_PSI_A_FOR _Pragma("omp for schedule(static) nowait")
+#else
+#define MACRO_B_PRE_FULL_PSI_A_PRAGMA
+#define MACRO_B_PRE_FULL_PSI_A_FOR
+#endif
+
+#define MACRO_B_PRE_FULL_PSI_A(psi_tab, index_tab, scale) \
 { \
-  (*fj) += ths->psi[ix] * g[ths->psi_index_g[ix]]; \
+  MACRO_B_PRE_FULL_PSI_A_PRAGMA \
+  { \
+    STATS_THREAD_BEGIN \
+    MACRO_B_PRE_FULL_PSI_A_FOR \
+    for (k = 0; k < M; k++) \
+    { \
+      INT l; \
+      const INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k; \
+      C fj = K(0.0); \
+      for (l = 0; l < lprod; l++) \
+        fj += (R)(psi_tab)[j*lprod+l] * g[(index_tab)[j*lprod+l]]; \
+      ths->f[j] = (scale) * fj; \
+    } \
+    STATS_THREAD_END(NFFT_STATS_B) \
+  } \
 }
 
-#define MACRO_B_PRE_FULL_PSI_compute_T \
-{ \
-  g[ths->psi_index_g[ix]] += ths->psi[ix] * (*fj); \
+/** Trafo part of B for flag PRE_FULL_PSI, with or without NFFT_FULL_PSI_FLOAT. */
+static void nfft_B_full_psi_A(X(plan) *ths)
+{
+  const C *g = (const C*)ths->g;
+  const INT M = ths->M_total;
+  INT k, lprod;
+
+  for (k = 0, lprod = 1; k < ths->d; k++)
+    lprod *= 2 * ths->m + 2;
+
+  if (ths->flags & NFFT_FULL_PSI_FLOAT)
+    MACRO_B_PRE_FULL_PSI_A(ths->psi_float, ths->psi_index_g32, ths->psi_float_scale)
+  else
+    MACRO_B_PRE_FULL_PSI_A(ths->psi, ths->psi_index_g, K(1.0))
 }
 
 #define MACRO_B_compute_A \
@@ -792,7 +1251,7 @@ static inline void B_serial_ ## which_one (X(plan) *ths) \
   INT u[ths->d], o[ths->d]; /* multi band with respect to x_j */ \
   INT t, t2; /* index dimensions */ \
   INT k; /* index nodes */ \
-  INT l_L, ix; /* index one row of B */ \
+  INT l_L; /* index one row of B */ \
   INT lj[ths->d]; /* multi index 0<=lj<u+o+1 */ \
   INT ll_plain[ths->d+1]; /* postfix plain index in g */ \
   R phi_prod[ths->d+1]; /* postfix product of PHI */ \
@@ -809,18 +1268,7 @@ static inline void B_serial_ ## which_one (X(plan) *ths) \
  \
   if (ths->flags & PRE_FULL_PSI) \
   { \
-    INT j; \
-    C *f, *g; /* local copy */ \
-    C *fj; /* local copy */ \
-    f = (C*)ths->f; g = (C*)ths->g; \
- \
-    for (ix = 0, j = 0, fj = f; j < ths->M_total; j++, fj++) \
-    { \
-      for (l_L = 0; l_L < ths->psi_index_f[j]; l_L++, ix++) \
-      { \
-        MACRO_B_PRE_FULL_PSI_compute_ ## which_one; \
-      } \
-    } \
+    nfft_B_full_psi_ ## which_one(ths); \
     return; \
   } \
 \
@@ -970,12 +1418,8 @@ static inline void B_serial_ ## which_one (X(plan) *ths) \
     MACRO_init_uo_l_lj_t; \
  \
     for (t2 = 0; t2 < ths->d; t2++) \
-    { \
-      INT lj_t; \
-      for (lj_t = 0; lj_t < 2*ths->m+2; lj_t++) \
-        psij_const[t2 * (2*ths->m+2) + lj_t] = PHI(ths->n[t2], ths->x[j*ths->d+t2] \
-                - ((R) (lj_t+u[t2]))/((R)ths->n[t2]), t2); \
-    } \
+      PHI_ROW(ths->n[t2], ths->x[j*ths->d+t2], u[t2], t2, \
+        &psij_const[t2 * (2*ths->m+2)]); \
  \
     MACRO_B_COMPUTE_ONE_NODE(which_one,without_PRE_PSI_improved); \
   } /* for(j) */ \
@@ -1057,12 +1501,8 @@ MACRO_B(A)
 
 #define MACRO_B_openmp_A_COMPUTE_BEFORE_LOOP_without_PRE_PSI \
     for (t2 = 0; t2 < ths->d; t2++) \
-    { \
-      INT lj_t; \
-      for (lj_t = 0; lj_t < 2*ths->m+2; lj_t++) \
-        psij_const[t2 * (2*ths->m+2) + lj_t] = PHI(ths->n[t2], ths->x[j*ths->d+t2] \
-                - ((R) (lj_t+u[t2]))/((R)ths->n[t2]), t2); \
-    }
+      PHI_ROW(ths->n[t2], ths->x[j*ths->d+t2], u[t2], t2, \
+        &psij_const[t2 * (2*ths->m+2)]);
 #define MACRO_B_openmp_A_COMPUTE_UPDATE_without_PRE_PSI \
   MACRO_update_phi_prod_ll_plain(without_PRE_PSI_improved);
 
@@ -1181,26 +1621,23 @@ static inline void B_openmp_A (X(plan) *ths)
 
   if (ths->flags & PRE_FULL_PSI)
   {
-    #pragma omp parallel for default(shared) private(k)
-    for (k = 0; k < ths->M_total; k++)
-    {
-      INT l;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      ths->f[j] = K(0.0);
-      for (l = 0; l < lprod; l++)
-        ths->f[j] += ths->psi[j*lprod+l] * ths->g[ths->psi_index_g[j*lprod+l]];
-    }
+    nfft_B_full_psi_A(ths);
     return;
   }
 
   if (ths->flags & PRE_PSI)
   {
-    #pragma omp parallel for default(shared) private(k)
-    for (k = 0; k < ths->M_total; k++)
+    #pragma omp parallel default(shared) private(k)
     {
-      INT t, t2; /* index dimensions */
-      MACRO_B_openmp_A_COMPUTE(with_PRE_PSI);
-    } /* for(j) */
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k = 0; k < ths->M_total; k++)
+      {
+        INT t, t2; /* index dimensions */
+        MACRO_B_openmp_A_COMPUTE(with_PRE_PSI);
+      } /* for(j) */
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
     return;
   } /* if(PRE_PSI) */
 
@@ -1211,15 +1648,20 @@ static inline void B_openmp_A (X(plan) *ths)
 
     MACRO_B_openmp_A_COMPUTE_INIT_FG_PSI
 
-    #pragma omp parallel for default(shared) private(k,t,t2)
-    for (k = 0; k < ths->M_total; k++)
+    #pragma omp parallel default(shared) private(k,t,t2)
     {
-      R fg_psi[ths->d][2*ths->m+2];
-      R tmpEXP1, tmp1;
-      INT l_fg,lj_fg;
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k = 0; k < ths->M_total; k++)
+      {
+        R fg_psi[ths->d][2*ths->m+2];
+        R tmpEXP1, tmp1;
+        INT l_fg,lj_fg;
 
-      MACRO_B_openmp_A_COMPUTE(with_PRE_FG_PSI);
-    } /* for(j) */
+        MACRO_B_openmp_A_COMPUTE(with_PRE_FG_PSI);
+      } /* for(j) */
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
     return;
   } /* if(PRE_FG_PSI) */
 
@@ -1232,15 +1674,20 @@ static inline void B_openmp_A (X(plan) *ths)
 
     MACRO_B_openmp_A_COMPUTE_INIT_FG_PSI
 
-    #pragma omp parallel for default(shared) private(k,t,t2)
-    for (k = 0; k < ths->M_total; k++)
+    #pragma omp parallel default(shared) private(k,t,t2)
     {
-      R fg_psi[ths->d][2*ths->m+2];
-      R tmpEXP1, tmp1;
-      INT l_fg,lj_fg;
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k = 0; k < ths->M_total; k++)
+      {
+        R fg_psi[ths->d][2*ths->m+2];
+        R tmpEXP1, tmp1;
+        INT l_fg,lj_fg;
 
-      MACRO_B_openmp_A_COMPUTE(with_FG_PSI);
-    } /* for(j) */
+        MACRO_B_openmp_A_COMPUTE(with_FG_PSI);
+      } /* for(j) */
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
     return;
   } /* if(FG_PSI) */
 
@@ -1248,33 +1695,43 @@ static inline void B_openmp_A (X(plan) *ths)
   {
     sort(ths);
 
-    #pragma omp parallel for default(shared) private(k)
-    for (k = 0; k<ths->M_total; k++)
+    #pragma omp parallel default(shared) private(k)
     {
-      INT t, t2; /* index dimensions */
-      R y[ths->d];
-      R fg_psi[ths->d][2*ths->m+2];
-      INT l_fg,lj_fg;
-      R ip_w;
-      INT ip_u;
-      INT ip_s = ths->K/(ths->m+2);
-
-      MACRO_B_openmp_A_COMPUTE(with_PRE_LIN_PSI);
-    } /* for(j) */
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k = 0; k<ths->M_total; k++)
+      {
+        INT t, t2; /* index dimensions */
+        R y[ths->d];
+        R fg_psi[ths->d][2*ths->m+2];
+        INT l_fg,lj_fg;
+        R ip_w;
+        INT ip_u;
+        INT ip_s = ths->K/(ths->m+2);
+
+        MACRO_B_openmp_A_COMPUTE(with_PRE_LIN_PSI);
+      } /* for(j) */
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
     return;
   } /* if(PRE_LIN_PSI) */
 
   /* no precomputed psi at all */
   sort(ths);
 
-  #pragma omp parallel for default(shared) private(k)
-  for (k = 0; k < ths->M_total; k++)
+  #pragma omp parallel default(shared) private(k)
   {
-    INT t, t2; /* index dimensions */
-    R psij_const[ths->d * (2*ths->m+2)];
+    STATS_THREAD_BEGIN
+    #pragma omp for schedule(static) nowait
+    for (k = 0; k < ths->M_total; k++)
+    {
+      INT t, t2; /* index dimensions */
+      R psij_const[ths->d * (2*ths->m+2)];
 
-    MACRO_B_openmp_A_COMPUTE(without_PRE_PSI);
-  } /* for(j) */
+      MACRO_B_openmp_A_COMPUTE(without_PRE_PSI);
+    } /* for(j) */
+    STATS_THREAD_END(NFFT_STATS_B)
+  }
 }
 #endif
 
@@ -1420,18 +1877,315 @@ static void nfft_adjoint_B_omp_blockwise_init(INT *my_u0, INT *my_o0,
 }
 #endif
 
+/**
+ * Window values of node x_j for all dimensions, psij[t*(2m+2)+l], taken from
+ * the precomputed psi for PRE_PSI and evaluated into buf otherwise.
+ */
+static inline const R *nfft_psij(const X(plan) *ths, const INT j, R *buf)
+{
+  const INT m2p2 = 2 * ths->m + 2;
+  INT t, u, o;
+
+  if (ths->flags & PRE_PSI)
+    return ths->psi + j * ths->d * m2p2;
+
+  for (t = 0; t < ths->d; t++)
+  {
+    uo(ths, j, &u, &o, t);
+    PHI_ROW(ths->n[t], ths->x[j * ths->d + t], u, t, buf + t * m2p2);
+  }
+
+  return buf;
+}
+
+#ifdef _OPENMP
+/* Tile-binned adjoint for flag NFFT_OMP_TILED_ADJOINT. The oversampled grid is
+ * cut into tiles of T[t] grid points per dimension and every node is binned
+ * into the tile containing floor(n x_j). The window of a node of tile q covers
+ * the T[t]+2m+1 grid points starting at q[t]*T[t]-m, so two tiles whose index
+ * differs by two in each dimension cover disjoint parts of g as soon as
+ * T[t] >= 2m+2. Tiles are processed in 2^d colours by the parity of q: within
+ * one colour every thread spreads a tile into a private subgrid and adds the
+ * subgrid to g without atomic operations. */
+
+/** preferred number of grid points of a tile per dimension for d = 1,2,3 */
+#define NFFT_TILE_1D 1024
+#define NFFT_TILE_2D 32
+#define NFFT_TILE_3D 16
+
+/**
+ * Chooses the tile widths T[t]. These are powers of two of at least 2m+2 such
+ * that every dimension holds an even number of tiles. Returns 0 if no such
+ * widths exist.
+ */
+static int nfft_tiled_init(const X(plan) *ths, INT *T)
+{
+  const INT d = ths->d, m2p2 = 2 * ths->m + 2;
+  const INT pref = d == 1 ? NFFT_TILE_1D : d == 2 ? NFFT_TILE_2D
+    : d == 3 ? NFFT_TILE_3D : 1;
+  INT t, T_min = 1;
+
+  while (T_min < m2p2)
+    T_min *= 2;
+
+  for (t = 0; t < d; t++)
+  {
+    T[t] = MAX(T_min, pref);
+    while (T[t] > T_min && ths->n[t] % (2 * T[t]) != 0)
+      T[t] /= 2;
+    if (ths->n[t] % (2 * T[t]) != 0)
+      return 0;
+  }
+
+  return 1;
+}
+
+/** Adds len entries of src to row[(u+l)%n], 0 <= u < n, len <= n. */
+static inline void nfft_tiled_add_row(C *row, const C *src, const INT u,
+  const INT len, const INT n)
+{
+  const INT len0 = MIN(len, n - u);
+  INT l;
+
+  for (l = 0; l < len0; l++)
+    row[u + l] += src[l];
+  for (l = len0; l < len; l++)
+    row[l - len0] += src[l];
+}
+
+/** Spreads f_j psij into the subgrid sub with sides S at local offset lc. */
+static inline void nfft_tiled_spread(C *sub, const INT *S, const C f,
+  const R *psij, const INT *lc, const INT d, const INT m)
+{
+  const INT m2p2 = 2 * m + 2;
+  INT t, r, rows = 1;
+
+  if (d == 2 && NFFT_B_FIXED(m))
+  {
+    nfft_adjoint_2d_compute_fixed(f, sub, psij, psij + m2p2, lc[0], lc[1],
+      S[1], m);
+    return;
+  }
+
+  if (d == 3 && NFFT_B_FIXED(m))
+  {
+    nfft_adjoint_3d_compute_fixed(f, sub, psij, psij + m2p2, psij + 2 * m2p2,
+      lc[0], lc[1], lc[2], S[1], S[2], m);
+    return;
+  }
+
+  for (t = 0; t < d - 1; t++)
+    rows *= m2p2;
+
+  for (r = 0; r < rows; r++)
+  {
+    INT rr = r, off = 0, stride = S[d - 1];
+    R w = K(1.0);
+
+    for (t = d - 2; t >= 0; t--)
+    {
+      const INT l = rr % m2p2;
+      rr /= m2p2;
+      off += (lc[t] + l) * stride;
+      stride *= S[t];
+      w *= psij[t * m2p2 + l];
+    }
+
+    nfft_upd_row_fixed(sub + off + lc[d - 1], f * w, psij + (d - 1) * m2p2,
+      m);
+  }
+}
+
+/**
+ * Adjoint B step with tile binning, see above. Returns 0 without touching g
+ * if the plan is not suited for it, i.e. for PRE_FULL_PSI, PRE_LIN_PSI,
+ * PRE_FG_PSI, FG_PSI or if no tile widths exist. Expects g zeroed.
+ */
+static int nfft_adjoint_B_omp_tiled(X(plan) *ths)
+{
+  const INT d = ths->d, m = ths->m, M = ths->M_total;
+  INT T[d], S[d], nq[d], nq_half[d];
+  INT t, ntiles = 1, ncolor_tiles = 1, sub_size = 1;
+  INT *tile, *order, *start, *cnt = NULL;
+  C *g = ths->g;
+
+  if (!(ths->flags & NFFT_OMP_TILED_ADJOINT))
+    return 0;
+
+  if (ths->flags & (PRE_FULL_PSI | PRE_LIN_PSI | PRE_FG_PSI | FG_PSI))
+    return 0;
+
+  if (!nfft_tiled_init(ths, T))
+    return 0;
+
+  for (t = 0; t < d; t++)
+  {
+    S[t] = T[t] + 2 * m + 1;
+    nq[t] = ths->n[t] / T[t];
+    nq_half[t] = nq[t] / 2;
+    ntiles *= nq[t];
+    ncolor_tiles *= nq_half[t];
+    sub_size *= S[t];
+  }
+
+  tile = (INT*) Y(malloc)((size_t)(M) * sizeof(INT));
+  order = (INT*) Y(malloc)((size_t)(M) * sizeof(INT));
+  start = (INT*) Y(malloc)((size_t)(ntiles + 1) * sizeof(INT));
+
+  #pragma omp parallel default(shared) private(t)
+  {
+    const INT nthreads = omp_get_num_threads();
+    const INT my_id = omp_get_thread_num();
+    R *buf = (R*) Y(malloc)((size_t)(d * (2 * m + 2)) * sizeof(R));
+    C *sub = (C*) Y(malloc)((size_t)(sub_size) * sizeof(C));
+    INT j, k, color;
+
+    #pragma omp single
+    {
+      cnt = (INT*) Y(malloc)((size_t)(nthreads * ntiles) * sizeof(INT));
+      memset(cnt, 0, (size_t)(nthreads * ntiles) * sizeof(INT));
+    }
+
+    /* counting sort of the nodes by tile, stable within every thread */
+    #pragma omp for schedule(static)
+    for (j = 0; j < M; j++)
+    {
+      INT q = 0;
+      for (t = 0; t < d; t++)
+      {
+        INT c = LRINT(FLOOR(ths->x[j * d + t] * (R)(ths->n[t]))) % ths->n[t];
+        if (c < 0)
+          c += ths->n[t];
+        q = q * nq[t] + c / T[t];
+      }
+      tile[j] = q;
+      cnt[my_id * ntiles + q]++;
+    }
+
+    #pragma omp single
+    {
+      INT q, p, off = 0;
+      for (q = 0; q < ntiles; q++)
+      {
+        start[q] = off;
+        for (p = 0; p < nthreads; p++)
+        {
+          const INT c = cnt[p * ntiles + q];
+          cnt[p * ntiles + q] = off;
+          off += c;
+        }
+      }
+      start[ntiles] = off;
+    }
+
+    #pragma omp for schedule(static)
+    for (j = 0; j < M; j++)
+      order[cnt[my_id * ntiles + tile[j]]++] = j;
+
+    for (color = 0; color < (1 << d); color++)
+    {
+      /* the busy time ends before the barrier between the colours */
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(dynamic) nowait
+      for (k = 0; k < ncolor_tiles; k++)
+      {
+        INT q = 0, qt[d], lc[d], kk = k, r, rows = 1, l;
+
+        for (t = d - 1; t >= 0; t--)
+        {
+          qt[t] = 2 * (kk % nq_half[t]) + ((color >> t) & 1);
+          kk /= nq_half[t];
+        }
+        for (t = 0; t < d; t++)
+          q = q * nq[t] + qt[t];
+
+        if (start[q] == start[q + 1])
+          continue;
+
+        memset(sub, 0, (size_t)(sub_size) * sizeof(C));
+
+        for (l = start[q]; l < start[q + 1]; l++)
+        {
+          const INT jj = order[l];
+          const R *psij = nfft_psij(ths, jj, buf);
+
+          for (t = 0; t < d; t++)
+          {
+            INT c = LRINT(FLOOR(ths->x[jj * d + t] * (R)(ths->n[t])))
+              % ths->n[t];
+            if (c < 0)
+              c += ths->n[t];
+            lc[t] = c - qt[t] * T[t];
+          }
+
+          nfft_tiled_spread(sub, S, ths->f[jj], psij, lc, d, m);
+        }
+
+        /* add the subgrid to g, its origin is q T - m */
+        for (t = 0; t < d - 1; t++)
+          rows *= S[t];
+
+        for (r = 0; r < rows; r++)
+        {
+          INT rr = r, off = 0, stride = ths->n[d - 1];
+
+          for (t = d - 2; t >= 0; t--)
+          {
+            const INT s = rr % S[t];
+            rr /= S[t];
+            off += ((qt[t] * T[t] - m + s + ths->n[t]) % ths->n[t]) * stride;
+            stride *= ths->n[t];
+          }
+
+          nfft_tiled_add_row(g + off, sub + r * S[d - 1],
+            (qt[d - 1] * T[d - 1] - m + ths->n[d - 1]) % ths->n[d - 1],
+            S[d - 1], ths->n[d - 1]);
+        }
+      } /* for(k) */
+      STATS_THREAD_END(NFFT_STATS_B)
+      #pragma omp barrier
+    } /* for(color) */
+
+    Y(free)(sub);
+    Y(free)(buf);
+  } /* omp parallel */
+
+  Y(free)(cnt);
+  Y(free)(start);
+  Y(free)(order);
+  Y(free)(tile);
+
+  return 1;
+}
+#endif
+
+#define FULL_PSI_INDEX_G(ix) \
+  (psi_float ? (INT)psi_index_g32[ix] : psi_index_g[ix])
+#define FULL_PSI(ix) (psi_float ? psi_scale * (R)psi_float[ix] : psi[ix])
+
 /**
  * Calculates adjoint NFFT for flag PRE_FULL_PSI.
  * Parallel calculation (OpenMP) with and without atomic operations.
+ * With flag NFFT_FULL_PSI_FLOAT the tables psi_float and psi_index_g32 are
+ * used instead of psi and psi_index_g.
  *
  * \arg lprod stride (2*m+2)^d
  *
  * \author Toni Volkmer
  */
-static void nfft_adjoint_B_compute_full_psi(C *g, const INT *psi_index_g,
-    const R *psi, const C *f, const INT M, const INT d, const INT *n,
-    const INT m, const unsigned flags, const INT *index_x)
+static void nfft_adjoint_B_compute_full_psi(X(plan) *ths)
 {
+  C *g = (C*)ths->g;
+  const C *f = ths->f;
+  const INT M = ths->M_total, d = ths->d, m = ths->m;
+  const INT *n = ths->n;
+  const unsigned flags = ths->flags;
+  const INT *index_x = ths->index_x;
+  const INT *psi_index_g = ths->psi_index_g;
+  const R *psi = ths->psi;
+  const int *psi_index_g32 = ths->psi_index_g32;
+  const float *psi_float = (flags & NFFT_FULL_PSI_FLOAT) ? ths->psi_float : NULL;
+  const R psi_scale = ths->psi_float_scale;
   INT k;
   INT lprod;
 #ifdef _OPENMP
@@ -1454,6 +2208,7 @@ static void nfft_adjoint_B_compute_full_psi(C *g, const INT *psi_index_g,
   {
     #pragma omp parallel private(k)
     {
+      STATS_THREAD_BEGIN
       INT my_u0, my_o0, min_u_a, max_u_a, min_u_b, max_u_b;
       const INT *ar_x = index_x;
       INT n_prod_rest = 1;
@@ -1482,7 +2237,7 @@ static void nfft_adjoint_B_compute_full_psi(C *g, const INT *psi_index_g,
 
           for (l0 = 0; l0 < 2 * m + 2; l0++)
           {
-            const INT start_index = psi_index_g[j * lprod + l0 * lprod_m1];
+            const INT start_index = FULL_PSI_INDEX_G(j * lprod + l0 * lprod_m1);
 
             if (start_index < my_u0 * n_prod_rest || start_index > (my_o0+1) * n_prod_rest - 1)
               continue;
@@ -1490,7 +2245,7 @@ static void nfft_adjoint_B_compute_full_psi(C *g, const INT *psi_index_g,
             for (lrest = 0; lrest < lprod_m1; lrest++)
             {
               const INT l = l0 * lprod_m1 + lrest;
-              g[psi_index_g[j * lprod + l]] += psi[j * lprod + l] * f[j];
+              g[FULL_PSI_INDEX_G(j * lprod + l)] += FULL_PSI(j * lprod + l) * f[j];
             }
           }
 
@@ -1517,54 +2272,67 @@ static void nfft_adjoint_B_compute_full_psi(C *g, const INT *psi_index_g,
 
           for (l0 = 0; l0 < 2 * m + 2; l0++)
           {
-            const INT start_index = psi_index_g[j * lprod + l0 * lprod_m1];
+            const INT start_index = FULL_PSI_INDEX_G(j * lprod + l0 * lprod_m1);
 
             if (start_index < my_u0 * n_prod_rest || start_index > (my_o0+1) * n_prod_rest - 1)
               continue;
             for (lrest = 0; lrest < lprod_m1; lrest++)
             {
               const INT l = l0 * lprod_m1 + lrest;
-              g[psi_index_g[j * lprod + l]] += psi[j * lprod + l] * f[j];
+              g[FULL_PSI_INDEX_G(j * lprod + l)] += FULL_PSI(j * lprod + l) * f[j];
             }
           }
 
           k++;
         }
       }
+      STATS_THREAD_END(NFFT_STATS_B)
     } /* omp parallel */
     return;
   } /* if(NFFT_OMP_BLOCKWISE_ADJOINT) */
 #endif
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(shared) private(k)
+  #pragma omp parallel default(shared) private(k)
 #endif
-  for (k = 0; k < M; k++)
   {
-    INT l;
-    INT j = (flags & NFFT_SORT_NODES) ? index_x[2*k+1] : k;
-
-    for (l = 0; l < lprod; l++)
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < M; k++)
     {
+      INT l;
+      INT j = (flags & NFFT_SORT_NODES) ? index_x[2*k+1] : k;
+
+      for (l = 0; l < lprod; l++)
+      {
 #ifdef _OPENMP
-      C val = psi[j * lprod + l] * f[j];
-      C *gref = g + psi_index_g[j * lprod + l];
-      R *gref_real = (R*) gref;
+        C val = FULL_PSI(j * lprod + l) * f[j];
+        C *gref = g + FULL_PSI_INDEX_G(j * lprod + l);
+        R *gref_real = (R*) gref;
 
-      #pragma omp atomic
-      gref_real[0] += CREAL(val);
+        #pragma omp atomic
+        gref_real[0] += CREAL(val);
 
-      #pragma omp atomic
-      gref_real[1] += CIMAG(val);
+        #pragma omp atomic
+        gref_real[1] += CIMAG(val);
 #else
-      g[psi_index_g[j * lprod + l]] += psi[j * lprod + l] * f[j];
+        g[FULL_PSI_INDEX_G(j * lprod + l)] += FULL_PSI(j * lprod + l) * f[j];
 #endif
+      }
     }
+    STATS_THREAD_END(NFFT_STATS_B)
   }
 }
 
+#undef FULL_PSI_INDEX_G
+#undef FULL_PSI
+
 #ifndef _OPENMP
+#define nfft_B_full_psi_T nfft_adjoint_B_compute_full_psi
 MACRO_B(T)
+#undef nfft_B_full_psi_T
 #endif
 
 
@@ -1660,12 +2428,8 @@ MACRO_B(T)
 #define MACRO_adjoint_nd_B_OMP_COMPUTE_BEFORE_LOOP_without_PRE_PSI \
       R psij_const[ths->d * (2*ths->m+2)]; \
       for (t2 = 0; t2 < ths->d; t2++) \
-      { \
-        INT lj_t; \
-        for (lj_t = 0; lj_t < 2*ths->m+2; lj_t++) \
-          psij_const[t2 * (2*ths->m+2) + lj_t] = PHI(ths->n[t2], ths->x[j*ths->d+t2] \
-                  - ((R) (lj_t+u[t2]))/((R)ths->n[t2]), t2); \
-      }
+        PHI_ROW(ths->n[t2], ths->x[j*ths->d+t2], u[t2], t2, \
+          &psij_const[t2 * (2*ths->m+2)]);
 #define MACRO_adjoint_nd_B_OMP_COMPUTE_UPDATE_without_PRE_PSI \
   MACRO_update_phi_prod_ll_plain(without_PRE_PSI_improved);
 
@@ -1791,6 +2555,7 @@ MACRO_B(T)
         lprodrest *= (2*ths->m+2); \
       _Pragma("omp parallel private(k)") \
       { \
+        STATS_THREAD_BEGIN \
         INT my_u0, my_o0, min_u_a, max_u_a, min_u_b, max_u_b; \
         INT *ar_x = ths->index_x; \
  \
@@ -1836,6 +2601,7 @@ MACRO_B(T)
             k++; \
           } \
         } \
+        STATS_THREAD_END(NFFT_STATS_B) \
       } /* omp parallel */ \
       return; \
     } /* if(NFFT_OMP_BLOCKWISE_ADJOINT) */ \
@@ -1978,13 +2744,15 @@ static inline void B_openmp_T(X(plan) *ths)
 
   memset(ths->g, 0, (size_t)(ths->n_total) * sizeof(C));
 
+  if (nfft_adjoint_B_omp_tiled(ths))
+    return;
+
   for (k = 0, lprod = 1; k < ths->d; k++)
     lprod *= (2*ths->m+2);
 
   if (ths->flags & PRE_FULL_PSI)
   {
-    nfft_adjoint_B_compute_full_psi(ths->g, ths->psi_index_g, ths->psi, ths->f,
-        ths->M_total, ths->d, ths->n, ths->m, ths->flags, ths->index_x);
+    nfft_adjoint_B_compute_full_psi(ths);
     return;
   }
 
@@ -1992,13 +2760,18 @@ static inline void B_openmp_T(X(plan) *ths)
   {
     MACRO_adjoint_nd_B_OMP_BLOCKWISE(with_PRE_PSI);
 
-    #pragma omp parallel for default(shared) private(k)
-    for (k = 0; k < ths->M_total; k++)
+    #pragma omp parallel default(shared) private(k)
     {
-      INT t, t2; /* index dimensions */ \
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      MACRO_adjoint_nd_B_OMP_COMPUTE(with_PRE_PSI);
-    } /* for(j) */
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k = 0; k < ths->M_total; k++)
+      {
+        INT t, t2; /* index dimensions */ \
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        MACRO_adjoint_nd_B_OMP_COMPUTE(with_PRE_PSI);
+      } /* for(j) */
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
     return;
   } /* if(PRE_PSI) */
 
@@ -2024,12 +2797,17 @@ static inline void B_openmp_T(X(plan) *ths)
 
     MACRO_adjoint_nd_B_OMP_BLOCKWISE(with_PRE_FG_PSI);
 
-    #pragma omp parallel for default(shared) private(k,t,t2)
-    for (k = 0; k < ths->M_total; k++)
+    #pragma omp parallel default(shared) private(k,t,t2)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      MACRO_adjoint_nd_B_OMP_COMPUTE(with_PRE_FG_PSI);
-    } /* for(j) */
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k = 0; k < ths->M_total; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        MACRO_adjoint_nd_B_OMP_COMPUTE(with_PRE_FG_PSI);
+      } /* for(j) */
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
     return;
   } /* if(PRE_FG_PSI) */
 
@@ -2058,12 +2836,17 @@ static inline void B_openmp_T(X(plan) *ths)
 
     MACRO_adjoint_nd_B_OMP_BLOCKWISE(with_FG_PSI);
 
-    #pragma omp parallel for default(shared) private(k,t,t2)
-    for (k = 0; k < ths->M_total; k++)
+    #pragma omp parallel default(shared) private(k,t,t2)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      MACRO_adjoint_nd_B_OMP_COMPUTE(with_FG_PSI);
-    } /* for(j) */
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k = 0; k < ths->M_total; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        MACRO_adjoint_nd_B_OMP_COMPUTE(with_FG_PSI);
+      } /* for(j) */
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
     return;
   } /* if(FG_PSI) */
 
@@ -2073,13 +2856,18 @@ static inline void B_openmp_T(X(plan) *ths)
 
     MACRO_adjoint_nd_B_OMP_BLOCKWISE(with_PRE_LIN_PSI);
 
-    #pragma omp parallel for default(shared) private(k)
-    for (k = 0; k<ths->M_total; k++)
+    #pragma omp parallel default(shared) private(k)
     {
-      INT t, t2; /* index dimensions */
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      MACRO_adjoint_nd_B_OMP_COMPUTE(with_PRE_LIN_PSI);
-    } /* for(j) */
+      STATS_THREAD_BEGIN
+      #pragma omp for schedule(static) nowait
+      for (k = 0; k<ths->M_total; k++)
+      {
+        INT t, t2; /* index dimensions */
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        MACRO_adjoint_nd_B_OMP_COMPUTE(with_PRE_LIN_PSI);
+      } /* for(j) */
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
     return;
   } /* if(PRE_LIN_PSI) */
 
@@ -2088,13 +2876,18 @@ static inline void B_openmp_T(X(plan) *ths)
 
   MACRO_adjoint_nd_B_OMP_BLOCKWISE(without_PRE_PSI);
 
-  #pragma omp parallel for default(shared) private(k)
-  for (k = 0; k < ths->M_total; k++)
+  #pragma omp parallel default(shared) private(k)
   {
-    INT t, t2; /* index dimensions */
-    INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-    MACRO_adjoint_nd_B_OMP_COMPUTE(without_PRE_PSI);
-  } /* for(j) */
+    STATS_THREAD_BEGIN
+    #pragma omp for schedule(static) nowait
+    for (k = 0; k < ths->M_total; k++)
+    {
+      INT t, t2; /* index dimensions */
+      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      MACRO_adjoint_nd_B_OMP_COMPUTE(without_PRE_PSI);
+    } /* for(j) */
+    STATS_THREAD_END(NFFT_STATS_B)
+  }
 }
 #endif
 
@@ -2131,52 +2924,36 @@ static void nfft_1d_init_fg_exp_l(R *fg_exp_l, const INT m, const R b)
 static void nfft_trafo_1d_compute(C *fj, const C *g,const R *psij_const,
   const R *xj, const INT n, const INT m)
 {
-  INT u, o, l;
-  const C *gj;
+  INT u, o;
   const R *psij;
   psij = psij_const;
 
   uo2(&u, &o, *xj, n, m);
 
   if (u < o)
-  {
-    for (l = 1, gj = g + u, (*fj) = (*psij++) * (*gj++); l <= 2*m+1; l++)
-      (*fj) += (*psij++) * (*gj++);
-  }
+    (*fj) = nfft_sum_row_fixed(psij, g + u, m);
   else
-  {
-    for (l = 1, gj = g + u, (*fj) = (*psij++) * (*gj++); l < 2*m+1 - o; l++)
-      (*fj) += (*psij++) * (*gj++);
-    for (l = 0, gj = g; l <= o; l++)
-      (*fj) += (*psij++) * (*gj++);
-  }
+    (*fj) = nfft_sum_wx(psij, g + u, 2*m+1 - o)
+      + nfft_sum_wx(psij + 2*m+1 - o, g, o+1);
 }
 
-#ifndef _OPENMP
 static void nfft_adjoint_1d_compute_serial(const C *fj, C *g,
     const R *psij_const, const R *xj, const INT n, const INT m)
 {
-  INT u,o,l;
-  C *gj;
+  INT u,o;
   const R *psij;
   psij = psij_const;
 
   uo2(&u,&o,*xj, n, m);
 
   if (u < o)
-  {
-    for (l = 0, gj = g+u; l <= 2*m+1; l++)
-      (*gj++) += (*psij++) * (*fj);
-  }
+    nfft_upd_row_fixed(g+u, (*fj), psij, m);
   else
   {
-    for (l = 0, gj = g+u; l < 2*m+1-o; l++)
-      (*gj++) += (*psij++) * (*fj);
-    for (l = 0, gj = g; l <= o; l++)
-      (*gj++) += (*psij++) * (*fj);
+    nfft_upd_xpaw(g+u, (*fj), psij, 2*m+1-o);
+    nfft_upd_xpaw(g, (*fj), psij+2*m+1-o, o+1);
   }
 }
-#endif
 
 #ifdef _OPENMP
 /* adjoint NFFT one-dimensional case with OpenMP atomic operations */
@@ -2227,7 +3004,7 @@ static void nfft_adjoint_1d_compute_omp_blockwise(const C f, C *g,
     const R *psij_const, const R *xj, const INT n, const INT m,
     const INT my_u0, const INT my_o0)
 {
-  INT ar_u,ar_o,l;
+  INT ar_u,ar_o;
 
   uo2(&ar_u,&ar_o,*xj, n, m);
 
@@ -2242,8 +3019,7 @@ static void nfft_adjoint_1d_compute_omp_blockwise(const C f, C *g,
     assert(offset_psij+o-u <= 2*m+1);
 #endif
 
-    for (l = 0; l <= o-u; l++)
-      g[u+l] += psij_const[offset_psij+l] * f;
+    nfft_upd_xpaw(g+u, f, psij_const+offset_psij, o-u+1);
   }
   else
   {
@@ -2256,8 +3032,7 @@ static void nfft_adjoint_1d_compute_omp_blockwise(const C f, C *g,
     assert(offset_psij+o-u <= 2*m+1);
 #endif
 
-    for (l = 0; l <= o-u; l++)
-      g[u+l] += psij_const[offset_psij+l] * f;
+    nfft_upd_xpaw(g+u, f, psij_const+offset_psij, o-u+1);
 
     u = my_u0;
     o = MIN(my_o0,ar_o);
@@ -2274,8 +3049,7 @@ static void nfft_adjoint_1d_compute_omp_blockwise(const C f, C *g,
       assert(offset_psij+o-u <= 2*m+1);
     }
 #endif
-    for (l = 0; l <= o-u; l++)
-      g[u+l] += psij_const[offset_psij+l] * f;
+    nfft_upd_xpaw(g+u, f, psij_const+offset_psij, o-u+1);
   }
 }
 #endif
@@ -2287,18 +3061,7 @@ static void nfft_trafo_1d_B(X(plan) *ths)
 
   if (ths->flags & PRE_FULL_PSI)
   {
-    INT k;
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
-#endif
-    for (k = 0; k < M; k++)
-    {
-      INT l;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      ths->f[j] = K(0.0);
-      for (l = 0; l < m2p2; l++)
-        ths->f[j] += ths->psi[j*m2p2+l] * g[ths->psi_index_g[j*m2p2+l]];
-    }
+    nfft_B_full_psi_A(ths);
     return;
   } /* if(PRE_FULL_PSI) */
 
@@ -2306,13 +3069,20 @@ static void nfft_trafo_1d_B(X(plan) *ths)
   {
     INT k;
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      nfft_trafo_1d_compute(&ths->f[j], g, ths->psi + j * (2 * m + 2),
-        &ths->x[j], n, m);
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        nfft_trafo_1d_compute(&ths->f[j], g, ths->psi + j * (2 * m + 2),
+          &ths->x[j], n, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
     return;
   } /* if(PRE_PSI) */
@@ -2325,25 +3095,32 @@ static void nfft_trafo_1d_B(X(plan) *ths)
     nfft_1d_init_fg_exp_l(fg_exp_l, m, ths->b[0]);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      const R fg_psij0 = ths->psi[2 * j], fg_psij1 = ths->psi[2 * j + 1];
-      R fg_psij2 = K(1.0);
-      R psij_const[m2p2];
-      INT l;
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        const R fg_psij0 = ths->psi[2 * j], fg_psij1 = ths->psi[2 * j + 1];
+        R fg_psij2 = K(1.0);
+        R psij_const[m2p2];
+        INT l;
 
-      psij_const[0] = fg_psij0;
+        psij_const[0] = fg_psij0;
 
-      for (l = 1; l < m2p2; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0 * fg_psij2 * fg_exp_l[l];
-      }
+        for (l = 1; l < m2p2; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0 * fg_psij2 * fg_exp_l[l];
+        }
 
-      nfft_trafo_1d_compute(&ths->f[j], g, psij_const, &ths->x[j], n, m);
+        nfft_trafo_1d_compute(&ths->f[j], g, psij_const, &ths->x[j], n, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -2359,29 +3136,36 @@ static void nfft_trafo_1d_B(X(plan) *ths)
     nfft_1d_init_fg_exp_l(fg_exp_l, m, ths->b[0]);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      INT u, o, l;
-      R fg_psij0, fg_psij1, fg_psij2;
-      R psij_const[m2p2];
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        INT u, o, l;
+        R fg_psij0, fg_psij1, fg_psij2;
+        R psij_const[m2p2];
 
-      uo(ths, (INT)j, &u, &o, (INT)0);
-      fg_psij0 = (PHI(ths->n[0], ths->x[j] - ((R)(u))/(R)(n), 0));
-      fg_psij1 = EXP(K(2.0) * ((R)(n) * ths->x[j] - (R)(u)) / ths->b[0]);
-      fg_psij2  = K(1.0);
+        uo(ths, (INT)j, &u, &o, (INT)0);
+        fg_psij0 = (PHI(ths->n[0], ths->x[j] - ((R)(u))/(R)(n), 0));
+        fg_psij1 = EXP(K(2.0) * ((R)(n) * ths->x[j] - (R)(u)) / ths->b[0]);
+        fg_psij2  = K(1.0);
 
-      psij_const[0] = fg_psij0;
+        psij_const[0] = fg_psij0;
 
-      for (l = 1; l < m2p2; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0 * fg_psij2 * fg_exp_l[l];
-      }
+        for (l = 1; l < m2p2; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0 * fg_psij2 * fg_exp_l[l];
+        }
 
-      nfft_trafo_1d_compute(&ths->f[j], g, psij_const, &ths->x[j], n, m);
+        nfft_trafo_1d_compute(&ths->f[j], g, psij_const, &ths->x[j], n, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
     return;
   } /* if(FG_PSI) */
@@ -2394,27 +3178,34 @@ static void nfft_trafo_1d_B(X(plan) *ths)
     sort(ths);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u, o, l;
-      R ip_y, ip_w;
-      INT ip_u;
-      R psij_const[m2p2];
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT u, o, l;
+        R ip_y, ip_w;
+        INT ip_u;
+        R psij_const[m2p2];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 
-      uo(ths, (INT)j, &u, &o, (INT)0);
+        uo(ths, (INT)j, &u, &o, (INT)0);
 
-      ip_y = FABS((R)(n) * ths->x[j] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
+        ip_y = FABS((R)(n) * ths->x[j] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
 
-      for (l = 0; l < m2p2; l++)
-        psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)] * (K(1.0) - ip_w)
-          + ths->psi[ABS(ip_u-l*ip_s+1)] * (ip_w);
+        for (l = 0; l < m2p2; l++)
+          psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)] * (K(1.0) - ip_w)
+            + ths->psi[ABS(ip_u-l*ip_s+1)] * (ip_w);
 
-      nfft_trafo_1d_compute(&ths->f[j], g, psij_const, &ths->x[j], n, m);
+        nfft_trafo_1d_compute(&ths->f[j], g, psij_const, &ths->x[j], n, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
     return;
   } /* if(PRE_LIN_PSI) */
@@ -2426,20 +3217,26 @@ static void nfft_trafo_1d_B(X(plan) *ths)
     sort(ths);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      R psij_const[m2p2];
-      INT u, o, l;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        R psij_const[m2p2];
+        INT u, o;
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 
-      uo(ths, (INT)j, &u, &o, (INT)0);
+        uo(ths, (INT)j, &u, &o, (INT)0);
 
-      for (l = 0; l < m2p2; l++)
-        psij_const[l] = (PHI(ths->n[0], ths->x[j] - ((R)((u+l))) / (R)(n), 0));
+        PHI_ROW(ths->n[0], ths->x[j], u, 0, psij_const);
 
-      nfft_trafo_1d_compute(&ths->f[j], g, psij_const, &ths->x[j], n, m);
+        nfft_trafo_1d_compute(&ths->f[j], g, psij_const, &ths->x[j], n, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
   }
 }
@@ -2515,12 +3312,11 @@ static void nfft_trafo_1d_B(X(plan) *ths)
 #define MACRO_adjoint_1d_B_OMP_BLOCKWISE_COMPUTE_NO_PSI \
 { \
             R psij_const[2 * m + 2]; \
-            INT u, o, l; \
+            INT u, o; \
  \
             uo(ths, j, &u, &o, (INT)0); \
  \
-            for (l = 0; l <= 2 * m + 1; l++) \
-              psij_const[l] = (PHI(ths->n[0],ths->x[j]-((R)((u+l)))/((R)n),0)); \
+            PHI_ROW(ths->n[0], ths->x[j], u, 0, psij_const); \
  \
             nfft_adjoint_1d_compute_omp_blockwise(ths->f[j], g, psij_const, \
                 ths->x + j, n, m, my_u0, my_o0); \
@@ -2532,6 +3328,7 @@ static void nfft_trafo_1d_B(X(plan) *ths)
     { \
       _Pragma("omp parallel private(k)") \
       { \
+        STATS_THREAD_BEGIN \
         INT my_u0, my_o0, min_u_a, max_u_a, min_u_b, max_u_b; \
         INT *ar_x = ths->index_x; \
  \
@@ -2577,6 +3374,7 @@ static void nfft_trafo_1d_B(X(plan) *ths)
             k++; \
           } \
         } \
+        STATS_THREAD_END(NFFT_STATS_B) \
       } /* omp parallel */ \
       return; \
     } /* if(NFFT_OMP_BLOCKWISE_ADJOINT) */ \
@@ -2590,10 +3388,14 @@ static void nfft_adjoint_1d_B(X(plan) *ths)
 
   memset(g, 0, (size_t)(ths->n_total) * sizeof(C));
 
+#ifdef _OPENMP
+  if (nfft_adjoint_B_omp_tiled(ths))
+    return;
+#endif
+
   if (ths->flags & PRE_FULL_PSI)
   {
-    nfft_adjoint_B_compute_full_psi(g, ths->psi_index_g, ths->psi, ths->f, M,
-        (INT)1, ths->n, m, ths->flags, ths->index_x);
+    nfft_adjoint_B_compute_full_psi(ths);
     return;
   } /* if(PRE_FULL_PSI) */
 
@@ -2604,16 +3406,23 @@ static void nfft_adjoint_1d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      STATS_THREAD_BEGIN
 #ifdef _OPENMP
-      nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, ths->psi + j * (2 * m + 2), ths->x + j, n, m);
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+#ifdef _OPENMP
+        nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, ths->psi + j * (2 * m + 2), ths->x + j, n, m);
 #else
-      nfft_adjoint_1d_compute_serial(ths->f + j, g, ths->psi + j * (2 * m + 2), ths->x + j, n, m);
+        nfft_adjoint_1d_compute_serial(ths->f + j, g, ths->psi + j * (2 * m + 2), ths->x + j, n, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -2631,29 +3440,36 @@ static void nfft_adjoint_1d_B(X(plan) *ths)
 
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      R psij_const[2 * m + 2];
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      INT l;
-      R fg_psij0 = ths->psi[2 * j];
-      R fg_psij1 = ths->psi[2 * j + 1];
-      R fg_psij2 = K(1.0);
-
-      psij_const[0] = fg_psij0;
-      for (l = 1; l <= 2 * m + 1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0 * fg_psij2 * fg_exp_l[l];
-      }
+        R psij_const[2 * m + 2];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        INT l;
+        R fg_psij0 = ths->psi[2 * j];
+        R fg_psij1 = ths->psi[2 * j + 1];
+        R fg_psij2 = K(1.0);
+
+        psij_const[0] = fg_psij0;
+        for (l = 1; l <= 2 * m + 1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0 * fg_psij2 * fg_exp_l[l];
+        }
 
 #ifdef _OPENMP
-      nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, psij_const, ths->x + j, n, m);
+        nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, psij_const, ths->x + j, n, m);
 #else
-      nfft_adjoint_1d_compute_serial(ths->f + j, g, psij_const, ths->x + j, n, m);
+        nfft_adjoint_1d_compute_serial(ths->f + j, g, psij_const, ths->x + j, n, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -2672,31 +3488,38 @@ static void nfft_adjoint_1d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u,o,l;
-      R psij_const[2 * m + 2];
-      R fg_psij0, fg_psij1, fg_psij2;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-
-      uo(ths, j, &u, &o, (INT)0);
-      fg_psij0 = (PHI(ths->n[0], ths->x[j] - ((R)u) / (R)(n),0));
-      fg_psij1 = EXP(K(2.0) * ((R)(n) * (ths->x[j]) - (R)(u)) / ths->b[0]);
-      fg_psij2 = K(1.0);
-      psij_const[0] = fg_psij0;
-      for (l = 1; l <= 2 * m + 1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0 * fg_psij2 * fg_exp_l[l];
-      }
+        INT u,o,l;
+        R psij_const[2 * m + 2];
+        R fg_psij0, fg_psij1, fg_psij2;
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+
+        uo(ths, j, &u, &o, (INT)0);
+        fg_psij0 = (PHI(ths->n[0], ths->x[j] - ((R)u) / (R)(n),0));
+        fg_psij1 = EXP(K(2.0) * ((R)(n) * (ths->x[j]) - (R)(u)) / ths->b[0]);
+        fg_psij2 = K(1.0);
+        psij_const[0] = fg_psij0;
+        for (l = 1; l <= 2 * m + 1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0 * fg_psij2 * fg_exp_l[l];
+        }
 
 #ifdef _OPENMP
-      nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, psij_const, ths->x + j, n, m);
+        nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, psij_const, ths->x + j, n, m);
 #else
-      nfft_adjoint_1d_compute_serial(ths->f + j, g, psij_const, ths->x + j, n, m);
+        nfft_adjoint_1d_compute_serial(ths->f + j, g, psij_const, ths->x + j, n, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -2714,31 +3537,38 @@ static void nfft_adjoint_1d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u,o,l;
-      INT ip_u;
-      R ip_y, ip_w;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      R psij_const[2 * m + 2];
-
-      uo(ths, j, &u, &o, (INT)0);
-
-      ip_y = FABS((R)(n) * ths->x[j] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for (l = 0; l < 2 * m + 2; l++)
-        psij_const[l]
-            = ths->psi[ABS(ip_u-l*ip_s)] * (K(1.0) - ip_w)
-                + ths->psi[ABS(ip_u-l*ip_s+1)] * (ip_w);
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT u,o,l;
+        INT ip_u;
+        R ip_y, ip_w;
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        R psij_const[2 * m + 2];
+
+        uo(ths, j, &u, &o, (INT)0);
+
+        ip_y = FABS((R)(n) * ths->x[j] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for (l = 0; l < 2 * m + 2; l++)
+          psij_const[l]
+              = ths->psi[ABS(ip_u-l*ip_s)] * (K(1.0) - ip_w)
+                  + ths->psi[ABS(ip_u-l*ip_s+1)] * (ip_w);
 
 #ifdef _OPENMP
-      nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, psij_const, ths->x + j, n, m);
+        nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, psij_const, ths->x + j, n, m);
 #else
-      nfft_adjoint_1d_compute_serial(ths->f + j, g, psij_const, ths->x + j, n, m);
+        nfft_adjoint_1d_compute_serial(ths->f + j, g, psij_const, ths->x + j, n, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
     return;
   } /* if(PRE_LIN_PSI) */
@@ -2751,29 +3581,37 @@ static void nfft_adjoint_1d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(shared) private(k)
+  #pragma omp parallel default(shared) private(k)
 #endif
-  for (k = 0; k < M; k++)
   {
-    INT u,o,l;
-    R psij_const[2 * m + 2];
-    INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < M; k++)
+    {
+      INT u,o;
+      R psij_const[2 * m + 2];
+      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 
-    uo(ths, j, &u, &o, (INT)0);
+      uo(ths, j, &u, &o, (INT)0);
 
-    for (l = 0; l <= 2 * m + 1; l++)
-      psij_const[l] = (PHI(ths->n[0], ths->x[j] - ((R)((u+l))) / (R)(n),0));
+      PHI_ROW(ths->n[0], ths->x[j], u, 0, psij_const);
 
 #ifdef _OPENMP
-    nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, psij_const, ths->x + j, n, m);
+      nfft_adjoint_1d_compute_omp_atomic(ths->f[j], g, psij_const, ths->x + j, n, m);
 #else
-    nfft_adjoint_1d_compute_serial(ths->f + j, g, psij_const, ths->x + j, n, m);
+      nfft_adjoint_1d_compute_serial(ths->f + j, g, psij_const, ths->x + j, n, m);
 #endif
+    }
+    STATS_THREAD_END(NFFT_STATS_B)
   }
 }
 
 void X(trafo_1d)(X(plan) *ths)
 {
+  update_nodes(ths);
+
   if((ths->N[0] <= ths->m) || (ths->n[0] <= 2*ths->m+2))
   {
     X(trafo_direct)(ths);
@@ -2790,13 +3628,18 @@ void X(trafo_1d)(X(plan) *ths)
     C *g_hat1 = (C*)&ths->g_hat[n-N/2], *g_hat2 = (C*)ths->g_hat;
     R *c_phi_inv1, *c_phi_inv2;
 
-    TIC(0)
+    TIC(NFFT_STATS_D)
 #ifdef _OPENMP
     {
       INT k;
-      #pragma omp parallel for default(shared) private(k)
-      for (k = 0; k < ths->n_total; k++)
-        ths->g_hat[k] = 0.0;
+      #pragma omp parallel default(shared) private(k)
+      {
+        STATS_THREAD_BEGIN
+        #pragma omp for schedule(static) nowait
+        for (k = 0; k < ths->n_total; k++)
+          ths->g_hat[k] = 0.0;
+        STATS_THREAD_END(NFFT_STATS_D)
+      }
     }
 #else
     memset(ths->g_hat, 0, (size_t)(ths->n_total) * sizeof(C));
@@ -2808,40 +3651,56 @@ void X(trafo_1d)(X(plan) *ths)
       c_phi_inv2 = &ths->c_phi_inv[0][N2];
 
 #ifdef _OPENMP
-      #pragma omp parallel for default(shared) private(k)
+      #pragma omp parallel default(shared) private(k)
 #endif
-      for (k = 0; k < N2; k++)
       {
-        g_hat1[k] = f_hat1[k] * c_phi_inv1[k];
-        g_hat2[k] = f_hat2[k] * c_phi_inv2[k];
+        STATS_THREAD_BEGIN
+#ifdef _OPENMP
+        #pragma omp for schedule(static) nowait
+#endif
+        for (k = 0; k < N2; k++)
+        {
+          g_hat1[k] = f_hat1[k] * c_phi_inv1[k];
+          g_hat2[k] = f_hat2[k] * c_phi_inv2[k];
+        }
+        STATS_THREAD_END(NFFT_STATS_D)
       }
     }
     else
     {
       INT k;
 #ifdef _OPENMP
-      #pragma omp parallel for default(shared) private(k)
+      #pragma omp parallel default(shared) private(k)
 #endif
-      for (k = 0; k < N2; k++)
       {
-        g_hat1[k] = f_hat1[k] / (PHI_HUT(ths->n[0],k-N2,0));
-        g_hat2[k] = f_hat2[k] / (PHI_HUT(ths->n[0],k,0));
+        STATS_THREAD_BEGIN
+#ifdef _OPENMP
+        #pragma omp for schedule(static) nowait
+#endif
+        for (k = 0; k < N2; k++)
+        {
+          g_hat1[k] = f_hat1[k] / (PHI_HUT(ths->n[0],k-N2,0));
+          g_hat2[k] = f_hat2[k] / (PHI_HUT(ths->n[0],k,0));
+        }
+        STATS_THREAD_END(NFFT_STATS_D)
       }
     }
-    TOC(0)
+    TOC(NFFT_STATS_D)
 
-    TIC_FFTW(1)
-    FFTW(execute)(ths->my_fftw_plan1);
-    TOC_FFTW(1);
+    TIC_FFTW(NFFT_STATS_FFT)
+    F_A(ths);
+    TOC_FFTW(NFFT_STATS_FFT);
 
-    TIC(2);
+    TIC(NFFT_STATS_B);
     nfft_trafo_1d_B(ths);
-    TOC(2);
+    TOC(NFFT_STATS_B);
   }
 }
 
 void X(adjoint_1d)(X(plan) *ths)
 {
+  update_nodes(ths);
+
   if((ths->N[0] <= ths->m) || (ths->n[0] <= 2*ths->m+2))
   {
     X(adjoint_direct)(ths);
@@ -2863,15 +3722,15 @@ void X(adjoint_1d)(X(plan) *ths)
   g_hat1=(C*)&ths->g_hat[n-N/2];
   g_hat2=(C*)ths->g_hat;
 
-  TIC(2)
+  TIC(NFFT_STATS_B)
   nfft_adjoint_1d_B(ths);
-  TOC(2)
+  TOC(NFFT_STATS_B)
 
-  TIC_FFTW(1)
-  FFTW(execute)(ths->my_fftw_plan2);
-  TOC_FFTW(1);
+  TIC_FFTW(NFFT_STATS_FFT)
+  F_T(ths);
+  TOC_FFTW(NFFT_STATS_FFT);
 
-  TIC(0)
+  TIC(NFFT_STATS_D)
   if(ths->flags & PRE_PHI_HUT)
   {
     INT k;
@@ -2879,12 +3738,19 @@ void X(adjoint_1d)(X(plan) *ths)
     c_phi_inv2=&ths->c_phi_inv[0][N/2];
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < N/2; k++)
     {
-      f_hat1[k] = g_hat1[k] * c_phi_inv1[k];
-      f_hat2[k] = g_hat2[k] * c_phi_inv2[k];
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < N/2; k++)
+      {
+        f_hat1[k] = g_hat1[k] * c_phi_inv1[k];
+        f_hat2[k] = g_hat2[k] * c_phi_inv2[k];
+      }
+      STATS_THREAD_END(NFFT_STATS_D)
     }
   }
   else
@@ -2892,15 +3758,22 @@ void X(adjoint_1d)(X(plan) *ths)
     INT k;
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < N/2; k++)
     {
-      f_hat1[k] = g_hat1[k] / (PHI_HUT(ths->n[0],k-N/2,0));
-      f_hat2[k] = g_hat2[k] / (PHI_HUT(ths->n[0],k,0));
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < N/2; k++)
+      {
+        f_hat1[k] = g_hat1[k] / (PHI_HUT(ths->n[0],k-N/2,0));
+        f_hat2[k] = g_hat2[k] / (PHI_HUT(ths->n[0],k,0));
+      }
+      STATS_THREAD_END(NFFT_STATS_D)
     }
   }
-  TOC(0)
+  TOC(NFFT_STATS_D)
 }
 
 
@@ -2928,7 +3801,7 @@ static void nfft_trafo_2d_compute(C *fj, const C *g, const R *psij_const0,
     const R *psij_const1, const R *xj0, const R *xj1, const INT n0,
     const INT n1, const INT m)
 {
-  INT u0,o0,l0,u1,o1,l1;
+  INT u0,o0,l0,u1,o1;
   const C *gj;
   const R *psij0,*psij1;
 
@@ -2938,6 +3811,12 @@ static void nfft_trafo_2d_compute(C *fj, const C *g, const R *psij_const0,
   uo2(&u0,&o0,*xj0, n0, m);
   uo2(&u1,&o1,*xj1, n1, m);
 
+  if (u0 < o0 && u1 < o1 && NFFT_B_FIXED(m))
+  {
+    nfft_trafo_2d_compute_fixed(fj, g, psij0, psij1, u0, u1, n1, m);
+    return;
+  }
+
   *fj=0;
 
   if (u0 < o0)
@@ -2946,19 +3825,17 @@ static void nfft_trafo_2d_compute(C *fj, const C *g, const R *psij_const0,
     {
         psij1=psij_const1;
         gj=g+(u0+l0)*n1+u1;
-        for(l1=0; l1<=2*m+1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, 2*m+2);
     }
       else
     for(l0=0; l0<=2*m+1; l0++,psij0++)
     {
         psij1=psij_const1;
         gj=g+(u0+l0)*n1+u1;
-        for(l1=0; l1<2*m+1-o1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, 2*m+1-o1);
+        psij1 += 2*m+1-o1;
         gj=g+(u0+l0)*n1;
-        for(l1=0; l1<=o1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, o1+1);
     }
   else
       if(u1<o1)
@@ -2967,15 +3844,13 @@ static void nfft_trafo_2d_compute(C *fj, const C *g, const R *psij_const0,
     {
         psij1=psij_const1;
         gj=g+(u0+l0)*n1+u1;
-        for(l1=0; l1<=2*m+1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, 2*m+2);
     }
     for(l0=0; l0<=o0; l0++,psij0++)
     {
         psij1=psij_const1;
         gj=g+l0*n1+u1;
-        for(l1=0; l1<=2*m+1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, 2*m+2);
     }
       }
       else
@@ -2984,21 +3859,19 @@ static void nfft_trafo_2d_compute(C *fj, const C *g, const R *psij_const0,
     {
         psij1=psij_const1;
         gj=g+(u0+l0)*n1+u1;
-        for(l1=0; l1<2*m+1-o1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, 2*m+1-o1);
+        psij1 += 2*m+1-o1;
         gj=g+(u0+l0)*n1;
-        for(l1=0; l1<=o1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, o1+1);
     }
     for(l0=0; l0<=o0; l0++,psij0++)
     {
         psij1=psij_const1;
         gj=g+l0*n1+u1;
-        for(l1=0; l1<2*m+1-o1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, 2*m+1-o1);
+        psij1 += 2*m+1-o1;
         gj=g+l0*n1;
-        for(l1=0; l1<=o1; l1++)
-      (*fj) += (*psij0) * (*psij1++) * (*gj++);
+        (*fj) += (*psij0) * nfft_sum_wx(psij1, gj, o1+1);
     }
       }
 }
@@ -3066,15 +3939,11 @@ static void nfft_adjoint_2d_compute_omp_blockwise(const C f, C *g,
             const R *xj1, const INT n0, const INT n1, const INT m,
             const INT my_u0, const INT my_o0)
 {
-  INT ar_u0,ar_o0,l0,u1,o1,l1;
-  INT index_temp1[2*m+2];
+  INT ar_u0,ar_o0,l0,u1,o1;
 
   uo2(&ar_u0,&ar_o0,*xj0, n0, m);
   uo2(&u1,&o1,*xj1, n1, m);
 
-  for (l1 = 0; l1 <= 2*m+1; l1++)
-    index_temp1[l1] = (u1+l1)%n1;
-
   if(ar_u0 < ar_o0)
   {
     INT u0 = MAX(my_u0,ar_u0);
@@ -3091,8 +3960,7 @@ static void nfft_adjoint_2d_compute_omp_blockwise(const C f, C *g,
       INT i0 = (u0+l0) * n1;
       const C val0 = psij_const0[offset_psij+l0];
 
-      for(l1=0; l1<=2*m+1; l1++)
-        g[i0 + index_temp1[l1]] += val0 * psij_const1[l1] * f;
+      nfft_upd_row(g + i0, val0 * f, psij_const1, u1, o1, m);
     }
   }
   else
@@ -3111,8 +3979,7 @@ static void nfft_adjoint_2d_compute_omp_blockwise(const C f, C *g,
       INT i0 = (u0+l0) * n1;
       const C val0 = psij_const0[offset_psij+l0];
 
-      for(l1=0; l1<=2*m+1; l1++)
-        g[i0 + index_temp1[l1]] += val0 * psij_const1[l1] * f;
+      nfft_upd_row(g + i0, val0 * f, psij_const1, u1, o1, m);
     }
 
     u0 = my_u0;
@@ -3132,19 +3999,17 @@ static void nfft_adjoint_2d_compute_omp_blockwise(const C f, C *g,
       INT i0 = (u0+l0) * n1;
       const C val0 = psij_const0[offset_psij+l0];
 
-      for(l1=0; l1<=2*m+1; l1++)
-        g[i0 + index_temp1[l1]] += val0 * psij_const1[l1] * f;
+      nfft_upd_row(g + i0, val0 * f, psij_const1, u1, o1, m);
     }
   }
 }
 #endif
 
-#ifndef _OPENMP
 static void nfft_adjoint_2d_compute_serial(const C *fj, C *g,
             const R *psij_const0, const R *psij_const1, const R *xj0,
             const R *xj1, const INT n0, const INT n1, const INT m)
 {
-  INT u0,o0,l0,u1,o1,l1;
+  INT u0,o0,l0,u1,o1;
   C *gj;
   const R *psij0,*psij1;
 
@@ -3154,25 +4019,29 @@ static void nfft_adjoint_2d_compute_serial(const C *fj, C *g,
   uo2(&u0,&o0,*xj0, n0, m);
   uo2(&u1,&o1,*xj1, n1, m);
 
+  if (u0 < o0 && u1 < o1 && NFFT_B_FIXED(m))
+  {
+    nfft_adjoint_2d_compute_fixed(*fj, g, psij0, psij1, u0, u1, n1, m);
+    return;
+  }
+
   if(u0<o0)
       if(u1<o1)
     for(l0=0; l0<=2*m+1; l0++,psij0++)
     {
         psij1=psij_const1;
         gj=g+(u0+l0)*n1+u1;
-        for(l1=0; l1<=2*m+1; l1++)
-    (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, 2*m+2);
     }
       else
     for(l0=0; l0<=2*m+1; l0++,psij0++)
     {
         psij1=psij_const1;
         gj=g+(u0+l0)*n1+u1;
-        for(l1=0; l1<2*m+1-o1; l1++)
-      (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, 2*m+1-o1);
+        psij1 += 2*m+1-o1;
         gj=g+(u0+l0)*n1;
-        for(l1=0; l1<=o1; l1++)
-      (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, o1+1);
     }
   else
       if(u1<o1)
@@ -3181,15 +4050,13 @@ static void nfft_adjoint_2d_compute_serial(const C *fj, C *g,
     {
         psij1=psij_const1;
         gj=g+(u0+l0)*n1+u1;
-        for(l1=0; l1<=2*m+1; l1++)
-      (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, 2*m+2);
     }
     for(l0=0; l0<=o0; l0++,psij0++)
     {
         psij1=psij_const1;
         gj=g+l0*n1+u1;
-        for(l1=0; l1<=2*m+1; l1++)
-      (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, 2*m+2);
     }
       }
       else
@@ -3198,25 +4065,22 @@ static void nfft_adjoint_2d_compute_serial(const C *fj, C *g,
     {
         psij1=psij_const1;
         gj=g+(u0+l0)*n1+u1;
-        for(l1=0; l1<2*m+1-o1; l1++)
-      (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, 2*m+1-o1);
+        psij1 += 2*m+1-o1;
         gj=g+(u0+l0)*n1;
-        for(l1=0; l1<=o1; l1++)
-      (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, o1+1);
     }
     for(l0=0; l0<=o0; l0++,psij0++)
     {
         psij1=psij_const1;
         gj=g+l0*n1+u1;
-        for(l1=0; l1<2*m+1-o1; l1++)
-      (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, 2*m+1-o1);
+        psij1 += 2*m+1-o1;
         gj=g+l0*n1;
-        for(l1=0; l1<=o1; l1++)
-      (*gj++) += (*psij0) * (*psij1++) * (*fj);
+        nfft_upd_xpaw(gj, (*psij0) * (*fj), psij1, o1+1);
     }
       }
 }
-#endif
 
 static void nfft_trafo_2d_B(X(plan) *ths)
 {
@@ -3230,30 +4094,26 @@ static void nfft_trafo_2d_B(X(plan) *ths)
 
   if(ths->flags & PRE_FULL_PSI)
   {
-    const INT lprod = (2*m+2) * (2*m+2);
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
-#endif
-    for (k = 0; k < M; k++)
-    {
-      INT l;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      ths->f[j] = K(0.0);
-      for (l = 0; l < lprod; l++)
-        ths->f[j] += ths->psi[j*lprod+l] * g[ths->psi_index_g[j*lprod+l]];
-    }
+    nfft_B_full_psi_A(ths);
     return;
   } /* if(PRE_FULL_PSI) */
 
   if(ths->flags & PRE_PSI)
   {
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      nfft_trafo_2d_compute(ths->f+j, g, ths->psi+j*2*(2*m+2), ths->psi+(j*2+1)*(2*m+2), ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        nfft_trafo_2d_compute(ths->f+j, g, ths->psi+j*2*(2*m+2), ths->psi+(j*2+1)*(2*m+2), ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
       return;
@@ -3267,35 +4127,42 @@ static void nfft_trafo_2d_B(X(plan) *ths)
     nfft_2d_init_fg_exp_l(fg_exp_l+2*m+2, m, ths->b[1]);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      R psij_const[2*(2*m+2)];
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      INT l;
-      R fg_psij0 = ths->psi[2*j*2];
-      R fg_psij1 = ths->psi[2*j*2+1];
-      R fg_psij2 = K(1.0);
-
-      psij_const[0] = fg_psij0;
-      for (l = 1; l <= 2*m+1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
-      }
+        R psij_const[2*(2*m+2)];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        INT l;
+        R fg_psij0 = ths->psi[2*j*2];
+        R fg_psij1 = ths->psi[2*j*2+1];
+        R fg_psij2 = K(1.0);
+
+        psij_const[0] = fg_psij0;
+        for (l = 1; l <= 2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
+        }
 
-      fg_psij0 = ths->psi[2*(j*2+1)];
-      fg_psij1 = ths->psi[2*(j*2+1)+1];
-      fg_psij2 = K(1.0);
-      psij_const[2*m+2] = fg_psij0;
-      for (l = 1; l <= 2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
-      }
+        fg_psij0 = ths->psi[2*(j*2+1)];
+        fg_psij1 = ths->psi[2*(j*2+1)+1];
+        fg_psij2 = K(1.0);
+        psij_const[2*m+2] = fg_psij0;
+        for (l = 1; l <= 2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
+        }
 
-      nfft_trafo_2d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_trafo_2d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -3311,38 +4178,45 @@ static void nfft_trafo_2d_B(X(plan) *ths)
     sort(ths);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u, o, l;
-      R fg_psij0, fg_psij1, fg_psij2;
-      R psij_const[2*(2*m+2)];
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-
-      uo(ths, j, &u, &o, (INT)0);
-      fg_psij0 = (PHI(ths->n[0], ths->x[2*j] - ((R)u) / (R)(n0),0));
-      fg_psij1 = EXP(K(2.0) * ((R)(n0) * (ths->x[2*j]) - (R)(u)) / ths->b[0]);
-      fg_psij2 = K(1.0);
-      psij_const[0] = fg_psij0;
-      for (l = 1; l <= 2*m+1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
-      }
+        INT u, o, l;
+        R fg_psij0, fg_psij1, fg_psij2;
+        R psij_const[2*(2*m+2)];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+
+        uo(ths, j, &u, &o, (INT)0);
+        fg_psij0 = (PHI(ths->n[0], ths->x[2*j] - ((R)u) / (R)(n0),0));
+        fg_psij1 = EXP(K(2.0) * ((R)(n0) * (ths->x[2*j]) - (R)(u)) / ths->b[0]);
+        fg_psij2 = K(1.0);
+        psij_const[0] = fg_psij0;
+        for (l = 1; l <= 2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
+        }
 
-      uo(ths,j,&u,&o, (INT)1);
-      fg_psij0 = (PHI(ths->n[1], ths->x[2*j+1] - ((R)u) / (R)(n1),1));
-      fg_psij1 = EXP(K(2.0) * ((R)(n1) * (ths->x[2*j+1]) - (R)(u)) / ths->b[1]);
-      fg_psij2 = K(1.0);
-      psij_const[2*m+2] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
-      }
+        uo(ths,j,&u,&o, (INT)1);
+        fg_psij0 = (PHI(ths->n[1], ths->x[2*j+1] - ((R)u) / (R)(n1),1));
+        fg_psij1 = EXP(K(2.0) * ((R)(n1) * (ths->x[2*j+1]) - (R)(u)) / ths->b[1]);
+        fg_psij2 = K(1.0);
+        psij_const[2*m+2] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
+        }
 
-      nfft_trafo_2d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_trafo_2d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -3355,31 +4229,38 @@ static void nfft_trafo_2d_B(X(plan) *ths)
     sort(ths);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u, o, l;
-      R ip_y, ip_w;
-      INT ip_u;
-      R psij_const[2*(2*m+2)];
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-
-      uo(ths,j,&u,&o,(INT)0);
-      ip_y = FABS((R)(n0) * ths->x[2*j] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)LRINT(FLOOR(ip_y));
-      ip_w = ip_y - (R)(ip_u);
-      for (l = 0; l < 2*m+2; l++)
-        psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) + ths->psi[ABS(ip_u-l*ip_s+1)]*(ip_w);
-
-      uo(ths,j,&u,&o,(INT)1);
-      ip_y = FABS((R)(n1) * ths->x[2*j+1] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for (l = 0; l < 2*m+2; l++)
-        psij_const[2*m+2+l] = ths->psi[(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) + ths->psi[(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
-
-      nfft_trafo_2d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT u, o, l;
+        R ip_y, ip_w;
+        INT ip_u;
+        R psij_const[2*(2*m+2)];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+
+        uo(ths,j,&u,&o,(INT)0);
+        ip_y = FABS((R)(n0) * ths->x[2*j] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)LRINT(FLOOR(ip_y));
+        ip_w = ip_y - (R)(ip_u);
+        for (l = 0; l < 2*m+2; l++)
+          psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) + ths->psi[ABS(ip_u-l*ip_s+1)]*(ip_w);
+
+        uo(ths,j,&u,&o,(INT)1);
+        ip_y = FABS((R)(n1) * ths->x[2*j+1] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for (l = 0; l < 2*m+2; l++)
+          psij_const[2*m+2+l] = ths->psi[(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) + ths->psi[(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
+
+        nfft_trafo_2d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
       return;
   } /* if(PRE_LIN_PSI) */
@@ -3389,23 +4270,28 @@ static void nfft_trafo_2d_B(X(plan) *ths)
   sort(ths);
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(shared) private(k)
+  #pragma omp parallel default(shared) private(k)
 #endif
-  for (k = 0; k < M; k++)
   {
-    R psij_const[2*(2*m+2)];
-    INT u, o, l;
-    INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < M; k++)
+    {
+      R psij_const[2*(2*m+2)];
+      INT u, o;
+      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 
-    uo(ths,j,&u,&o,(INT)0);
-    for (l = 0; l <= 2*m+1; l++)
-      psij_const[l]=(PHI(ths->n[0], ths->x[2*j] - ((R)((u+l))) / (R)(n0),0));
+      uo(ths,j,&u,&o,(INT)0);
+      PHI_ROW(ths->n[0], ths->x[2*j], u, 0, psij_const);
 
-    uo(ths,j,&u,&o,(INT)1);
-    for (l = 0; l <= 2*m+1; l++)
-      psij_const[2*m+2+l] = (PHI(ths->n[1], ths->x[2*j+1] - ((R)((u+l)))/(R)(n1),1));
+      uo(ths,j,&u,&o,(INT)1);
+      PHI_ROW(ths->n[1], ths->x[2*j+1], u, 1, psij_const+2*m+2);
 
-    nfft_trafo_2d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      nfft_trafo_2d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+    }
+    STATS_THREAD_END(NFFT_STATS_B)
   }
 }
 
@@ -3508,15 +4394,13 @@ static void nfft_trafo_2d_B(X(plan) *ths)
 #define MACRO_adjoint_2d_B_OMP_BLOCKWISE_COMPUTE_NO_PSI \
 { \
             R psij_const[2*(2*m+2)]; \
-            INT u, o, l; \
+            INT u, o; \
  \
             uo(ths,j,&u,&o,(INT)0); \
-            for(l=0;l<=2*m+1;l++) \
-              psij_const[l]=(PHI(ths->n[0],ths->x[2*j]-((R)((u+l)))/((R)n0),0)); \
+            PHI_ROW(ths->n[0], ths->x[2*j], u, 0, psij_const); \
  \
             uo(ths,j,&u,&o,(INT)1); \
-            for(l=0;l<=2*m+1;l++) \
-              psij_const[2*m+2+l]=(PHI(ths->n[1],ths->x[2*j+1]-((R)((u+l)))/((R)n1),1)); \
+            PHI_ROW(ths->n[1], ths->x[2*j+1], u, 1, psij_const+2*m+2); \
  \
             nfft_adjoint_2d_compute_omp_blockwise(ths->f[j], g, \
                 psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, \
@@ -3529,6 +4413,7 @@ static void nfft_trafo_2d_B(X(plan) *ths)
     { \
       _Pragma("omp parallel private(k)") \
       { \
+        STATS_THREAD_BEGIN \
         INT my_u0, my_o0, min_u_a, max_u_a, min_u_b, max_u_b; \
         INT *ar_x = ths->index_x; \
  \
@@ -3574,6 +4459,7 @@ static void nfft_trafo_2d_B(X(plan) *ths)
             k++; \
           } \
         } \
+        STATS_THREAD_END(NFFT_STATS_B) \
       } /* omp parallel */ \
       return; \
     } /* if(NFFT_OMP_BLOCKWISE_ADJOINT) */ \
@@ -3591,10 +4477,14 @@ static void nfft_adjoint_2d_B(X(plan) *ths)
 
   memset(g, 0, (size_t)(ths->n_total) * sizeof(C));
 
+#ifdef _OPENMP
+  if (nfft_adjoint_B_omp_tiled(ths))
+    return;
+#endif
+
   if(ths->flags & PRE_FULL_PSI)
   {
-    nfft_adjoint_B_compute_full_psi(g, ths->psi_index_g, ths->psi, ths->f, M,
-        (INT)2, ths->n, m, ths->flags, ths->index_x);
+    nfft_adjoint_B_compute_full_psi(ths);
     return;
   } /* if(PRE_FULL_PSI) */
 
@@ -3605,16 +4495,23 @@ static void nfft_adjoint_2d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 #ifdef _OPENMP
-      nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, ths->psi+j*2*(2*m+2), ths->psi+(j*2+1)*(2*m+2), ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, ths->psi+j*2*(2*m+2), ths->psi+(j*2+1)*(2*m+2), ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #else
-      nfft_adjoint_2d_compute_serial(ths->f+j, g, ths->psi+j*2*(2*m+2), ths->psi+(j*2+1)*(2*m+2), ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_adjoint_2d_compute_serial(ths->f+j, g, ths->psi+j*2*(2*m+2), ths->psi+(j*2+1)*(2*m+2), ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
     return;
   } /* if(PRE_PSI) */
@@ -3632,39 +4529,46 @@ static void nfft_adjoint_2d_B(X(plan) *ths)
 
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      R psij_const[2*(2*m+2)];
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      INT l;
-      R fg_psij0 = ths->psi[2*j*2];
-      R fg_psij1 = ths->psi[2*j*2+1];
-      R fg_psij2 = K(1.0);
-
-      psij_const[0] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
-      }
+        R psij_const[2*(2*m+2)];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        INT l;
+        R fg_psij0 = ths->psi[2*j*2];
+        R fg_psij1 = ths->psi[2*j*2+1];
+        R fg_psij2 = K(1.0);
+
+        psij_const[0] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
+        }
 
-      fg_psij0 = ths->psi[2*(j*2+1)];
-      fg_psij1 = ths->psi[2*(j*2+1)+1];
-      fg_psij2 = K(1.0);
-      psij_const[2*m+2] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
-      }
+        fg_psij0 = ths->psi[2*(j*2+1)];
+        fg_psij1 = ths->psi[2*(j*2+1)+1];
+        fg_psij2 = K(1.0);
+        psij_const[2*m+2] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
+        }
 
 #ifdef _OPENMP
-      nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #else
-      nfft_adjoint_2d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_adjoint_2d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -3684,42 +4588,49 @@ static void nfft_adjoint_2d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u, o, l;
-      R fg_psij0, fg_psij1, fg_psij2;
-      R psij_const[2*(2*m+2)];
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-
-      uo(ths,j,&u,&o,(INT)0);
-      fg_psij0 = (PHI(ths->n[0], ths->x[2*j] - ((R)u)/(R)(n0),0));
-      fg_psij1 = EXP(K(2.0) * ((R)(n0) * (ths->x[2*j]) - (R)(u)) / ths->b[0]);
-      fg_psij2 = K(1.0);
-      psij_const[0] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
-      }
+        INT u, o, l;
+        R fg_psij0, fg_psij1, fg_psij2;
+        R psij_const[2*(2*m+2)];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+
+        uo(ths,j,&u,&o,(INT)0);
+        fg_psij0 = (PHI(ths->n[0], ths->x[2*j] - ((R)u)/(R)(n0),0));
+        fg_psij1 = EXP(K(2.0) * ((R)(n0) * (ths->x[2*j]) - (R)(u)) / ths->b[0]);
+        fg_psij2 = K(1.0);
+        psij_const[0] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
+        }
 
-      uo(ths,j,&u,&o,(INT)1);
-      fg_psij0 = (PHI(ths->n[1], ths->x[2*j+1] - ((R)u) / (R)(n1),1));
-      fg_psij1 = EXP(K(2.0) * ((R)(n1) * (ths->x[2*j+1]) - (R)(u)) / ths->b[1]);
-      fg_psij2 = K(1.0);
-      psij_const[2*m+2] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
-      }
+        uo(ths,j,&u,&o,(INT)1);
+        fg_psij0 = (PHI(ths->n[1], ths->x[2*j+1] - ((R)u) / (R)(n1),1));
+        fg_psij1 = EXP(K(2.0) * ((R)(n1) * (ths->x[2*j+1]) - (R)(u)) / ths->b[1]);
+        fg_psij2 = K(1.0);
+        psij_const[2*m+2] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
+        }
 
 #ifdef _OPENMP
-      nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #else
-      nfft_adjoint_2d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_adjoint_2d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -3737,38 +4648,45 @@ static void nfft_adjoint_2d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u,o,l;
-      INT ip_u;
-      R ip_y, ip_w;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      R psij_const[2*(2*m+2)];
-
-      uo(ths,j,&u,&o,(INT)0);
-      ip_y = FABS((R)(n0) * (ths->x[2*j]) - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for(l=0; l < 2*m+2; l++)
-        psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
-          ths->psi[ABS(ip_u-l*ip_s+1)]*(ip_w);
-
-      uo(ths,j,&u,&o,(INT)1);
-      ip_y = FABS((R)(n1) * (ths->x[2*j+1]) - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for(l=0; l < 2*m+2; l++)
-        psij_const[2*m+2+l] = ths->psi[(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
-          ths->psi[(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT u,o,l;
+        INT ip_u;
+        R ip_y, ip_w;
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        R psij_const[2*(2*m+2)];
+
+        uo(ths,j,&u,&o,(INT)0);
+        ip_y = FABS((R)(n0) * (ths->x[2*j]) - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for(l=0; l < 2*m+2; l++)
+          psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
+            ths->psi[ABS(ip_u-l*ip_s+1)]*(ip_w);
+
+        uo(ths,j,&u,&o,(INT)1);
+        ip_y = FABS((R)(n1) * (ths->x[2*j+1]) - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for(l=0; l < 2*m+2; l++)
+          psij_const[2*m+2+l] = ths->psi[(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
+            ths->psi[(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
 
 #ifdef _OPENMP
-      nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #else
-      nfft_adjoint_2d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+        nfft_adjoint_2d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #endif
-  }
+    }
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
       return;
     } /* if(PRE_LIN_PSI) */
 
@@ -3780,33 +4698,40 @@ static void nfft_adjoint_2d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(shared) private(k)
+  #pragma omp parallel default(shared) private(k)
 #endif
-  for (k = 0; k < M; k++)
   {
-    INT u,o,l;
-    R psij_const[2*(2*m+2)];
-    INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < M; k++)
+    {
+      INT u,o;
+      R psij_const[2*(2*m+2)];
+      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 
-    uo(ths,j,&u,&o,(INT)0);
-    for(l=0;l<=2*m+1;l++)
-      psij_const[l]=(PHI(ths->n[0], ths->x[2*j] - ((R)((u+l))) / (R)(n0),0));
+      uo(ths,j,&u,&o,(INT)0);
+      PHI_ROW(ths->n[0], ths->x[2*j], u, 0, psij_const);
 
-    uo(ths,j,&u,&o,(INT)1);
-    for(l=0;l<=2*m+1;l++)
-      psij_const[2*m+2+l]=(PHI(ths->n[1], ths->x[2*j+1] - ((R)((u+l))) / (R)(n1),1));
+      uo(ths,j,&u,&o,(INT)1);
+      PHI_ROW(ths->n[1], ths->x[2*j+1], u, 1, psij_const+2*m+2);
 
 #ifdef _OPENMP
-    nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      nfft_adjoint_2d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #else
-    nfft_adjoint_2d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
+      nfft_adjoint_2d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, ths->x+2*j, ths->x+2*j+1, n0, n1, m);
 #endif
+    }
+    STATS_THREAD_END(NFFT_STATS_B)
   }
 }
 
 
 void X(trafo_2d)(X(plan) *ths)
 {
+  update_nodes(ths);
+
   if((ths->N[0] <= ths->m) || (ths->N[1] <= ths->m) || (ths->n[0] <= 2*ths->m+2) || (ths->n[1] <= 2*ths->m+2))
   {
     X(trafo_direct)(ths);
@@ -3830,11 +4755,16 @@ void X(trafo_2d)(X(plan) *ths)
   f_hat=(C*)ths->f_hat;
   g_hat=(C*)ths->g_hat;
 
-  TIC(0)
+  TIC(NFFT_STATS_D)
 #ifdef _OPENMP
-  #pragma omp parallel for default(shared) private(k0)
-  for (k0 = 0; k0 < ths->n_total; k0++)
-    ths->g_hat[k0] = 0.0;
+  #pragma omp parallel default(shared) private(k0)
+  {
+    STATS_THREAD_BEGIN
+    #pragma omp for schedule(static) nowait
+    for (k0 = 0; k0 < ths->n_total; k0++)
+      ths->g_hat[k0] = 0.0;
+    STATS_THREAD_END(NFFT_STATS_D)
+  }
 #else
   memset(ths->g_hat, 0, (size_t)(ths->n_total) * sizeof(C));
 #endif
@@ -3844,69 +4774,85 @@ void X(trafo_2d)(X(plan) *ths)
       c_phi_inv02=&ths->c_phi_inv[0][N0/2];
 
 #ifdef _OPENMP
-      #pragma omp parallel for default(shared) private(k0,k1,ck01,ck02,c_phi_inv11,c_phi_inv12,g_hat11,f_hat11,g_hat21,f_hat21,g_hat12,f_hat12,g_hat22,f_hat22,ck11,ck12)
+      #pragma omp parallel default(shared) private(k0,k1,ck01,ck02,c_phi_inv11,c_phi_inv12,g_hat11,f_hat11,g_hat21,f_hat21,g_hat12,f_hat12,g_hat22,f_hat22,ck11,ck12)
 #endif
-      for(k0=0;k0<N0/2;k0++)
       {
-        ck01=c_phi_inv01[k0];
-        ck02=c_phi_inv02[k0];
-
-        c_phi_inv11=ths->c_phi_inv[1];
-        c_phi_inv12=&ths->c_phi_inv[1][N1/2];
-
-        g_hat11=g_hat + (n0-(N0/2)+k0)*n1+n1-(N1/2);
-        f_hat11=f_hat + k0*N1;
-        g_hat21=g_hat + k0*n1+n1-(N1/2);
-        f_hat21=f_hat + ((N0/2)+k0)*N1;
-        g_hat12=g_hat + (n0-(N0/2)+k0)*n1;
-        f_hat12=f_hat + k0*N1+(N1/2);
-        g_hat22=g_hat + k0*n1;
-        f_hat22=f_hat + ((N0/2)+k0)*N1+(N1/2);
-
-        for(k1=0;k1<N1/2;k1++)
+        STATS_THREAD_BEGIN
+#ifdef _OPENMP
+        #pragma omp for schedule(static) nowait
+#endif
+        for(k0=0;k0<N0/2;k0++)
         {
-          ck11=c_phi_inv11[k1];
-          ck12=c_phi_inv12[k1];
+          ck01=c_phi_inv01[k0];
+          ck02=c_phi_inv02[k0];
+
+          c_phi_inv11=ths->c_phi_inv[1];
+          c_phi_inv12=&ths->c_phi_inv[1][N1/2];
+
+          g_hat11=g_hat + (n0-(N0/2)+k0)*n1+n1-(N1/2);
+          f_hat11=f_hat + k0*N1;
+          g_hat21=g_hat + k0*n1+n1-(N1/2);
+          f_hat21=f_hat + ((N0/2)+k0)*N1;
+          g_hat12=g_hat + (n0-(N0/2)+k0)*n1;
+          f_hat12=f_hat + k0*N1+(N1/2);
+          g_hat22=g_hat + k0*n1;
+          f_hat22=f_hat + ((N0/2)+k0)*N1+(N1/2);
+
+          for(k1=0;k1<N1/2;k1++)
+          {
+            ck11=c_phi_inv11[k1];
+            ck12=c_phi_inv12[k1];
 
-          g_hat11[k1] = f_hat11[k1] * ck01 * ck11;
-          g_hat21[k1] = f_hat21[k1] * ck02 * ck11;
-          g_hat12[k1] = f_hat12[k1] * ck01 * ck12;
-          g_hat22[k1] = f_hat22[k1] * ck02 * ck12;
+            g_hat11[k1] = f_hat11[k1] * ck01 * ck11;
+            g_hat21[k1] = f_hat21[k1] * ck02 * ck11;
+            g_hat12[k1] = f_hat12[k1] * ck01 * ck12;
+            g_hat22[k1] = f_hat22[k1] * ck02 * ck12;
+          }
         }
+        STATS_THREAD_END(NFFT_STATS_D)
       }
     }
   else
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k0,k1,ck01,ck02,ck11,ck12)
+    #pragma omp parallel default(shared) private(k0,k1,ck01,ck02,ck11,ck12)
 #endif
-    for(k0=0;k0<N0/2;k0++)
-      {
-  ck01=K(1.0)/(PHI_HUT(ths->n[0],k0-N0/2,0));
-  ck02=K(1.0)/(PHI_HUT(ths->n[0],k0,0));
-  for(k1=0;k1<N1/2;k1++)
     {
-      ck11=K(1.0)/(PHI_HUT(ths->n[1],k1-N1/2,1));
-      ck12=K(1.0)/(PHI_HUT(ths->n[1],k1,1));
-      g_hat[(n0-N0/2+k0)*n1+n1-N1/2+k1] = f_hat[k0*N1+k1]             * ck01 * ck11;
-      g_hat[k0*n1+n1-N1/2+k1]           = f_hat[(N0/2+k0)*N1+k1]      * ck02 * ck11;
-      g_hat[(n0-N0/2+k0)*n1+k1]         = f_hat[k0*N1+N1/2+k1]        * ck01 * ck12;
-      g_hat[k0*n1+k1]                   = f_hat[(N0/2+k0)*N1+N1/2+k1] * ck02 * ck12;
-    }
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for(k0=0;k0<N0/2;k0++)
+        {
+    ck01=K(1.0)/(PHI_HUT(ths->n[0],k0-N0/2,0));
+    ck02=K(1.0)/(PHI_HUT(ths->n[0],k0,0));
+    for(k1=0;k1<N1/2;k1++)
+      {
+        ck11=K(1.0)/(PHI_HUT(ths->n[1],k1-N1/2,1));
+        ck12=K(1.0)/(PHI_HUT(ths->n[1],k1,1));
+        g_hat[(n0-N0/2+k0)*n1+n1-N1/2+k1] = f_hat[k0*N1+k1]             * ck01 * ck11;
+        g_hat[k0*n1+n1-N1/2+k1]           = f_hat[(N0/2+k0)*N1+k1]      * ck02 * ck11;
+        g_hat[(n0-N0/2+k0)*n1+k1]         = f_hat[k0*N1+N1/2+k1]        * ck01 * ck12;
+        g_hat[k0*n1+k1]                   = f_hat[(N0/2+k0)*N1+N1/2+k1] * ck02 * ck12;
       }
+        }
+      STATS_THREAD_END(NFFT_STATS_D)
+    }
 
-  TOC(0)
+  TOC(NFFT_STATS_D)
 
-  TIC_FFTW(1)
-  FFTW(execute)(ths->my_fftw_plan1);
-  TOC_FFTW(1);
+  TIC_FFTW(NFFT_STATS_FFT)
+  F_A(ths);
+  TOC_FFTW(NFFT_STATS_FFT);
 
-  TIC(2);
+  TIC(NFFT_STATS_B);
   nfft_trafo_2d_B(ths);
-  TOC(2);
+  TOC(NFFT_STATS_B);
 }
 
 void X(adjoint_2d)(X(plan) *ths)
 {
+  update_nodes(ths);
+
   if((ths->N[0] <= ths->m) || (ths->N[1] <= ths->m) || (ths->n[0] <= 2*ths->m+2) || (ths->n[1] <= 2*ths->m+2))
   {
     X(adjoint_direct)(ths);
@@ -3930,71 +4876,85 @@ void X(adjoint_2d)(X(plan) *ths)
   f_hat=(C*)ths->f_hat;
   g_hat=(C*)ths->g_hat;
 
-  TIC(2);
+  TIC(NFFT_STATS_B);
   nfft_adjoint_2d_B(ths);
-  TOC(2);
+  TOC(NFFT_STATS_B);
 
-  TIC_FFTW(1)
-  FFTW(execute)(ths->my_fftw_plan2);
-  TOC_FFTW(1);
+  TIC_FFTW(NFFT_STATS_FFT)
+  F_T(ths);
+  TOC_FFTW(NFFT_STATS_FFT);
 
-  TIC(0)
+  TIC(NFFT_STATS_D)
   if(ths->flags & PRE_PHI_HUT)
     {
       c_phi_inv01=ths->c_phi_inv[0];
       c_phi_inv02=&ths->c_phi_inv[0][N0/2];
 
 #ifdef _OPENMP
-      #pragma omp parallel for default(shared) private(k0,k1,ck01,ck02,c_phi_inv11,c_phi_inv12,g_hat11,f_hat11,g_hat21,f_hat21,g_hat12,f_hat12,g_hat22,f_hat22,ck11,ck12)
+      #pragma omp parallel default(shared) private(k0,k1,ck01,ck02,c_phi_inv11,c_phi_inv12,g_hat11,f_hat11,g_hat21,f_hat21,g_hat12,f_hat12,g_hat22,f_hat22,ck11,ck12)
 #endif
-      for(k0=0;k0<N0/2;k0++)
       {
-        ck01=c_phi_inv01[k0];
-        ck02=c_phi_inv02[k0];
-
-        c_phi_inv11=ths->c_phi_inv[1];
-        c_phi_inv12=&ths->c_phi_inv[1][N1/2];
-
-        g_hat11=g_hat + (n0-(N0/2)+k0)*n1+n1-(N1/2);
-        f_hat11=f_hat + k0*N1;
-        g_hat21=g_hat + k0*n1+n1-(N1/2);
-        f_hat21=f_hat + ((N0/2)+k0)*N1;
-        g_hat12=g_hat + (n0-(N0/2)+k0)*n1;
-        f_hat12=f_hat + k0*N1+(N1/2);
-        g_hat22=g_hat + k0*n1;
-        f_hat22=f_hat + ((N0/2)+k0)*N1+(N1/2);
-
-        for(k1=0;k1<N1/2;k1++)
+        STATS_THREAD_BEGIN
+#ifdef _OPENMP
+        #pragma omp for schedule(static) nowait
+#endif
+        for(k0=0;k0<N0/2;k0++)
         {
-          ck11=c_phi_inv11[k1];
-          ck12=c_phi_inv12[k1];
+          ck01=c_phi_inv01[k0];
+          ck02=c_phi_inv02[k0];
+
+          c_phi_inv11=ths->c_phi_inv[1];
+          c_phi_inv12=&ths->c_phi_inv[1][N1/2];
+
+          g_hat11=g_hat + (n0-(N0/2)+k0)*n1+n1-(N1/2);
+          f_hat11=f_hat + k0*N1;
+          g_hat21=g_hat + k0*n1+n1-(N1/2);
+          f_hat21=f_hat + ((N0/2)+k0)*N1;
+          g_hat12=g_hat + (n0-(N0/2)+k0)*n1;
+          f_hat12=f_hat + k0*N1+(N1/2);
+          g_hat22=g_hat + k0*n1;
+          f_hat22=f_hat + ((N0/2)+k0)*N1+(N1/2);
+
+          for(k1=0;k1<N1/2;k1++)
+          {
+            ck11=c_phi_inv11[k1];
+            ck12=c_phi_inv12[k1];
 
-          f_hat11[k1] = g_hat11[k1] * ck01 * ck11;
-          f_hat21[k1] = g_hat21[k1] * ck02 * ck11;
-          f_hat12[k1] = g_hat12[k1] * ck01 * ck12;
-          f_hat22[k1] = g_hat22[k1] * ck02 * ck12;
+            f_hat11[k1] = g_hat11[k1] * ck01 * ck11;
+            f_hat21[k1] = g_hat21[k1] * ck02 * ck11;
+            f_hat12[k1] = g_hat12[k1] * ck01 * ck12;
+            f_hat22[k1] = g_hat22[k1] * ck02 * ck12;
+          }
         }
+        STATS_THREAD_END(NFFT_STATS_D)
       }
     }
   else
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k0,k1,ck01,ck02,ck11,ck12)
+    #pragma omp parallel default(shared) private(k0,k1,ck01,ck02,ck11,ck12)
 #endif
-    for(k0=0;k0<N0/2;k0++)
-      {
-  ck01=K(1.0)/(PHI_HUT(ths->n[0],k0-N0/2,0));
-  ck02=K(1.0)/(PHI_HUT(ths->n[0],k0,0));
-  for(k1=0;k1<N1/2;k1++)
     {
-      ck11=K(1.0)/(PHI_HUT(ths->n[1],k1-N1/2,1));
-      ck12=K(1.0)/(PHI_HUT(ths->n[1],k1,1));
-      f_hat[k0*N1+k1]             = g_hat[(n0-N0/2+k0)*n1+n1-N1/2+k1] * ck01 * ck11;
-      f_hat[(N0/2+k0)*N1+k1]      = g_hat[k0*n1+n1-N1/2+k1]           * ck02 * ck11;
-      f_hat[k0*N1+N1/2+k1]        = g_hat[(n0-N0/2+k0)*n1+k1]         * ck01 * ck12;
-      f_hat[(N0/2+k0)*N1+N1/2+k1] = g_hat[k0*n1+k1]                   * ck02 * ck12;
-    }
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for(k0=0;k0<N0/2;k0++)
+        {
+    ck01=K(1.0)/(PHI_HUT(ths->n[0],k0-N0/2,0));
+    ck02=K(1.0)/(PHI_HUT(ths->n[0],k0,0));
+    for(k1=0;k1<N1/2;k1++)
+      {
+        ck11=K(1.0)/(PHI_HUT(ths->n[1],k1-N1/2,1));
+        ck12=K(1.0)/(PHI_HUT(ths->n[1],k1,1));
+        f_hat[k0*N1+k1]             = g_hat[(n0-N0/2+k0)*n1+n1-N1/2+k1] * ck01 * ck11;
+        f_hat[(N0/2+k0)*N1+k1]      = g_hat[k0*n1+n1-N1/2+k1]           * ck02 * ck11;
+        f_hat[k0*N1+N1/2+k1]        = g_hat[(n0-N0/2+k0)*n1+k1]         * ck01 * ck12;
+        f_hat[(N0/2+k0)*N1+N1/2+k1] = g_hat[k0*n1+k1]                   * ck02 * ck12;
       }
-  TOC(0)
+        }
+      STATS_THREAD_END(NFFT_STATS_D)
+    }
+  TOC(NFFT_STATS_D)
 }
 
 /* ################################################ SPECIFIC VERSIONS FOR d=3 */
@@ -4021,7 +4981,7 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
     const R *psij_const1, const R *psij_const2, const R *xj0, const R *xj1,
     const R *xj2, const INT n0, const INT n1, const INT n2, const INT m)
 {
-  INT u0, o0, l0, u1, o1, l1, u2, o2, l2;
+  INT u0, o0, l0, u1, o1, l1, u2, o2;
   const C *gj;
   const R *psij0, *psij1, *psij2;
 
@@ -4033,6 +4993,13 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
   uo2(&u1, &o1, *xj1, n1, m);
   uo2(&u2, &o2, *xj2, n2, m);
 
+  if (u0 < o0 && u1 < o1 && u2 < o2 && NFFT_B_FIXED(m))
+  {
+    nfft_trafo_3d_compute_fixed(fj, g, psij0, psij1, psij2, u0, u1, u2, n1, n2,
+      m);
+    return;
+  }
+
   *fj = 0;
 
   if (u0 < o0)
@@ -4045,8 +5012,8 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
       else
@@ -4058,11 +5025,11 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
         }
     else /* asserts (u1>o1)*/
@@ -4074,15 +5041,15 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
       else/* asserts (u2>o2) */
@@ -4094,21 +5061,21 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + l1) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
         }
       }
@@ -4123,8 +5090,8 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
 
@@ -4135,8 +5102,8 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
       } else/* asserts (u2>o2) */
@@ -4148,11 +5115,11 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
         }
 
@@ -4163,11 +5130,11 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
         }
       }
@@ -4181,15 +5148,15 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
         for (l0 = 0; l0 <= o0; l0++, psij0++)
@@ -4199,15 +5166,15 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
       } else/* asserts (u2>o2) */
@@ -4219,21 +5186,21 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + l1) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
         }
 
@@ -4244,21 +5211,21 @@ static void nfft_trafo_3d_compute(C *fj, const C *g, const R *psij_const0,
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + (l0 * n1 + l1) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*fj) += (*psij0) * (*psij1) * (*psij2++) * (*gj++);
+            (*fj) += (*psij0) * (*psij1) * nfft_sum_wx(psij2, gj, o2+1);
+            psij2 += o2+1;
           }
         }
       }
@@ -4292,10 +5259,9 @@ static void nfft_adjoint_3d_compute_omp_blockwise(const C f, C *g,
     const INT n0, const INT n1, const INT n2, const INT m,
     const INT my_u0, const INT my_o0)
 {
-  INT ar_u0,ar_o0,l0,u1,o1,l1,u2,o2,l2;
+  INT ar_u0,ar_o0,l0,u1,o1,l1,u2,o2;
 
   INT index_temp1[2*m+2];
-  INT index_temp2[2*m+2];
 
   uo2(&ar_u0,&ar_o0,*xj0, n0, m);
   uo2(&u1,&o1,*xj1, n1, m);
@@ -4304,9 +5270,6 @@ static void nfft_adjoint_3d_compute_omp_blockwise(const C f, C *g,
   for (l1=0; l1<=2*m+1; l1++)
     index_temp1[l1] = (u1+l1)%n1;
 
-  for (l2=0; l2<=2*m+1; l2++)
-    index_temp2[l2] = (u2+l2)%n2;
-
   if(ar_u0<ar_o0)
   {
     INT u0 = MAX(my_u0,ar_u0);
@@ -4328,8 +5291,7 @@ static void nfft_adjoint_3d_compute_omp_blockwise(const C f, C *g,
         const INT i1 = (i0 + index_temp1[l1]) * n2;
         const C val1 = psij_const1[l1];
 
-        for(l2=0; l2<=2*m+1; l2++)
-          g[i1 + index_temp2[l2]] += val0 * val1 * psij_const2[l2] * f;
+        nfft_upd_row(g + i1, val0 * val1 * f, psij_const2, u2, o2, m);
       }
     }
   }
@@ -4354,8 +5316,7 @@ static void nfft_adjoint_3d_compute_omp_blockwise(const C f, C *g,
         const INT i1 = (i0 + index_temp1[l1]) * n2;
         const C val1 = psij_const1[l1];
 
-        for(l2=0; l2<=2*m+1; l2++)
-          g[i1 + index_temp2[l2]] += val0 * val1 * psij_const2[l2] * f;
+        nfft_upd_row(g + i1, val0 * val1 * f, psij_const2, u2, o2, m);
       }
     }
 
@@ -4380,8 +5341,7 @@ static void nfft_adjoint_3d_compute_omp_blockwise(const C f, C *g,
         const INT i1 = (i0 + index_temp1[l1]) * n2;
         const C val1 = psij_const1[l1];
 
-        for(l2=0; l2<=2*m+1; l2++)
-          g[i1 + index_temp2[l2]] += val0 * val1 * psij_const2[l2] * f;
+        nfft_upd_row(g + i1, val0 * val1 * f, psij_const2, u2, o2, m);
       }
     }
   }
@@ -4436,13 +5396,12 @@ static void nfft_adjoint_3d_compute_omp_atomic(const C f, C *g,
 }
 #endif
 
-#ifndef _OPENMP
 static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
     const R *psij_const0, const R *psij_const1, const R *psij_const2, const R *xj0,
     const R *xj1, const R *xj2, const INT n0, const INT n1, const INT n2,
     const INT m)
 {
-  INT u0, o0, l0, u1, o1, l1, u2, o2, l2;
+  INT u0, o0, l0, u1, o1, l1, u2, o2;
   C *gj;
   const R *psij0, *psij1, *psij2;
 
@@ -4454,6 +5413,13 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
   uo2(&u1, &o1, *xj1, n1, m);
   uo2(&u2, &o2, *xj2, n2, m);
 
+  if (u0 < o0 && u1 < o1 && u2 < o2 && NFFT_B_FIXED(m))
+  {
+    nfft_adjoint_3d_compute_fixed(*fj, g, psij0, psij1, psij2, u0, u1, u2, n1,
+      n2, m);
+    return;
+  }
+
   if (u0 < o0)
     if (u1 < o1)
       if (u2 < o2)
@@ -4464,8 +5430,8 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
       else
@@ -4477,11 +5443,11 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
         }
     else /* asserts (u1>o1)*/
@@ -4493,15 +5459,15 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
       else/* asserts (u2>o2) */
@@ -4513,21 +5479,21 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + l1) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
         }
       }
@@ -4542,8 +5508,8 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
 
@@ -4554,8 +5520,8 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
       } else/* asserts (u2>o2) */
@@ -4567,11 +5533,11 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
         }
 
@@ -4582,11 +5548,11 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
         }
       }
@@ -4600,15 +5566,15 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
         for (l0 = 0; l0 <= o0; l0++, psij0++)
@@ -4618,15 +5584,15 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 <= 2 * m + 1; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 2);
+            psij2 += 2 * m + 2;
           }
         }
       } else/* asserts (u2>o2) */
@@ -4638,21 +5604,21 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + ((u0 + l0) * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + ((u0 + l0) * n1 + l1) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
         }
 
@@ -4663,26 +5629,25 @@ static void nfft_adjoint_3d_compute_serial(const C *fj, C *g,
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + (l0 * n1 + (u1 + l1)) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
           for (l1 = 0; l1 <= o1; l1++, psij1++)
           {
             psij2 = psij_const2;
             gj = g + (l0 * n1 + l1) * n2 + u2;
-            for (l2 = 0; l2 < 2 * m + 1 - o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, 2 * m + 1 - o2);
+            psij2 += 2 * m + 1 - o2;
             gj = g + (l0 * n1 + l1) * n2;
-            for (l2 = 0; l2 <= o2; l2++)
-              (*gj++) += (*psij0) * (*psij1) * (*psij2++) * (*fj);
+            nfft_upd_xpaw(gj, (*psij0) * (*psij1) * (*fj), psij2, o2+1);
+            psij2 += o2+1;
           }
         }
       }
 }
-#endif
 
 static void nfft_trafo_3d_B(X(plan) *ths)
 {
@@ -4698,30 +5663,26 @@ static void nfft_trafo_3d_B(X(plan) *ths)
 
   if(ths->flags & PRE_FULL_PSI)
   {
-    const INT lprod = (2*m+2) * (2*m+2) * (2*m+2);
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
-#endif
-    for (k = 0; k < M; k++)
-    {
-      INT l;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      ths->f[j] = K(0.0);
-      for (l = 0; l < lprod; l++)
-        ths->f[j] += ths->psi[j*lprod+l] * g[ths->psi_index_g[j*lprod+l]];
-    }
+    nfft_B_full_psi_A(ths);
     return;
   } /* if(PRE_FULL_PSI) */
 
   if(ths->flags & PRE_PSI)
   {
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      nfft_trafo_3d_compute(ths->f+j, g, ths->psi+j*3*(2*m+2), ths->psi+(j*3+1)*(2*m+2), ths->psi+(j*3+2)*(2*m+2), ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        nfft_trafo_3d_compute(ths->f+j, g, ths->psi+j*3*(2*m+2), ths->psi+(j*3+1)*(2*m+2), ths->psi+(j*3+2)*(2*m+2), ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
     return;
   } /* if(PRE_PSI) */
@@ -4735,45 +5696,52 @@ static void nfft_trafo_3d_B(X(plan) *ths)
     nfft_3d_init_fg_exp_l(fg_exp_l+2*(2*m+2), m, ths->b[2]);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      INT l;
-      R psij_const[3*(2*m+2)];
-      R fg_psij0 = ths->psi[2*j*3];
-      R fg_psij1 = ths->psi[2*j*3+1];
-      R fg_psij2 = K(1.0);
-
-      psij_const[0] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
-      }
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        INT l;
+        R psij_const[3*(2*m+2)];
+        R fg_psij0 = ths->psi[2*j*3];
+        R fg_psij1 = ths->psi[2*j*3+1];
+        R fg_psij2 = K(1.0);
+
+        psij_const[0] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
+        }
 
-      fg_psij0 = ths->psi[2*(j*3+1)];
-      fg_psij1 = ths->psi[2*(j*3+1)+1];
-      fg_psij2 = K(1.0);
-      psij_const[2*m+2] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
-      }
+        fg_psij0 = ths->psi[2*(j*3+1)];
+        fg_psij1 = ths->psi[2*(j*3+1)+1];
+        fg_psij2 = K(1.0);
+        psij_const[2*m+2] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
+        }
 
-      fg_psij0 = ths->psi[2*(j*3+2)];
-      fg_psij1 = ths->psi[2*(j*3+2)+1];
-      fg_psij2 = K(1.0);
-      psij_const[2*(2*m+2)] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*(2*m+2)+l] = fg_psij0*fg_psij2*fg_exp_l[2*(2*m+2)+l];
-      }
+        fg_psij0 = ths->psi[2*(j*3+2)];
+        fg_psij1 = ths->psi[2*(j*3+2)+1];
+        fg_psij2 = K(1.0);
+        psij_const[2*(2*m+2)] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*(2*m+2)+l] = fg_psij0*fg_psij2*fg_exp_l[2*(2*m+2)+l];
+        }
 
-      nfft_trafo_3d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_trafo_3d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -4790,49 +5758,56 @@ static void nfft_trafo_3d_B(X(plan) *ths)
     sort(ths);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      INT u, o, l;
-      R psij_const[3*(2*m+2)];
-      R fg_psij0, fg_psij1, fg_psij2;
-
-      uo(ths,j,&u,&o,(INT)0);
-      fg_psij0 = (PHI(ths->n[0], ths->x[3*j] - ((R)u) / (R)(n0),0));
-      fg_psij1 = EXP(K(2.0) * ((R)(n0) * (ths->x[3*j]) - (R)(u)) / ths->b[0]);
-      fg_psij2 = K(1.0);
-      psij_const[0] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
-      }
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        INT u, o, l;
+        R psij_const[3*(2*m+2)];
+        R fg_psij0, fg_psij1, fg_psij2;
+
+        uo(ths,j,&u,&o,(INT)0);
+        fg_psij0 = (PHI(ths->n[0], ths->x[3*j] - ((R)u) / (R)(n0),0));
+        fg_psij1 = EXP(K(2.0) * ((R)(n0) * (ths->x[3*j]) - (R)(u)) / ths->b[0]);
+        fg_psij2 = K(1.0);
+        psij_const[0] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
+        }
 
-      uo(ths,j,&u,&o,(INT)1);
-      fg_psij0 = (PHI(ths->n[1], ths->x[3*j+1] - ((R)u) / (R)(n1),1));
-      fg_psij1 = EXP(K(2.0) * ((R)(n1) * (ths->x[3*j+1]) - (R)(u)) / ths->b[1]);
-      fg_psij2 = K(1.0);
-      psij_const[2*m+2] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
-      }
+        uo(ths,j,&u,&o,(INT)1);
+        fg_psij0 = (PHI(ths->n[1], ths->x[3*j+1] - ((R)u) / (R)(n1),1));
+        fg_psij1 = EXP(K(2.0) * ((R)(n1) * (ths->x[3*j+1]) - (R)(u)) / ths->b[1]);
+        fg_psij2 = K(1.0);
+        psij_const[2*m+2] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
+        }
 
-      uo(ths,j,&u,&o,(INT)2);
-      fg_psij0 = (PHI(ths->n[2], ths->x[3*j+2] - ((R)u) / (R)(n2),2));
-      fg_psij1 = EXP(K(2.0) * ((R)(n2) * (ths->x[3*j+2]) - (R)(u)) / ths->b[2]);
-      fg_psij2 = K(1.0);
-      psij_const[2*(2*m+2)] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*(2*m+2)+l] = fg_psij0*fg_psij2*fg_exp_l[2*(2*m+2)+l];
-      }
+        uo(ths,j,&u,&o,(INT)2);
+        fg_psij0 = (PHI(ths->n[2], ths->x[3*j+2] - ((R)u) / (R)(n2),2));
+        fg_psij1 = EXP(K(2.0) * ((R)(n2) * (ths->x[3*j+2]) - (R)(u)) / ths->b[2]);
+        fg_psij2 = K(1.0);
+        psij_const[2*(2*m+2)] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*(2*m+2)+l] = fg_psij0*fg_psij2*fg_exp_l[2*(2*m+2)+l];
+        }
 
-      nfft_trafo_3d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_trafo_3d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -4845,71 +5820,82 @@ static void nfft_trafo_3d_B(X(plan) *ths)
     sort(ths);
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
+#endif
+    {
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT u, o, l;
+        R ip_y, ip_w;
+        INT ip_u;
+        R psij_const[3*(2*m+2)];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+
+        uo(ths,j,&u,&o,(INT)0);
+        ip_y = FABS((R)(n0) * ths->x[3*j+0] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for(l=0; l < 2*m+2; l++)
+          psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
+            ths->psi[ABS(ip_u-l*ip_s+1)]*(ip_w);
+
+        uo(ths,j,&u,&o,(INT)1);
+        ip_y = FABS((R)(n1) * ths->x[3*j+1] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for(l=0; l < 2*m+2; l++)
+          psij_const[2*m+2+l] = ths->psi[(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
+            ths->psi[(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
+
+        uo(ths,j,&u,&o,(INT)2);
+        ip_y = FABS((R)(n2) * ths->x[3*j+2] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for(l=0; l < 2*m+2; l++)
+          psij_const[2*(2*m+2)+l] = ths->psi[2*(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
+            ths->psi[2*(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
+
+        nfft_trafo_3d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
+    return;
+  } /* if(PRE_LIN_PSI) */
+
+  /* no precomputed psi at all */
+
+  sort(ths);
+
+#ifdef _OPENMP
+  #pragma omp parallel default(shared) private(k)
+#endif
+  {
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
 #endif
     for (k = 0; k < M; k++)
     {
-      INT u, o, l;
-      R ip_y, ip_w;
-      INT ip_u;
       R psij_const[3*(2*m+2)];
+      INT u, o;
       INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 
       uo(ths,j,&u,&o,(INT)0);
-      ip_y = FABS((R)(n0) * ths->x[3*j+0] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for(l=0; l < 2*m+2; l++)
-        psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
-          ths->psi[ABS(ip_u-l*ip_s+1)]*(ip_w);
+      PHI_ROW(ths->n[0], ths->x[3*j], u, 0, psij_const);
 
       uo(ths,j,&u,&o,(INT)1);
-      ip_y = FABS((R)(n1) * ths->x[3*j+1] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for(l=0; l < 2*m+2; l++)
-        psij_const[2*m+2+l] = ths->psi[(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
-          ths->psi[(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
+      PHI_ROW(ths->n[1], ths->x[3*j+1], u, 1, psij_const+2*m+2);
 
       uo(ths,j,&u,&o,(INT)2);
-      ip_y = FABS((R)(n2) * ths->x[3*j+2] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for(l=0; l < 2*m+2; l++)
-        psij_const[2*(2*m+2)+l] = ths->psi[2*(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
-          ths->psi[2*(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
+      PHI_ROW(ths->n[2], ths->x[3*j+2], u, 2, psij_const+2*(2*m+2));
 
       nfft_trafo_3d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
     }
-    return;
-  } /* if(PRE_LIN_PSI) */
-
-  /* no precomputed psi at all */
-
-  sort(ths);
-
-#ifdef _OPENMP
-  #pragma omp parallel for default(shared) private(k)
-#endif
-  for (k = 0; k < M; k++)
-  {
-    R psij_const[3*(2*m+2)];
-    INT u, o, l;
-    INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-
-    uo(ths,j,&u,&o,(INT)0);
-    for(l=0;l<=2*m+1;l++)
-      psij_const[l]=(PHI(ths->n[0], ths->x[3*j] - ((R)((u+l))) / (R)(n0),0));
-
-    uo(ths,j,&u,&o,(INT)1);
-    for(l=0;l<=2*m+1;l++)
-      psij_const[2*m+2+l]=(PHI(ths->n[1], ths->x[3*j+1] - ((R)((u+l))) / (R)(n1),1));
-
-    uo(ths,j,&u,&o,(INT)2);
-    for(l=0;l<=2*m+1;l++)
-      psij_const[2*(2*m+2)+l]=(PHI(ths->n[2], ths->x[3*j+2] - ((R)((u+l))) / (R)(n2),2));
-
-    nfft_trafo_3d_compute(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+    STATS_THREAD_END(NFFT_STATS_B)
   }
 }
 
@@ -5046,20 +6032,17 @@ static void nfft_trafo_3d_B(X(plan) *ths)
 
 #define MACRO_adjoint_3d_B_OMP_BLOCKWISE_COMPUTE_NO_PSI \
 { \
-            INT u, o, l; \
+            INT u, o; \
             R psij_const[3*(2*m+2)]; \
  \
             uo(ths,j,&u,&o,(INT)0); \
-            for(l=0;l<=2*m+1;l++) \
-              psij_const[l]=(PHI(ths->n[0],ths->x[3*j]-((R)((u+l)))/((R) n0),0)); \
+            PHI_ROW(ths->n[0], ths->x[3*j], u, 0, psij_const); \
  \
             uo(ths,j,&u,&o,(INT)1); \
-            for(l=0;l<=2*m+1;l++) \
-              psij_const[2*m+2+l]=(PHI(ths->n[1],ths->x[3*j+1]-((R)((u+l)))/((R) n1),1)); \
+            PHI_ROW(ths->n[1], ths->x[3*j+1], u, 1, psij_const+2*m+2); \
  \
             uo(ths,j,&u,&o,(INT)2); \
-            for(l=0;l<=2*m+1;l++) \
-              psij_const[2*(2*m+2)+l]=(PHI(ths->n[2],ths->x[3*j+2]-((R)((u+l)))/((R) n2),2)); \
+            PHI_ROW(ths->n[2], ths->x[3*j+2], u, 2, psij_const+2*(2*m+2)); \
  \
             nfft_adjoint_3d_compute_omp_blockwise(ths->f[j], g, \
                 psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, \
@@ -5073,6 +6056,7 @@ static void nfft_trafo_3d_B(X(plan) *ths)
     { \
       _Pragma("omp parallel private(k)") \
       { \
+        STATS_THREAD_BEGIN \
         INT my_u0, my_o0, min_u_a, max_u_a, min_u_b, max_u_b; \
         INT *ar_x = ths->index_x; \
  \
@@ -5118,6 +6102,7 @@ static void nfft_trafo_3d_B(X(plan) *ths)
             k++; \
           } \
         } \
+        STATS_THREAD_END(NFFT_STATS_B) \
       } /* omp parallel */ \
       return; \
     } /* if(NFFT_OMP_BLOCKWISE_ADJOINT) */ \
@@ -5136,10 +6121,14 @@ static void nfft_adjoint_3d_B(X(plan) *ths)
 
   memset(g, 0, (size_t)(ths->n_total) * sizeof(C));
 
+#ifdef _OPENMP
+  if (nfft_adjoint_B_omp_tiled(ths))
+    return;
+#endif
+
   if(ths->flags & PRE_FULL_PSI)
   {
-    nfft_adjoint_B_compute_full_psi(g, ths->psi_index_g, ths->psi, ths->f, M,
-        (INT)3, ths->n, m, ths->flags, ths->index_x);
+    nfft_adjoint_B_compute_full_psi(ths);
     return;
   } /* if(PRE_FULL_PSI) */
 
@@ -5150,16 +6139,23 @@ static void nfft_adjoint_3d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 #ifdef _OPENMP
-      nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, ths->psi+j*3*(2*m+2), ths->psi+(j*3+1)*(2*m+2), ths->psi+(j*3+2)*(2*m+2), ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, ths->psi+j*3*(2*m+2), ths->psi+(j*3+1)*(2*m+2), ths->psi+(j*3+2)*(2*m+2), ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #else
-      nfft_adjoint_3d_compute_serial(ths->f+j, g, ths->psi+j*3*(2*m+2), ths->psi+(j*3+1)*(2*m+2), ths->psi+(j*3+2)*(2*m+2), ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_adjoint_3d_compute_serial(ths->f+j, g, ths->psi+j*3*(2*m+2), ths->psi+(j*3+1)*(2*m+2), ths->psi+(j*3+2)*(2*m+2), ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
     return;
   } /* if(PRE_PSI) */
@@ -5177,49 +6173,56 @@ static void nfft_adjoint_3d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      R psij_const[3*(2*m+2)];
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      INT l;
-      R fg_psij0 = ths->psi[2*j*3];
-      R fg_psij1 = ths->psi[2*j*3+1];
-      R fg_psij2 = K(1.0);
-
-      psij_const[0] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
-      }
+        R psij_const[3*(2*m+2)];
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        INT l;
+        R fg_psij0 = ths->psi[2*j*3];
+        R fg_psij1 = ths->psi[2*j*3+1];
+        R fg_psij2 = K(1.0);
+
+        psij_const[0] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
+        }
 
-      fg_psij0 = ths->psi[2*(j*3+1)];
-      fg_psij1 = ths->psi[2*(j*3+1)+1];
-      fg_psij2 = K(1.0);
-      psij_const[2*m+2] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
-      }
+        fg_psij0 = ths->psi[2*(j*3+1)];
+        fg_psij1 = ths->psi[2*(j*3+1)+1];
+        fg_psij2 = K(1.0);
+        psij_const[2*m+2] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
+        }
 
-      fg_psij0 = ths->psi[2*(j*3+2)];
-      fg_psij1 = ths->psi[2*(j*3+2)+1];
-      fg_psij2 = K(1.0);
-      psij_const[2*(2*m+2)] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*(2*m+2)+l] = fg_psij0*fg_psij2*fg_exp_l[2*(2*m+2)+l];
-      }
+        fg_psij0 = ths->psi[2*(j*3+2)];
+        fg_psij1 = ths->psi[2*(j*3+2)+1];
+        fg_psij2 = K(1.0);
+        psij_const[2*(2*m+2)] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*(2*m+2)+l] = fg_psij0*fg_psij2*fg_exp_l[2*(2*m+2)+l];
+        }
 
 #ifdef _OPENMP
-      nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #else
-      nfft_adjoint_3d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_adjoint_3d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -5240,53 +6243,60 @@ static void nfft_adjoint_3d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u,o,l;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      R psij_const[3*(2*m+2)];
-      R fg_psij0, fg_psij1, fg_psij2;
-
-      uo(ths,j,&u,&o,(INT)0);
-      fg_psij0 = (PHI(ths->n[0], ths->x[3*j] - ((R)u) / (R)(n0),0));
-      fg_psij1 = EXP(K(2.0) * ((R)(n0) * (ths->x[3*j]) - (R)(u))/ths->b[0]);
-      fg_psij2 = K(1.0);
-      psij_const[0] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
       {
-        fg_psij2 *= fg_psij1;
-        psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
-      }
+        INT u,o,l;
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        R psij_const[3*(2*m+2)];
+        R fg_psij0, fg_psij1, fg_psij2;
+
+        uo(ths,j,&u,&o,(INT)0);
+        fg_psij0 = (PHI(ths->n[0], ths->x[3*j] - ((R)u) / (R)(n0),0));
+        fg_psij1 = EXP(K(2.0) * ((R)(n0) * (ths->x[3*j]) - (R)(u))/ths->b[0]);
+        fg_psij2 = K(1.0);
+        psij_const[0] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[l] = fg_psij0*fg_psij2*fg_exp_l[l];
+        }
 
-      uo(ths,j,&u,&o,(INT)1);
-      fg_psij0 = (PHI(ths->n[1], ths->x[3*j+1] - ((R)u) / (R)(n1),1));
-      fg_psij1 = EXP(K(2.0) * ((R)(n1) * (ths->x[3*j+1]) - (R)(u))/ths->b[1]);
-      fg_psij2 = K(1.0);
-      psij_const[2*m+2] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
-      }
+        uo(ths,j,&u,&o,(INT)1);
+        fg_psij0 = (PHI(ths->n[1], ths->x[3*j+1] - ((R)u) / (R)(n1),1));
+        fg_psij1 = EXP(K(2.0) * ((R)(n1) * (ths->x[3*j+1]) - (R)(u))/ths->b[1]);
+        fg_psij2 = K(1.0);
+        psij_const[2*m+2] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*m+2+l] = fg_psij0*fg_psij2*fg_exp_l[2*m+2+l];
+        }
 
-      uo(ths,j,&u,&o,(INT)2);
-      fg_psij0 = (PHI(ths->n[2], ths->x[3*j+2] - ((R)u) / (R)(n2),2));
-      fg_psij1 = EXP(K(2.0) * ((R)(n2) * (ths->x[3*j+2]) - (R)(u))/ths->b[2]);
-      fg_psij2 = K(1.0);
-      psij_const[2*(2*m+2)] = fg_psij0;
-      for(l=1; l<=2*m+1; l++)
-      {
-        fg_psij2 *= fg_psij1;
-        psij_const[2*(2*m+2)+l] = fg_psij0*fg_psij2*fg_exp_l[2*(2*m+2)+l];
-      }
+        uo(ths,j,&u,&o,(INT)2);
+        fg_psij0 = (PHI(ths->n[2], ths->x[3*j+2] - ((R)u) / (R)(n2),2));
+        fg_psij1 = EXP(K(2.0) * ((R)(n2) * (ths->x[3*j+2]) - (R)(u))/ths->b[2]);
+        fg_psij2 = K(1.0);
+        psij_const[2*(2*m+2)] = fg_psij0;
+        for(l=1; l<=2*m+1; l++)
+        {
+          fg_psij2 *= fg_psij1;
+          psij_const[2*(2*m+2)+l] = fg_psij0*fg_psij2*fg_exp_l[2*(2*m+2)+l];
+        }
 
 #ifdef _OPENMP
-      nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #else
-      nfft_adjoint_3d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_adjoint_3d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
 
     return;
@@ -5304,45 +6314,52 @@ static void nfft_adjoint_3d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k)
+    #pragma omp parallel default(shared) private(k)
 #endif
-    for (k = 0; k < M; k++)
     {
-      INT u,o,l;
-      INT ip_u;
-      R ip_y, ip_w;
-      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
-      R psij_const[3*(2*m+2)];
-
-      uo(ths,j,&u,&o,(INT)0);
-      ip_y = FABS((R)(n0) * ths->x[3*j+0] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for(l=0; l < 2*m+2; l++)
-        psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
-          ths->psi[ABS(ip_u-l*ip_s+1)]*(ip_w);
-
-      uo(ths,j,&u,&o,(INT)1);
-      ip_y = FABS((R)(n1) * ths->x[3*j+1] - (R)(u)) * ((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for(l=0; l < 2*m+2; l++)
-        psij_const[2*m+2+l] = ths->psi[(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
-          ths->psi[(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
-
-      uo(ths,j,&u,&o,(INT)2);
-      ip_y = FABS((R)(n2) * ths->x[3*j+2] - (R)(u))*((R)ip_s);
-      ip_u = (INT)(LRINT(FLOOR(ip_y)));
-      ip_w = ip_y - (R)(ip_u);
-      for(l=0; l < 2*m+2; l++)
-        psij_const[2*(2*m+2)+l] = ths->psi[2*(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
-          ths->psi[2*(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < M; k++)
+      {
+        INT u,o,l;
+        INT ip_u;
+        R ip_y, ip_w;
+        INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+        R psij_const[3*(2*m+2)];
+
+        uo(ths,j,&u,&o,(INT)0);
+        ip_y = FABS((R)(n0) * ths->x[3*j+0] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for(l=0; l < 2*m+2; l++)
+          psij_const[l] = ths->psi[ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
+            ths->psi[ABS(ip_u-l*ip_s+1)]*(ip_w);
+
+        uo(ths,j,&u,&o,(INT)1);
+        ip_y = FABS((R)(n1) * ths->x[3*j+1] - (R)(u)) * ((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for(l=0; l < 2*m+2; l++)
+          psij_const[2*m+2+l] = ths->psi[(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
+            ths->psi[(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
+
+        uo(ths,j,&u,&o,(INT)2);
+        ip_y = FABS((R)(n2) * ths->x[3*j+2] - (R)(u))*((R)ip_s);
+        ip_u = (INT)(LRINT(FLOOR(ip_y)));
+        ip_w = ip_y - (R)(ip_u);
+        for(l=0; l < 2*m+2; l++)
+          psij_const[2*(2*m+2)+l] = ths->psi[2*(K+1)+ABS(ip_u-l*ip_s)]*(K(1.0)-ip_w) +
+            ths->psi[2*(K+1)+ABS(ip_u-l*ip_s+1)]*(ip_w);
 
 #ifdef _OPENMP
-      nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #else
-      nfft_adjoint_3d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+        nfft_adjoint_3d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #endif
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
     }
     return;
   } /* if(PRE_LIN_PSI) */
@@ -5355,37 +6372,43 @@ static void nfft_adjoint_3d_B(X(plan) *ths)
 #endif
 
 #ifdef _OPENMP
-  #pragma omp parallel for default(shared) private(k)
+  #pragma omp parallel default(shared) private(k)
 #endif
-  for (k = 0; k < M; k++)
   {
-    INT u,o,l;
-    R psij_const[3*(2*m+2)];
-    INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < M; k++)
+    {
+      INT u,o;
+      R psij_const[3*(2*m+2)];
+      INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
 
-    uo(ths,j,&u,&o,(INT)0);
-    for(l=0;l<=2*m+1;l++)
-      psij_const[l]=(PHI(ths->n[0], ths->x[3*j] - ((R)((u+l))) / (R)(n0),0));
+      uo(ths,j,&u,&o,(INT)0);
+      PHI_ROW(ths->n[0], ths->x[3*j], u, 0, psij_const);
 
-    uo(ths,j,&u,&o,(INT)1);
-    for(l=0;l<=2*m+1;l++)
-      psij_const[2*m+2+l]=(PHI(ths->n[1], ths->x[3*j+1] - ((R)((u+l))) / (R)(n1),1));
+      uo(ths,j,&u,&o,(INT)1);
+      PHI_ROW(ths->n[1], ths->x[3*j+1], u, 1, psij_const+2*m+2);
 
-    uo(ths,j,&u,&o,(INT)2);
-    for(l=0;l<=2*m+1;l++)
-      psij_const[2*(2*m+2)+l]=(PHI(ths->n[2], ths->x[3*j+2] - ((R)((u+l))) / (R)(n2),2));
+      uo(ths,j,&u,&o,(INT)2);
+      PHI_ROW(ths->n[2], ths->x[3*j+2], u, 2, psij_const+2*(2*m+2));
 
 #ifdef _OPENMP
-    nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+      nfft_adjoint_3d_compute_omp_atomic(ths->f[j], g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #else
-    nfft_adjoint_3d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
+      nfft_adjoint_3d_compute_serial(ths->f+j, g, psij_const, psij_const+2*m+2, psij_const+(2*m+2)*2, ths->x+3*j, ths->x+3*j+1, ths->x+3*j+2, n0, n1, n2, m);
 #endif
+    }
+    STATS_THREAD_END(NFFT_STATS_B)
   }
 }
 
 
 void X(trafo_3d)(X(plan) *ths)
 {
+  update_nodes(ths);
+
   if((ths->N[0] <= ths->m) || (ths->N[1] <= ths->m) || (ths->N[2] <= ths->m) || (ths->n[0] <= 2*ths->m+2) || (ths->n[1] <= 2*ths->m+2) || (ths->n[2] <= 2*ths->m+2))
   {
     X(trafo_direct)(ths);
@@ -5412,11 +6435,16 @@ void X(trafo_3d)(X(plan) *ths)
   f_hat=(C*)ths->f_hat;
   g_hat=(C*)ths->g_hat;
 
-  TIC(0)
+  TIC(NFFT_STATS_D)
 #ifdef _OPENMP
-  #pragma omp parallel for default(shared) private(k0)
-  for (k0 = 0; k0 < ths->n_total; k0++)
-    ths->g_hat[k0] = 0.0;
+  #pragma omp parallel default(shared) private(k0)
+  {
+    STATS_THREAD_BEGIN
+    #pragma omp for schedule(static) nowait
+    for (k0 = 0; k0 < ths->n_total; k0++)
+      ths->g_hat[k0] = 0.0;
+    STATS_THREAD_END(NFFT_STATS_D)
+  }
 #else
   memset(ths->g_hat, 0, (size_t)(ths->n_total) * sizeof(C));
 #endif
@@ -5427,102 +6455,118 @@ void X(trafo_3d)(X(plan) *ths)
       c_phi_inv02=&ths->c_phi_inv[0][N0/2];
 
 #ifdef _OPENMP
-      #pragma omp parallel for default(shared) private(k0,k1,k2,ck01,ck02,c_phi_inv11,c_phi_inv12,ck11,ck12,c_phi_inv21,c_phi_inv22,g_hat111,f_hat111,g_hat211,f_hat211,g_hat121,f_hat121,g_hat221,f_hat221,g_hat112,f_hat112,g_hat212,f_hat212,g_hat122,f_hat122,g_hat222,f_hat222,ck21,ck22)
+      #pragma omp parallel default(shared) private(k0,k1,k2,ck01,ck02,c_phi_inv11,c_phi_inv12,ck11,ck12,c_phi_inv21,c_phi_inv22,g_hat111,f_hat111,g_hat211,f_hat211,g_hat121,f_hat121,g_hat221,f_hat221,g_hat112,f_hat112,g_hat212,f_hat212,g_hat122,f_hat122,g_hat222,f_hat222,ck21,ck22)
 #endif
-      for(k0=0;k0<N0/2;k0++)
-  {
-    ck01=c_phi_inv01[k0];
-    ck02=c_phi_inv02[k0];
-    c_phi_inv11=ths->c_phi_inv[1];
-    c_phi_inv12=&ths->c_phi_inv[1][N1/2];
-
-    for(k1=0;k1<N1/2;k1++)
       {
-        ck11=c_phi_inv11[k1];
-        ck12=c_phi_inv12[k1];
-        c_phi_inv21=ths->c_phi_inv[2];
-        c_phi_inv22=&ths->c_phi_inv[2][N2/2];
-
-        g_hat111=g_hat + ((n0-(N0/2)+k0)*n1+n1-(N1/2)+k1)*n2+n2-(N2/2);
-        f_hat111=f_hat + (k0*N1+k1)*N2;
-        g_hat211=g_hat + (k0*n1+n1-(N1/2)+k1)*n2+n2-(N2/2);
-        f_hat211=f_hat + (((N0/2)+k0)*N1+k1)*N2;
-        g_hat121=g_hat + ((n0-(N0/2)+k0)*n1+k1)*n2+n2-(N2/2);
-        f_hat121=f_hat + (k0*N1+(N1/2)+k1)*N2;
-        g_hat221=g_hat + (k0*n1+k1)*n2+n2-(N2/2);
-        f_hat221=f_hat + (((N0/2)+k0)*N1+(N1/2)+k1)*N2;
-
-        g_hat112=g_hat + ((n0-(N0/2)+k0)*n1+n1-(N1/2)+k1)*n2;
-        f_hat112=f_hat + (k0*N1+k1)*N2+(N2/2);
-        g_hat212=g_hat + (k0*n1+n1-(N1/2)+k1)*n2;
-        f_hat212=f_hat + (((N0/2)+k0)*N1+k1)*N2+(N2/2);
-        g_hat122=g_hat + ((n0-(N0/2)+k0)*n1+k1)*n2;
-        f_hat122=f_hat + (k0*N1+N1/2+k1)*N2+(N2/2);
-        g_hat222=g_hat + (k0*n1+k1)*n2;
-        f_hat222=f_hat + (((N0/2)+k0)*N1+(N1/2)+k1)*N2+(N2/2);
-
-        for(k2=0;k2<N2/2;k2++)
+        STATS_THREAD_BEGIN
+#ifdef _OPENMP
+        #pragma omp for schedule(static) nowait
+#endif
+        for(k0=0;k0<N0/2;k0++)
     {
-      ck21=c_phi_inv21[k2];
-      ck22=c_phi_inv22[k2];
-
-      g_hat111[k2] = f_hat111[k2] * ck01 * ck11 * ck21;
-      g_hat211[k2] = f_hat211[k2] * ck02 * ck11 * ck21;
-      g_hat121[k2] = f_hat121[k2] * ck01 * ck12 * ck21;
-      g_hat221[k2] = f_hat221[k2] * ck02 * ck12 * ck21;
+      ck01=c_phi_inv01[k0];
+      ck02=c_phi_inv02[k0];
+      c_phi_inv11=ths->c_phi_inv[1];
+      c_phi_inv12=&ths->c_phi_inv[1][N1/2];
 
-      g_hat112[k2] = f_hat112[k2] * ck01 * ck11 * ck22;
-      g_hat212[k2] = f_hat212[k2] * ck02 * ck11 * ck22;
-      g_hat122[k2] = f_hat122[k2] * ck01 * ck12 * ck22;
-      g_hat222[k2] = f_hat222[k2] * ck02 * ck12 * ck22;
+      for(k1=0;k1<N1/2;k1++)
+        {
+          ck11=c_phi_inv11[k1];
+          ck12=c_phi_inv12[k1];
+          c_phi_inv21=ths->c_phi_inv[2];
+          c_phi_inv22=&ths->c_phi_inv[2][N2/2];
+
+          g_hat111=g_hat + ((n0-(N0/2)+k0)*n1+n1-(N1/2)+k1)*n2+n2-(N2/2);
+          f_hat111=f_hat + (k0*N1+k1)*N2;
+          g_hat211=g_hat + (k0*n1+n1-(N1/2)+k1)*n2+n2-(N2/2);
+          f_hat211=f_hat + (((N0/2)+k0)*N1+k1)*N2;
+          g_hat121=g_hat + ((n0-(N0/2)+k0)*n1+k1)*n2+n2-(N2/2);
+          f_hat121=f_hat + (k0*N1+(N1/2)+k1)*N2;
+          g_hat221=g_hat + (k0*n1+k1)*n2+n2-(N2/2);
+          f_hat221=f_hat + (((N0/2)+k0)*N1+(N1/2)+k1)*N2;
+
+          g_hat112=g_hat + ((n0-(N0/2)+k0)*n1+n1-(N1/2)+k1)*n2;
+          f_hat112=f_hat + (k0*N1+k1)*N2+(N2/2);
+          g_hat212=g_hat + (k0*n1+n1-(N1/2)+k1)*n2;
+          f_hat212=f_hat + (((N0/2)+k0)*N1+k1)*N2+(N2/2);
+          g_hat122=g_hat + ((n0-(N0/2)+k0)*n1+k1)*n2;
+          f_hat122=f_hat + (k0*N1+N1/2+k1)*N2+(N2/2);
+          g_hat222=g_hat + (k0*n1+k1)*n2;
+          f_hat222=f_hat + (((N0/2)+k0)*N1+(N1/2)+k1)*N2+(N2/2);
+
+          for(k2=0;k2<N2/2;k2++)
+      {
+        ck21=c_phi_inv21[k2];
+        ck22=c_phi_inv22[k2];
+
+        g_hat111[k2] = f_hat111[k2] * ck01 * ck11 * ck21;
+        g_hat211[k2] = f_hat211[k2] * ck02 * ck11 * ck21;
+        g_hat121[k2] = f_hat121[k2] * ck01 * ck12 * ck21;
+        g_hat221[k2] = f_hat221[k2] * ck02 * ck12 * ck21;
+
+        g_hat112[k2] = f_hat112[k2] * ck01 * ck11 * ck22;
+        g_hat212[k2] = f_hat212[k2] * ck02 * ck11 * ck22;
+        g_hat122[k2] = f_hat122[k2] * ck01 * ck12 * ck22;
+        g_hat222[k2] = f_hat222[k2] * ck02 * ck12 * ck22;
+      }
+        }
     }
+        STATS_THREAD_END(NFFT_STATS_D)
       }
-  }
     }
   else
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k0,k1,k2,ck01,ck02,ck11,ck12,ck21,ck22)
+    #pragma omp parallel default(shared) private(k0,k1,k2,ck01,ck02,ck11,ck12,ck21,ck22)
 #endif
-    for(k0=0;k0<N0/2;k0++)
-      {
-  ck01=K(1.0)/(PHI_HUT(ths->n[0],k0-N0/2,0));
-  ck02=K(1.0)/(PHI_HUT(ths->n[0],k0,0));
-  for(k1=0;k1<N1/2;k1++)
     {
-      ck11=K(1.0)/(PHI_HUT(ths->n[1],k1-N1/2,1));
-      ck12=K(1.0)/(PHI_HUT(ths->n[1],k1,1));
-
-      for(k2=0;k2<N2/2;k2++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for(k0=0;k0<N0/2;k0++)
         {
-    ck21=K(1.0)/(PHI_HUT(ths->n[2],k2-N2/2,2));
-    ck22=K(1.0)/(PHI_HUT(ths->n[2],k2,2));
-
-    g_hat[((n0-N0/2+k0)*n1+n1-N1/2+k1)*n2+n2-N2/2+k2] = f_hat[(k0*N1+k1)*N2+k2]                  * ck01 * ck11 * ck21;
-    g_hat[(k0*n1+n1-N1/2+k1)*n2+n2-N2/2+k2]           = f_hat[((N0/2+k0)*N1+k1)*N2+k2]           * ck02 * ck11 * ck21;
-    g_hat[((n0-N0/2+k0)*n1+k1)*n2+n2-N2/2+k2]         = f_hat[(k0*N1+N1/2+k1)*N2+k2]             * ck01 * ck12 * ck21;
-    g_hat[(k0*n1+k1)*n2+n2-N2/2+k2]                   = f_hat[((N0/2+k0)*N1+N1/2+k1)*N2+k2]      * ck02 * ck12 * ck21;
-
-    g_hat[((n0-N0/2+k0)*n1+n1-N1/2+k1)*n2+k2]         = f_hat[(k0*N1+k1)*N2+N2/2+k2]             * ck01 * ck11 * ck22;
-    g_hat[(k0*n1+n1-N1/2+k1)*n2+k2]                   = f_hat[((N0/2+k0)*N1+k1)*N2+N2/2+k2]      * ck02 * ck11 * ck22;
-    g_hat[((n0-N0/2+k0)*n1+k1)*n2+k2]                 = f_hat[(k0*N1+N1/2+k1)*N2+N2/2+k2]        * ck01 * ck12 * ck22;
-    g_hat[(k0*n1+k1)*n2+k2]                           = f_hat[((N0/2+k0)*N1+N1/2+k1)*N2+N2/2+k2] * ck02 * ck12 * ck22;
+    ck01=K(1.0)/(PHI_HUT(ths->n[0],k0-N0/2,0));
+    ck02=K(1.0)/(PHI_HUT(ths->n[0],k0,0));
+    for(k1=0;k1<N1/2;k1++)
+      {
+        ck11=K(1.0)/(PHI_HUT(ths->n[1],k1-N1/2,1));
+        ck12=K(1.0)/(PHI_HUT(ths->n[1],k1,1));
+
+        for(k2=0;k2<N2/2;k2++)
+          {
+      ck21=K(1.0)/(PHI_HUT(ths->n[2],k2-N2/2,2));
+      ck22=K(1.0)/(PHI_HUT(ths->n[2],k2,2));
+
+      g_hat[((n0-N0/2+k0)*n1+n1-N1/2+k1)*n2+n2-N2/2+k2] = f_hat[(k0*N1+k1)*N2+k2]                  * ck01 * ck11 * ck21;
+      g_hat[(k0*n1+n1-N1/2+k1)*n2+n2-N2/2+k2]           = f_hat[((N0/2+k0)*N1+k1)*N2+k2]           * ck02 * ck11 * ck21;
+      g_hat[((n0-N0/2+k0)*n1+k1)*n2+n2-N2/2+k2]         = f_hat[(k0*N1+N1/2+k1)*N2+k2]             * ck01 * ck12 * ck21;
+      g_hat[(k0*n1+k1)*n2+n2-N2/2+k2]                   = f_hat[((N0/2+k0)*N1+N1/2+k1)*N2+k2]      * ck02 * ck12 * ck21;
+
+      g_hat[((n0-N0/2+k0)*n1+n1-N1/2+k1)*n2+k2]         = f_hat[(k0*N1+k1)*N2+N2/2+k2]             * ck01 * ck11 * ck22;
+      g_hat[(k0*n1+n1-N1/2+k1)*n2+k2]                   = f_hat[((N0/2+k0)*N1+k1)*N2+N2/2+k2]      * ck02 * ck11 * ck22;
+      g_hat[((n0-N0/2+k0)*n1+k1)*n2+k2]                 = f_hat[(k0*N1+N1/2+k1)*N2+N2/2+k2]        * ck01 * ck12 * ck22;
+      g_hat[(k0*n1+k1)*n2+k2]                           = f_hat[((N0/2+k0)*N1+N1/2+k1)*N2+N2/2+k2] * ck02 * ck12 * ck22;
+          }
+      }
         }
+      STATS_THREAD_END(NFFT_STATS_D)
     }
-      }
 
-  TOC(0)
+  TOC(NFFT_STATS_D)
 
-  TIC_FFTW(1)
-  FFTW(execute)(ths->my_fftw_plan1);
-  TOC_FFTW(1);
+  TIC_FFTW(NFFT_STATS_FFT)
+  F_A(ths);
+  TOC_FFTW(NFFT_STATS_FFT);
 
-  TIC(2);
+  TIC(NFFT_STATS_B);
   nfft_trafo_3d_B(ths);
-  TOC(2);
+  TOC(NFFT_STATS_B);
 }
 
 void X(adjoint_3d)(X(plan) *ths)
 {
+  update_nodes(ths);
+
   if((ths->N[0] <= ths->m) || (ths->N[1] <= ths->m) || (ths->N[2] <= ths->m) || (ths->n[0] <= 2*ths->m+2) || (ths->n[1] <= 2*ths->m+2) || (ths->n[2] <= 2*ths->m+2))
   {
     X(adjoint_direct)(ths);
@@ -5549,170 +6593,503 @@ void X(adjoint_3d)(X(plan) *ths)
   f_hat=(C*)ths->f_hat;
   g_hat=(C*)ths->g_hat;
 
-  TIC(2);
+  TIC(NFFT_STATS_B);
   nfft_adjoint_3d_B(ths);
-  TOC(2);
+  TOC(NFFT_STATS_B);
 
-  TIC_FFTW(1)
-  FFTW(execute)(ths->my_fftw_plan2);
-  TOC_FFTW(1);
+  TIC_FFTW(NFFT_STATS_FFT)
+  F_T(ths);
+  TOC_FFTW(NFFT_STATS_FFT);
 
-  TIC(0)
+  TIC(NFFT_STATS_D)
   if(ths->flags & PRE_PHI_HUT)
     {
       c_phi_inv01=ths->c_phi_inv[0];
       c_phi_inv02=&ths->c_phi_inv[0][N0/2];
 
 #ifdef _OPENMP
-      #pragma omp parallel for default(shared) private(k0,k1,k2,ck01,ck02,c_phi_inv11,c_phi_inv12,ck11,ck12,c_phi_inv21,c_phi_inv22,g_hat111,f_hat111,g_hat211,f_hat211,g_hat121,f_hat121,g_hat221,f_hat221,g_hat112,f_hat112,g_hat212,f_hat212,g_hat122,f_hat122,g_hat222,f_hat222,ck21,ck22)
+      #pragma omp parallel default(shared) private(k0,k1,k2,ck01,ck02,c_phi_inv11,c_phi_inv12,ck11,ck12,c_phi_inv21,c_phi_inv22,g_hat111,f_hat111,g_hat211,f_hat211,g_hat121,f_hat121,g_hat221,f_hat221,g_hat112,f_hat112,g_hat212,f_hat212,g_hat122,f_hat122,g_hat222,f_hat222,ck21,ck22)
 #endif
-      for(k0=0;k0<N0/2;k0++)
-  {
-    ck01=c_phi_inv01[k0];
-    ck02=c_phi_inv02[k0];
-    c_phi_inv11=ths->c_phi_inv[1];
-    c_phi_inv12=&ths->c_phi_inv[1][N1/2];
-
-    for(k1=0;k1<N1/2;k1++)
       {
-        ck11=c_phi_inv11[k1];
-        ck12=c_phi_inv12[k1];
-        c_phi_inv21=ths->c_phi_inv[2];
-        c_phi_inv22=&ths->c_phi_inv[2][N2/2];
-
-        g_hat111=g_hat + ((n0-(N0/2)+k0)*n1+n1-(N1/2)+k1)*n2+n2-(N2/2);
-        f_hat111=f_hat + (k0*N1+k1)*N2;
-        g_hat211=g_hat + (k0*n1+n1-(N1/2)+k1)*n2+n2-(N2/2);
-        f_hat211=f_hat + (((N0/2)+k0)*N1+k1)*N2;
-        g_hat121=g_hat + ((n0-(N0/2)+k0)*n1+k1)*n2+n2-(N2/2);
-        f_hat121=f_hat + (k0*N1+(N1/2)+k1)*N2;
-        g_hat221=g_hat + (k0*n1+k1)*n2+n2-(N2/2);
-        f_hat221=f_hat + (((N0/2)+k0)*N1+(N1/2)+k1)*N2;
-
-        g_hat112=g_hat + ((n0-(N0/2)+k0)*n1+n1-(N1/2)+k1)*n2;
-        f_hat112=f_hat + (k0*N1+k1)*N2+(N2/2);
-        g_hat212=g_hat + (k0*n1+n1-(N1/2)+k1)*n2;
-        f_hat212=f_hat + (((N0/2)+k0)*N1+k1)*N2+(N2/2);
-        g_hat122=g_hat + ((n0-(N0/2)+k0)*n1+k1)*n2;
-        f_hat122=f_hat + (k0*N1+(N1/2)+k1)*N2+(N2/2);
-        g_hat222=g_hat + (k0*n1+k1)*n2;
-        f_hat222=f_hat + (((N0/2)+k0)*N1+(N1/2)+k1)*N2+(N2/2);
-
-        for(k2=0;k2<N2/2;k2++)
+        STATS_THREAD_BEGIN
+#ifdef _OPENMP
+        #pragma omp for schedule(static) nowait
+#endif
+        for(k0=0;k0<N0/2;k0++)
     {
-      ck21=c_phi_inv21[k2];
-      ck22=c_phi_inv22[k2];
-
-      f_hat111[k2] = g_hat111[k2] * ck01 * ck11 * ck21;
-      f_hat211[k2] = g_hat211[k2] * ck02 * ck11 * ck21;
-      f_hat121[k2] = g_hat121[k2] * ck01 * ck12 * ck21;
-      f_hat221[k2] = g_hat221[k2] * ck02 * ck12 * ck21;
+      ck01=c_phi_inv01[k0];
+      ck02=c_phi_inv02[k0];
+      c_phi_inv11=ths->c_phi_inv[1];
+      c_phi_inv12=&ths->c_phi_inv[1][N1/2];
 
-      f_hat112[k2] = g_hat112[k2] * ck01 * ck11 * ck22;
-      f_hat212[k2] = g_hat212[k2] * ck02 * ck11 * ck22;
-      f_hat122[k2] = g_hat122[k2] * ck01 * ck12 * ck22;
-      f_hat222[k2] = g_hat222[k2] * ck02 * ck12 * ck22;
+      for(k1=0;k1<N1/2;k1++)
+        {
+          ck11=c_phi_inv11[k1];
+          ck12=c_phi_inv12[k1];
+          c_phi_inv21=ths->c_phi_inv[2];
+          c_phi_inv22=&ths->c_phi_inv[2][N2/2];
+
+          g_hat111=g_hat + ((n0-(N0/2)+k0)*n1+n1-(N1/2)+k1)*n2+n2-(N2/2);
+          f_hat111=f_hat + (k0*N1+k1)*N2;
+          g_hat211=g_hat + (k0*n1+n1-(N1/2)+k1)*n2+n2-(N2/2);
+          f_hat211=f_hat + (((N0/2)+k0)*N1+k1)*N2;
+          g_hat121=g_hat + ((n0-(N0/2)+k0)*n1+k1)*n2+n2-(N2/2);
+          f_hat121=f_hat + (k0*N1+(N1/2)+k1)*N2;
+          g_hat221=g_hat + (k0*n1+k1)*n2+n2-(N2/2);
+          f_hat221=f_hat + (((N0/2)+k0)*N1+(N1/2)+k1)*N2;
+
+          g_hat112=g_hat + ((n0-(N0/2)+k0)*n1+n1-(N1/2)+k1)*n2;
+          f_hat112=f_hat + (k0*N1+k1)*N2+(N2/2);
+          g_hat212=g_hat + (k0*n1+n1-(N1/2)+k1)*n2;
+          f_hat212=f_hat + (((N0/2)+k0)*N1+k1)*N2+(N2/2);
+          g_hat122=g_hat + ((n0-(N0/2)+k0)*n1+k1)*n2;
+          f_hat122=f_hat + (k0*N1+(N1/2)+k1)*N2+(N2/2);
+          g_hat222=g_hat + (k0*n1+k1)*n2;
+          f_hat222=f_hat + (((N0/2)+k0)*N1+(N1/2)+k1)*N2+(N2/2);
+
+          for(k2=0;k2<N2/2;k2++)
+      {
+        ck21=c_phi_inv21[k2];
+        ck22=c_phi_inv22[k2];
+
+        f_hat111[k2] = g_hat111[k2] * ck01 * ck11 * ck21;
+        f_hat211[k2] = g_hat211[k2] * ck02 * ck11 * ck21;
+        f_hat121[k2] = g_hat121[k2] * ck01 * ck12 * ck21;
+        f_hat221[k2] = g_hat221[k2] * ck02 * ck12 * ck21;
+
+        f_hat112[k2] = g_hat112[k2] * ck01 * ck11 * ck22;
+        f_hat212[k2] = g_hat212[k2] * ck02 * ck11 * ck22;
+        f_hat122[k2] = g_hat122[k2] * ck01 * ck12 * ck22;
+        f_hat222[k2] = g_hat222[k2] * ck02 * ck12 * ck22;
+      }
+        }
     }
+        STATS_THREAD_END(NFFT_STATS_D)
       }
-  }
     }
   else
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(k0,k1,k2,ck01,ck02,ck11,ck12,ck21,ck22)
+    #pragma omp parallel default(shared) private(k0,k1,k2,ck01,ck02,ck11,ck12,ck21,ck22)
 #endif
-    for(k0=0;k0<N0/2;k0++)
-      {
-  ck01=K(1.0)/(PHI_HUT(ths->n[0],k0-N0/2,0));
-  ck02=K(1.0)/(PHI_HUT(ths->n[0],k0,0));
-  for(k1=0;k1<N1/2;k1++)
     {
-      ck11=K(1.0)/(PHI_HUT(ths->n[1],k1-N1/2,1));
-      ck12=K(1.0)/(PHI_HUT(ths->n[1],k1,1));
-
-      for(k2=0;k2<N2/2;k2++)
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for(k0=0;k0<N0/2;k0++)
         {
-    ck21=K(1.0)/(PHI_HUT(ths->n[2],k2-N2/2,2));
-    ck22=K(1.0)/(PHI_HUT(ths->n[2],k2,2));
-
-    f_hat[(k0*N1+k1)*N2+k2]                  = g_hat[((n0-N0/2+k0)*n1+n1-N1/2+k1)*n2+n2-N2/2+k2] * ck01 * ck11 * ck21;
-    f_hat[((N0/2+k0)*N1+k1)*N2+k2]           = g_hat[(k0*n1+n1-N1/2+k1)*n2+n2-N2/2+k2]           * ck02 * ck11 * ck21;
-    f_hat[(k0*N1+N1/2+k1)*N2+k2]             = g_hat[((n0-N0/2+k0)*n1+k1)*n2+n2-N2/2+k2]         * ck01 * ck12 * ck21;
-    f_hat[((N0/2+k0)*N1+N1/2+k1)*N2+k2]      = g_hat[(k0*n1+k1)*n2+n2-N2/2+k2]                   * ck02 * ck12 * ck21;
-
-    f_hat[(k0*N1+k1)*N2+N2/2+k2]             = g_hat[((n0-N0/2+k0)*n1+n1-N1/2+k1)*n2+k2]         * ck01 * ck11 * ck22;
-    f_hat[((N0/2+k0)*N1+k1)*N2+N2/2+k2]      = g_hat[(k0*n1+n1-N1/2+k1)*n2+k2]                   * ck02 * ck11 * ck22;
-    f_hat[(k0*N1+N1/2+k1)*N2+N2/2+k2]        = g_hat[((n0-N0/2+k0)*n1+k1)*n2+k2]                 * ck01 * ck12 * ck22;
-    f_hat[((N0/2+k0)*N1+N1/2+k1)*N2+N2/2+k2] = g_hat[(k0*n1+k1)*n2+k2]                           * ck02 * ck12 * ck22;
+    ck01=K(1.0)/(PHI_HUT(ths->n[0],k0-N0/2,0));
+    ck02=K(1.0)/(PHI_HUT(ths->n[0],k0,0));
+    for(k1=0;k1<N1/2;k1++)
+      {
+        ck11=K(1.0)/(PHI_HUT(ths->n[1],k1-N1/2,1));
+        ck12=K(1.0)/(PHI_HUT(ths->n[1],k1,1));
+
+        for(k2=0;k2<N2/2;k2++)
+          {
+      ck21=K(1.0)/(PHI_HUT(ths->n[2],k2-N2/2,2));
+      ck22=K(1.0)/(PHI_HUT(ths->n[2],k2,2));
+
+      f_hat[(k0*N1+k1)*N2+k2]                  = g_hat[((n0-N0/2+k0)*n1+n1-N1/2+k1)*n2+n2-N2/2+k2] * ck01 * ck11 * ck21;
+      f_hat[((N0/2+k0)*N1+k1)*N2+k2]           = g_hat[(k0*n1+n1-N1/2+k1)*n2+n2-N2/2+k2]           * ck02 * ck11 * ck21;
+      f_hat[(k0*N1+N1/2+k1)*N2+k2]             = g_hat[((n0-N0/2+k0)*n1+k1)*n2+n2-N2/2+k2]         * ck01 * ck12 * ck21;
+      f_hat[((N0/2+k0)*N1+N1/2+k1)*N2+k2]      = g_hat[(k0*n1+k1)*n2+n2-N2/2+k2]                   * ck02 * ck12 * ck21;
+
+      f_hat[(k0*N1+k1)*N2+N2/2+k2]             = g_hat[((n0-N0/2+k0)*n1+n1-N1/2+k1)*n2+k2]         * ck01 * ck11 * ck22;
+      f_hat[((N0/2+k0)*N1+k1)*N2+N2/2+k2]      = g_hat[(k0*n1+n1-N1/2+k1)*n2+k2]                   * ck02 * ck11 * ck22;
+      f_hat[(k0*N1+N1/2+k1)*N2+N2/2+k2]        = g_hat[((n0-N0/2+k0)*n1+k1)*n2+k2]                 * ck01 * ck12 * ck22;
+      f_hat[((N0/2+k0)*N1+N1/2+k1)*N2+N2/2+k2] = g_hat[(k0*n1+k1)*n2+k2]                           * ck02 * ck12 * ck22;
+          }
+      }
         }
+      STATS_THREAD_END(NFFT_STATS_D)
     }
-      }
 
-  TOC(0)
+  TOC(NFFT_STATS_D)
 }
 
-/** user routines
+/* ## specialized version for d>=4  ########################################## */
+
+/* The window of a node is the tensor product of its d one-dimensional windows
+ * and is applied row by row: the (2m+2)^(d-1) taps of the first d-1
+ * dimensions are run through by an odometer that keeps the partial products
+ * of the window values and the partial offsets in g per dimension, so that
+ * only the dimensions that changed are recomputed from one row to the next.
+ * The 2m+2 entries of a row in the last dimension are contiguous in g up to
+ * the wrap-around and are handled by the row kernels of the cases d<=3. */
+
+/**
+ * Lower and upper window indices u[t], o[t] of node xj, 0 <= u[t] < n[t], and
+ * the indices idx[t*(2m+2)+l] = (u[t]+l)%n[t] of the first d-1 dimensions.
  */
-void X(trafo)(X(plan) *ths)
+static inline void nfft_nd_uo(const X(plan) *ths, const R *xj, INT *u, INT *o,
+  INT *idx)
 {
-  /* use direct transform if degree N is too low */
-  for (int j = 0; j < ths->d; j++)
-  {
-    if((ths->N[j] <= ths->m) || (ths->n[j] <= 2*ths->m+2))
-    {
-      X(trafo_direct)(ths);
-      return;
-    }
-  }
-  
-  switch(ths->d)
-  {
-    case 1: X(trafo_1d)(ths); break;
-    case 2: X(trafo_2d)(ths); break;
-    case 3: X(trafo_3d)(ths); break;
-    default:
-    {
-      /* use ths->my_fftw_plan1 */
-      ths->g_hat = ths->g1;
-      ths->g = ths->g2;
+  const INT d = ths->d, m = ths->m, m2p2 = 2 * m + 2;
+  INT t, l;
 
-      /** form \f$ \hat g_k = \frac{\hat f_k}{c_k\left(\phi\right)} \text{ for }
-       *  k \in I_N \f$
-       */
-      TIC(0)
-      D_A(ths);
-      TOC(0)
+  for (t = 0; t < d; t++)
+    uo2(&u[t], &o[t], xj[t], ths->n[t], m);
 
-      /** compute by d-variate discrete Fourier transform
-       *  \f$ g_l = \sum_{k \in I_N} \hat g_k {\rm e}^{-2\pi {\rm i} \frac{kl}{n}}
-       *  \text{ for } l \in I_n \f$
-       */
-      TIC_FFTW(1)
-      FFTW(execute)(ths->my_fftw_plan1);
-      TOC_FFTW(1)
+  for (t = 0; t < d - 1; t++)
+    for (l = 0; l < m2p2; l++)
+      idx[t * m2p2 + l] = (u[t] + l) % ths->n[t];
+}
 
-      /** set \f$ f_j =\sum_{l \in I_n,m(x_j)} g_l \psi\left(x_j-\frac{l}{n}\right)
-       *  \text{ for } j=0,\dots,M_total-1 \f$
-       */
-      TIC(2)
-      B_A(ths);
-      TOC(2)
-    }
-  }
-} /* nfft_trafo */
+/**
+ * Runs through the rows of the window of one node whose index in the first
+ * dimension lies in [lo,hi]. For every row, w[d-1] holds the product of the
+ * window values of the first d-1 dimensions and off[d-1] the offset of the
+ * row in g.
+ */
+#define MACRO_nd_B_FOR_EACH_ROW(lo, hi, compute_row) \
+{ \
+  INT l0, t; \
+ \
+  for (l0 = 0; l0 < m2p2; l0++) \
+  { \
+    if (idx[l0] < (lo) || idx[l0] > (hi)) \
+      continue; \
+ \
+    w[1] = psij[l0]; \
+    off[1] = idx[l0] * ths->n[1]; \
+    for (t = 1; t < d - 1; t++) \
+      lj[t] = 0; \
+ \
+    for (t = 1; ; ) \
+    { \
+      for (; t < d - 1; t++) \
+      { \
+        w[t+1] = w[t] * psij[t * m2p2 + lj[t]]; \
+        off[t+1] = (off[t] + idx[t * m2p2 + lj[t]]) * ths->n[t+1]; \
+      } \
+ \
+      compute_row; \
+ \
+      for (t = d - 2; t > 0; t--) \
+      { \
+        if (++lj[t] < m2p2) \
+          break; \
+        lj[t] = 0; \
+      } \
+      if (t == 0) \
+        break; \
+    } \
+  } \
+}
 
-void X(adjoint)(X(plan) *ths)
+#define MACRO_nd_B_init \
+  const INT d = ths->d, m = ths->m, m2p2 = 2 * m + 2; \
+  const R *psij_last = psij + (d - 1) * m2p2; \
+  INT u[d], o[d], idx[(d - 1) * m2p2], lj[d], off[d]; \
+  R w[d]; \
+ \
+  nfft_nd_uo(ths, xj, u, o, idx);
+
+static void nfft_trafo_nd_compute(const X(plan) *ths, C *fj, const C *g,
+  const R *psij, const R *xj)
 {
-  /* use direct transform if degree N is too low */
-  for (int j = 0; j < ths->d; j++)
+  MACRO_nd_B_init
+  C s = K(0.0);
+
+  MACRO_nd_B_FOR_EACH_ROW(0, ths->n[0] - 1,
+    s += w[d-1] * nfft_sum_row(g + off[d-1], psij_last, u[d-1], o[d-1], m))
+
+  *fj = s;
+}
+
+static void nfft_adjoint_nd_compute(const X(plan) *ths, const C f, C *g,
+  const R *psij, const R *xj)
+{
+  MACRO_nd_B_init
+
+  MACRO_nd_B_FOR_EACH_ROW(0, ths->n[0] - 1,
+    nfft_upd_row(g + off[d-1], w[d-1] * f, psij_last, u[d-1], o[d-1], m))
+}
+
+#ifdef _OPENMP
+/** Adds a psij[l] to row[(u+l)%n] by OpenMP atomic operations. */
+static inline void nfft_upd_row_omp_atomic(C *row, const C a, const R *psij,
+  const INT u, const INT n, const INT m)
+{
+  INT l;
+
+  for (l = 0; l <= 2*m+1; l++)
   {
-    if((ths->N[j] <= ths->m) || (ths->n[j] <= 2*ths->m+2))
-    {
-      X(adjoint_direct)(ths);
-      return;
-    }
+    const INT i = u + l < n ? u + l : u + l - n;
+    R *lhs_real = (R*)(row + i);
+    C val = psij[l] * a;
+
+    #pragma omp atomic
+    lhs_real[0] += CREAL(val);
+
+    #pragma omp atomic
+    lhs_real[1] += CIMAG(val);
   }
-  
-  switch(ths->d)
+}
+
+/* adjoint NFFT for d>=4 with OpenMP atomic operations */
+static void nfft_adjoint_nd_compute_omp_atomic(const X(plan) *ths, const C f,
+  C *g, const R *psij, const R *xj)
+{
+  MACRO_nd_B_init
+
+  MACRO_nd_B_FOR_EACH_ROW(0, ths->n[0] - 1,
+    nfft_upd_row_omp_atomic(g + off[d-1], w[d-1] * f, psij_last, u[d-1],
+      ths->n[d-1], m))
+}
+
+/**
+ * Adjoint NFFT for d>=4 updating only the part my_u0 <= l_0 <= my_o0 of g
+ * that the current thread owns, see nfft_adjoint_B_omp_blockwise_init.
+ */
+static void nfft_adjoint_nd_compute_omp_blockwise(const X(plan) *ths,
+  const C f, C *g, const R *psij, const R *xj, const INT my_u0,
+  const INT my_o0)
+{
+  MACRO_nd_B_init
+
+  MACRO_nd_B_FOR_EACH_ROW(my_u0, my_o0,
+    nfft_upd_row(g + off[d-1], w[d-1] * f, psij_last, u[d-1], o[d-1], m))
+}
+
+/** Blockwise adjoint for the nodes whose sort key lies in [min_u,max_u]. */
+static void nfft_adjoint_nd_B_omp_blockwise_range(X(plan) *ths,
+  const INT min_u, const INT max_u, const INT my_u0, const INT my_o0, R *buf)
+{
+  const INT *ar_x = ths->index_x;
+  INT k;
+
+  for (k = index_x_binary_search(ar_x, ths->M_total, min_u);
+    k < ths->M_total; k++)
+  {
+    const INT u_prod = ar_x[2*k];
+    const INT j = ar_x[2*k+1];
+
+    if (u_prod < min_u || u_prod > max_u)
+      break;
+
+    nfft_adjoint_nd_compute_omp_blockwise(ths, ths->f[j], ths->g,
+      nfft_psij(ths, j, buf), ths->x + j * ths->d, my_u0, my_o0);
+  }
+}
+#endif
+
+/**
+ * B step of the trafo for d>=4 and the flags PRE_PSI or none, all other
+ * precomputation flags are left to the generic B_A.
+ */
+static void nfft_trafo_nd_B(X(plan) *ths)
+{
+  const INT d = ths->d, M = ths->M_total, m2p2 = 2 * ths->m + 2;
+  const C *g = (const C*) ths->g;
+  INT k;
+
+  if (ths->flags & (PRE_FULL_PSI | PRE_LIN_PSI | PRE_FG_PSI | FG_PSI))
+  {
+    B_A(ths);
+    return;
+  }
+
+  sort(ths);
+
+#ifdef _OPENMP
+  #pragma omp parallel default(shared) private(k)
+#endif
+  {
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < M; k++)
+    {
+      const INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      R buf[d * m2p2];
+
+      nfft_trafo_nd_compute(ths, ths->f + j, g, nfft_psij(ths, j, buf),
+        ths->x + j * d);
+    }
+    STATS_THREAD_END(NFFT_STATS_B)
+  }
+}
+
+/**
+ * B step of the adjoint for d>=4, see nfft_trafo_nd_B. With OpenMP, g is
+ * updated by NFFT_OMP_TILED_ADJOINT, NFFT_OMP_BLOCKWISE_ADJOINT or atomic
+ * operations.
+ */
+static void nfft_adjoint_nd_B(X(plan) *ths)
+{
+  const INT d = ths->d, M = ths->M_total, m2p2 = 2 * ths->m + 2;
+  C *g = (C*) ths->g;
+  INT k;
+
+  if (ths->flags & (PRE_FULL_PSI | PRE_LIN_PSI | PRE_FG_PSI | FG_PSI))
+  {
+    B_T(ths);
+    return;
+  }
+
+  memset(g, 0, (size_t)(ths->n_total) * sizeof(C));
+
+#ifdef _OPENMP
+  if (nfft_adjoint_B_omp_tiled(ths))
+    return;
+#endif
+
+  sort(ths);
+
+#ifdef _OPENMP
+  if (ths->flags & NFFT_OMP_BLOCKWISE_ADJOINT)
+  {
+    #pragma omp parallel
+    {
+      STATS_THREAD_BEGIN
+      INT my_u0, my_o0, min_u_a, max_u_a, min_u_b, max_u_b;
+      R buf[d * m2p2];
+
+      nfft_adjoint_B_omp_blockwise_init(&my_u0, &my_o0, &min_u_a, &max_u_a,
+          &min_u_b, &max_u_b, d, ths->n, ths->m);
+
+      if (min_u_a != -1)
+        nfft_adjoint_nd_B_omp_blockwise_range(ths, min_u_a, max_u_a, my_u0,
+          my_o0, buf);
+
+      if (min_u_b != -1)
+        nfft_adjoint_nd_B_omp_blockwise_range(ths, min_u_b, max_u_b, my_u0,
+          my_o0, buf);
+      STATS_THREAD_END(NFFT_STATS_B)
+    } /* omp parallel */
+    return;
+  } /* if(NFFT_OMP_BLOCKWISE_ADJOINT) */
+
+  #pragma omp parallel default(shared) private(k)
+#endif
+  {
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < M; k++)
+    {
+      const INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      R buf[d * m2p2];
+      const R *psij = nfft_psij(ths, j, buf);
+
+#ifdef _OPENMP
+      nfft_adjoint_nd_compute_omp_atomic(ths, ths->f[j], g, psij, ths->x + j * d);
+#else
+      nfft_adjoint_nd_compute(ths, ths->f[j], g, psij, ths->x + j * d);
+#endif
+    }
+    STATS_THREAD_END(NFFT_STATS_B)
+  }
+}
+
+/** Counts the nodes of a transform and estimates the bytes it touches: the
+ * node, its coefficient and window values, the coefficients \f$\hat f\f$
+ * and the oversampled vectors g_hat and g. */
+static void stats_count(X(plan) *ths, const int direct)
+{
+  const double lprod = (double)plan_lprod(ths);
+  double per_node = (double)(sizeof(C) + (size_t)ths->d * sizeof(R));
+
+  if (!ths->stats.enabled)
+    return;
+
+  ths->stats.nodes += (double)ths->M_total;
+
+  if (direct)
+  {
+    /* every node meets every coefficient */
+    ths->stats.bytes += (double)ths->M_total * per_node
+      + (double)ths->M_total * (double)ths->N_total * (double)sizeof(C);
+    return;
+  }
+
+  if (ths->flags & PRE_FULL_PSI)
+    per_node += lprod * (double)(sizeof(R) + sizeof(INT));
+  else if (ths->flags & PRE_PSI)
+    per_node += (double)(ths->d * (2 * ths->m + 2)) * (double)sizeof(R);
+  per_node += lprod * (double)sizeof(C);
+
+  ths->stats.bytes += (double)ths->M_total * per_node
+    + 2.0 * (double)(ths->N_total + ths->n_total) * (double)sizeof(C);
+}
+
+/** user routines
+ */
+void X(trafo)(X(plan) *ths)
+{
+  int direct = 0;
+
+  update_nodes(ths);
+
+  /* use direct transform if degree N is too low */
+  for (int j = 0; j < ths->d; j++)
+  {
+    if((ths->N[j] <= ths->m) || (ths->n[j] <= 2*ths->m+2))
+      direct = 1;
+  }
+
+  TIC(NFFT_STATS_TRAFO)
+  if (direct)
+    X(trafo_direct)(ths);
+  else switch(ths->d)
+  {
+    case 1: X(trafo_1d)(ths); break;
+    case 2: X(trafo_2d)(ths); break;
+    case 3: X(trafo_3d)(ths); break;
+    default:
+    {
+      /* use ths->my_fftw_plan1 */
+      ths->g_hat = ths->g1;
+      ths->g = ths->g2;
+
+      /** form \f$ \hat g_k = \frac{\hat f_k}{c_k\left(\phi\right)} \text{ for }
+       *  k \in I_N \f$
+       */
+      TIC(NFFT_STATS_D)
+      D_A(ths);
+      TOC(NFFT_STATS_D)
+
+      /** compute by d-variate discrete Fourier transform
+       *  \f$ g_l = \sum_{k \in I_N} \hat g_k {\rm e}^{-2\pi {\rm i} \frac{kl}{n}}
+       *  \text{ for } l \in I_n \f$
+       */
+      TIC_FFTW(NFFT_STATS_FFT)
+      F_A(ths);
+      TOC_FFTW(NFFT_STATS_FFT)
+
+      /** set \f$ f_j =\sum_{l \in I_n,m(x_j)} g_l \psi\left(x_j-\frac{l}{n}\right)
+       *  \text{ for } j=0,\dots,M_total-1 \f$
+       */
+      TIC(NFFT_STATS_B)
+      nfft_trafo_nd_B(ths);
+      TOC(NFFT_STATS_B)
+    }
+  }
+  stats_count(ths, direct);
+  TOC(NFFT_STATS_TRAFO)
+} /* nfft_trafo */
+
+void X(adjoint)(X(plan) *ths)
+{
+  int direct = 0;
+
+  update_nodes(ths);
+
+  /* use direct transform if degree N is too low */
+  for (int j = 0; j < ths->d; j++)
+  {
+    if((ths->N[j] <= ths->m) || (ths->n[j] <= 2*ths->m+2))
+      direct = 1;
+  }
+
+  TIC(NFFT_STATS_TRAFO)
+  if (direct)
+    X(adjoint_direct)(ths);
+  else switch(ths->d)
   {
     case 1: X(adjoint_1d)(ths); break;
     case 2: X(adjoint_2d)(ths); break;
@@ -5726,545 +7103,2890 @@ void X(adjoint)(X(plan) *ths)
       /** set \f$ g_l = \sum_{j=0}^{M_total-1} f_j \psi\left(x_j-\frac{l}{n}\right)
        *  \text{ for } l \in I_n,m(x_j) \f$
        */
-      TIC(2)
-      B_T(ths);
-      TOC(2)
+      TIC(NFFT_STATS_B)
+      nfft_adjoint_nd_B(ths);
+      TOC(NFFT_STATS_B)
 
       /** compute by d-variate discrete Fourier transform
        *  \f$ \hat g_k = \sum_{l \in I_n} g_l {\rm e}^{+2\pi {\rm i} \frac{kl}{n}}
        *  \text{ for }  k \in I_N\f$
        */
-      TIC_FFTW(1)
-      FFTW(execute)(ths->my_fftw_plan2);
-      TOC_FFTW(1)
+      TIC_FFTW(NFFT_STATS_FFT)
+      F_T(ths);
+      TOC_FFTW(NFFT_STATS_FFT)
+
+      /** form \f$ \hat f_k = \frac{\hat g_k}{c_k\left(\phi\right)} \text{ for }
+       *  k \in I_N \f$
+       */
+      TIC(NFFT_STATS_D)
+      D_T(ths);
+      TOC(NFFT_STATS_D)
+    }
+  }
+  stats_count(ths, direct);
+  TOC(NFFT_STATS_TRAFO)
+} /* nfft_adjoint */
+
+/* Convolution with the window function only, i.e. the sparse matrices B and
+ * B^T, on an oversampled grid g of n_total entries supplied by the caller and
+ * stored like the input of the FFTW plans. Requires n_t > 2m+2 as the fast
+ * transforms do. */
+
+/** f = B g on the vectors ths->g and ths->f. */
+static void nfft_trafo_B(X(plan) *ths)
+{
+  switch(ths->d)
+  {
+    case 1: nfft_trafo_1d_B(ths); break;
+    case 2: nfft_trafo_2d_B(ths); break;
+    case 3: nfft_trafo_3d_B(ths); break;
+    default: nfft_trafo_nd_B(ths);
+  }
+}
+
+/** g = B^T f on the vectors ths->f and ths->g. */
+static void nfft_adjoint_B(X(plan) *ths)
+{
+  switch(ths->d)
+  {
+    case 1: nfft_adjoint_1d_B(ths); break;
+    case 2: nfft_adjoint_2d_B(ths); break;
+    case 3: nfft_adjoint_3d_B(ths); break;
+    default: nfft_adjoint_nd_B(ths);
+  }
+}
+
+void X(interp)(X(plan) *ths, const C *g, C *f)
+{
+  C *g_save = ths->g, *f_save = ths->f;
+
+  update_nodes(ths);
+
+  ths->g = (C*)g;
+  ths->f = f;
+
+  nfft_trafo_B(ths);
+
+  ths->g = g_save;
+  ths->f = f_save;
+} /* nfft_interp */
+
+void X(spread)(X(plan) *ths, const C *f, C *g)
+{
+  C *g_save = ths->g, *f_save = ths->f;
+
+  update_nodes(ths);
+
+  ths->g = g;
+  ths->f = (C*)f;
+
+  nfft_adjoint_B(ths);
+
+  ths->g = g_save;
+  ths->f = f_save;
+} /* nfft_spread */
+
+/* Batched transforms. The nodes and the window are shared by all vectors, so
+ * the window values psi of each node are evaluated once and applied to every
+ * vector of the batch. They are read from the tables of PRE_PSI, PRE_FULL_PSI,
+ * PRE_LIN_PSI and PRE_FG_PSI, computed by fast Gaussian gridding for FG_PSI and
+ * evaluated directly without precomputation. The oversampled vectors of the batch are stored
+ * consecutively in g1, g2 with distance n_total. */
+
+/** number of nodes whose window values are kept at once by adjoint_many */
+#define NFFT_MANY_BLOCK 512
+
+static inline void nfft_trafo_many_compute(const X(plan) *ths, C *fj,
+  const C *g, const R *psij, const R *xj)
+{
+  const INT m = ths->m, m2p2 = 2 * m + 2;
+  const INT *n = ths->n;
+
+  switch (ths->d)
+  {
+    case 1: nfft_trafo_1d_compute(fj, g, psij, xj, n[0], m); break;
+    case 2: nfft_trafo_2d_compute(fj, g, psij, psij + m2p2, xj, xj + 1, n[0],
+      n[1], m); break;
+    case 3: nfft_trafo_3d_compute(fj, g, psij, psij + m2p2, psij + 2 * m2p2, xj,
+      xj + 1, xj + 2, n[0], n[1], n[2], m); break;
+    default: nfft_trafo_nd_compute(ths, fj, g, psij, xj);
+  }
+}
+
+static inline void nfft_adjoint_many_compute(const X(plan) *ths, const C *fj,
+  C *g, const R *psij, const R *xj)
+{
+  const INT m = ths->m, m2p2 = 2 * m + 2;
+  const INT *n = ths->n;
+
+  switch (ths->d)
+  {
+    case 1: nfft_adjoint_1d_compute_serial(fj, g, psij, xj, n[0], m); break;
+    case 2: nfft_adjoint_2d_compute_serial(fj, g, psij, psij + m2p2, xj, xj + 1,
+      n[0], n[1], m); break;
+    case 3: nfft_adjoint_3d_compute_serial(fj, g, psij, psij + m2p2,
+      psij + 2 * m2p2, xj, xj + 1, xj + 2, n[0], n[1], n[2], m); break;
+    default: nfft_adjoint_nd_compute(ths, *fj, g, psij, xj);
+  }
+}
+
+/**
+ * Window values of node x_j for all dimensions, psij[t*(2m+2)+l], like
+ * nfft_psij but also taken from the tables of PRE_FG_PSI and PRE_LIN_PSI, and
+ * by fast Gaussian gridding for FG_PSI as in the single transforms.
+ * fg_exp_l[t*(2m+2)+l] holds the factors exp(-l^2/b_t) of both. Returns NULL
+ * for PRE_FULL_PSI, whose table holds the products of all dimensions.
+ */
+static inline const R *nfft_many_psij(const X(plan) *ths, const INT j, R *buf,
+  const R *fg_exp_l)
+{
+  const INT d = ths->d, m2p2 = 2 * ths->m + 2;
+  INT t, l, u, o;
+
+  if (ths->flags & PRE_FULL_PSI)
+    return NULL;
+
+  if (ths->flags & (PRE_FG_PSI | FG_PSI))
+  {
+    for (t = 0; t < d; t++)
+    {
+      R fg_psij0, fg_psij1, fg_psij2 = K(1.0);
+
+      if (ths->flags & PRE_FG_PSI)
+      {
+        fg_psij0 = ths->psi[2 * (j * d + t)];
+        fg_psij1 = ths->psi[2 * (j * d + t) + 1];
+      }
+      else
+      {
+        uo(ths, j, &u, &o, t);
+        fg_psij0 = PHI(ths->n[t], ths->x[j * d + t]
+          - ((R)(u)) / (R)(ths->n[t]), t);
+        fg_psij1 = EXP(K(2.0) * ((R)(ths->n[t]) * ths->x[j * d + t] - (R)(u))
+          / ths->b[t]);
+      }
+
+      buf[t * m2p2] = fg_psij0;
+
+      for (l = 1; l < m2p2; l++)
+      {
+        fg_psij2 *= fg_psij1;
+        buf[t * m2p2 + l] = fg_psij0 * fg_psij2 * fg_exp_l[t * m2p2 + l];
+      }
+    }
+    return buf;
+  }
+
+  if (ths->flags & PRE_LIN_PSI)
+  {
+    const INT ip_s = ths->K / (ths->m + 2);
+
+    for (t = 0; t < d; t++)
+    {
+      const R *psi_t = ths->psi + (ths->K + 1) * t;
+      R ip_y, ip_w;
+      INT ip_u;
+
+      uo(ths, j, &u, &o, t);
+
+      ip_y = FABS((R)(ths->n[t]) * ths->x[j * d + t] - (R)(u)) * ((R)ip_s);
+      ip_u = (INT)(LRINT(FLOOR(ip_y)));
+      ip_w = ip_y - (R)(ip_u);
+
+      for (l = 0; l < m2p2; l++)
+        buf[t * m2p2 + l] = psi_t[ABS(ip_u-l*ip_s)] * (K(1.0) - ip_w)
+          + psi_t[ABS(ip_u-l*ip_s+1)] * (ip_w);
+    }
+    return buf;
+  }
+
+  return nfft_psij(ths, j, buf);
+}
+
+/** fg_exp_l[t*(2m+2)+l] = exp(-l^2/b_t) for nfft_many_psij */
+static void nfft_many_init_fg_exp_l(const X(plan) *ths, R *fg_exp_l)
+{
+  const INT m2p2 = 2 * ths->m + 2;
+  INT t;
+
+  if (ths->flags & (PRE_FG_PSI | FG_PSI))
+    for (t = 0; t < ths->d; t++)
+      nfft_1d_init_fg_exp_l(fg_exp_l + t * m2p2, ths->m, ths->b[t]);
+}
+
+/** number (2m+2)^d of window values of one node in the PRE_FULL_PSI table */
+static inline INT nfft_many_lprod(const X(plan) *ths)
+{
+  INT t, lprod;
+
+  for (t = 0, lprod = 1; t < ths->d; t++)
+    lprod *= 2 * ths->m + 2;
+
+  return lprod;
+}
+
+/** f_j = sum_l psi[j*lprod+l] g[psi_index_g[j*lprod+l]] for PRE_FULL_PSI */
+static inline C nfft_many_full_psi_A(const X(plan) *ths, const C *g,
+  const INT j, const INT lprod)
+{
+  C fj = K(0.0);
+  INT l;
+
+  if (ths->flags & NFFT_FULL_PSI_FLOAT)
+  {
+    for (l = j * lprod; l < (j + 1) * lprod; l++)
+      fj += (R)ths->psi_float[l] * g[ths->psi_index_g32[l]];
+    return ths->psi_float_scale * fj;
+  }
+
+  for (l = j * lprod; l < (j + 1) * lprod; l++)
+    fj += ths->psi[l] * g[ths->psi_index_g[l]];
+  return fj;
+}
+
+/** g[psi_index_g[j*lprod+l]] += psi[j*lprod+l] f_j for PRE_FULL_PSI, with
+ *  atomic additions if atomic is set */
+static inline void nfft_many_full_psi_T(const X(plan) *ths, const C fj, C *g,
+  const INT j, const INT lprod, const int atomic)
+{
+  const int psi_float = (ths->flags & NFFT_FULL_PSI_FLOAT) != 0;
+  INT l;
+#ifndef _OPENMP
+  UNUSED(atomic);
+#endif
+
+  for (l = j * lprod; l < (j + 1) * lprod; l++)
+  {
+    const C val = (psi_float ? ths->psi_float_scale * (R)ths->psi_float[l]
+      : ths->psi[l]) * fj;
+    C *gref = g + (psi_float ? (INT)ths->psi_index_g32[l]
+      : ths->psi_index_g[l]);
+#ifdef _OPENMP
+    if (atomic)
+    {
+      R *gref_real = (R*) gref;
+
+      #pragma omp atomic
+      gref_real[0] += CREAL(val);
+
+      #pragma omp atomic
+      gref_real[1] += CIMAG(val);
+      continue;
+    }
+#endif
+    *gref += val;
+  }
+}
+
+#ifdef _OPENMP
+static inline void nfft_adjoint_many_compute_omp_atomic(const X(plan) *ths,
+  const C fj, C *g, const R *psij, const R *xj)
+{
+  const INT m = ths->m, m2p2 = 2 * ths->m + 2;
+  const INT *n = ths->n;
+
+  switch (ths->d)
+  {
+    case 1: nfft_adjoint_1d_compute_omp_atomic(fj, g, psij, xj, n[0], m); break;
+    case 2: nfft_adjoint_2d_compute_omp_atomic(fj, g, psij, psij + m2p2, xj,
+      xj + 1, n[0], n[1], m); break;
+    case 3: nfft_adjoint_3d_compute_omp_atomic(fj, g, psij, psij + m2p2,
+      psij + 2 * m2p2, xj, xj + 1, xj + 2, n[0], n[1], n[2], m); break;
+    default: nfft_adjoint_nd_compute_omp_atomic(ths, fj, g, psij, xj);
+  }
+}
+#endif
+
+/** f_v[j] = sum_l g_v[l] psi(x_j - l/n) for the vectors v of one batch */
+static void B_A_many(X(plan) *ths, const INT howmany, C *f, const INT f_dist)
+{
+  const INT d = ths->d, m2p2 = 2 * ths->m + 2, lprod = nfft_many_lprod(ths);
+  R fg_exp_l[d * m2p2];
+  INT k;
+
+  if (!(ths->flags & PRE_PSI))
+    sort(ths);
+
+  nfft_many_init_fg_exp_l(ths, fg_exp_l);
+
+#ifdef _OPENMP
+  #pragma omp parallel default(shared) private(k)
+#endif
+  {
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < ths->M_total; k++)
+    {
+      const INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      R buf[d * m2p2];
+      const R *psij = nfft_many_psij(ths, j, buf, fg_exp_l);
+      INT v;
+
+      for (v = 0; v < howmany; v++)
+        if (psij)
+          nfft_trafo_many_compute(ths, f + v * f_dist + j,
+            ths->g + v * ths->n_total, psij, ths->x + j * d);
+        else
+          f[v * f_dist + j] = nfft_many_full_psi_A(ths,
+            ths->g + v * ths->n_total, j, lprod);
+    }
+    STATS_THREAD_END(NFFT_STATS_B)
+  }
+}
+
+/** g_v[l] = sum_j f_v[j] psi(x_j - l/n) for the vectors v of one batch. The
+ *  window values are evaluated for a block of nodes, then every thread adds
+ *  the block to its own vectors g_v. With fewer vectors than threads, the
+ *  threads share the nodes of the block instead and add them to all vectors
+ *  with atomic operations. */
+static void B_T_many(X(plan) *ths, const INT howmany, const C *f,
+  const INT f_dist)
+{
+  const INT d = ths->d, m2p2 = 2 * ths->m + 2, lprod = nfft_many_lprod(ths);
+  R *buf = NULL;
+  R fg_exp_l[d * m2p2];
+  const R **psi_blk;
+  INT k0, v;
+#ifdef _OPENMP
+  const int by_nodes = howmany < (INT)omp_get_max_threads();
+#endif
+
+  if (!(ths->flags & PRE_PSI))
+    sort(ths);
+
+  if (!(ths->flags & (PRE_PSI | PRE_FULL_PSI)))
+    buf = (R*) Y(malloc)((size_t)(NFFT_MANY_BLOCK * d * m2p2) * sizeof(R));
+
+  nfft_many_init_fg_exp_l(ths, fg_exp_l);
+
+  psi_blk = (const R**) Y(malloc)((size_t)(NFFT_MANY_BLOCK) * sizeof(R*));
+
+  memset(ths->g, 0, (size_t)(howmany * ths->n_total) * sizeof(C));
+
+  for (k0 = 0; k0 < ths->M_total; k0 += NFFT_MANY_BLOCK)
+  {
+    const INT cnt = MIN(NFFT_MANY_BLOCK, ths->M_total - k0);
+    INT k;
+
+#ifdef _OPENMP
+    #pragma omp parallel default(shared) private(k)
+#endif
+    {
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (k = 0; k < cnt; k++)
+      {
+        const INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*(k0+k)+1]
+          : k0 + k;
+        psi_blk[k] = nfft_many_psij(ths, j, buf ? buf + k * d * m2p2 : NULL,
+          fg_exp_l);
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
+
+#ifdef _OPENMP
+    if (by_nodes)
+    {
+      #pragma omp parallel default(shared) private(v,k)
+      {
+        STATS_THREAD_BEGIN
+        #pragma omp for schedule(static) nowait
+        for (k = 0; k < cnt; k++)
+        {
+          const INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*(k0+k)+1]
+            : k0 + k;
+          for (v = 0; v < howmany; v++)
+            if (psi_blk[k])
+              nfft_adjoint_many_compute_omp_atomic(ths, f[v * f_dist + j],
+                ths->g + v * ths->n_total, psi_blk[k], ths->x + j * d);
+            else
+              nfft_many_full_psi_T(ths, f[v * f_dist + j],
+                ths->g + v * ths->n_total, j, lprod, 1);
+        }
+        STATS_THREAD_END(NFFT_STATS_B)
+      }
+      continue;
+    }
+
+    #pragma omp parallel default(shared) private(v,k)
+#endif
+    {
+      STATS_THREAD_BEGIN
+#ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+#endif
+      for (v = 0; v < howmany; v++)
+      {
+        for (k = 0; k < cnt; k++)
+        {
+          const INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*(k0+k)+1]
+            : k0 + k;
+          if (psi_blk[k])
+            nfft_adjoint_many_compute(ths, f + v * f_dist + j,
+              ths->g + v * ths->n_total, psi_blk[k], ths->x + j * d);
+          else
+            nfft_many_full_psi_T(ths, f[v * f_dist + j],
+              ths->g + v * ths->n_total, j, lprod, 0);
+        }
+      }
+      STATS_THREAD_END(NFFT_STATS_B)
+    }
+  }
+
+  Y(free)(psi_blk);
+  if (buf)
+    Y(free)(buf);
+}
+
+/** Runs the FFTW plan of the whole batch if it has the planned size, and the
+ *  single plan on each of its vectors otherwise. */
+static void fftw_many(X(plan) *ths, FFTW(plan) p, FFTW(plan) p_many,
+  C *in, C *out, const INT howmany)
+{
+  INT v;
+
+  if (howmany == ths->howmany && ths->howmany > 1)
+    FFTW(execute)(p_many);
+  else
+    for (v = 0; v < howmany; v++)
+      FFTW(execute_dft)(p, in + v * ths->n_total, out + v * ths->n_total);
+}
+
+static int nfft_many_direct(const X(plan) *ths)
+{
+  INT t;
+
+  for (t = 0; t < ths->d; t++)
+    if ((ths->N[t] <= ths->m) || (ths->n[t] <= 2*ths->m+2))
+      return 1;
+
+  return 0;
+}
+
+void X(trafo_many)(X(plan) *ths, int howmany, C *f_hat, int f_hat_dist,
+  C *f, int f_dist)
+{
+  C *f_hat_save = ths->f_hat, *f_save = ths->f;
+  C *g_hat_save = ths->g_hat, *g_save = ths->g;
+  INT v0, v;
+
+  update_nodes(ths);
+
+  if (nfft_many_direct(ths))
+  {
+    for (v = 0; v < howmany; v++)
+    {
+      ths->f_hat = f_hat + v * f_hat_dist;
+      ths->f = f + v * f_dist;
+      X(trafo_direct)(ths);
+    }
+    ths->f_hat = f_hat_save;
+    ths->f = f_save;
+    return;
+  }
+
+  for (v0 = 0; v0 < howmany; v0 += ths->howmany)
+  {
+    const INT cnt = MIN(ths->howmany, howmany - v0);
+
+    /* g_hat_v = f_hat_v / c_k(phi) */
+    TIC(NFFT_STATS_D)
+    for (v = 0; v < cnt; v++)
+    {
+      ths->f_hat = f_hat + (v0 + v) * f_hat_dist;
+      ths->g_hat = ths->g1 + v * ths->n_total;
+      D_A(ths);
+    }
+    TOC(NFFT_STATS_D)
+
+    TIC(NFFT_STATS_FFT)
+    fftw_many(ths, ths->my_fftw_plan1, ths->my_fftw_plan1_many, ths->g1,
+      ths->g2, cnt);
+    TOC(NFFT_STATS_FFT)
+
+    ths->g = ths->g2;
+    TIC(NFFT_STATS_B)
+    B_A_many(ths, cnt, f + v0 * f_dist, f_dist);
+    TOC(NFFT_STATS_B)
+  }
+
+  ths->f_hat = f_hat_save;
+  ths->f = f_save;
+  ths->g_hat = g_hat_save;
+  ths->g = g_save;
+} /* nfft_trafo_many */
+
+void X(adjoint_many)(X(plan) *ths, int howmany, C *f_hat, int f_hat_dist,
+  C *f, int f_dist)
+{
+  C *f_hat_save = ths->f_hat, *f_save = ths->f;
+  C *g_hat_save = ths->g_hat, *g_save = ths->g;
+  INT v0, v;
+
+  update_nodes(ths);
+
+  if (nfft_many_direct(ths))
+  {
+    for (v = 0; v < howmany; v++)
+    {
+      ths->f_hat = f_hat + v * f_hat_dist;
+      ths->f = f + v * f_dist;
+      X(adjoint_direct)(ths);
+    }
+    ths->f_hat = f_hat_save;
+    ths->f = f_save;
+    return;
+  }
+
+  for (v0 = 0; v0 < howmany; v0 += ths->howmany)
+  {
+    const INT cnt = MIN(ths->howmany, howmany - v0);
+
+    ths->g = ths->g2;
+    TIC(NFFT_STATS_B)
+    B_T_many(ths, cnt, f + v0 * f_dist, f_dist);
+    TOC(NFFT_STATS_B)
+
+    TIC(NFFT_STATS_FFT)
+    fftw_many(ths, ths->my_fftw_plan2, ths->my_fftw_plan2_many, ths->g2,
+      ths->g1, cnt);
+    TOC(NFFT_STATS_FFT)
+
+    /* f_hat_v = g_hat_v / c_k(phi) */
+    TIC(NFFT_STATS_D)
+    for (v = 0; v < cnt; v++)
+    {
+      ths->f_hat = f_hat + (v0 + v) * f_hat_dist;
+      ths->g_hat = ths->g1 + v * ths->n_total;
+      D_T(ths);
+    }
+    TOC(NFFT_STATS_D)
+  }
+
+  ths->f_hat = f_hat_save;
+  ths->f = f_save;
+  ths->g_hat = g_hat_save;
+  ths->g = g_save;
+} /* nfft_adjoint_many */
+
+
+/** initialisation of direct transform
+ */
+static void precompute_phi_hut(X(plan) *ths)
+{
+  INT ks[ths->d]; /* index over all frequencies */
+  INT t; /* index over all dimensions */
+
+  ths->c_phi_inv = (R**) plan_malloc(ths, (size_t)(ths->d) * sizeof(R*));
+
+  for (t = 0; t < ths->d; t++)
+  {
+    ths->c_phi_inv[t] = (R*) plan_malloc(ths, (size_t)(ths->N[t]) * sizeof(R));
+
+    for (ks[t] = 0; ks[t] < ths->N[t]; ks[t]++)
+    {
+      ths->c_phi_inv[t][ks[t]]= K(1.0) / (PHI_HUT(ths->n[t], ks[t] - ths->N[t] / 2,t));
+    }
+  }
+} /* nfft_phi_hut */
+
+/** create a lookup table, but NOT for each node
+ *  good idea K=2^xx
+ *  assumes an EVEN window function
+ */
+void X(precompute_lin_psi)(X(plan) *ths)
+{
+  TIC(NFFT_STATS_PRECOMPUTE)
+  INT t;                                /**< index over all dimensions       */
+  INT j;                                /**< index over all nodes            */
+  R step;                          /**< step size in [0,(m+2)/n]        */
+
+  plan_own_tables(ths);
+
+  for (t=0; t<ths->d; t++)
+    {
+      step = ((R)(ths->m+2)) / ((R)(ths->K * ths->n[t]));
+      for(j = 0;j <= ths->K; j++)
+  {
+    ths->psi[(ths->K+1)*t + j] = PHI(ths->n[t], (R)(j) * step,t);
+  } /* for(j) */
+    } /* for(t) */
+  TOC(NFFT_STATS_PRECOMPUTE)
+}
+
+void X(precompute_fg_psi)(X(plan) *ths)
+{
+  TIC(NFFT_STATS_PRECOMPUTE)
+  INT t;                                /**< index over all dimensions       */
+  INT u, o;                             /**< depends on x_j                  */
+  INT j;                                /**< index over all nodes            */
+
+  plan_own_tables(ths);
+  sort(ths);
+
+#ifdef _OPENMP
+  #pragma omp parallel for default(shared) private(j,t,u,o)
+#endif
+  for (j = 0; j < ths->M_total; j++)
+  {
+    for (t=0; t<ths->d; t++)
+    {
+      uo(ths,j,&u,&o,t);
+
+      ths->psi[2*(j*ths->d+t)]=
+          (PHI(ths->n[t] ,(ths->x[j*ths->d+t] - ((R)u) / (R)(ths->n[t])),t));
+
+      ths->psi[2*(j*ths->d+t)+1]=
+          EXP(K(2.0) * ((R)(ths->n[t]) * ths->x[j*ths->d+t] - (R)(u)) / ths->b[t]);
+    } /* for(t) */
+  } /* for(j) */
+  TOC(NFFT_STATS_PRECOMPUTE)
+} /* nfft_precompute_fg_psi */
+
+void X(precompute_psi)(X(plan) *ths)
+{
+  TIC(NFFT_STATS_PRECOMPUTE)
+  INT t; /* index over all dimensions */
+  INT u, o; /* depends on x_j */
+  INT j; /* index over all nodes */
+
+  plan_own_tables(ths);
+  sort(ths);
+
+  /* The window values of node j are written by the thread that gets j in the
+   * static schedule of the B step, which places them on its NUMA node. */
+#ifdef _OPENMP
+  #pragma omp parallel for default(shared) private(j,t,u,o)
+#endif
+  for (j = 0; j < ths->M_total; j++)
+  {
+    for (t=0; t<ths->d; t++)
+    {
+      uo(ths,j,&u,&o,t);
+
+      PHI_ROW(ths->n[t], ths->x[j*ths->d+t], u, t,
+        &ths->psi[(j * ths->d + t) * (2 * ths->m + 2)]);
+    } /* for(t) */
+  } /* for(j) */
+  TOC(NFFT_STATS_PRECOMPUTE)
+} /* nfft_precompute_psi */
+
+#ifdef _OPENMP
+static void nfft_precompute_full_psi_omp(X(plan) *ths)
+{
+  INT j;                                /**< index over all nodes            */
+  INT lprod;                            /**< 'bandwidth' of matrix B         */
+
+  {
+    INT t;
+    for(t=0,lprod = 1; t<ths->d; t++)
+        lprod *= 2*ths->m+2;
+  }
+
+  #pragma omp parallel for default(shared) private(j)
+  for(j=0; j<ths->M_total; j++)
+    {
+      INT t,t2;                             /**< index over all dimensions       */
+      INT l_L;                              /**< plain index 0<=l_L<lprod        */
+      INT lj[ths->d];                       /**< multi index 0<=lj<u+o+1         */
+      INT ll_plain[ths->d+1];               /**< postfix plain index             */
+
+      INT u[ths->d], o[ths->d];             /**< depends on x_j                  */
+
+      R phi_prod[ths->d+1];
+      INT ix = j*lprod;
+
+      phi_prod[0]=1;
+      ll_plain[0]=0;
+
+      MACRO_init_uo_l_lj_t;
+
+      for(l_L=0; l_L<lprod; l_L++, ix++)
+      {
+        MACRO_update_phi_prod_ll_plain(without_PRE_PSI);
+
+        if (ths->flags & NFFT_FULL_PSI_FLOAT)
+        {
+          ths->psi_index_g32[ix]=(int)ll_plain[ths->d];
+          ths->psi_float[ix]=(float)(phi_prod[ths->d] / ths->psi_float_scale);
+        }
+        else
+        {
+          ths->psi_index_g[ix]=ll_plain[ths->d];
+          ths->psi[ix]=phi_prod[ths->d];
+        }
+
+        MACRO_count_uo_l_lj_t;
+      } /* for(l_L) */
+
+      ths->psi_index_f[j]=lprod;
+    } /* for(j) */
+}
+#endif
+
+/** Sets psi_float_scale to the window at its centre, the largest entry of the
+ *  full psi table, so that the float table stays in [0,1] even for large d. */
+static void nfft_full_psi_float_scale(X(plan) *ths)
+{
+  INT t;
+
+  ths->psi_float_scale = K(1.0);
+
+  if (!(ths->flags & NFFT_FULL_PSI_FLOAT))
+    return;
+
+  for (t = 0; t < ths->d; t++)
+    ths->psi_float_scale *= PHI(ths->n[t], K(0.0), t);
+}
+
+void X(precompute_full_psi)(X(plan) *ths)
+{
+  TIC(NFFT_STATS_PRECOMPUTE)
+  plan_own_tables(ths);
+  nfft_full_psi_float_scale(ths);
+
+#ifdef _OPENMP
+  sort(ths);
+
+  nfft_precompute_full_psi_omp(ths);
+#else
+  INT t, t2; /* index over all dimensions */
+  INT j; /* index over all nodes */
+  INT l_L; /* plain index 0 <= l_L < lprod */
+  INT lj[ths->d]; /* multi index 0<=lj<u+o+1 */
+  INT ll_plain[ths->d+1]; /* postfix plain index */
+  INT lprod; /* 'bandwidth' of matrix B */
+  INT u[ths->d], o[ths->d]; /* depends on x_j */
+
+  R phi_prod[ths->d+1];
+
+  INT ix, ix_old;
+
+  sort(ths);
+
+  phi_prod[0] = K(1.0);
+  ll_plain[0] = 0;
+
+  for (t = 0, lprod = 1; t < ths->d; t++)
+    lprod *= 2 * ths->m + 2;
+
+  for (j = 0, ix = 0, ix_old = 0; j < ths->M_total; j++)
+  {
+    MACRO_init_uo_l_lj_t;
+
+    for (l_L = 0; l_L < lprod; l_L++, ix++)
+    {
+      MACRO_update_phi_prod_ll_plain(without_PRE_PSI);
+
+      if (ths->flags & NFFT_FULL_PSI_FLOAT)
+      {
+        ths->psi_index_g32[ix] = (int)ll_plain[ths->d];
+        ths->psi_float[ix] = (float)(phi_prod[ths->d] / ths->psi_float_scale);
+      }
+      else
+      {
+        ths->psi_index_g[ix] = ll_plain[ths->d];
+        ths->psi[ix] = phi_prod[ths->d];
+      }
+
+      MACRO_count_uo_l_lj_t;
+    } /* for(l_L) */
+
+    ths->psi_index_f[j] = ix - ix_old;
+    ix_old = ix;
+  } /* for(j) */
+#endif
+  TOC(NFFT_STATS_PRECOMPUTE)
+}
+
+void X(precompute_one_psi)(X(plan) *ths)
+{
+  plan_own_tables(ths);
+
+  if(ths->flags & PRE_LIN_PSI)
+    X(precompute_lin_psi)(ths);
+  if(ths->flags & PRE_FG_PSI)
+    X(precompute_fg_psi)(ths);
+  if(ths->flags & PRE_PSI)
+    X(precompute_psi)(ths);
+  if(ths->flags & PRE_FULL_PSI)
+    X(precompute_full_psi)(ths);
+
+  ths->nodes_changed = 0;
+}
+
+/* Reentrant execution. The plan is only read, so several threads may execute
+ * one plan at the same time; the oversampled vectors and, if the nodes are
+ * sorted, the permutation index_x and its sort buffer are placed in the
+ * caller's workspace of X(workspace_size) bytes. The workspace has to be
+ * allocated by Y(malloc) to meet the alignment of the FFTW plans, and the
+ * precomputation of psi has to be finished before the plan is shared. */
+
+size_t X(workspace_size)(const X(plan) *ths)
+{
+  size_t size = (size_t)(ths->n_total) * sizeof(C);
+
+  if (ths->flags & FFT_OUT_OF_PLACE)
+    size += (size_t)(ths->n_total) * sizeof(C);
+
+  if (ths->flags & NFFT_SORT_NODES)
+    size += 4U * (size_t)(ths->M_total) * sizeof(INT);
+
+  return size;
+}
+
+/** Shallow copy of a plan that works on the given vectors and workspace. */
+static void plan_on_workspace(const X(plan) *ths, X(plan) *p, const C *f_hat,
+  const C *f, void *work)
+{
+  /* the precomputation for nodes of X(set_nodes) would write to the shared
+   * plan, so it has to be done by a transform on the plan itself first */
+  if (ths->nodes_changed)
+    Y(die)("nfft: execute on a plan whose nodes of "
+      STRINGIZE(X(set_nodes)) " are not yet precomputed\n");
+
+  *p = *ths;
+
+  p->f_hat = (C*)f_hat;
+  p->f = (C*)f;
+  p->g1 = (C*)work;
+  p->g2 = (ths->flags & FFT_OUT_OF_PLACE) ? p->g1 + ths->n_total : p->g1;
+  p->g_hat = p->g1;
+  p->g = p->g2;
+
+  if (ths->flags & NFFT_SORT_NODES)
+  {
+    p->index_x = (INT*)(p->g2 + ths->n_total);
+    p->index_x_tmp = p->index_x + 2 * ths->M_total;
+    memcpy(p->index_x, ths->index_x,
+      2U * (size_t)(ths->M_total) * sizeof(INT));
+  }
+}
+
+void X(execute_trafo)(const X(plan) *ths, const C *f_hat, C *f, void *work)
+{
+  X(plan) p;
+
+  plan_on_workspace(ths, &p, f_hat, f, work);
+  X(trafo)(&p);
+}
+
+void X(execute_adjoint)(const X(plan) *ths, C *f_hat, const C *f, void *work)
+{
+  X(plan) p;
+
+  plan_on_workspace(ths, &p, f_hat, f, work);
+  X(adjoint)(&p);
+}
+
+/* Pipelined batches. Every vector of the batch passes the stages D, FFT and B
+ * of X(trafo), or B, FFT and D of X(adjoint), on a workspace of its own. In
+ * each step the stages work on different vectors: with three workspaces, B
+ * runs on vector i while the FFT runs on vector i+1 and D on vector i+2, so
+ * that the bandwidth bound stages overlap with the FFT. With depth
+ * workspaces, vector i enters the first stage in step i*(4-depth). */
+
+#define PIPELINE_STAGES 3
+
+/** Runs stage k, in the order of the transform, on vector v of the batch. */
+static void pipeline_stage(X(plan) *p, const int adjoint, const int k,
+  const INT v, C *f_hat, const INT f_hat_dist, C *f, const INT f_dist)
+{
+  /* the stages run in parallel sections, so they are traced, but not timed */
+  const int phase = k == 1 ? NFFT_STATS_FFT
+    : ((k == 0) != (adjoint != 0)) ? NFFT_STATS_D : NFFT_STATS_B;
+
+  p->f_hat = f_hat + v * f_hat_dist;
+  p->f = f + v * f_dist;
+  p->g_hat = p->g1;
+  p->g = p->g2;
+
+  TRACE_BEGIN(phase, p, p->M_total, p->N_total)
+  if (!adjoint)
+  {
+    switch (k)
+    {
+      case 0: D_A(p); break;
+      case 1: F_A(p); break;
+      default: nfft_trafo_B(p);
+    }
+  }
+  else
+  {
+    switch (k)
+    {
+      case 0: nfft_adjoint_B(p); break;
+      case 1: F_T(p); break;
+      default: D_T(p);
+    }
+  }
+  TRACE_END(phase, p, p->M_total, p->N_total)
+}
+
+#ifdef _OPENMP
+/** Threads of stage k if the stages in active run at the same time and share
+ *  nthreads threads. The FFTW plans of the FFT stage use the fftw_nthreads
+ *  threads they were created with, so D and B share the rest: D a quarter and
+ *  B the others, but each at least one thread. */
+static int pipeline_threads(const X(plan) *ths, const int adjoint, const int k,
+  const int *active, const int nthreads)
+{
+  const int kD = adjoint ? 2 : 0, kB = adjoint ? 0 : 2;
+  const int rest = active[1] ? nthreads - ths->fftw_nthreads : nthreads;
+  const int nD = active[kB] ? MAX(1, rest / 4) : MAX(1, rest);
+
+  if (k == 1)
+    return 1;
+
+  if (k == kD)
+    return nD;
+
+  return active[kD] ? MAX(1, rest - nD) : MAX(1, rest);
+}
+#endif
+
+static void pipeline(X(plan) *ths, const int adjoint, const INT howmany,
+  C *f_hat, const INT f_hat_dist, C *f, const INT f_dist, int depth,
+  R *occupancy)
+{
+  const size_t size = X(workspace_size)(ths);
+  X(plan) slot[PIPELINE_STAGES];
+  void *work[PIPELINE_STAGES];
+  R busy[PIPELINE_STAGES] = {K(0.0), K(0.0), K(0.0)}, t0, wall;
+  INT delta, steps, s;
+  int k, i;
+#ifdef _OPENMP
+  const int levels = omp_get_max_active_levels();
+  const int nthreads = omp_get_max_threads();
+#endif
+
+  depth = MAX(1, MIN(PIPELINE_STAGES, depth));
+  delta = (INT)(PIPELINE_STAGES + 1 - depth);
+  steps = howmany > 0 ? (howmany - 1) * delta + PIPELINE_STAGES : 0;
+
+#ifdef _OPENMP
+  /* the stages run their parallel loops in nested teams */
+  if (depth > 1)
+    omp_set_max_active_levels(MAX(levels, 2));
+#endif
+
+  for (i = 0; i < depth; i++)
+  {
+    work[i] = Y(malloc)(size);
+    plan_on_workspace(ths, &slot[i], ths->f_hat, ths->f, work[i]);
+  }
+
+  t0 = Y(clock_gettime_seconds)();
+
+  for (s = 0; s < steps; s++)
+  {
+    INT v[PIPELINE_STAGES];
+    int active[PIPELINE_STAGES];
+
+    for (k = 0; k < PIPELINE_STAGES; k++)
+    {
+      v[k] = (s - k) / delta;
+      active[k] = s >= k && (s - k) % delta == 0 && v[k] < howmany;
+    }
+
+#ifdef _OPENMP
+    if (active[0] + active[1] + active[2] > 1)
+    {
+      #pragma omp parallel for num_threads(PIPELINE_STAGES) schedule(static,1)
+      for (k = 0; k < PIPELINE_STAGES; k++)
+      {
+        if (active[k])
+        {
+          R t = Y(clock_gettime_seconds)();
+
+          omp_set_num_threads(pipeline_threads(ths, adjoint, k, active,
+            nthreads));
+          pipeline_stage(&slot[v[k] % depth], adjoint, k, v[k], f_hat,
+            f_hat_dist, f, f_dist);
+          busy[k] += Y(clock_gettime_seconds)() - t;
+        }
+      }
+      continue;
+    }
+#endif
+
+    for (k = 0; k < PIPELINE_STAGES; k++)
+    {
+      if (active[k])
+      {
+        R t = Y(clock_gettime_seconds)();
+
+        pipeline_stage(&slot[v[k] % depth], adjoint, k, v[k], f_hat,
+          f_hat_dist, f, f_dist);
+        busy[k] += Y(clock_gettime_seconds)() - t;
+      }
+    }
+  }
+
+  wall = Y(clock_gettime_seconds)() - t0;
+
+#ifdef _OPENMP
+  if (depth > 1)
+    omp_set_max_active_levels(levels);
+#endif
+
+  /* occupancy in the order D, FFT, B */
+  if (occupancy != NULL)
+    for (k = 0; k < PIPELINE_STAGES; k++)
+      occupancy[adjoint ? PIPELINE_STAGES - 1 - k : k] =
+        wall > K(0.0) ? busy[k] / wall : K(0.0);
+
+  for (i = 0; i < depth; i++)
+    Y(free)(work[i]);
+}
+
+void X(trafo_pipeline)(X(plan) *ths, int howmany, C *f_hat, int f_hat_dist,
+  C *f, int f_dist, int depth, R *occupancy)
+{
+  update_nodes(ths);
+
+  if (nfft_many_direct(ths))
+  {
+    X(trafo_many)(ths, howmany, f_hat, f_hat_dist, f, f_dist);
+    if (occupancy != NULL)
+      occupancy[0] = occupancy[1] = occupancy[2] = K(0.0);
+    return;
+  }
+
+  pipeline(ths, 0, (INT)howmany, f_hat, (INT)f_hat_dist, f, (INT)f_dist,
+    depth, occupancy);
+}
+
+void X(adjoint_pipeline)(X(plan) *ths, int howmany, C *f_hat, int f_hat_dist,
+  C *f, int f_dist, int depth, R *occupancy)
+{
+  update_nodes(ths);
+
+  if (nfft_many_direct(ths))
+  {
+    X(adjoint_many)(ths, howmany, f_hat, f_hat_dist, f, f_dist);
+    if (occupancy != NULL)
+      occupancy[0] = occupancy[1] = occupancy[2] = K(0.0);
+    return;
+  }
+
+  pipeline(ths, 1, (INT)howmany, f_hat, (INT)f_hat_dist, f, (INT)f_dist,
+    depth, occupancy);
+}
+
+/* Streamed transforms for node sets that do not fit into memory. The plan is
+ * initialised with M_total the size of a chunk; its own x and f are not used,
+ * so MALLOC_X and MALLOC_F may be left out. The adjoint accumulates the
+ * chunks on the oversampled grid g and ends with one FFT and the division by
+ * c_k(phi); the transform does the division and the FFT once and evaluates
+ * the chunks from g. The nodes and samples of a chunk are only read and may
+ * point into a file mapped by mmap. Per chunk, the nodes are sorted and psi
+ * is precomputed into the tables of the plan, whose size is that of a chunk;
+ * longer chunks are processed in parts of M_total nodes. */
+
+/** Lets the plan work on the nodes x and samples f of one chunk. */
+static void stream_chunk(X(plan) *ths, const INT M, const R *x, C *f)
+{
+  ths->M_total = M;
+  ths->x = (R*)x;
+  ths->f = f;
+  ths->nodes_changed = 1;
+  update_nodes(ths);
+}
+
+/** Returns the plan to its own nodes, whose psi has to be recomputed. */
+static void stream_restore(X(plan) *ths, const INT M_total, R *x, C *f)
+{
+  ths->M_total = M_total;
+  ths->x = x;
+  ths->f = f;
+  ths->nodes_changed = 1;
+}
+
+/** g += B^T f on the nodes of the plan, with the window values evaluated per
+ *  node unless PRE_PSI is set. */
+static void B_T_add(X(plan) *ths)
+{
+  const INT d = ths->d, m = ths->m, m2p2 = 2 * m + 2;
+  INT k;
+
+  sort(ths);
+
+#ifdef _OPENMP
+  #pragma omp parallel default(shared) private(k)
+#endif
+  {
+    STATS_THREAD_BEGIN
+#ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+#endif
+    for (k = 0; k < ths->M_total; k++)
+    {
+      const INT j = (ths->flags & NFFT_SORT_NODES) ? ths->index_x[2*k+1] : k;
+      R buf[d * m2p2];
+      const R *psij = nfft_psij(ths, j, buf), *xj = ths->x + j * d;
+
+#ifdef _OPENMP
+      switch (d)
+      {
+        case 1: nfft_adjoint_1d_compute_omp_atomic(ths->f[j], ths->g, psij, xj,
+          ths->n[0], m); break;
+        case 2: nfft_adjoint_2d_compute_omp_atomic(ths->f[j], ths->g, psij,
+          psij + m2p2, xj, xj + 1, ths->n[0], ths->n[1], m); break;
+        case 3: nfft_adjoint_3d_compute_omp_atomic(ths->f[j], ths->g, psij,
+          psij + m2p2, psij + 2 * m2p2, xj, xj + 1, xj + 2, ths->n[0],
+          ths->n[1], ths->n[2], m); break;
+        default: nfft_adjoint_nd_compute_omp_atomic(ths, ths->f[j], ths->g, psij,
+          xj);
+      }
+#else
+      nfft_adjoint_many_compute(ths, ths->f + j, ths->g, psij, xj);
+#endif
+    }
+    STATS_THREAD_END(NFFT_STATS_B)
+  }
+}
+
+void X(adjoint_stream_begin)(X(plan) *ths)
+{
+  /* tables of a plan restored by X(load_plan) are mapped with its nodes */
+  plan_own_tables(ths);
+
+  if (nfft_many_direct(ths))
+  {
+    memset(ths->f_hat, 0, (size_t)(ths->N_total) * sizeof(C));
+    return;
+  }
+
+  ths->g_hat = ths->g1;
+  ths->g = ths->g2;
+  memset(ths->g, 0, (size_t)(ths->n_total) * sizeof(C));
+}
+
+void X(adjoint_stream_chunk)(X(plan) *ths, int M, const R *x, const C *f)
+{
+  const INT M_total = ths->M_total;
+  R *x_save = ths->x;
+  C *f_save = ths->f, *f_hat = NULL;
+  INT j0, k;
+
+  if (nfft_many_direct(ths))
+    f_hat = (C*) Y(malloc)((size_t)(ths->N_total) * sizeof(C));
+
+  for (j0 = 0; j0 < (INT)M; j0 += M_total)
+  {
+    stream_chunk(ths, MIN(M_total, (INT)M - j0), x + j0 * ths->d,
+      (C*)f + j0);
+
+    if (f_hat)
+    {
+      C *f_hat_save = ths->f_hat;
+
+      ths->f_hat = f_hat;
+      X(adjoint_direct)(ths);
+      ths->f_hat = f_hat_save;
+
+      for (k = 0; k < ths->N_total; k++)
+        ths->f_hat[k] += f_hat[k];
+    }
+    else
+      B_T_add(ths);
+  }
+
+  stream_restore(ths, M_total, x_save, f_save);
+
+  if (f_hat)
+    Y(free)(f_hat);
+}
+
+void X(adjoint_stream_end)(X(plan) *ths)
+{
+  if (nfft_many_direct(ths))
+    return;
+
+  ths->g_hat = ths->g1;
+  ths->g = ths->g2;
+  TIC(NFFT_STATS_FFT)
+  F_T(ths);
+  TOC(NFFT_STATS_FFT)
+  TIC(NFFT_STATS_D)
+  D_T(ths);
+  TOC(NFFT_STATS_D)
+}
+
+void X(trafo_stream_begin)(X(plan) *ths)
+{
+  plan_own_tables(ths);
+
+  if (nfft_many_direct(ths))
+    return;
+
+  ths->g_hat = ths->g1;
+  ths->g = ths->g2;
+  TIC(NFFT_STATS_D)
+  D_A(ths);
+  TOC(NFFT_STATS_D)
+  TIC(NFFT_STATS_FFT)
+  F_A(ths);
+  TOC(NFFT_STATS_FFT)
+}
+
+void X(trafo_stream_chunk)(X(plan) *ths, int M, const R *x, C *f)
+{
+  const INT M_total = ths->M_total;
+  R *x_save = ths->x;
+  C *f_save = ths->f;
+  INT j0;
+
+  for (j0 = 0; j0 < (INT)M; j0 += M_total)
+  {
+    stream_chunk(ths, MIN(M_total, (INT)M - j0), x + j0 * ths->d, f + j0);
+
+    if (nfft_many_direct(ths))
+      X(trafo_direct)(ths);
+    else
+    {
+      ths->g = ths->g2;
+      nfft_trafo_B(ths);
+    }
+  }
+
+  stream_restore(ths, M_total, x_save, f_save);
+}
+
+void X(set_nodes)(X(plan) *ths, const R *x)
+{
+  plan_own_tables(ths);
+
+  if (x && x != ths->x)
+    memcpy(ths->x, x, (size_t)(ths->d * ths->M_total) * sizeof(R));
+
+  ths->nodes_changed = 1;
+}
+
+static void init_help(X(plan) *ths)
+{
+  INT t; /* index over all dimensions */
+  INT lprod; /* 'bandwidth' of matrix B */
+
+  memset(&ths->stats, 0, sizeof(ths->stats));
+
+  if (ths->flags & NFFT_OMP_BLOCKWISE_ADJOINT)
+    ths->flags |= NFFT_SORT_NODES;
+
+  ths->N_total = intprod(ths->N, 0, ths->d);
+  ths->n_total = intprod(ths->n, 0, ths->d);
+  ths->nodes_changed = 0;
+  ths->map = NULL;
+  ths->map_size = 0;
+
+  ths->sigma = (R*) plan_malloc(ths, (size_t)(ths->d) * sizeof(R));
+
+  for(t = 0;t < ths->d; t++)
+    ths->sigma[t] = ((R)ths->n[t]) / (R)(ths->N[t]);
+
+  WINDOW_HELP_INIT;
+
+  /* Y(zero_omp) first touches the vectors in the static OpenMP partition of
+   * the loops over the nodes and over the Fourier coefficients in B and D, so
+   * that the pages are spread over the NUMA nodes of the threads. */
+  if(ths->flags & MALLOC_X)
+  {
+    ths->x = (R*) plan_malloc(ths, (size_t)(ths->d * ths->M_total) * sizeof(R));
+    Y(zero_omp)(ths->x, ths->M_total, (size_t)(ths->d) * sizeof(R));
+  }
+
+  if(ths->flags & MALLOC_F_HAT)
+  {
+    ths->f_hat = (C*) plan_malloc(ths, (size_t)(ths->N_total) * sizeof(C));
+    Y(zero_omp)(ths->f_hat, ths->N_total, sizeof(C));
+  }
+
+  if(ths->flags & MALLOC_F)
+  {
+    ths->f = (C*) plan_malloc(ths, (size_t)(ths->M_total) * sizeof(C));
+    Y(zero_omp)(ths->f, ths->M_total, sizeof(C));
+  }
+
+  if(ths->flags & PRE_PHI_HUT)
+    precompute_phi_hut(ths);
+
+  if (ths->flags & PRE_LIN_PSI)
+  {
+      if (ths->K == 0)
+      {
+        ths->K = Y(m2K)(ths->window, ths->m);
+      }
+      ths->psi = (R*) plan_malloc(ths, (size_t)((ths->K+1) * ths->d) * sizeof(R));
+  }
+
+  if(ths->flags & PRE_FG_PSI)
+    ths->psi = (R*) plan_malloc(ths, (size_t)(ths->M_total * ths->d * 2) * sizeof(R));
+
+  if(ths->flags & PRE_PSI)
+    ths->psi = (R*) plan_malloc(ths, (size_t)(ths->M_total * ths->d * (2 * ths->m + 2)) * sizeof(R));
+
+  if(ths->flags & PRE_FULL_PSI)
+  {
+      for (t = 0, lprod = 1; t < ths->d; t++)
+        lprod *= 2 * ths->m + 2;
+
+      /* float tables need grid indices that fit into an int */
+      if (ths->n_total > INT_MAX)
+        ths->flags &= ~NFFT_FULL_PSI_FLOAT;
+
+      if (ths->flags & NFFT_FULL_PSI_FLOAT)
+      {
+        ths->psi_float = (float*) plan_malloc(ths, (size_t)(ths->M_total * lprod) * sizeof(float));
+        ths->psi_index_g32 = (int*) plan_malloc(ths, (size_t)(ths->M_total * lprod) * sizeof(int));
+      }
+      else
+      {
+        ths->psi = (R*) plan_malloc(ths, (size_t)(ths->M_total * lprod) * sizeof(R));
+        ths->psi_index_g = (INT*) plan_malloc(ths, (size_t)(ths->M_total * lprod) * sizeof(INT));
+        ths->psi_float = NULL;
+        ths->psi_index_g32 = NULL;
+      }
+
+      ths->psi_index_f = (INT*) plan_malloc(ths, (size_t)(ths->M_total) * sizeof(INT));
+  }
+  else
+  {
+    ths->flags &= ~NFFT_FULL_PSI_FLOAT;
+    ths->psi_float = NULL;
+    ths->psi_index_g32 = NULL;
+  }
+
+  ths->my_fftw_plan1_pruned = ths->my_fftw_plan2_pruned = NULL;
+
+  ths->fftw_nthreads = 1;
+
+  if(ths->flags & FFTW_INIT)
+  {
+#ifdef _OPENMP
+    INT nthreads = Y(get_num_threads)();
+
+    ths->fftw_nthreads = (int)nthreads;
+#endif
+
+    ths->g1 = (C*) plan_malloc(ths, (size_t)(ths->howmany * ths->n_total) * sizeof(C));
+    Y(zero_omp)(ths->g1, ths->howmany * ths->n_total, sizeof(C));
+
+    if(ths->flags & FFT_OUT_OF_PLACE)
+    {
+      ths->g2 = (C*) plan_malloc(ths, (size_t)(ths->howmany * ths->n_total) * sizeof(C));
+      Y(zero_omp)(ths->g2, ths->howmany * ths->n_total, sizeof(C));
+    }
+    else
+      ths->g2 = ths->g1;
+
+#ifdef _OPENMP
+#pragma omp critical (nfft_omp_critical_fftw_plan)
+{
+    FFTW(plan_with_nthreads)(nthreads);
+#endif
+    {
+      int *_n = plan_malloc(ths, (size_t)(ths->d) * sizeof(int));
+
+      for (t = 0; t < ths->d; t++)
+        _n[t] = (int)(ths->n[t]);
+
+      ths->my_fftw_plan1 = FFTW(plan_dft)((int)ths->d, _n, ths->g1, ths->g2, FFTW_FORWARD, ths->fftw_flags);
+      ths->my_fftw_plan2 = FFTW(plan_dft)((int)ths->d, _n, ths->g2, ths->g1, FFTW_BACKWARD, ths->fftw_flags);
+
+      if ((ths->flags & NFFT_PRUNED_FFT) && ths->d > 1)
+        nfft_pruned_fft_init(ths);
+
+      if (ths->howmany > 1)
+      {
+        ths->my_fftw_plan1_many = FFTW(plan_many_dft)((int)ths->d, _n,
+          (int)ths->howmany, ths->g1, NULL, 1, (int)ths->n_total, ths->g2, NULL,
+          1, (int)ths->n_total, FFTW_FORWARD, ths->fftw_flags);
+        ths->my_fftw_plan2_many = FFTW(plan_many_dft)((int)ths->d, _n,
+          (int)ths->howmany, ths->g2, NULL, 1, (int)ths->n_total, ths->g1, NULL,
+          1, (int)ths->n_total, FFTW_BACKWARD, ths->fftw_flags);
+      }
+      plan_free(ths, _n);
+    }
+#ifdef _OPENMP
+}
+#endif
+  }
+
+  if(ths->flags & NFFT_SORT_NODES)
+  {
+    ths->index_x = (INT*) plan_malloc(ths, sizeof(INT) * 2U * (size_t)(ths->M_total));
+    ths->index_x_tmp = (INT*) plan_malloc(ths, sizeof(INT) * 2U
+      * (size_t)(ths->M_total));
+  }
+  else
+  {
+    ths->index_x = NULL;
+    ths->index_x_tmp = NULL;
+  }
+
+  ths->mv_trafo = (void (*) (void* ))X(trafo);
+  ths->mv_adjoint = (void (*) (void* ))X(adjoint);
+}
+
+/** Flags of X(init) in dimension d. */
+static unsigned init_default_flags(const INT d)
+{
+  if (d > 1)
+  {
+#ifdef _OPENMP
+    return PRE_PHI_HUT | PRE_PSI | MALLOC_X| MALLOC_F_HAT | MALLOC_F |
+                      FFTW_INIT | NFFT_SORT_NODES |
+                 NFFT_OMP_BLOCKWISE_ADJOINT;
+#else
+    return PRE_PHI_HUT | PRE_PSI | MALLOC_X| MALLOC_F_HAT | MALLOC_F |
+                      FFTW_INIT | NFFT_SORT_NODES;
+#endif
+  }
+  else
+    return PRE_PHI_HUT | PRE_PSI | MALLOC_X| MALLOC_F_HAT | MALLOC_F |
+                      FFTW_INIT | FFT_OUT_OF_PLACE;
+}
+
+void X(init)(X(plan) *ths, int d, int *N, int M_total)
+{
+  INT t; /* index over all dimensions */
+
+  ths->d = (INT)d;
+  ths->arena = NULL;
+
+  ths->N = (INT*) Y(malloc)((size_t)(d) * sizeof(INT));
+
+  for (t = 0; t < d; t++)
+    ths->N[t] = (INT)N[t];
+
+  ths->M_total = (INT)M_total;
+
+  ths->n = (INT*) Y(malloc)((size_t)(d) * sizeof(INT));
+
+  for (t = 0; t < d; t++)
+    ths->n[t] = 2 * (Y(next_power_of_2)(ths->N[t]));
+
+  ths->m = WINDOW_HELP_ESTIMATE_m;
+  ths->window = WINDOW_DEFAULT;
+
+  ths->flags = init_default_flags(ths->d);
+  ths->fftw_flags= FFTW_ESTIMATE| FFTW_DESTROY_INPUT;
+
+  ths->K = 0;
+  ths->howmany = 1;
+  init_help(ths);
+}
+
+/**
+ * Chooses FFT lengths n[t], the smallest even sizes \f$2^a3^b5^c7^d\f$ of at
+ * least sigma*N[t], and the cut-off m with which the default window keeps the
+ * accuracy of X(init) on this grid. A sigma of 1.25 to 1.5 trades a wider
+ * window for an oversampled grid that is much smaller than the power of two
+ * sizes of X(init), in particular for d = 3. The shape parameter of the
+ * window follows from the actual oversampling factors n[t]/N[t].
+ */
+void X(oversampling_params)(int d, int *N, R sigma, int *n, int *m)
+{
+  R s = K(0.0);
+  int t;
+
+  for (t = 0; t < d; t++)
+  {
+    n[t] = (int)(Y(next_fft_size)(MAX((INT)(CEIL(sigma * (R)(N[t]))),
+      (INT)(N[t]) + 1)));
+    s = (t == 0) ? (R)(n[t]) / (R)(N[t]) : MIN(s, (R)(n[t]) / (R)(N[t]));
+  }
+
+  *m = (int)(Y(window_m)(WINDOW_DEFAULT, s, K(0.0)));
+
+  /* The window of a node must fit into the oversampled grid. */
+  for (t = 0; t < d; t++)
+    if (n[t] < 2 * *m + 2)
+      n[t] = (int)(Y(next_fft_size)((INT)(2 * *m + 2)));
+}
+
+/** Like X(init) with the FFT lengths and cut-off of X(oversampling_params). */
+void X(init_sigma)(X(plan) *ths, int d, int *N, int M_total, R sigma)
+{
+  int *n = (int*) Y(malloc)((size_t)(d) * sizeof(int));
+  int m;
+
+  X(oversampling_params)(d, N, sigma, n, &m);
+  X(init_guru)(ths, d, N, M_total, n, m, init_default_flags((INT)(d)),
+    FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+
+  Y(free)(n);
+}
+
+void X(init_guru)(X(plan) *ths, int d, int *N, int M_total, int *n, int m,
+  unsigned flags, unsigned fftw_flags)
+{
+  X(init_guru_window)(ths, d, N, M_total, n, m, flags, fftw_flags,
+    NFFT_WINDOW_DEFAULT);
+}
+
+void X(init_guru_window)(X(plan) *ths, int d, int *N, int M_total, int *n,
+  int m, unsigned flags, unsigned fftw_flags, unsigned window)
+{
+  X(init_guru_many)(ths, d, N, M_total, n, m, 1, flags, fftw_flags, window);
+}
+
+/**
+ * Sets the arena of a plan: the given one, or with flag NFFT_ARENA (implied
+ * by NFFT_ARENA_HUGE_PAGES) an own arena that takes the X(estimate_memory) of
+ * the plan plus the alignment padding of its blocks. Returns the flags of the
+ * plan, where NFFT_ARENA marks an own arena.
+ */
+static unsigned plan_arena_init(X(plan) *ths, int d, int *N, int M_total,
+  int *n, int m, unsigned flags, X(arena) *arena)
+{
+  ths->arena = arena;
+
+  if (arena != NULL)
+    return flags & ~(NFFT_ARENA | NFFT_ARENA_HUGE_PAGES);
+
+  if (flags & NFFT_ARENA_HUGE_PAGES)
+    flags |= NFFT_ARENA;
+
+  if (flags & NFFT_ARENA)
+    ths->arena = Y(arena_create)(X(estimate_memory)(d, N, M_total, n, m, flags)
+      + (size_t)(32 + 2 * d) * ARENA_ALIGN, flags);
+
+  return flags;
+}
+
+static void init_guru_arena_many(X(plan) *ths, int d, int *N, int M_total,
+  int *n, int m, int howmany, unsigned flags, unsigned fftw_flags,
+  unsigned window, X(arena) *arena)
+{
+  INT t; /* index over all dimensions */
+
+  flags = plan_arena_init(ths, d, N, M_total, n, m, flags, arena);
+
+  ths->d = (INT)d;
+  ths->M_total = (INT)M_total;
+  ths->N = (INT*) plan_malloc(ths, (size_t)(ths->d) * sizeof(INT));
+
+  for (t = 0; t < d; t++)
+    ths->N[t] = (INT)N[t];
+
+  ths->n = (INT*) plan_malloc(ths, (size_t)(ths->d) * sizeof(INT));
+
+  for (t = 0; t < d; t++)
+    ths->n[t] = (INT)n[t];
+
+  ths->m = (INT)m;
+  ths->window = Y(window_resolve)(window);
+
+  ths->flags = flags;
+  ths->fftw_flags = fftw_flags;
+
+  ths->K = 0;
+  ths->howmany = MAX(1, (INT)howmany);
+  init_help(ths);
+}
+
+void X(init_guru_many)(X(plan) *ths, int d, int *N, int M_total, int *n,
+  int m, int howmany, unsigned flags, unsigned fftw_flags, unsigned window)
+{
+  init_guru_arena_many(ths, d, N, M_total, n, m, howmany, flags, fftw_flags,
+    window, NULL);
+}
+
+/**
+ * Like X(init_guru), with all plan buffers in the given arena. After
+ * X(finalize), X(arena_reset) makes the arena ready for the next plan, so
+ * that a sequence of plans reuses the slab without calls to X(malloc).
+ */
+void X(init_guru_arena)(X(plan) *ths, int d, int *N, int M_total, int *n,
+  int m, unsigned flags, unsigned fftw_flags, X(arena) *arena)
+{
+  init_guru_arena_many(ths, d, N, M_total, n, m, 1, flags, fftw_flags,
+    NFFT_WINDOW_DEFAULT, arena);
+}
+
+void X(init_lin)(X(plan) *ths, int d, int *N, int M_total, int *n, int m, int K,
+  unsigned flags, unsigned fftw_flags)
+{
+  INT t; /* index over all dimensions */
+
+  flags = plan_arena_init(ths, d, N, M_total, n, m, flags, NULL);
+
+  ths->d = (INT)d;
+  ths->M_total = (INT)M_total;
+  ths->N = (INT*) plan_malloc(ths, (size_t)(ths->d) * sizeof(INT));
+
+  for (t = 0; t < d; t++)
+    ths->N[t] = (INT)N[t];
+
+  ths->n = (INT*) plan_malloc(ths, (size_t)(ths->d) * sizeof(INT));
+
+  for (t = 0; t < d; t++)
+    ths->n[t] = (INT)n[t];
+
+  ths->m = (INT)m;
+  ths->window = WINDOW_DEFAULT;
+
+  ths->flags = flags;
+  ths->fftw_flags = fftw_flags;
+
+  ths->K = K;
+  ths->howmany = 1;
+  init_help(ths);
+}
+
+/** Number of bytes X(init_guru) and X(precompute_one_psi) allocate for a plan
+ *  with these parameters and the default window. The plan struct itself, the
+ *  internal data of the FFTW plans and the temporary buffers of the transforms
+ *  are not included. */
+size_t X(estimate_memory)(int d, int *N, int M_total, int *n, int m,
+  unsigned flags)
+{
+  const unsigned window = Y(window_resolve)(NFFT_WINDOW_DEFAULT);
+  const size_t M = (size_t)(M_total);
+  size_t N_total = 1, n_total = 1, N_sum = 0, lprod = 1, bytes;
+  int t;
+
+  if (flags & NFFT_OMP_BLOCKWISE_ADJOINT)
+    flags |= NFFT_SORT_NODES;
+
+  for (t = 0; t < d; t++)
+  {
+    N_total *= (size_t)(N[t]);
+    n_total *= (size_t)(n[t]);
+    N_sum += (size_t)(N[t]);
+    lprod *= (size_t)(2 * m + 2);
+  }
+
+  /* N, n, sigma, b and the window coefficients */
+  bytes = (size_t)(d) * (2 * sizeof(INT) + 2 * sizeof(R))
+    + (size_t)(d * Y(window_coeffs_size)(window, (INT)m)) * sizeof(R);
+
+  if (flags & MALLOC_X)
+    bytes += (size_t)(d) * M * sizeof(R);
+
+  if (flags & MALLOC_F_HAT)
+    bytes += N_total * sizeof(C);
+
+  if (flags & MALLOC_F)
+    bytes += M * sizeof(C);
+
+  if (flags & PRE_PHI_HUT)
+    bytes += (size_t)(d) * sizeof(R*) + N_sum * sizeof(R);
+
+  if (flags & PRE_LIN_PSI)
+    bytes += (size_t)((Y(m2K)(window, (INT)m) + 1) * d) * sizeof(R);
+
+  if (flags & PRE_FG_PSI)
+    bytes += M * (size_t)(d) * 2 * sizeof(R);
+
+  if (flags & PRE_PSI)
+    bytes += M * (size_t)(d * (2 * m + 2)) * sizeof(R);
+
+  if (flags & PRE_FULL_PSI)
+  {
+    if ((flags & NFFT_FULL_PSI_FLOAT) && n_total <= (size_t)(INT_MAX))
+      bytes += M * lprod * (sizeof(float) + sizeof(int));
+    else
+      bytes += M * lprod * (sizeof(R) + sizeof(INT));
+
+    bytes += M * sizeof(INT);
+  }
+
+  if (flags & FFTW_INIT)
+  {
+    bytes += n_total * sizeof(C) * ((flags & FFT_OUT_OF_PLACE) ? 2U : 1U);
+
+    if ((flags & NFFT_PRUNED_FFT) && d > 1)
+      bytes += 2 * (size_t)(d) * sizeof(FFTW(plan));
+  }
+
+  if (flags & NFFT_SORT_NODES)
+    bytes += 4 * M * sizeof(INT);
+
+  return bytes;
+}
+
+/** Returns flags with the fastest precomputation scheme, and the node sorting
+ *  X(init) would use, whose X(estimate_memory) does not exceed max_bytes.
+ *  Schemes are tried in the order PRE_FULL_PSI, PRE_PSI, PRE_FG_PSI (Gaussian
+ *  window only), PRE_LIN_PSI and none, each with and then without sorting.
+ *  If nothing fits, the cheapest plan is returned. The precomputation and
+ *  sorting bits of flags are replaced, all others are kept. */
+unsigned X(budget_flags)(int d, int *N, int M_total, int *n, int m,
+  unsigned flags, size_t max_bytes)
+{
+  static const unsigned psi[] = {PRE_FULL_PSI, PRE_PSI, PRE_FG_PSI,
+    PRE_LIN_PSI, 0U};
+  unsigned sort = 0U;
+  size_t i;
+
+  flags &= ~(PRE_ONE_PSI | FG_PSI | NFFT_FULL_PSI_FLOAT | NFFT_SORT_NODES
+    | NFFT_OMP_BLOCKWISE_ADJOINT);
+
+  if (d > 1)
+  {
+#ifdef _OPENMP
+    sort = NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT;
+#else
+    sort = NFFT_SORT_NODES;
+#endif
+  }
+
+  for (i = 0; i < SIZE(psi); i++)
+  {
+    if ((psi[i] & PRE_FG_PSI)
+      && Y(window_resolve)(NFFT_WINDOW_DEFAULT) != NFFT_WINDOW_GAUSSIAN)
+      continue;
+
+    if (X(estimate_memory)(d, N, M_total, n, m, flags | psi[i] | sort)
+      <= max_bytes)
+      return flags | psi[i] | sort;
+
+    if (sort && X(estimate_memory)(d, N, M_total, n, m, flags | psi[i])
+      <= max_bytes)
+      return flags | psi[i];
+  }
+
+  return flags;
+}
+
+void X(init_guru_budget)(X(plan) *ths, int d, int *N, int M_total, int *n,
+  int m, unsigned flags, unsigned fftw_flags, size_t max_bytes)
+{
+  X(init_guru)(ths, d, N, M_total, n, m,
+    X(budget_flags)(d, N, M_total, n, m, flags, max_bytes), fftw_flags);
+}
+
+void X(init_1d)(X(plan) *ths, int N1, int M_total)
+{
+  int N[1];
+
+  N[0] = N1;
+
+  X(init)(ths, 1, N, M_total);
+}
+
+void X(init_2d)(X(plan) *ths, int N1, int N2, int M_total)
+{
+  int N[2];
+
+  N[0] = N1;
+  N[1] = N2;
+  X(init)(ths, 2, N, M_total);
+}
+
+void X(init_3d)(X(plan) *ths, int N1, int N2, int N3, int M_total)
+{
+  int N[3];
+
+  N[0] = N1;
+  N[1] = N2;
+  N[2] = N3;
+  X(init)(ths, 3, N, M_total);
+}
+
+const char* X(check)(X(plan) *ths)
+{
+  INT j;
+
+  if (!ths->f)
+      return "Member f not initialized.";
+
+  if (!ths->x)
+      return "Member x not initialized.";
+
+  if (!ths->f_hat)
+      return "Member f_hat not initialized.";
+
+  if ((ths->flags & PRE_LIN_PSI) && ths->K < ths->M_total)
+    return "Number of nodes too small to use PRE_LIN_PSI.";
+
+  if ((ths->flags & (FG_PSI | PRE_FG_PSI)) && ths->window != NFFT_WINDOW_GAUSSIAN)
+    return "FG_PSI and PRE_FG_PSI require the Gaussian window function.";
+
+  for (j = 0; j < ths->M_total * ths->d; j++)
+  {
+    if ((ths->x[j]<-K(0.5)) || (ths->x[j]>= K(0.5)))
+    {
+      return "ths->x out of range [-0.5,0.5)";
+    }
+  }
+
+  for (j = 0; j < ths->d; j++)
+  {
+    if (ths->sigma[j] <= 1)
+      return "Oversampling factor too small";
+    
+    /* Automatically calls trafo_direct if 
+    if(ths->N[j] <= ths->m)
+      return "Polynomial degree N is <= cut-off m";
+    */
+
+    if(ths->N[j]%2 == 1)
+      return "polynomial degree N has to be even";
+  }
+  return 0;
+}
+
+/* Plan files of X(save_plan) hold, in native byte order, a header, the
+ * bandwidths N and FFT lengths n as 64-bit integers, the FFTW wisdom as a
+ * string, the nodes x and the tables of PLAN_TABLES. The nodes and each table
+ * start at a multiple of PLAN_ALIGN bytes, so that all of them are aligned in
+ * a mapping of the whole file. */
+
+#define PLAN_MAGIC "NFFTPLAN"
+#define PLAN_VERSION 1
+#define PLAN_ALIGN 64
+#define PLAN_PAD(size) (((size) + PLAN_ALIGN - 1) / PLAN_ALIGN * PLAN_ALIGN)
+
+typedef struct
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t size_R;        /**< sizeof(R) */
+  uint32_t size_INT;      /**< sizeof(INT) */
+  uint32_t window;
+  uint32_t flags;
+  uint32_t fftw_flags;
+  int64_t d;
+  int64_t M_total;
+  int64_t m;
+  int64_t K;
+  int64_t howmany;
+  double psi_float_scale;
+  uint64_t nodes_hash;    /**< FNV-1a hash of the nodes */
+  uint64_t wisdom_size;   /**< length of the FFTW wisdom including the 0 */
+  uint64_t file_size;
+} plan_header_t;
+
+static uint64_t plan_nodes_hash(const R *x, const size_t size)
+{
+  const unsigned char *c = (const unsigned char*)x;
+  uint64_t h = 14695981039346656037ULL;
+  size_t i;
+
+  for (i = 0; i < size; i++)
+  {
+    h ^= (uint64_t)(c[i]);
+    h *= 1099511628211ULL;
+  }
+
+  return h;
+}
+
+/** Offset of the nodes in a plan file. */
+static size_t plan_data_offset(const plan_header_t *h)
+{
+  return PLAN_PAD(sizeof(plan_header_t) + 2 * (size_t)(h->d) * sizeof(int64_t)
+    + (size_t)(h->wisdom_size));
+}
+
+/** Tests that the sizes in a header are consistent with its file size, before
+ *  they are used to allocate and to read the file. */
+static int plan_header_valid(const plan_header_t *h)
+{
+  if (memcmp(h->magic, PLAN_MAGIC, sizeof(h->magic)) != 0
+    || h->version != PLAN_VERSION || h->size_R != sizeof(R)
+    || h->size_INT != sizeof(INT) || h->d <= 0 || h->d > 1024
+    || h->M_total < 0 || h->wisdom_size >= h->file_size
+    || (uint64_t)(h->M_total) > h->file_size / ((uint64_t)(h->d) * sizeof(R)))
+    return 0;
+
+  return IF(plan_data_offset(h) + PLAN_PAD((size_t)(h->d * h->M_total)
+    * sizeof(R)) <= h->file_size, 1, 0);
+}
+
+/** Writes pad < PLAN_ALIGN zero bytes. */
+static int plan_pad(FILE *f, const size_t pad)
+{
+  static const char zero[PLAN_ALIGN] = {0};
+
+  return IF(pad == 0 || fwrite(zero, 1, pad, f) == pad, 1, 0);
+}
+
+/** Writes size bytes and pads them to a multiple of PLAN_ALIGN. */
+static int plan_write(FILE *f, const void *p, const size_t size)
+{
+  if (size > 0 && fwrite(p, 1, size, f) != size)
+    return 0;
+
+  return plan_pad(f, PLAN_PAD(size) - size);
+}
+
+/** Maps a plan file of the given size read-only and shared, or reads it into
+ *  memory where mmap is not available. */
+static void *plan_map(const char *filename, const size_t size)
+{
+#ifdef NFFT_PLAN_MMAP
+  struct stat st;
+  void *p;
+  int fd = open(filename, O_RDONLY);
+
+  if (fd < 0)
+    return NULL;
+
+  if (fstat(fd, &st) != 0 || (size_t)(st.st_size) != size)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  return (p == MAP_FAILED) ? NULL : p;
+#else
+  FILE *f = fopen(filename, "rb");
+  void *p;
+
+  if (f == NULL)
+    return NULL;
+
+  p = Y(malloc)(size);
+  if (fread(p, 1, size, f) != size || fgetc(f) != EOF)
+  {
+    Y(free)(p);
+    p = NULL;
+  }
+  fclose(f);
+
+  return p;
+#endif
+}
+
+/**
+ * Writes a precomputed plan to a file from which X(load_plan) restores it
+ * without recomputing psi, the node sorting and the FFTW plans. Pending node
+ * changes are precomputed first; tables that have never been precomputed by
+ * X(precompute_one_psi) are written as they are. Returns 1 on success.
+ */
+int X(save_plan)(X(plan) *ths, const char *filename)
+{
+  plan_header_t h;
+  char *wisdom;
+  FILE *f;
+  size_t size;
+  INT t;
+  int ok;
+
+  update_nodes(ths);
+  sort(ths);
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, PLAN_MAGIC, sizeof(h.magic));
+  h.version = PLAN_VERSION;
+  h.size_R = (uint32_t)(sizeof(R));
+  h.size_INT = (uint32_t)(sizeof(INT));
+  h.window = ths->window;
+  h.flags = ths->flags;
+  h.fftw_flags = ths->fftw_flags;
+  h.d = (int64_t)(ths->d);
+  h.M_total = (int64_t)(ths->M_total);
+  h.m = (int64_t)(ths->m);
+  h.K = (int64_t)(ths->K);
+  h.howmany = (int64_t)(ths->howmany);
+  h.psi_float_scale = (double)(ths->psi_float_scale);
+  h.nodes_hash = plan_nodes_hash(ths->x, (size_t)(ths->d * ths->M_total)
+    * sizeof(R));
+
+#ifdef _OPENMP
+  #pragma omp critical (nfft_omp_critical_fftw_plan)
+#endif
+  wisdom = FFTW(export_wisdom_to_string)();
+
+  h.wisdom_size = (wisdom == NULL) ? 0U : (uint64_t)(strlen(wisdom) + 1);
+
+  size = plan_data_offset(&h)
+    + PLAN_PAD((size_t)(ths->d * ths->M_total) * sizeof(R));
+#define PLAN_SIZE(field, type, count, cond) \
+  if (cond) \
+    size += PLAN_PAD((count) * sizeof(type));
+  PLAN_TABLES(PLAN_SIZE)
+#undef PLAN_SIZE
+  h.file_size = (uint64_t)(size);
+
+  f = fopen(filename, "wb");
+  ok = IF(f != NULL, 1, 0);
+
+  ok = ok && IF(fwrite(&h, sizeof(h), 1, f) == 1, 1, 0);
+  for (t = 0; t < 2 * ths->d; t++)
+  {
+    const int64_t v = (int64_t)((t < ths->d) ? ths->N[t] : ths->n[t - ths->d]);
+    ok = ok && IF(fwrite(&v, sizeof(v), 1, f) == 1, 1, 0);
+  }
+  ok = ok && IF(h.wisdom_size == 0 || fwrite(wisdom, 1, (size_t)(h.wisdom_size),
+    f) == (size_t)(h.wisdom_size), 1, 0);
+  /* one padding after header, N, n and the wisdom */
+  ok = ok && plan_pad(f, plan_data_offset(&h) - sizeof(h) - 2
+    * (size_t)(ths->d) * sizeof(int64_t) - (size_t)(h.wisdom_size));
+  ok = ok && plan_write(f, ths->x, (size_t)(ths->d * ths->M_total)
+    * sizeof(R));
+#define PLAN_WRITE(field, type, count, cond) \
+  if (cond) \
+    ok = ok && plan_write(f, ths->field, (count) * sizeof(type));
+  PLAN_TABLES(PLAN_WRITE)
+#undef PLAN_WRITE
+
+  if (f != NULL && fclose(f) != 0)
+    ok = 0;
+
+  if (wisdom != NULL)
+    FFTW(free)(wisdom);
+
+  return ok;
+}
+
+/**
+ * Initialises a plan from a file written by X(save_plan). The FFTW wisdom of
+ * the file is imported before the FFTW plans are created, the nodes are
+ * copied to ths->x, which is always allocated, and the tables of psi and the
+ * node sorting are mapped read-only and shared from the file. They are copied
+ * to own memory when the plan precomputes again, e.g. after X(set_nodes).
+ * If x is not NULL, it holds the d*M_total nodes the plan is expected for and
+ * the plan is only restored if the nodes of the file are the same; the hash of
+ * the nodes in the file detects corruption only.
+ * Returns 1 on success and 0, leaving the plan uninitialised, if the file
+ * cannot be read, was written by a library of another precision or for other
+ * nodes than x.
+ */
+int X(load_plan)(X(plan) *ths, const char *filename, const R *x)
+{
+  plan_header_t h;
+  int64_t *Nn = NULL;
+  char *wisdom = NULL;
+  unsigned char *map = NULL;
+  size_t offset;
+  FILE *f;
+  INT t;
+  int ok;
+
+  f = fopen(filename, "rb");
+  if (f == NULL)
+    return 0;
+
+  ok = IF(fread(&h, sizeof(h), 1, f) == 1, 1, 0);
+  ok = ok && plan_header_valid(&h);
 
-      /** form \f$ \hat f_k = \frac{\hat g_k}{c_k\left(\phi\right)} \text{ for }
-       *  k \in I_N \f$
-       */
-      TIC(0)
-      D_T(ths);
-      TOC(0)
-    }
+  if (ok)
+  {
+    Nn = (int64_t*) Y(malloc)(2 * (size_t)(h.d) * sizeof(int64_t));
+    wisdom = (char*) Y(malloc)((size_t)(h.wisdom_size) + 1);
+    ok = IF(fread(Nn, sizeof(int64_t), 2 * (size_t)(h.d), f)
+      == 2 * (size_t)(h.d), 1, 0);
+    ok = ok && IF(fread(wisdom, 1, (size_t)(h.wisdom_size), f)
+      == (size_t)(h.wisdom_size), 1, 0);
+    wisdom[h.wisdom_size] = '\0';
   }
-} /* nfft_adjoint */
 
+  fclose(f);
 
-/** initialisation of direct transform
- */
-static void precompute_phi_hut(X(plan) *ths)
-{
-  INT ks[ths->d]; /* index over all frequencies */
-  INT t; /* index over all dimensions */
+  if (ok)
+    map = (unsigned char*) plan_map(filename, (size_t)(h.file_size));
+
+  if (map == NULL)
+  {
+    Y(free)(wisdom);
+    Y(free)(Nn);
+    return 0;
+  }
+
+  if (h.wisdom_size > 0)
+  {
+#ifdef _OPENMP
+    #pragma omp critical (nfft_omp_critical_fftw_plan)
+#endif
+    FFTW(import_wisdom_from_string)(wisdom);
+  }
+  Y(free)(wisdom);
 
-  ths->c_phi_inv = (R**) Y(malloc)((size_t)(ths->d) * sizeof(R*));
+  ths->d = (INT)(h.d);
+  ths->M_total = (INT)(h.M_total);
+  ths->arena = NULL;
+  ths->N = (INT*) Y(malloc)((size_t)(ths->d) * sizeof(INT));
+  ths->n = (INT*) Y(malloc)((size_t)(ths->d) * sizeof(INT));
 
   for (t = 0; t < ths->d; t++)
   {
-    ths->c_phi_inv[t] = (R*)Y(malloc)((size_t)(ths->N[t]) * sizeof(R));
+    ths->N[t] = (INT)(Nn[t]);
+    ths->n[t] = (INT)(Nn[ths->d + t]);
+  }
+  Y(free)(Nn);
+
+  ths->m = (INT)(h.m);
+  ths->window = h.window;
+  ths->flags = (h.flags | MALLOC_X) & ~(NFFT_ARENA | NFFT_ARENA_HUGE_PAGES);
+  ths->fftw_flags = h.fftw_flags;
+  ths->K = (INT)(h.K);
+  ths->howmany = (INT)(h.howmany);
+  init_help(ths);
 
-    for (ks[t] = 0; ks[t] < ths->N[t]; ks[t]++)
-    {
-      ths->c_phi_inv[t][ks[t]]= K(1.0) / (PHI_HUT(ths->n[t], ks[t] - ths->N[t] / 2,t));
-    }
+  /* replace the tables allocated by init_help by views of the file */
+#define PLAN_FREE(field, type, count, cond) \
+  if (cond) \
+    plan_free(ths, ths->field);
+  PLAN_TABLES(PLAN_FREE)
+#undef PLAN_FREE
+
+  ths->map = map;
+  ths->map_size = (size_t)(h.file_size);
+
+  offset = plan_data_offset(&h);
+  memcpy(ths->x, map + offset, (size_t)(ths->d * ths->M_total) * sizeof(R));
+  offset += PLAN_PAD((size_t)(ths->d * ths->M_total) * sizeof(R));
+
+#define PLAN_VIEW(field, type, count, cond) \
+  if (cond) \
+  { \
+    ths->field = (type*)(map + offset); \
+    offset += PLAN_PAD((count) * sizeof(type)); \
   }
-} /* nfft_phi_hut */
+  PLAN_TABLES(PLAN_VIEW)
+#undef PLAN_VIEW
 
-/** create a lookup table, but NOT for each node
- *  good idea K=2^xx
- *  assumes an EVEN window function
- */
-void X(precompute_lin_psi)(X(plan) *ths)
-{
-  INT t;                                /**< index over all dimensions       */
-  INT j;                                /**< index over all nodes            */
-  R step;                          /**< step size in [0,(m+2)/n]        */
+  ths->psi_float_scale = (R)(h.psi_float_scale);
+  ths->nodes_changed = 0;
 
-  for (t=0; t<ths->d; t++)
-    {
-      step = ((R)(ths->m+2)) / ((R)(ths->K * ths->n[t]));
-      for(j = 0;j <= ths->K; j++)
+  if (offset != ths->map_size || plan_nodes_hash(ths->x,
+    (size_t)(ths->d * ths->M_total) * sizeof(R)) != h.nodes_hash
+    || (x != NULL && memcmp(ths->x, x, (size_t)(ths->d * ths->M_total)
+    * sizeof(R)) != 0))
   {
-    ths->psi[(ths->K+1)*t + j] = PHI(ths->n[t], (R)(j) * step,t);
-  } /* for(j) */
-    } /* for(t) */
+    X(finalize)(ths);
+    return 0;
+  }
+
+  return 1;
 }
 
-void X(precompute_fg_psi)(X(plan) *ths)
+void X(finalize)(X(plan) *ths)
 {
-  INT t;                                /**< index over all dimensions       */
-  INT u, o;                             /**< depends on x_j                  */
+  INT t; /* index over dimensions */
 
-  sort(ths);
+  if (ths->map != NULL)
+  {
+#define PLAN_FORGET(field, type, count, cond) ths->field = NULL;
+    PLAN_TABLES(PLAN_FORGET)
+#undef PLAN_FORGET
+    plan_unmap(ths);
+  }
 
-  for (t=0; t<ths->d; t++)
+  if(ths->flags & NFFT_SORT_NODES)
+  {
+    plan_free(ths, ths->index_x_tmp);
+    plan_free(ths, ths->index_x);
+  }
+
+  if(ths->flags & FFTW_INIT)
   {
-    INT j;
 #ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(j,u,o)
+    #pragma omp critical (nfft_omp_critical_fftw_plan)
 #endif
-    for (j = 0; j < ths->M_total; j++)
-      {
-  uo(ths,j,&u,&o,t);
+    FFTW(destroy_plan)(ths->my_fftw_plan2);
+#ifdef _OPENMP
+    #pragma omp critical (nfft_omp_critical_fftw_plan)
+#endif
+    FFTW(destroy_plan)(ths->my_fftw_plan1);
 
-        ths->psi[2*(j*ths->d+t)]=
-            (PHI(ths->n[t] ,(ths->x[j*ths->d+t] - ((R)u) / (R)(ths->n[t])),t));
+    if (ths->howmany > 1)
+    {
+#ifdef _OPENMP
+      #pragma omp critical (nfft_omp_critical_fftw_plan)
+#endif
+      {
+        FFTW(destroy_plan)(ths->my_fftw_plan2_many);
+        FFTW(destroy_plan)(ths->my_fftw_plan1_many);
+      }
+    }
 
-        ths->psi[2*(j*ths->d+t)+1]=
-            EXP(K(2.0) * ((R)(ths->n[t]) * ths->x[j*ths->d+t] - (R)(u)) / ths->b[t]);
-      } /* for(j) */
-  }
-  /* for(t) */
-} /* nfft_precompute_fg_psi */
+#ifdef _OPENMP
+    #pragma omp critical (nfft_omp_critical_fftw_plan)
+#endif
+    {
+      if (ths->my_fftw_plan2_pruned)
+        nfft_pruned_fft_destroy(ths, &ths->my_fftw_plan2_pruned);
+      if (ths->my_fftw_plan1_pruned)
+        nfft_pruned_fft_destroy(ths, &ths->my_fftw_plan1_pruned);
+    }
 
-void X(precompute_psi)(X(plan) *ths)
-{
-  INT t; /* index over all dimensions */
-  INT l; /* index u<=l<=o */
-  INT lj; /* index 0<=lj<u+o+1 */
-  INT u, o; /* depends on x_j */
+    if(ths->flags & FFT_OUT_OF_PLACE)
+      plan_free(ths, ths->g2);
 
-  sort(ths);
+    plan_free(ths, ths->g1);
+  }
 
-  for (t=0; t<ths->d; t++)
+  if(ths->flags & PRE_FULL_PSI)
   {
-    INT j;
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(j,l,lj,u,o)
-#endif
-    for (j = 0; j < ths->M_total; j++)
+    if (ths->flags & NFFT_FULL_PSI_FLOAT)
     {
-      uo(ths,j,&u,&o,t);
+      plan_free(ths, ths->psi_index_g32);
+      plan_free(ths, ths->psi_float);
+    }
+    else
+    {
+      plan_free(ths, ths->psi_index_g);
+      plan_free(ths, ths->psi);
+    }
+    plan_free(ths, ths->psi_index_f);
+  }
 
-      for(l = u, lj = 0; l <= o; l++, lj++)
-        ths->psi[(j * ths->d + t) * (2 * ths->m + 2) + lj] =
-            (PHI(ths->n[t], (ths->x[j*ths->d+t] - ((R)l) / (R)(ths->n[t])), t));
-    } /* for(j) */
+  if(ths->flags & PRE_PSI)
+    plan_free(ths, ths->psi);
+
+  if(ths->flags & PRE_FG_PSI)
+    plan_free(ths, ths->psi);
+
+  if(ths->flags & PRE_LIN_PSI)
+    plan_free(ths, ths->psi);
+
+  if(ths->flags & PRE_PHI_HUT)
+  {
+    for (t = 0; t < ths->d; t++)
+        plan_free(ths, ths->c_phi_inv[t]);
+    plan_free(ths, ths->c_phi_inv);
   }
-  /* for(t) */
-} /* nfft_precompute_psi */
 
-#ifdef _OPENMP
-static void nfft_precompute_full_psi_omp(X(plan) *ths)
+  if(ths->flags & MALLOC_F)
+    plan_free(ths, ths->f);
+
+  if(ths->flags & MALLOC_F_HAT)
+    plan_free(ths, ths->f_hat);
+
+  if(ths->flags & MALLOC_X)
+    plan_free(ths, ths->x);
+
+  WINDOW_HELP_FINALIZE;
+
+  plan_free(ths, ths->sigma);
+  plan_free(ths, ths->n);
+  plan_free(ths, ths->N);
+
+  if (ths->flags & NFFT_ARENA)
+    Y(arena_destroy)(ths->arena);
+}
+
+/* Real-valued NFFT. The samples are real, so only the half spectrum
+ * k_{d-1} >= 0 is stored and the transform takes the real part of the sum over
+ * it. The window convolution runs on a real oversampled vector g and the
+ * FFT is a c2r (trafo) or r2c (adjoint) transform of its half spectrum g_hat.
+ * With this definition the adjoint is the transpose of the transform with
+ * respect to the real inner product of the interleaved f_hat, which is what
+ * the solver module expects. The nodes, the window and the precomputed psi
+ * and phi_hut live in the internal plan plan_nfft. */
+
+/** Frequency ranges of the half spectrum for Y(ndft_trafo). */
+static void nfft_real_range(const X(real_plan) *ths, INT *L, INT *k0)
 {
-  INT j;                                /**< index over all nodes            */
-  INT lprod;                            /**< 'bandwidth' of matrix B         */
+  INT t;
 
+  for (t = 0; t < ths->d - 1; t++)
   {
-    INT t;
-    for(t=0,lprod = 1; t<ths->d; t++)
-        lprod *= 2*ths->m+2;
+    L[t] = ths->plan_nfft.N[t];
+    k0[t] = -L[t] / 2;
   }
+  L[ths->d - 1] = ths->N_half;
+  k0[ths->d - 1] = 0;
+}
 
-  #pragma omp parallel for default(shared) private(j)
-  for(j=0; j<ths->M_total; j++)
-    {
-      INT t,t2;                             /**< index over all dimensions       */
-      INT l_L;                              /**< plain index 0<=l_L<lprod        */
-      INT lj[ths->d];                       /**< multi index 0<=lj<u+o+1         */
-      INT ll_plain[ths->d+1];               /**< postfix plain index             */
+void X(real_trafo_direct)(const X(real_plan) *ths)
+{
+  INT L[ths->d], k0[ths->d], j;
+  C *g = (C*)Y(malloc)((size_t)(ths->M_total) * sizeof(C));
 
-      INT u[ths->d], o[ths->d];             /**< depends on x_j                  */
+  nfft_real_range(ths, L, k0);
+  Y(ndft_trafo)(ths->d, L, k0, ths->M_total, ths->x, (const C*)ths->f_hat, g,
+    K(-1.0));
 
-      R phi_prod[ths->d+1];
-      INT ix = j*lprod;
+  for (j = 0; j < ths->M_total; j++)
+    ths->f[j] = CREAL(g[j]);
 
-      phi_prod[0]=1;
-      ll_plain[0]=0;
+  Y(free)(g);
+}
 
-      MACRO_init_uo_l_lj_t;
+void X(real_adjoint_direct)(const X(real_plan) *ths)
+{
+  INT L[ths->d], k0[ths->d], j;
+  C *g = (C*)Y(malloc)((size_t)(ths->M_total) * sizeof(C));
 
-      for(l_L=0; l_L<lprod; l_L++, ix++)
-      {
-        MACRO_update_phi_prod_ll_plain(without_PRE_PSI);
+  for (j = 0; j < ths->M_total; j++)
+    g[j] = ths->f[j];
 
-        ths->psi_index_g[ix]=ll_plain[ths->d];
-        ths->psi[ix]=phi_prod[ths->d];
+  nfft_real_range(ths, L, k0);
+  Y(ndft_adjoint)(ths->d, L, k0, ths->M_total, ths->x, g, (C*)ths->f_hat,
+    K(1.0));
 
-        MACRO_count_uo_l_lj_t;
-      } /* for(l_L) */
+  Y(free)(g);
+}
 
-      ths->psi_index_f[j]=lprod;
-    } /* for(j) */
+/** Entry ks of the diagonal matrix D in dimension t. */
+static inline R nfft_real_c_phi_inv(const X(plan) *ths, const INT t,
+  const INT ks)
+{
+  if (ths->flags & PRE_PHI_HUT)
+    return ths->c_phi_inv[t][ks];
+
+  return K(1.0) / PHI_HUT(ths->n[t], ks - ths->N[t] / 2, t);
 }
-#endif
 
-void X(precompute_full_psi)(X(plan) *ths)
+/**
+ * Offset in g_hat of the line r of the half spectrum along the last dimension
+ * and the product of the entries of D in the other dimensions.
+ */
+static inline INT nfft_real_line(const X(real_plan) *ths, INT r, R *c)
 {
-#ifdef _OPENMP
-  sort(ths);
+  const X(plan) *p = &ths->plan_nfft;
+  INT t, ks, off = 0, stride = p->n[ths->d - 1] / 2 + 1;
 
-  nfft_precompute_full_psi_omp(ths);
-#else
-  INT t, t2; /* index over all dimensions */
-  INT j; /* index over all nodes */
-  INT l_L; /* plain index 0 <= l_L < lprod */
-  INT lj[ths->d]; /* multi index 0<=lj<u+o+1 */
-  INT ll_plain[ths->d+1]; /* postfix plain index */
-  INT lprod; /* 'bandwidth' of matrix B */
-  INT u[ths->d], o[ths->d]; /* depends on x_j */
+  *c = K(1.0);
 
-  R phi_prod[ths->d+1];
+  for (t = ths->d - 2; t >= 0; t--)
+  {
+    ks = r % p->N[t];
+    r /= p->N[t];
+    *c *= nfft_real_c_phi_inv(p, t, ks);
+    off += ((ks - p->N[t] / 2 + p->n[t]) % p->n[t]) * stride;
+    stride *= p->n[t];
+  }
 
-  INT ix, ix_old;
+  return off;
+}
 
-  sort(ths);
+/**
+ * g_hat = conj(D f_hat) on the half spectrum, halved for k_{d-1} > 0. The
+ * plane k_{d-1} = 0 is replaced by its Hermitian part, for which the c2r
+ * transform yields the real part of the sum over this plane.
+ */
+static void nfft_real_D_A(X(real_plan) *ths)
+{
+  const X(plan) *p = &ths->plan_nfft;
+  const C *f_hat = (const C*)ths->f_hat;
+  const INT NH = ths->N_half, nh = p->n[ths->d - 1] / 2 + 1;
+  const INT lines = ths->N_total / 2 / NH, plane = ths->n_hat_total / nh;
+  C *g_hat = ths->g_hat;
+  INT r, l;
 
-  phi_prod[0] = K(1.0);
-  ll_plain[0] = 0;
+  memset(g_hat, 0, (size_t)(ths->n_hat_total) * sizeof(C));
 
-  for (t = 0, lprod = 1; t < ths->d; t++)
-    lprod *= 2 * ths->m + 2;
+#ifdef _OPENMP
+  #pragma omp parallel for default(shared) private(r) schedule(static)
+#endif
+  for (r = 0; r < lines; r++)
+  {
+    R c;
+    const INT off = nfft_real_line(ths, r, &c);
+    const INT ks0 = p->N[ths->d - 1] / 2;
+    INT kk;
 
-  for (j = 0, ix = 0, ix_old = 0; j < ths->M_total; j++)
+    g_hat[off] = CONJ(f_hat[r * NH]) * c
+      * nfft_real_c_phi_inv(p, ths->d - 1, ks0);
+
+    for (kk = 1; kk < NH; kk++)
+      g_hat[off + kk] = CONJ(f_hat[r * NH + kk]) * (K(0.5) * c)
+        * nfft_real_c_phi_inv(p, ths->d - 1, ks0 + kk);
+  }
+
+  for (l = 0; l < plane; l++)
   {
-    MACRO_init_uo_l_lj_t;
+    INT t, ll = l, lp = 0, stride = 1;
 
-    for (l_L = 0; l_L < lprod; l_L++, ix++)
+    for (t = ths->d - 2; t >= 0; t--)
     {
-      MACRO_update_phi_prod_ll_plain(without_PRE_PSI);
+      lp += ((p->n[t] - ll % p->n[t]) % p->n[t]) * stride;
+      ll /= p->n[t];
+      stride *= p->n[t];
+    }
 
-      ths->psi_index_g[ix] = ll_plain[ths->d];
-      ths->psi[ix] = phi_prod[ths->d];
+    if (lp == l)
+      g_hat[l * nh] = CREAL(g_hat[l * nh]);
+    else if (lp > l)
+    {
+      const C a = g_hat[l * nh], b = g_hat[lp * nh];
 
-      MACRO_count_uo_l_lj_t;
-    } /* for(l_L) */
+      g_hat[l * nh] = K(0.5) * (a + CONJ(b));
+      g_hat[lp * nh] = K(0.5) * (b + CONJ(a));
+    }
+  }
+}
 
-    ths->psi_index_f[j] = ix - ix_old;
-    ix_old = ix;
-  } /* for(j) */
+/** f_hat = D conj(g_hat) on the half spectrum. */
+static void nfft_real_D_T(X(real_plan) *ths)
+{
+  const X(plan) *p = &ths->plan_nfft;
+  C *f_hat = (C*)ths->f_hat;
+  const INT NH = ths->N_half, lines = ths->N_total / 2 / NH;
+  INT r;
+
+#ifdef _OPENMP
+  #pragma omp parallel for default(shared) private(r) schedule(static)
 #endif
+  for (r = 0; r < lines; r++)
+  {
+    R c;
+    const INT off = nfft_real_line(ths, r, &c);
+    const INT ks0 = p->N[ths->d - 1] / 2;
+    INT kk;
+
+    for (kk = 0; kk < NH; kk++)
+      f_hat[r * NH + kk] = CONJ(ths->g_hat[off + kk]) * c
+        * nfft_real_c_phi_inv(p, ths->d - 1, ks0 + kk);
+  }
 }
 
-void X(precompute_one_psi)(X(plan) *ths)
-{
-  if(ths->flags & PRE_LIN_PSI)
-    X(precompute_lin_psi)(ths);
-  if(ths->flags & PRE_FG_PSI)
-    X(precompute_fg_psi)(ths);
-  if(ths->flags & PRE_PSI)
-    X(precompute_psi)(ths);
-  if(ths->flags & PRE_FULL_PSI)
-    X(precompute_full_psi)(ths);
+#define MACRO_REAL_B_FIXED_KERNELS(MM) \
+static inline R nfft_real_sum_row_##MM(const R *psij, const R *gj) \
+{ \
+  R s = K(0.0); \
+  INT l; \
+  for (l = 0; l < 2*MM+2; l++) \
+    s += psij[l] * gj[l]; \
+  return s; \
+} \
+\
+static inline void nfft_real_upd_row_##MM(R *gj, const R a, const R *psij) \
+{ \
+  INT l; \
+  for (l = 0; l < 2*MM+2; l++) \
+    gj[l] += psij[l] * a; \
 }
 
-static void init_help(X(plan) *ths)
-{
-  INT t; /* index over all dimensions */
-  INT lprod; /* 'bandwidth' of matrix B */
+NFFT_B_FOR_EACH_M(MACRO_REAL_B_FIXED_KERNELS)
 
-  if (ths->flags & NFFT_OMP_BLOCKWISE_ADJOINT)
-    ths->flags |= NFFT_SORT_NODES;
+#define MACRO_REAL_B_FIXED_CASE_SUM_ROW(MM) \
+  case MM: return nfft_real_sum_row_##MM(psij, row + u);
+#define MACRO_REAL_B_FIXED_CASE_UPD_ROW(MM) \
+  case MM: nfft_real_upd_row_##MM(row + u, a, psij); return;
 
-  ths->N_total = intprod(ths->N, 0, ths->d);
-  ths->n_total = intprod(ths->n, 0, ths->d);
+/** Sum of row[(u+l)%n] psij[l] over l = 0,...,2m+1, 0 <= u < n. */
+static inline R nfft_real_sum_row(const R *row, const R *psij, const INT u,
+  const INT m, const INT n)
+{
+  const INT len = 2 * m + 2, len0 = MIN(len, n - u);
+  R s = K(0.0);
+  INT l;
+
+  if (len0 == len)
+  {
+    switch (m)
+    {
+      NFFT_B_FOR_EACH_M(MACRO_REAL_B_FIXED_CASE_SUM_ROW)
+      default: break;
+    }
+  }
 
-  ths->sigma = (R*) Y(malloc)((size_t)(ths->d) * sizeof(R));
+  for (l = 0; l < len0; l++)
+    s += row[u + l] * psij[l];
+  for (l = len0; l < len; l++)
+    s += row[l - len0] * psij[l];
 
-  for(t = 0;t < ths->d; t++)
-    ths->sigma[t] = ((R)ths->n[t]) / (R)(ths->N[t]);
+  return s;
+}
 
-  WINDOW_HELP_INIT;
+/** Adds a psij[l] to row[(u+l)%n] for l = 0,...,2m+1, 0 <= u < n. */
+static inline void nfft_real_upd_row(R *row, const R a, const R *psij,
+  const INT u, const INT m, const INT n)
+{
+  const INT len = 2 * m + 2, len0 = MIN(len, n - u);
+  INT l;
 
-  if(ths->flags & MALLOC_X)
-    ths->x = (R*)Y(malloc)((size_t)(ths->d * ths->M_total) * sizeof(R));
+  if (len0 == len)
+  {
+    switch (m)
+    {
+      NFFT_B_FOR_EACH_M(MACRO_REAL_B_FIXED_CASE_UPD_ROW)
+      default: break;
+    }
+  }
 
-  if(ths->flags & MALLOC_F_HAT)
-    ths->f_hat = (C*)Y(malloc)((size_t)(ths->N_total) * sizeof(C));
+  for (l = 0; l < len0; l++)
+    row[u + l] += a * psij[l];
+  for (l = len0; l < len; l++)
+    row[l - len0] += a * psij[l];
+}
 
-  if(ths->flags & MALLOC_F)
-    ths->f = (C*)Y(malloc)((size_t)(ths->M_total) * sizeof(C));
+/**
+ * Window of node j on the real oversampled vector: the offsets off[t*(2m+2)+l]
+ * in g of its grid points in dimension t < d-1, the first grid point u0 in
+ * dimension 0 and u in the last dimension, 0 <= u0 < n_0, 0 <= u < n_{d-1}.
+ */
+static inline void nfft_real_window(const X(plan) *ths, const INT j, INT *off,
+  INT *u0, INT *u)
+{
+  const INT m2p2 = 2 * ths->m + 2;
+  INT t, l, c, o, stride = ths->n[ths->d - 1];
 
-  if(ths->flags & PRE_PHI_HUT)
-    precompute_phi_hut(ths);
+  uo(ths, j, u, &o, ths->d - 1);
+  *u = (*u % stride + stride) % stride;
+  *u0 = *u;
 
-  if (ths->flags & PRE_LIN_PSI)
+  for (t = ths->d - 2; t >= 0; t--)
   {
-      if (ths->K == 0)
-      {
-        ths->K = Y(m2K)(ths->m);
-      }
-      ths->psi = (R*) Y(malloc)((size_t)((ths->K+1) * ths->d) * sizeof(R));
+    uo(ths, j, &c, &o, t);
+    c = (c % ths->n[t] + ths->n[t]) % ths->n[t];
+    *u0 = c;
+    for (l = 0; l < m2p2; l++, c = (c + 1 == ths->n[t]) ? 0 : c + 1)
+      off[t * m2p2 + l] = c * stride;
+    stride *= ths->n[t];
   }
+}
 
-  if(ths->flags & PRE_FG_PSI)
-    ths->psi = (R*) Y(malloc)((size_t)(ths->M_total * ths->d * 2) * sizeof(R));
+/** Interpolation from the window of a node in the dimensions t,...,d-1. */
+static R nfft_real_interp_window(const X(plan) *ths, const R *g,
+  const R *psij, const INT *off, const INT u, const INT t)
+{
+  const INT m = ths->m, m2p2 = 2 * m + 2, d = ths->d, n = ths->n[d - 1];
+  R s = K(0.0);
+  INT l0, l1;
 
-  if(ths->flags & PRE_PSI)
-    ths->psi = (R*) Y(malloc)((size_t)(ths->M_total * ths->d * (2 * ths->m + 2)) * sizeof(R));
+  if (t == d - 1)
+    return nfft_real_sum_row(g, psij + t * m2p2, u, m, n);
 
-  if(ths->flags & PRE_FULL_PSI)
+  if (t == d - 2)
   {
-      for (t = 0, lprod = 1; t < ths->d; t++)
-        lprod *= 2 * ths->m + 2;
-
-      ths->psi = (R*) Y(malloc)((size_t)(ths->M_total * lprod) * sizeof(R));
-
-      ths->psi_index_f = (INT*) Y(malloc)((size_t)(ths->M_total) * sizeof(INT));
-      ths->psi_index_g = (INT*) Y(malloc)((size_t)(ths->M_total * lprod) * sizeof(INT));
+    for (l0 = 0; l0 < m2p2; l0++)
+      s += psij[t * m2p2 + l0] * nfft_real_sum_row(g + off[t * m2p2 + l0],
+        psij + (t + 1) * m2p2, u, m, n);
+    return s;
   }
 
-  if(ths->flags & FFTW_INIT)
+  if (t == d - 3)
   {
-#ifdef _OPENMP
-    INT nthreads = Y(get_num_threads)();
-#endif
-
-    ths->g1 = (C*)Y(malloc)((size_t)(ths->n_total) * sizeof(C));
-
-    if(ths->flags & FFT_OUT_OF_PLACE)
-      ths->g2 = (C*) Y(malloc)((size_t)(ths->n_total) * sizeof(C));
-    else
-      ths->g2 = ths->g1;
-
-#ifdef _OPENMP
-#pragma omp critical (nfft_omp_critical_fftw_plan)
-{
-    FFTW(plan_with_nthreads)(nthreads);
-#endif
+    for (l0 = 0; l0 < m2p2; l0++)
     {
-      int *_n = Y(malloc)((size_t)(ths->d) * sizeof(int));
-
-      for (t = 0; t < ths->d; t++)
-        _n[t] = (int)(ths->n[t]);
+      const R *g0 = g + off[t * m2p2 + l0];
+      R s1 = K(0.0);
 
-      ths->my_fftw_plan1 = FFTW(plan_dft)((int)ths->d, _n, ths->g1, ths->g2, FFTW_FORWARD, ths->fftw_flags);
-      ths->my_fftw_plan2 = FFTW(plan_dft)((int)ths->d, _n, ths->g2, ths->g1, FFTW_BACKWARD, ths->fftw_flags);
-      Y(free)(_n);
+      for (l1 = 0; l1 < m2p2; l1++)
+        s1 += psij[(t + 1) * m2p2 + l1] * nfft_real_sum_row(g0
+          + off[(t + 1) * m2p2 + l1], psij + (t + 2) * m2p2, u, m, n);
+      s += psij[t * m2p2 + l0] * s1;
     }
-#ifdef _OPENMP
-}
-#endif
+    return s;
   }
 
-  if(ths->flags & NFFT_SORT_NODES)
-    ths->index_x = (INT*) Y(malloc)(sizeof(INT) * 2U * (size_t)(ths->M_total));
-  else
-    ths->index_x = NULL;
+  for (l0 = 0; l0 < m2p2; l0++)
+    s += psij[t * m2p2 + l0] * nfft_real_interp_window(ths,
+      g + off[t * m2p2 + l0], psij, off, u, t + 1);
 
-  ths->mv_trafo = (void (*) (void* ))X(trafo);
-  ths->mv_adjoint = (void (*) (void* ))X(adjoint);
+  return s;
 }
 
-void X(init)(X(plan) *ths, int d, int *N, int M_total)
+/** Spreading of a into the window of a node in the dimensions t,...,d-1. */
+static void nfft_real_spread_window(const X(plan) *ths, R *g, const R a,
+  const R *psij, const INT *off, const INT u, const INT t)
 {
-  INT t; /* index over all dimensions */
+  const INT m = ths->m, m2p2 = 2 * m + 2, d = ths->d, n = ths->n[d - 1];
+  INT l0, l1;
 
-  ths->d = (INT)d;
+  if (t == d - 1)
+  {
+    nfft_real_upd_row(g, a, psij + t * m2p2, u, m, n);
+    return;
+  }
 
-  ths->N = (INT*) Y(malloc)((size_t)(d) * sizeof(INT));
+  if (t == d - 2)
+  {
+    for (l0 = 0; l0 < m2p2; l0++)
+      nfft_real_upd_row(g + off[t * m2p2 + l0], a * psij[t * m2p2 + l0],
+        psij + (t + 1) * m2p2, u, m, n);
+    return;
+  }
 
-  for (t = 0; t < d; t++)
-    ths->N[t] = (INT)N[t];
+  if (t == d - 3)
+  {
+    for (l0 = 0; l0 < m2p2; l0++)
+    {
+      R *g0 = g + off[t * m2p2 + l0];
+      const R a0 = a * psij[t * m2p2 + l0];
 
-  ths->M_total = (INT)M_total;
+      for (l1 = 0; l1 < m2p2; l1++)
+        nfft_real_upd_row(g0 + off[(t + 1) * m2p2 + l1],
+          a0 * psij[(t + 1) * m2p2 + l1], psij + (t + 2) * m2p2, u, m, n);
+    }
+    return;
+  }
 
-  ths->n = (INT*) Y(malloc)((size_t)(d) * sizeof(INT));
+  for (l0 = 0; l0 < m2p2; l0++)
+    nfft_real_spread_window(ths, g + off[t * m2p2 + l0],
+      a * psij[t * m2p2 + l0], psij, off, u, t + 1);
+}
 
-  for (t = 0; t < d; t++)
-    ths->n[t] = 2 * (Y(next_power_of_2)(ths->N[t]));
+/** f = B g with the real oversampled vector g. */
+static void nfft_real_B_A(X(real_plan) *ths)
+{
+  X(plan) *p = &ths->plan_nfft;
+  const INT d = ths->d, m2p2 = 2 * p->m + 2;
+  INT k;
 
-  ths->m = WINDOW_HELP_ESTIMATE_m;
+  sort(p);
 
-  if (d > 1)
-  {
 #ifdef _OPENMP
-    ths->flags = PRE_PHI_HUT | PRE_PSI | MALLOC_X| MALLOC_F_HAT | MALLOC_F |
-                      FFTW_INIT | NFFT_SORT_NODES |
-                 NFFT_OMP_BLOCKWISE_ADJOINT;
-#else
-    ths->flags = PRE_PHI_HUT | PRE_PSI | MALLOC_X| MALLOC_F_HAT | MALLOC_F |
-                      FFTW_INIT | NFFT_SORT_NODES;
+  #pragma omp parallel for default(shared) private(k) schedule(static)
 #endif
-  }
-  else
-    ths->flags = PRE_PHI_HUT | PRE_PSI | MALLOC_X| MALLOC_F_HAT | MALLOC_F |
-                      FFTW_INIT | FFT_OUT_OF_PLACE;
-
-  ths->fftw_flags= FFTW_ESTIMATE| FFTW_DESTROY_INPUT;
+  for (k = 0; k < ths->M_total; k++)
+  {
+    const INT j = (p->flags & NFFT_SORT_NODES) ? p->index_x[2*k+1] : k;
+    R buf[d * m2p2];
+    INT off[d * m2p2], u0, u;
+    const R *psij = nfft_psij(p, j, buf);
 
-  ths->K = 0;
-  init_help(ths);
+    nfft_real_window(p, j, off, &u0, &u);
+    ths->f[j] = nfft_real_interp_window(p, ths->g, psij, off, u, 0);
+  }
 }
 
-void X(init_guru)(X(plan) *ths, int d, int *N, int M_total, int *n, int m,
-  unsigned flags, unsigned fftw_flags)
+/**
+ * Spreads f_j into the rows lo <= i0 < hi of the real oversampled vector g
+ * along the first dimension.
+ */
+static void nfft_real_spread_slab(const X(real_plan) *ths, R *g, const INT j,
+  const INT lo, const INT hi, R *buf, INT *off)
 {
-  INT t; /* index over all dimensions */
+  const X(plan) *p = &ths->plan_nfft;
+  const INT m2p2 = 2 * p->m + 2, n0 = p->n[0];
+  const R *psij = nfft_psij(p, j, buf);
+  INT u0, u, l0;
 
-  ths->d = (INT)d;
-  ths->M_total = (INT)M_total;
-  ths->N = (INT*)Y(malloc)((size_t)(ths->d) * sizeof(INT));
+  nfft_real_window(p, j, off, &u0, &u);
 
-  for (t = 0; t < d; t++)
-    ths->N[t] = (INT)N[t];
+  if (lo == 0 && hi == n0)
+  {
+    nfft_real_spread_window(p, g, ths->f[j], psij, off, u, 0);
+    return;
+  }
 
-  ths->n = (INT*)Y(malloc)((size_t)(ths->d) * sizeof(INT));
+  for (l0 = 0; l0 < m2p2; l0++)
+  {
+    const INT i0 = (u0 + l0 < n0) ? u0 + l0 : u0 + l0 - n0;
 
-  for (t = 0; t < d; t++)
-    ths->n[t] = (INT)n[t];
+    if (i0 < lo || i0 >= hi)
+      continue;
 
-  ths->m = (INT)m;
+    if (p->d == 1)
+      g[i0] += ths->f[j] * psij[l0];
+    else
+      nfft_real_spread_window(p, g + off[l0], ths->f[j] * psij[l0], psij, off,
+        u, 1);
+  }
+}
 
-  ths->flags = flags;
-  ths->fftw_flags = fftw_flags;
+#ifdef _OPENMP
+/** Spreads the sorted nodes whose sort key lies in [min_u,max_u] into the
+ *  rows my_u0,...,my_o0 of g, see nfft_adjoint_B_omp_blockwise_init. */
+static void nfft_real_B_T_blockwise_range(const X(real_plan) *ths,
+  const INT min_u, const INT max_u, const INT my_u0, const INT my_o0, R *buf,
+  INT *off)
+{
+  const INT *ar_x = ths->plan_nfft.index_x;
+  INT k;
 
-  ths->K = 0;
-  init_help(ths);
+  for (k = index_x_binary_search(ar_x, ths->M_total, min_u);
+    k < ths->M_total; k++)
+  {
+    if (ar_x[2*k] < min_u || ar_x[2*k] > max_u)
+      break;
+
+    nfft_real_spread_slab(ths, ths->g, ar_x[2*k+1], my_u0, my_o0 + 1, buf,
+      off);
+  }
 }
+#endif
 
-void X(init_lin)(X(plan) *ths, int d, int *N, int M_total, int *n, int m, int K,
-  unsigned flags, unsigned fftw_flags)
+/**
+ * g = B^T f with the real oversampled vector g. With OpenMP, every thread owns
+ * a slab of g along the first dimension and spreads the parts of the windows
+ * that fall into it, so that no atomic operations are needed. Sorted nodes
+ * are partitioned as by NFFT_OMP_BLOCKWISE_ADJOINT, so that each thread only
+ * visits the nodes that reach its slab; otherwise every thread tests all
+ * nodes.
+ */
+static void nfft_real_B_T(X(real_plan) *ths)
 {
-  INT t; /* index over all dimensions */
+  X(plan) *p = &ths->plan_nfft;
+  const INT d = ths->d, m2p2 = 2 * p->m + 2;
+  R *g = ths->g;
 
-  ths->d = (INT)d;
-  ths->M_total = (INT)M_total;
-  ths->N = (INT*)Y(malloc)((size_t)(ths->d) * sizeof(INT));
+  memset(g, 0, (size_t)(p->n_total) * sizeof(R));
 
-  for (t = 0; t < d; t++)
-    ths->N[t] = (INT)N[t];
+  sort(p);
 
-  ths->n = (INT*)Y(malloc)((size_t)(ths->d) * sizeof(INT));
+#ifdef _OPENMP
+  if (p->flags & NFFT_SORT_NODES)
+  {
+    #pragma omp parallel default(shared)
+    {
+      INT my_u0, my_o0, min_u_a, max_u_a, min_u_b, max_u_b;
+      R buf[d * m2p2];
+      INT off[d * m2p2];
 
-  for (t = 0; t < d; t++)
-    ths->n[t] = (INT)n[t];
+      nfft_adjoint_B_omp_blockwise_init(&my_u0, &my_o0, &min_u_a, &max_u_a,
+        &min_u_b, &max_u_b, d, p->n, p->m);
 
-  ths->m = (INT)m;
+      if (min_u_a != -1)
+        nfft_real_B_T_blockwise_range(ths, min_u_a, max_u_a, my_u0, my_o0, buf,
+          off);
 
-  ths->flags = flags;
-  ths->fftw_flags = fftw_flags;
+      if (min_u_b != -1)
+        nfft_real_B_T_blockwise_range(ths, min_u_b, max_u_b, my_u0, my_o0, buf,
+          off);
+    }
+    return;
+  }
 
-  ths->K = K;
-  init_help(ths);
-}
+  #pragma omp parallel default(shared)
+#endif
+  {
+#ifdef _OPENMP
+    const INT nthreads = omp_get_num_threads(), tid = omp_get_thread_num();
+#else
+    const INT nthreads = 1, tid = 0;
+#endif
+    const INT n0 = p->n[0];
+    const INT lo = (n0 * tid) / nthreads, hi = (n0 * (tid + 1)) / nthreads;
+    R buf[d * m2p2];
+    INT off[d * m2p2], k;
 
-void X(init_1d)(X(plan) *ths, int N1, int M_total)
-{
-  int N[1];
+    for (k = 0; k < ths->M_total; k++)
+    {
+      const INT j = (p->flags & NFFT_SORT_NODES) ? p->index_x[2*k+1] : k;
 
-  N[0] = N1;
+      if (nthreads > 1)
+      {
+        INT u0, o0;
 
-  X(init)(ths, 1, N, M_total);
+        uo(p, j, &u0, &o0, 0);
+        u0 = (u0 % n0 + n0) % n0;
+        o0 = u0 + m2p2 - 1;
+        if (!((u0 < hi && o0 >= lo) || o0 - n0 >= lo))
+          continue;
+      }
+
+      nfft_real_spread_slab(ths, g, j, lo, hi, buf, off);
+    }
+  }
 }
 
-void X(init_2d)(X(plan) *ths, int N1, int N2, int M_total)
+void X(real_trafo)(X(real_plan) *ths)
 {
-  int N[2];
+  update_nodes(&ths->plan_nfft);
 
-  N[0] = N1;
-  N[1] = N2;
-  X(init)(ths, 2, N, M_total);
+  nfft_real_D_A(ths);
+  FFTW(execute_dft_c2r)(ths->my_fftw_c2r_plan, ths->g_hat, ths->g);
+  nfft_real_B_A(ths);
 }
 
-void X(init_3d)(X(plan) *ths, int N1, int N2, int N3, int M_total)
+void X(real_adjoint)(X(real_plan) *ths)
 {
-  int N[3];
+  update_nodes(&ths->plan_nfft);
 
-  N[0] = N1;
-  N[1] = N2;
-  N[2] = N3;
-  X(init)(ths, 3, N, M_total);
+  nfft_real_B_T(ths);
+  FFTW(execute_dft_r2c)(ths->my_fftw_r2c_plan, ths->g, ths->g_hat);
+  nfft_real_D_T(ths);
 }
 
-const char* X(check)(X(plan) *ths)
+void X(real_init_guru)(X(real_plan) *ths, int d, int *N, int M, int *n, int m,
+  unsigned flags, unsigned fftw_flags)
 {
-  INT j;
+  X(plan) *p = &ths->plan_nfft;
+  INT t;
 
-  if (!ths->f)
-      return "Member f not initialized.";
+  /* The internal plan keeps the nodes, phi_hut, psi and the node order, but no
+   * FFT. Other precomputation schemes of psi are evaluated on the fly. */
+  X(init_guru)(p, d, N, M, n, m, flags & (PRE_PHI_HUT | PRE_PSI | MALLOC_X
+    | NFFT_SORT_NODES), fftw_flags);
 
-  if (!ths->x)
-      return "Member x not initialized.";
+  ths->d = p->d;
+  ths->M_total = p->M_total;
+  ths->x = p->x;
+  ths->flags = flags;
+  ths->fftw_flags = fftw_flags;
 
-  if (!ths->f_hat)
-      return "Member f_hat not initialized.";
+  ths->N_half = p->N[ths->d - 1] - p->N[ths->d - 1] / 2;
+  ths->N_total = 2 * (p->N_total / p->N[ths->d - 1]) * ths->N_half;
+  ths->n_hat_total = (p->n_total / p->n[ths->d - 1])
+    * (p->n[ths->d - 1] / 2 + 1);
 
-  if ((ths->flags & PRE_LIN_PSI) && ths->K < ths->M_total)
-    return "Number of nodes too small to use PRE_LIN_PSI.";
+  if (flags & MALLOC_F_HAT)
+    ths->f_hat = (R*)Y(malloc)((size_t)(ths->N_total) * sizeof(R));
 
-  for (j = 0; j < ths->M_total * ths->d; j++)
-  {
-    if ((ths->x[j]<-K(0.5)) || (ths->x[j]>= K(0.5)))
-    {
-      return "ths->x out of range [-0.5,0.5)";
-    }
-  }
+  if (flags & MALLOC_F)
+    ths->f = (R*)Y(malloc)((size_t)(ths->M_total) * sizeof(R));
 
-  for (j = 0; j < ths->d; j++)
+  if (flags & FFTW_INIT)
   {
-    if (ths->sigma[j] <= 1)
-      return "Oversampling factor too small";
-    
-    /* Automatically calls trafo_direct if 
-    if(ths->N[j] <= ths->m)
-      return "Polynomial degree N is <= cut-off m";
-    */
-
-    if(ths->N[j]%2 == 1)
-      return "polynomial degree N has to be even";
-  }
-  return 0;
-}
+#ifdef _OPENMP
+    INT nthreads = Y(get_num_threads)();
+#endif
+    int *_n = Y(malloc)((size_t)(ths->d) * sizeof(int));
 
-void X(finalize)(X(plan) *ths)
-{
-  INT t; /* index over dimensions */
+    for (t = 0; t < ths->d; t++)
+      _n[t] = (int)(p->n[t]);
 
-  if(ths->flags & NFFT_SORT_NODES)
-    Y(free)(ths->index_x);
+    ths->g = (R*)Y(malloc)((size_t)(p->n_total) * sizeof(R));
+    ths->g_hat = (C*)Y(malloc)((size_t)(ths->n_hat_total) * sizeof(C));
 
-  if(ths->flags & FFTW_INIT)
-  {
 #ifdef _OPENMP
-    #pragma omp critical (nfft_omp_critical_fftw_plan)
+#pragma omp critical (nfft_omp_critical_fftw_plan)
+{
+    FFTW(plan_with_nthreads)(nthreads);
 #endif
-    FFTW(destroy_plan)(ths->my_fftw_plan2);
+    ths->my_fftw_c2r_plan = FFTW(plan_dft_c2r)((int)ths->d, _n, ths->g_hat,
+      ths->g, fftw_flags);
+    ths->my_fftw_r2c_plan = FFTW(plan_dft_r2c)((int)ths->d, _n, ths->g,
+      ths->g_hat, fftw_flags);
 #ifdef _OPENMP
-    #pragma omp critical (nfft_omp_critical_fftw_plan)
+}
 #endif
-    FFTW(destroy_plan)(ths->my_fftw_plan1);
-
-    if(ths->flags & FFT_OUT_OF_PLACE)
-      Y(free)(ths->g2);
-
-    Y(free)(ths->g1);
+    Y(free)(_n);
   }
 
-  if(ths->flags & PRE_FULL_PSI)
-  {
-    Y(free)(ths->psi_index_g);
-    Y(free)(ths->psi_index_f);
-    Y(free)(ths->psi);
-  }
+  ths->mv_trafo = (void (*) (void* ))X(real_trafo);
+  ths->mv_adjoint = (void (*) (void* ))X(real_adjoint);
+}
 
-  if(ths->flags & PRE_PSI)
-    Y(free)(ths->psi);
+void X(real_init)(X(real_plan) *ths, int d, int *N, int M)
+{
+  int n[d];
+  INT t;
 
-  if(ths->flags & PRE_FG_PSI)
-    Y(free)(ths->psi);
+  for (t = 0; t < d; t++)
+    n[t] = 2 * (int)(Y(next_power_of_2)(N[t]));
 
-  if(ths->flags & PRE_LIN_PSI)
-    Y(free)(ths->psi);
+  X(real_init_guru)(ths, d, N, M, n, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT
+    | PRE_PSI | MALLOC_X | MALLOC_F_HAT | MALLOC_F | FFTW_INIT
+    | (d > 1 ? NFFT_SORT_NODES : 0U), FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+}
 
-  if(ths->flags & PRE_PHI_HUT)
+void X(real_precompute_one_psi)(X(real_plan) *ths)
+{
+  X(precompute_one_psi)(&ths->plan_nfft);
+}
+
+void X(real_finalize)(X(real_plan) *ths)
+{
+  if (ths->flags & FFTW_INIT)
   {
-    for (t = 0; t < ths->d; t++)
-        Y(free)(ths->c_phi_inv[t]);
-    Y(free)(ths->c_phi_inv);
+#ifdef _OPENMP
+    #pragma omp critical (nfft_omp_critical_fftw_plan)
+#endif
+    {
+      FFTW(destroy_plan)(ths->my_fftw_r2c_plan);
+      FFTW(destroy_plan)(ths->my_fftw_c2r_plan);
+    }
+
+    Y(free)(ths->g_hat);
+    Y(free)(ths->g);
   }
 
-  if(ths->flags & MALLOC_F)
+  if (ths->flags & MALLOC_F)
     Y(free)(ths->f);
 
-  if(ths->flags & MALLOC_F_HAT)
+  if (ths->flags & MALLOC_F_HAT)
     Y(free)(ths->f_hat);
 
-  if(ths->flags & MALLOC_X)
-    Y(free)(ths->x);
-
-  WINDOW_HELP_FINALIZE;
-
-  Y(free)(ths->sigma);
-  Y(free)(ths->n);
-  Y(free)(ths->N);
+  X(finalize)(&ths->plan_nfft);
 }
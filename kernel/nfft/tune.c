@@ -0,0 +1,550 @@
+/*
+ * Copyright (c) 2002, 2017 Jens Keiner, Stefan Kunis, Daniel Potts
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Autotuning of the NFFT parameters */
+
+/* configure header */
+#include "config.h"
+
+/* complex datatype (maybe) */
+#ifdef HAVE_COMPLEX_H
+#include<complex.h>
+#endif
+
+/* NFFT headers */
+#include "nfft3.h"
+#include "infft.h"
+
+#include <ctype.h>
+#include <float.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#undef X
+#define X(name) NFFT(name)
+
+/* X(tune) searches the parameters in four stages, each keeping the fastest
+ * candidate of the previous ones fixed:
+ *  1. the oversampling factor sigma together with the smallest cut-off m
+ *     whose error estimate meets the requested accuracy,
+ *  2. the precomputation PRE_PSI, PRE_FULL_PSI or PRE_FULL_PSI with single
+ *     precision tables,
+ *  3. unsorted nodes, sorted nodes and the OpenMP adjoint variants,
+ *  4. FFTW_ESTIMATE or FFTW_MEASURE.
+ * A candidate is timed by one X(trafo) and one X(adjoint) on random nodes,
+ * repeated until NFFT_TUNE_SECONDS have elapsed. The result is kept in the
+ * tune wisdom under the problem and the CPU it was measured on. */
+
+/** largest cut-off parameter m considered */
+#define NFFT_TUNE_MAX_m 16
+
+/** minimal time in seconds spent timing one candidate */
+#define NFFT_TUNE_SECONDS K(0.01)
+
+/** length of the CPU identification string */
+#define NFFT_TUNE_CPU_LEN 128
+
+/** precision tag of the wisdom entries of this library */
+#define NFFT_TUNE_TAG STRINGIZE(X(tune))
+
+/** the bits of the NFFT flags chosen by the tuner */
+#define NFFT_TUNE_FLAGS (PRE_ONE_PSI | FG_PSI | NFFT_FULL_PSI_FLOAT \
+  | NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT | NFFT_OMP_TILED_ADJOINT)
+
+static const R tune_sigma_[] = {K(2.0), K(1.5), K(1.25)};
+
+/** One tune wisdom entry. All fields but n, m, fftw_flags and the tuned bits
+ *  of flags identify the problem. */
+typedef struct
+{
+  char cpu[NFFT_TUNE_CPU_LEN]; /**< CPU identification */
+  int nthreads;                /**< number of threads */
+  double eps;                  /**< requested accuracy */
+  int d;                       /**< dimension */
+  int *N;                      /**< bandwidths, shares its memory with n */
+  int M_total;                 /**< number of nodes */
+  int *n;                      /**< chosen FFT lengths */
+  int m;                       /**< chosen cut-off parameter */
+  unsigned flags;              /**< chosen NFFT flags */
+  unsigned fftw_flags;         /**< chosen FFTW flags */
+} tune_wisdom_t;
+
+static tune_wisdom_t *wisdom_ = NULL;
+static int wisdom_size_ = 0;
+static int wisdom_capacity_ = 0;
+
+/** State of one tuning run. */
+typedef struct
+{
+  int d;
+  int *N;
+  int M_total;
+  size_t max_bytes;
+  const R *x;
+  const C *f_hat;
+  int *n;             /**< FFT lengths of the fastest candidate */
+  int m;
+  unsigned flags;
+  unsigned fftw_flags;
+  R time;             /**< seconds of the fastest candidate, negative if none */
+} tune_t;
+
+/** Identifies the CPU by its model name, if the system provides it, and the
+ *  SIMD level of the B step kernels. */
+static void tune_cpu(char *cpu)
+{
+  char line[NFFT_TUNE_CPU_LEN], *model = NULL;
+  FILE *f = fopen("/proc/cpuinfo", "r");
+  size_t i;
+
+  if (f != NULL)
+  {
+    while (fgets(line, (int)(sizeof(line)), f) != NULL)
+    {
+      if (strncmp(line, "model name", 10) == 0
+        && (model = strchr(line, ':')) != NULL)
+      {
+        model++;
+        while (isspace((unsigned char)(*model)))
+          model++;
+        break;
+      }
+    }
+    fclose(f);
+  }
+
+  snprintf(cpu, NFFT_TUNE_CPU_LEN, "%s-simd%d",
+    (model != NULL && *model != '\0') ? model : "unknown", Y(simd_level)());
+
+  /* The wisdom file separates fields by white space. */
+  for (i = 0; cpu[i] != '\0'; i++)
+    if (!isalnum((unsigned char)(cpu[i])) && cpu[i] != '-' && cpu[i] != '.')
+      cpu[i] = '_';
+}
+
+static tune_wisdom_t *tune_lookup(const char *cpu, int nthreads, double eps,
+  int d, const int *N, int M_total, unsigned flags)
+{
+  int i, t;
+
+  for (i = 0; i < wisdom_size_; i++)
+  {
+    tune_wisdom_t *w = &wisdom_[i];
+
+    if (w->nthreads != nthreads || w->d != d || w->M_total != M_total
+      || (w->flags & ~NFFT_TUNE_FLAGS) != (flags & ~NFFT_TUNE_FLAGS)
+      || fabs(w->eps - eps) > 1e-6 * eps || strcmp(w->cpu, cpu) != 0)
+      continue;
+
+    for (t = 0; t < d && w->N[t] == N[t]; t++)
+      ;
+
+    if (t == d)
+      return w;
+  }
+
+  return NULL;
+}
+
+/** Adds an entry to the tune wisdom or replaces the one of the same problem. */
+static void tune_store(const char *cpu, int nthreads, double eps, int d,
+  const int *N, int M_total, const int *n, int m, unsigned flags,
+  unsigned fftw_flags)
+{
+  tune_wisdom_t *w = tune_lookup(cpu, nthreads, eps, d, N, M_total, flags);
+  int t;
+
+  if (w == NULL)
+  {
+    if (wisdom_size_ == wisdom_capacity_)
+    {
+      const int capacity = (wisdom_capacity_ == 0) ? 8 : 2 * wisdom_capacity_;
+      tune_wisdom_t *wisdom = (tune_wisdom_t*) Y(malloc)((size_t)(capacity)
+        * sizeof(tune_wisdom_t));
+
+      if (wisdom_size_ > 0)
+        memcpy(wisdom, wisdom_, (size_t)(wisdom_size_) * sizeof(tune_wisdom_t));
+      if (wisdom_ != NULL)
+        Y(free)(wisdom_);
+
+      wisdom_ = wisdom;
+      wisdom_capacity_ = capacity;
+    }
+
+    w = &wisdom_[wisdom_size_++];
+    strncpy(w->cpu, cpu, NFFT_TUNE_CPU_LEN - 1);
+    w->cpu[NFFT_TUNE_CPU_LEN - 1] = '\0';
+    w->nthreads = nthreads;
+    w->eps = eps;
+    w->d = d;
+    w->N = (int*) Y(malloc)((size_t)(2 * d) * sizeof(int));
+    w->n = w->N + d;
+    w->M_total = M_total;
+
+    for (t = 0; t < d; t++)
+      w->N[t] = N[t];
+  }
+
+  for (t = 0; t < d; t++)
+    w->n[t] = n[t];
+
+  w->m = m;
+  w->flags = flags;
+  w->fftw_flags = fftw_flags;
+}
+
+/** Seconds of one X(trafo) and one X(adjoint) with the given parameters. */
+static R tune_time(const tune_t *ths, int *n, int m, unsigned flags,
+  unsigned fftw_flags)
+{
+  X(plan) p;
+  R t0, t = K(0.0);
+  int reps, r;
+
+  X(init_guru)(&p, ths->d, ths->N, ths->M_total, n, m, flags | MALLOC_X
+    | MALLOC_F_HAT | MALLOC_F | FFTW_INIT, fftw_flags);
+
+  memcpy(p.x, ths->x, (size_t)(ths->d * ths->M_total) * sizeof(R));
+
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  for (reps = 1; reps <= (1 << 20); reps *= 2)
+  {
+    t0 = Y(clock_gettime_seconds)();
+    for (r = 0; r < reps; r++)
+    {
+      /* The adjoint overwrites f_hat, which would grow without bound. */
+      memcpy(p.f_hat, ths->f_hat, (size_t)(p.N_total) * sizeof(C));
+      X(trafo)(&p);
+      X(adjoint)(&p);
+    }
+    t = Y(clock_gettime_seconds)() - t0;
+
+    if (t >= NFFT_TUNE_SECONDS)
+      break;
+  }
+
+  X(finalize)(&p);
+
+  return t / (R)(MIN(reps, 1 << 20));
+}
+
+/** Times a candidate within the memory limit and keeps it if it is the
+ *  fastest so far. */
+static void tune_try(tune_t *ths, int *n, int m, unsigned flags,
+  unsigned fftw_flags)
+{
+  R t;
+  int i;
+
+  if (X(estimate_memory)(ths->d, ths->N, ths->M_total, n, m, flags)
+    > ths->max_bytes)
+    return;
+
+  t = tune_time(ths, n, m, flags, fftw_flags);
+
+  if (ths->time < K(0.0) || t < ths->time)
+  {
+    for (i = 0; i < ths->d; i++)
+      ths->n[i] = n[i];
+    ths->m = m;
+    ths->flags = flags;
+    ths->fftw_flags = fftw_flags;
+    ths->time = t;
+  }
+}
+
+/** Tries the fastest candidate with the bits mask of its flags replaced by
+ *  each of the choices. */
+static void tune_flags(tune_t *ths, unsigned mask, const unsigned *choice,
+  size_t size)
+{
+  const unsigned flags = ths->flags & ~mask;
+  int *n = (int*) Y(malloc)((size_t)(ths->d) * sizeof(int));
+  size_t i;
+  int t;
+
+  for (t = 0; t < ths->d; t++)
+    n[t] = ths->n[t];
+
+  for (i = 0; i < size; i++)
+    if ((flags | choice[i]) != ths->flags)
+      tune_try(ths, n, ths->m, flags | choice[i], ths->fftw_flags);
+
+  Y(free)(n);
+}
+
+/**
+ * Chooses the oversampled FFT lengths n, the cut-off m, the precomputation,
+ * the node sorting and OpenMP adjoint flags and the FFTW flags for the
+ * fastest NFFT of the given size with error estimate at most eps, whose
+ * X(estimate_memory) does not exceed max_bytes. The other bits of flags
+ * (MALLOC_*, FFTW_INIT, PRE_PHI_HUT, ...) are kept and take part in the
+ * timing. If the tune wisdom holds a result for this problem, CPU and number
+ * of threads, it is returned without timing and the return value is 1,
+ * otherwise 0. Not thread safe.
+ */
+int X(tune)(int d, int *N, int M_total, R eps, size_t max_bytes, int *n,
+  int *m, unsigned *flags, unsigned *fftw_flags)
+{
+  const unsigned window = Y(window_resolve)(NFFT_WINDOW_DEFAULT);
+  const unsigned base = *flags & ~NFFT_TUNE_FLAGS;
+  const int nthreads = (int)(Y(get_num_threads)());
+  static const unsigned psi[] = {PRE_PSI, PRE_FULL_PSI,
+    PRE_FULL_PSI | NFFT_FULL_PSI_FLOAT};
+#ifdef _OPENMP
+  static const unsigned sort[] = {0U, NFFT_SORT_NODES,
+    NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT, NFFT_OMP_TILED_ADJOINT};
+  const unsigned sort_default = (d > 1) ? NFFT_SORT_NODES
+    | NFFT_OMP_BLOCKWISE_ADJOINT : 0U;
+#else
+  static const unsigned sort[] = {0U, NFFT_SORT_NODES};
+  const unsigned sort_default = (d > 1) ? NFFT_SORT_NODES : 0U;
+#endif
+  static const unsigned fftw[] = {FFTW_ESTIMATE | FFTW_DESTROY_INPUT,
+    FFTW_MEASURE | FFTW_DESTROY_INPUT};
+  char cpu[NFFT_TUNE_CPU_LEN];
+  tune_wisdom_t *w;
+  tune_t ths;
+  int *nn, mm, t, N_total = 1;
+  size_t i;
+
+  tune_cpu(cpu);
+
+  w = tune_lookup(cpu, nthreads, (double)(eps), d, N, M_total, base);
+  if (w != NULL)
+  {
+    for (t = 0; t < d; t++)
+      n[t] = w->n[t];
+    *m = w->m;
+    *flags = w->flags;
+    *fftw_flags = w->fftw_flags;
+    return 1;
+  }
+
+  for (t = 0; t < d; t++)
+    N_total *= N[t];
+
+  ths.d = d;
+  ths.N = N;
+  ths.M_total = M_total;
+  ths.max_bytes = max_bytes;
+  ths.n = n;
+  ths.time = K(-1.0);
+
+  ths.x = (R*) Y(malloc)((size_t)(d * M_total) * sizeof(R));
+  ths.f_hat = (C*) Y(malloc)((size_t)(N_total) * sizeof(C));
+  Y(vrand_shifted_unit_double)((R*)(ths.x), d * M_total);
+  Y(vrand_unit_complex)((C*)(ths.f_hat), N_total);
+
+  nn = (int*) Y(malloc)((size_t)(d) * sizeof(int));
+
+  /* stage 1: oversampling factor and cut-off */
+  for (i = 0; i < SIZE(tune_sigma_); i++)
+  {
+    R sigma = K(0.0);
+    unsigned f = base | PRE_PSI | sort_default;
+
+    for (t = 0; t < d; t++)
+    {
+      if (i == 0)
+        nn[t] = 2 * (int)(Y(next_power_of_2)((INT)(N[t])));
+      else
+        nn[t] = (int)(Y(next_fft_size)((INT)(CEIL(tune_sigma_[i]
+          * (R)(N[t])))));
+      sigma = (t == 0) ? (R)(nn[t]) / (R)(N[t])
+        : MIN(sigma, (R)(nn[t]) / (R)(N[t]));
+    }
+
+    for (mm = 1; mm <= NFFT_TUNE_MAX_m
+      && Y(window_error)(window, (INT)(mm), sigma) > eps; mm++)
+      ;
+
+    /* Without a cut-off reaching eps the largest one for sigma = 2 is used. */
+    if (mm > NFFT_TUNE_MAX_m)
+    {
+      if (i > 0)
+        continue;
+      mm = NFFT_TUNE_MAX_m;
+    }
+
+    /* The window of a node must fit into the oversampled grid. */
+    for (t = 0; t < d && (i == 0 || nn[t] >= 2 * mm + 2); t++)
+      ;
+    if (t < d)
+      continue;
+
+    if (X(estimate_memory)(d, N, M_total, nn, mm, f) > max_bytes)
+      f = X(budget_flags)(d, N, M_total, nn, mm, base, max_bytes);
+
+    /* The first candidate is always kept, also beyond the memory limit. */
+    if (ths.time < K(0.0))
+      ths.max_bytes = SIZE_MAX;
+    tune_try(&ths, nn, mm, f, fftw[0]);
+    ths.max_bytes = max_bytes;
+  }
+
+  /* stage 2: precomputation, single precision tables need a moderate eps */
+  tune_flags(&ths, PRE_ONE_PSI | NFFT_FULL_PSI_FLOAT, psi,
+    (eps >= K(100.0) * FLT_EPSILON) ? SIZE(psi) : SIZE(psi) - 1);
+
+  /* stage 3: node sorting and the OpenMP adjoint */
+  tune_flags(&ths, NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT
+    | NFFT_OMP_TILED_ADJOINT, sort, SIZE(sort));
+
+  /* stage 4: FFTW planning */
+  for (t = 0; t < d; t++)
+    nn[t] = ths.n[t];
+  tune_try(&ths, nn, ths.m, ths.flags, fftw[1]);
+
+  Y(free)(nn);
+  Y(free)((C*)(ths.f_hat));
+  Y(free)((R*)(ths.x));
+
+  *m = ths.m;
+  *flags = ths.flags;
+  *fftw_flags = ths.fftw_flags;
+
+  tune_store(cpu, nthreads, (double)(eps), d, N, M_total, n, *m, *flags,
+    *fftw_flags);
+
+  return 0;
+}
+
+/** Initialises a plan like X(init) with the parameters chosen by X(tune) for
+ *  accuracy eps. */
+void X(init_tune)(X(plan) *ths, int d, int *N, int M_total, R eps)
+{
+  int *n = (int*) Y(malloc)((size_t)(d) * sizeof(int));
+  int m;
+  unsigned flags = PRE_PHI_HUT | MALLOC_X | MALLOC_F_HAT | MALLOC_F
+    | FFTW_INIT, fftw_flags;
+
+  if (d == 1)
+    flags |= FFT_OUT_OF_PLACE;
+
+  X(tune)(d, N, M_total, eps, SIZE_MAX, n, &m, &flags, &fftw_flags);
+  X(init_guru)(ths, d, N, M_total, n, m, flags, fftw_flags);
+
+  Y(free)(n);
+}
+
+/** Writes the tune wisdom to a file, one entry per line. Returns 1 on
+ *  success. */
+int X(export_tune_wisdom_to_filename)(const char *filename)
+{
+  FILE *f = fopen(filename, "w");
+  int i, t;
+
+  if (f == NULL)
+    return 0;
+
+  for (i = 0; i < wisdom_size_; i++)
+  {
+    const tune_wisdom_t *w = &wisdom_[i];
+
+    fprintf(f, "%s %s %d %.17g %d", NFFT_TUNE_TAG, w->cpu, w->nthreads,
+      w->eps, w->d);
+    for (t = 0; t < w->d; t++)
+      fprintf(f, " %d", w->N[t]);
+    fprintf(f, " %d %d", w->M_total, w->m);
+    for (t = 0; t < w->d; t++)
+      fprintf(f, " %d", w->n[t]);
+    fprintf(f, " %u %u\n", w->flags, w->fftw_flags);
+  }
+
+  return IF(fclose(f) == 0, 1, 0);
+}
+
+/** Adds the entries of a file written by X(export_tune_wisdom_to_filename)
+ *  to the tune wisdom. Entries of other precisions are skipped. Returns 1 on
+ *  success and 0 if the file cannot be read or is malformed. */
+int X(import_tune_wisdom_from_filename)(const char *filename)
+{
+  FILE *f = fopen(filename, "r");
+  char tag[32], cpu[NFFT_TUNE_CPU_LEN];
+  int nthreads, d, M_total, m, t, ok = 1, *N = NULL, *n;
+  double eps;
+  unsigned flags, fftw_flags;
+  int r;
+
+  if (f == NULL)
+    return 0;
+
+  while ((r = fscanf(f, "%31s %127s %d %lg %d", tag, cpu, &nthreads, &eps,
+    &d)) == 5)
+  {
+    if (d < 1 || d > 1024)
+    {
+      ok = 0;
+      break;
+    }
+
+    N = (int*) Y(malloc)((size_t)(2 * d) * sizeof(int));
+    n = N + d;
+
+    for (t = 0; t < d && fscanf(f, "%d", &N[t]) == 1; t++)
+      ;
+    if (t < d || fscanf(f, "%d %d", &M_total, &m) != 2)
+    {
+      ok = 0;
+      break;
+    }
+    for (t = 0; t < d && fscanf(f, "%d", &n[t]) == 1; t++)
+      ;
+    if (t < d || fscanf(f, "%u %u", &flags, &fftw_flags) != 2)
+    {
+      ok = 0;
+      break;
+    }
+
+    if (strcmp(tag, NFFT_TUNE_TAG) == 0)
+      tune_store(cpu, nthreads, eps, d, N, M_total, n, m, flags, fftw_flags);
+
+    Y(free)(N);
+    N = NULL;
+  }
+
+  if (r != EOF)
+    ok = 0;
+
+  if (N != NULL)
+    Y(free)(N);
+
+  fclose(f);
+
+  return ok;
+}
+
+/** Removes all entries from the tune wisdom. */
+void X(forget_tune_wisdom)(void)
+{
+  int i;
+
+  for (i = 0; i < wisdom_size_; i++)
+    Y(free)(wisdom_[i].N);
+
+  if (wisdom_ != NULL)
+    Y(free)(wisdom_);
+
+  wisdom_ = NULL;
+  wisdom_size_ = 0;
+  wisdom_capacity_ = 0;
+}
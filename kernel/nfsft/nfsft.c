@@ -280,6 +280,7 @@ void nfsft_init_guru(nfsft_plan *plan, int N, int M, unsigned int flags,
 
   /* Save the flags in the plan. */
   plan->flags = flags;
+  memset(&plan->stats, 0, sizeof(plan->stats));
 
   /* Save the bandwidth N and the number of samples M in the plan. */
   plan->N = N;
@@ -686,12 +687,6 @@ void nfsft_trafo_direct(nfsft_plan *plan)
   double stheta;       /*< Current angle theta for Clenshaw algorithm        */
   double sphi;         /*< Current angle phi for Clenshaw algorithm          */
 
-#ifdef MEASURE_TIME
-  plan->MEASURE_TIME_t[0] = 0.0;
-  plan->MEASURE_TIME_t[1] = 0.0;
-  plan->MEASURE_TIME_t[2] = 0.0;
-#endif
-
   if (wisdom.flags & NFSFT_NO_DIRECT_ALGORITHM)
   {
     nfsft_set_f_nan(plan);
@@ -864,12 +859,6 @@ void nfsft_adjoint_direct(nfsft_plan *plan)
                            coefficient beta_k^n for associated Legendre
                            functions P_k^n                                   */
 
-#ifdef MEASURE_TIME
-  plan->MEASURE_TIME_t[0] = 0.0;
-  plan->MEASURE_TIME_t[1] = 0.0;
-  plan->MEASURE_TIME_t[2] = 0.0;
-#endif
-
   if (wisdom.flags & NFSFT_NO_DIRECT_ALGORITHM)
   {
     nfsft_set_f_hat_nan(plan);
@@ -1069,9 +1058,7 @@ void nfsft_trafo(nfsft_plan *plan)
 {
   int k; /*< The degree k                                                    */
   int n; /*< The order n                                                     */
-#ifdef MEASURE_TIME
-  ticks t0, t1;
-#endif
+  double t0 = 0.0; /*< Start of the current phase for the statistics     */
   #ifdef DEBUG
     double t, t_pre, t_nfft, t_fpt, t_c2e, t_norm;
     t_pre = 0.0;
@@ -1081,12 +1068,6 @@ void nfsft_trafo(nfsft_plan *plan)
     t_nfft = 0.0;
   #endif
 
-#ifdef MEASURE_TIME
-  plan->MEASURE_TIME_t[0] = 0.0;
-  plan->MEASURE_TIME_t[1] = 0.0;
-  plan->MEASURE_TIME_t[2] = 0.0;
-#endif
-
   if ((wisdom.flags & NFSFT_NO_FAST_ALGORITHM) || (plan->flags & NFSFT_NO_FAST_ALGORITHM))
   {
     nfsft_set_f_nan(plan);
@@ -1153,9 +1134,8 @@ void nfsft_trafo(nfsft_plan *plan)
       }
     }
 
-#ifdef MEASURE_TIME
-    t0 = getticks();
-#endif
+    if (plan->stats.enabled)
+      t0 = Y(stats_seconds)();
     /* Check, which polynomial transform algorithm should be used. */
     if (plan->flags & NFSFT_USE_DPT)
     {
@@ -1233,24 +1213,18 @@ void nfsft_trafo(nfsft_plan *plan)
       }
 #endif
     }
-#ifdef MEASURE_TIME
-    t1 = getticks();
-    plan->MEASURE_TIME_t[0] = nfft_elapsed_seconds(t1,t0);
-#endif
+    if (plan->stats.enabled)
+      Y(stats_add)(&plan->stats, NFSFT_STATS_FPT, Y(stats_seconds)() - t0);
 
-#ifdef MEASURE_TIME
-    t0 = getticks();
-#endif
+    if (plan->stats.enabled)
+      t0 = Y(stats_seconds)();
     /* Convert Chebyshev coefficients to Fourier coefficients. */
     c2e(plan);
-#ifdef MEASURE_TIME
-    t1 = getticks();
-    plan->MEASURE_TIME_t[1] = nfft_elapsed_seconds(t1,t0);
-#endif
+    if (plan->stats.enabled)
+      Y(stats_add)(&plan->stats, NFSFT_STATS_C2E, Y(stats_seconds)() - t0);
 
-#ifdef MEASURE_TIME
-    t0 = getticks();
-#endif
+    if (plan->stats.enabled)
+      t0 = Y(stats_seconds)();
     if (plan->flags & NFSFT_EQUISPACED)
     {
       /* Algorithm for equispaced nodes.
@@ -1306,10 +1280,8 @@ void nfsft_trafo(nfsft_plan *plan)
       //fprintf(stderr,"nfsft_adjoint: nfft_trafo\n");
       nfft_trafo_2d(&plan->plan_nfft);
     }
-#ifdef MEASURE_TIME
-    t1 = getticks();
-    plan->MEASURE_TIME_t[2] = nfft_elapsed_seconds(t1,t0);
-#endif
+    if (plan->stats.enabled)
+      Y(stats_add)(&plan->stats, NFSFT_STATS_NFFT, Y(stats_seconds)() - t0);
   }
 }
 
@@ -1317,15 +1289,7 @@ void nfsft_adjoint(nfsft_plan *plan)
 {
   int k; /*< The degree k                                                    */
   int n; /*< The order n                                                     */
-#ifdef MEASURE_TIME
-  ticks t0, t1;
-#endif
-
-#ifdef MEASURE_TIME
-  plan->MEASURE_TIME_t[0] = 0.0;
-  plan->MEASURE_TIME_t[1] = 0.0;
-  plan->MEASURE_TIME_t[2] = 0.0;
-#endif
+  double t0 = 0.0; /*< Start of the current phase for the statistics     */
 
   if ((wisdom.flags & NFSFT_NO_FAST_ALGORITHM) || (plan->flags & NFSFT_NO_FAST_ALGORITHM))
   {
@@ -1363,9 +1327,8 @@ void nfsft_adjoint(nfsft_plan *plan)
       plan->plan_nfft.f_hat = plan->f_hat;
     }
 
-#ifdef MEASURE_TIME
-    t0 = getticks();
-#endif
+    if (plan->stats.enabled)
+      t0 = Y(stats_seconds)();
     if (plan->flags & NFSFT_EQUISPACED)
     {
       /* Algorithm for equispaced nodes.
@@ -1407,26 +1370,20 @@ void nfsft_adjoint(nfsft_plan *plan)
       /* Use adjoint NFFT. */
       nfft_adjoint_2d(&plan->plan_nfft);
     }
-#ifdef MEASURE_TIME
-    t1 = getticks();
-    plan->MEASURE_TIME_t[2] = nfft_elapsed_seconds(t1,t0);
-#endif
+    if (plan->stats.enabled)
+      Y(stats_add)(&plan->stats, NFSFT_STATS_NFFT, Y(stats_seconds)() - t0);
 
     //fprintf(stderr,"nfsft_adjoint: Executing c2e_transposed\n");
     //fflush(stderr);
-#ifdef MEASURE_TIME
-    t0 = getticks();
-#endif
+    if (plan->stats.enabled)
+      t0 = Y(stats_seconds)();
     /* Convert Fourier coefficients to Chebyshev coefficients. */
     c2e_transposed(plan);
-#ifdef MEASURE_TIME
-    t1 = getticks();
-    plan->MEASURE_TIME_t[1] = nfft_elapsed_seconds(t1,t0);
-#endif
+    if (plan->stats.enabled)
+      Y(stats_add)(&plan->stats, NFSFT_STATS_C2E, Y(stats_seconds)() - t0);
 
-#ifdef MEASURE_TIME
-    t0 = getticks();
-#endif
+    if (plan->stats.enabled)
+      t0 = Y(stats_seconds)();
     /* Check, which transposed polynomial transform algorithm should be used */
     if (plan->flags & NFSFT_USE_DPT)
     {
@@ -1505,10 +1462,8 @@ void nfsft_adjoint(nfsft_plan *plan)
       }
 #endif
     }
-#ifdef MEASURE_TIME
-    t1 = getticks();
-    plan->MEASURE_TIME_t[0] = nfft_elapsed_seconds(t1,t0);
-#endif
+    if (plan->stats.enabled)
+      Y(stats_add)(&plan->stats, NFSFT_STATS_FPT, Y(stats_seconds)() - t0);
 
     /* Check, if we compute with L^2-normalized spherical harmonics. If so,
      * multiply spherical Fourier coefficients with corresponding normalization
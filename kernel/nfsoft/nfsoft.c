@@ -89,6 +89,7 @@ void nfsoft_init_guru_advanced(nfsoft_plan *plan, int B, int M,
   plan->N_total = B;
   plan->M_total = M;
   plan->flags = nfsoft_flags;
+  memset(&plan->stats, 0, sizeof(plan->stats));
 
   if (plan->flags & NFSOFT_MALLOC_F_HAT)
   {
@@ -428,6 +429,8 @@ void nfsoft_trafo(nfsoft_plan *plan3D)
     return;
   }
 
+  const double stats_t0 = plan3D->stats.enabled ? Y(stats_seconds)() : 0.0;
+
   for (int j = 0; j < plan3D->p_nfft.N_total; j++)
     plan3D->p_nfft.f_hat[j] = 0.0;
 
@@ -500,6 +503,12 @@ void nfsoft_trafo(nfsoft_plan *plan3D)
     for (int j = 0; j < plan3D->M_total; j++)
       plan3D->f[j] = plan3D->p_nfft.f[j];
 
+  if (plan3D->stats.enabled)
+  {
+    Y(stats_add)(&plan3D->stats, NFFT_STATS_TRAFO,
+      Y(stats_seconds)() - stats_t0);
+    plan3D->stats.nodes += (double)M;
+  }
 }
 
 static void e2c(nfsoft_plan *my_plan, int even, C* wig_coeffs, C* cheby)
@@ -558,6 +567,8 @@ void nfsoft_adjoint(nfsoft_plan *plan3D)
     return;
   }
 
+  const double stats_t0 = plan3D->stats.enabled ? Y(stats_seconds)() : 0.0;
+
   if (plan3D->p_nfft.f != plan3D->f)
     for (int j = 0; j < M; j++)
     {
@@ -640,6 +651,13 @@ void nfsoft_adjoint(nfsoft_plan *plan3D)
 
     }
   }
+
+  if (plan3D->stats.enabled)
+  {
+    Y(stats_add)(&plan3D->stats, NFFT_STATS_TRAFO,
+      Y(stats_seconds)() - stats_t0);
+    plan3D->stats.nodes += (double)M;
+  }
 }
 
 void nfsoft_finalize(nfsoft_plan *plan)
@@ -58,6 +58,7 @@ static inline INT intprod(const INT *vec, const INT a, const INT d)
 /* handy shortcuts */
 #define BASE(x) SIN(x)
 #define NN(x) (x + 1)
+#define NDFT_BASIS NDFT_SIN
 #define OFFSET 1
 #define FOURIER_TRAFO FFTW_RODFT00
 #define FFTW_DEFAULT_FLAGS FFTW_ESTIMATE | FFTW_DESTROY_INPUT
@@ -87,156 +88,30 @@ static inline INT intprod(const INT *vec, const INT a, const INT d)
  */
 void X(trafo_direct)(const X(plan) *ths)
 {
-  R *f_hat = (R*)ths->f_hat, *f = (R*)ths->f;
+  INT L[ths->d], k0[ths->d], t;
 
-  memset(f, 0, (size_t)(ths->M_total) * sizeof(R));
-
-  if (ths->d == 1)
+  for (t = 0; t < ths->d; t++)
   {
-    /* specialize for univariate case, rationale: faster */
-    INT j;
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(j)
-#endif
-    for (j = 0; j < ths->M_total; j++)
-    {
-      INT k_L;
-      for (k_L = 0; k_L < ths->N_total; k_L++)
-      {
-        R omega = K2PI * ((R)(k_L + OFFSET)) * ths->x[j];
-        f[j] += f_hat[k_L] * BASE(omega);
-      }
-    }
+    L[t] = ths->N[t] - OFFSET;
+    k0[t] = OFFSET;
   }
-  else
-  {
-    /* multivariate case */
-    INT j;
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(j)
-#endif
-    for (j = 0; j < ths->M_total; j++)
-    {
-      R x[ths->d], omega, Omega[ths->d + 1];
-      INT t, t2, k_L, k[ths->d];
-      Omega[0] = K(1.0);
-      for (t = 0; t < ths->d; t++)
-      {
-        k[t] = OFFSET;
-        x[t] = K2PI * ths->x[j * ths->d + t];
-        Omega[t+1] = BASE(((R)(k[t])) * x[t]) * Omega[t];
-      }
-      omega = Omega[ths->d];
-
-      for (k_L = 0; k_L < ths->N_total; k_L++)
-      {
-        f[j] += f_hat[k_L] * omega;
-        {
-          for (t = ths->d - 1; (t >= 1) && (k[t] == (ths->N[t] - 1)); t--)
-            k[t] = OFFSET;
-
-          k[t]++;
-
-          for (t2 = t; t2 < ths->d; t2++)
-            Omega[t2+1] = BASE(((R)(k[t2])) * x[t2]) * Omega[t2];
 
-          omega = Omega[ths->d];
-        }
-      }
-    }
-  }
+  Y(ndft_trafo_real)(ths->d, L, k0, ths->M_total, ths->x, ths->f_hat, ths->f,
+    NDFT_BASIS);
 }
 
 void X(adjoint_direct)(const X(plan) *ths)
 {
-  R *f_hat = (R*)ths->f_hat, *f = (R*)ths->f;
+  INT L[ths->d], k0[ths->d], t;
 
-  memset(f_hat, 0, (size_t)(ths->N_total) * sizeof(R));
-
-  if (ths->d == 1)
+  for (t = 0; t < ths->d; t++)
   {
-    /* specialize for univariate case, rationale: faster */
-#ifdef _OPENMP
-      INT k_L;
-      #pragma omp parallel for default(shared) private(k_L)
-      for (k_L = 0; k_L < ths->N_total; k_L++)
-      {
-        INT j;
-        for (j = 0; j < ths->M_total; j++)
-        {
-          R omega = K2PI * ((R)(k_L + OFFSET)) * ths->x[j];
-          f_hat[k_L] += f[j] * BASE(omega);
-        }
-      }
-#else
-      INT j;
-      for (j = 0; j < ths->M_total; j++)
-      {
-        INT k_L;
-        for (k_L = 0; k_L < ths->N_total; k_L++)
-        {
-          R omega = K2PI * ((R)(k_L + OFFSET)) * ths->x[j];
-          f_hat[k_L] += f[j] * BASE(omega);
-        }
-      }
-#endif
+    L[t] = ths->N[t] - OFFSET;
+    k0[t] = OFFSET;
   }
-  else
-  {
-    /* multivariate case */
-    INT j, k_L;
-#ifdef _OPENMP
-    #pragma omp parallel for default(shared) private(j, k_L)
-    for (k_L = 0; k_L < ths->N_total; k_L++)
-    {
-      INT k[ths->d], k_temp, t;
 
-      k_temp = k_L;
-
-      for (t = ths->d - 1; t >= 0; t--)
-      {
-        k[t] = k_temp % ths->N[t];
-        k_temp /= ths->N[t];
-      }
-
-      for (j = 0; j < ths->M_total; j++)
-      {
-        R omega = K(1.0);
-        for (t = 0; t < ths->d; t++)
-          omega *= BASE(K2PI * (k[t] + OFFSET) * ths->x[j * ths->d + t]);
-        f_hat[k_L] += f[j] * omega;
-      }
-    }
-#else
-    for (j = 0; j < ths->M_total; j++)
-    {
-      R x[ths->d], omega, Omega[ths->d+1];
-      INT t, t2, k[ths->d];
-      Omega[0] = K(1.0);
-      for (t = 0; t < ths->d; t++)
-      {
-        k[t] = OFFSET;
-        x[t] = K2PI * ths->x[j * ths->d + t];
-        Omega[t+1] = BASE(((R)(k[t])) * x[t]) * Omega[t];
-      }
-      omega = Omega[ths->d];
-      for (k_L = 0; k_L < ths->N_total; k_L++)
-      {
-        f_hat[k_L] += f[j] * omega;
-
-        for (t = ths->d-1; (t >= 1) && (k[t] == ths->N[t] - 1); t--)
-          k[t] = OFFSET;
-
-        k[t]++;
-
-        for (t2 = t; t2 < ths->d; t2++)
-          Omega[t2+1] = BASE(((R)(k[t2])) * x[t2]) * Omega[t2];
-
-        omega = Omega[ths->d];
-      }
-    }
-#endif
-  }
+  Y(ndft_adjoint_real)(ths->d, L, k0, ths->M_total, ths->x, ths->f,
+    ths->f_hat, NDFT_BASIS);
 }
 
 /** fast computation of non equispaced sine transforms
@@ -680,10 +555,14 @@ static inline void B_ ## which_one (X(plan) *ths) \
   for (j = 0, fj = &f[0]; j < ths->M_total; j++, fj += 1) \
   { \
     MACRO_init_uo_l_lj_t; \
+ \
+    for (t2 = 0; t2 < ths->d; t2++) \
+      PHI_ROW((2 * NN(ths->n[t2])), ths->x[j * ths->d + t2], u[t2], t2, \
+        fg_psi[t2]); \
  \
     for (l_L = 0; l_L < lprod; l_L++) \
     { \
-      MACRO_update_phi_prod_ll_plain(which_one, without_PRE_PSI); \
+      MACRO_update_phi_prod_ll_plain(which_one, with_FG_PSI); \
  \
       MACRO_B_compute_ ## which_one; \
  \
@@ -700,6 +579,7 @@ MACRO_B(T)
  */
 void X(trafo)(X(plan) *ths)
 {
+  TIC(NFFT_STATS_TRAFO)
   switch(ths->d)
   {
     default:
@@ -710,25 +590,25 @@ void X(trafo)(X(plan) *ths)
 
       /* form \f$ \hat g_k = \frac{\hat f_k}{c_k\left(\phi\right)} \text{ for }
        * k \in I_N \f$ */
-      TIC(0)
+      TIC(NFFT_STATS_D)
       D_A(ths);
-      TOC(0)
+      TOC(NFFT_STATS_D)
 
       /* Compute by d-variate discrete Fourier transform
        * \f$ g_l = \sum_{k \in I_N} \hat g_k {\rm e}^{-2\pi {\rm i} \frac{kl}{n}}
        * \text{ for } l \in I_n \f$ */
-      TIC_FFTW(1)
+      TIC_FFTW(NFFT_STATS_FFT)
       FFTW(execute)(ths->my_fftw_r2r_plan);
-      TOC_FFTW(1)
+      TOC_FFTW(NFFT_STATS_FFT)
 
       /*if (ths->flags & PRE_FULL_PSI)
         full_psi__A(ths);*/
 
       /* Set \f$ f_j = \sum_{l \in I_n,m(x_j)} g_l \psi\left(x_j-\frac{l}{n}\right)
        * \text{ for } j=0,\dots,M-1 \f$ */
-      TIC(2)
+      TIC(NFFT_STATS_B)
       B_A(ths);
-      TOC(2)
+      TOC(NFFT_STATS_B)
 
       /*if (ths->flags & PRE_FULL_PSI)
       {
@@ -737,10 +617,14 @@ void X(trafo)(X(plan) *ths)
       }*/
     }
   }
+  if (ths->stats.enabled)
+    ths->stats.nodes += (double)ths->M_total;
+  TOC(NFFT_STATS_TRAFO)
 } /* trafo */
 
 void X(adjoint)(X(plan) *ths)
 {
+  TIC(NFFT_STATS_TRAFO)
   switch(ths->d)
   {
     default:
@@ -754,24 +638,27 @@ void X(adjoint)(X(plan) *ths)
 
       /* Set \f$ g_l = \sum_{j=0}^{M-1} f_j \psi\left(x_j-\frac{l}{n}\right)
        * \text{ for } l \in I_n,m(x_j) \f$ */
-      TIC(2)
+      TIC(NFFT_STATS_B)
       B_T(ths);
-      TOC(2)
+      TOC(NFFT_STATS_B)
 
       /* Compute by d-variate discrete cosine transform
        * \f$ \hat g_k = \sum_{l \in I_n} g_l {\rm e}^{-2\pi {\rm i} \frac{kl}{n}}
        * \text{ for }  k \in I_N\f$ */
-      TIC_FFTW(1)
+      TIC_FFTW(NFFT_STATS_FFT)
       FFTW(execute)(ths->my_fftw_r2r_plan);
-      TOC_FFTW(1)
+      TOC_FFTW(NFFT_STATS_FFT)
 
       /* Form \f$ \hat f_k = \frac{\hat g_k}{c_k\left(\phi\right)} \text{ for }
        * k \in I_N \f$ */
-      TIC(0)
+      TIC(NFFT_STATS_D)
       D_T(ths);
-      TOC(0)
+      TOC(NFFT_STATS_D)
     }
   }
+  if (ths->stats.enabled)
+    ths->stats.nodes += (double)ths->M_total;
+  TOC(NFFT_STATS_TRAFO)
 } /* adjoint */
 
 /** initialisation of direct transform
@@ -841,7 +728,6 @@ void X(precompute_fg_psi)(X(plan) *ths)
 void X(precompute_psi)(X(plan) *ths)
 {
   INT t; /* index over all dimensions */
-  INT lj; /* index 0<=lj<u+o+1 */
   INT u, o; /* depends on x_j */
 
   //sort(ths);
@@ -854,9 +740,8 @@ void X(precompute_psi)(X(plan) *ths)
     {
       uo(ths, j, &u, &o, t);
 
-      for(lj = 0; lj < (2 * ths->m + 2); lj++)
-        ths->psi[(j * ths->d + t) * (2 * ths->m + 2) + lj] =
-            (PHI((2 * NN(ths->n[t])), ((ths->x[(j) * ths->d + (t)]) - ((R)(lj + u)) / (K(2.0) * ((R)NN(ths->n[t])))), t));
+      PHI_ROW((2 * NN(ths->n[t])), ths->x[j * ths->d + t], u, t,
+        &ths->psi[(j * ths->d + t) * (2 * ths->m + 2)]);
     } /* for (j) */
   } /* for (t) */
 } /* precompute_psi */
@@ -928,6 +813,8 @@ static inline void init_help(X(plan) *ths)
   INT t; /* index over all dimensions */
   INT lprod; /* 'bandwidth' of matrix B */
 
+  memset(&ths->stats, 0, sizeof(ths->stats));
+
   if (ths->flags & NFFT_OMP_BLOCKWISE_ADJOINT)
     ths->flags |= NFFT_SORT_NODES;
 
@@ -1029,6 +916,7 @@ void X(init)(X(plan) *ths, int d, int *N, int M_total)
     ths->n[t] = 2 * (Y(next_power_of_2)(ths->N[t]) - 1) + OFFSET;
 
   ths->m = WINDOW_HELP_ESTIMATE_m;
+  ths->window = WINDOW_DEFAULT;
 
   if (d > 1)
   {
@@ -1051,6 +939,13 @@ void X(init)(X(plan) *ths, int d, int *N, int M_total)
 
 void X(init_guru)(X(plan) *ths, int d, int *N, int M_total, int *n, int m,
   unsigned flags, unsigned fftw_flags)
+{
+  X(init_guru_window)(ths, d, N, M_total, n, m, flags, fftw_flags,
+    NFFT_WINDOW_DEFAULT);
+}
+
+void X(init_guru_window)(X(plan) *ths, int d, int *N, int M_total, int *n,
+  int m, unsigned flags, unsigned fftw_flags, unsigned window)
 {
   INT t; /* index over all dimensions */
 
@@ -1067,6 +962,7 @@ void X(init_guru)(X(plan) *ths, int d, int *N, int M_total, int *n, int m,
     ths->n[t] = (INT)n[t];
 
   ths->m = (INT)m;
+  ths->window = Y(window_resolve)(window);
 
   ths->flags = flags;
   ths->fftw_flags = fftw_flags;
@@ -1074,6 +970,60 @@ void X(init_guru)(X(plan) *ths, int d, int *N, int M_total, int *n, int m,
   init_help(ths);
 }
 
+/** Number of bytes X(init_guru) and X(precompute_one_psi) allocate for a plan
+ *  with these parameters and the default window. The plan struct itself and
+ *  the internal data of the FFTW plan are not included. */
+size_t X(estimate_memory)(int d, int *N, int M_total, int *n, int m,
+  unsigned flags)
+{
+  const unsigned window = Y(window_resolve)(NFFT_WINDOW_DEFAULT);
+  const size_t M = (size_t)(M_total);
+  size_t N_total = 1, n_total = 1, N_sum = 0, lprod = 1, bytes;
+  int t;
+
+  for (t = 0; t < d; t++)
+  {
+    N_total *= (size_t)(N[t] - OFFSET);
+    n_total *= (size_t)(n[t]);
+    N_sum += (size_t)(N[t] - OFFSET);
+    lprod *= (size_t)(2 * m + 2);
+  }
+
+  /* N, n, sigma, r2r_kind, b and the window coefficients */
+  bytes = (size_t)(d) * (2 * sizeof(INT) + 2 * sizeof(R)
+    + sizeof(FFTW(r2r_kind)))
+    + (size_t)(d * Y(window_coeffs_size)(window, (INT)m)) * sizeof(R);
+
+  if (flags & MALLOC_X)
+    bytes += (size_t)(d) * M * sizeof(R);
+
+  if (flags & MALLOC_F_HAT)
+    bytes += N_total * sizeof(R);
+
+  if (flags & MALLOC_F)
+    bytes += M * sizeof(R);
+
+  if (flags & PRE_PHI_HUT)
+    bytes += (size_t)(d) * sizeof(R*) + N_sum * sizeof(R);
+
+  if (flags & PRE_LIN_PSI)
+    bytes += (size_t)(((1U<< 10) * (m + 2) + 1) * d) * sizeof(R);
+
+  if (flags & PRE_FG_PSI)
+    bytes += M * (size_t)(d) * 2 * sizeof(R);
+
+  if (flags & PRE_PSI)
+    bytes += M * (size_t)(d * (2 * m + 2)) * sizeof(R);
+
+  if (flags & PRE_FULL_PSI)
+    bytes += M * lprod * (sizeof(R) + sizeof(INT)) + M * sizeof(INT);
+
+  if (flags & FFTW_INIT)
+    bytes += n_total * sizeof(R) * ((flags & FFT_OUT_OF_PLACE) ? 2U : 1U);
+
+  return bytes;
+}
+
 void X(init_1d)(X(plan) *ths, int N1, int M_total)
 {
   int N[1];
@@ -1117,6 +1067,9 @@ const char* X(check)(X(plan) *ths)
   if (!ths->f_hat)
       return "Member f_hat not initialized.";
 
+  if ((ths->flags & (FG_PSI | PRE_FG_PSI)) && ths->window != NFFT_WINDOW_GAUSSIAN)
+    return "FG_PSI and PRE_FG_PSI require the Gaussian window function.";
+
   for (j = 0; j < ths->M_total * ths->d; j++)
   {
     if ((ths->x[j] < K(0.0)) || (ths->x[j] >= K(0.5)))
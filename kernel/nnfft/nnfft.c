@@ -292,7 +292,10 @@ void nnfft_trafo(nnfft_plan *ths)
 {
   int j,t;
 
+  TIC(NFFT_STATS_TRAFO)
+  TIC(NFFT_STATS_B)
   nnfft_B_T(ths);
+  TOC(NFFT_STATS_B)
 
   for(j=0;j<ths->M_total;j++) {
     for(t=0;t<ths->d;t++) {
@@ -304,7 +307,10 @@ void nnfft_trafo(nnfft_plan *ths)
   /* allows for external swaps of ths->f */
   ths->direct_plan->f = ths->f;
 
+  /* the inner nfft is counted as the FFT phase of the nnfft */
+  TIC(NFFT_STATS_FFT)
   nfft_trafo(ths->direct_plan);
+  TOC(NFFT_STATS_FFT)
 
   for(j=0;j<ths->M_total;j++) {
     for(t=0;t<ths->d;t++) {
@@ -312,15 +318,23 @@ void nnfft_trafo(nnfft_plan *ths)
     }
   }
 
+  TIC(NFFT_STATS_D)
   nnfft_D(ths);
+  TOC(NFFT_STATS_D)
 
+  if (ths->stats.enabled)
+    ths->stats.nodes += (double)ths->M_total;
+  TOC(NFFT_STATS_TRAFO)
 } /* nnfft_trafo */
 
 void nnfft_adjoint(nnfft_plan *ths)
 {
   int j,t;
 
+  TIC(NFFT_STATS_TRAFO)
+  TIC(NFFT_STATS_D)
   nnfft_D(ths);
+  TOC(NFFT_STATS_D)
 
   for(j=0;j<ths->M_total;j++) {
     for(t=0;t<ths->d;t++) {
@@ -331,7 +345,9 @@ void nnfft_adjoint(nnfft_plan *ths)
   /* allows for external swaps of ths->f */
   ths->direct_plan->f=ths->f;
 
+  TIC(NFFT_STATS_FFT)
   nfft_adjoint(ths->direct_plan);
+  TOC(NFFT_STATS_FFT)
 
   for(j=0;j<ths->M_total;j++) {
     for(t=0;t<ths->d;t++) {
@@ -339,7 +355,13 @@ void nnfft_adjoint(nnfft_plan *ths)
     }
   }
 
+  TIC(NFFT_STATS_B)
   nnfft_B_A(ths);
+  TOC(NFFT_STATS_B)
+
+  if (ths->stats.enabled)
+    ths->stats.nodes += (double)ths->M_total;
+  TOC(NFFT_STATS_TRAFO)
 } /* nnfft_adjoint */
 
 /** initialisation of direct transform
@@ -386,8 +408,6 @@ void nnfft_precompute_psi(nnfft_plan *ths)
 {
   int t;                                /**< index over all dimensions        */
   int j;                                /**< index over all nodes             */
-  int l;                                /**< index u<=l<=o                    */
-  int lj;                               /**< index 0<=lj<u+o+1                */
   int u, o;                             /**< depends on v_j                   */
 
   for (t=0; t<ths->d; t++)
@@ -395,9 +415,9 @@ void nnfft_precompute_psi(nnfft_plan *ths)
       {
         nnfft_uo(ths,j,&u,&o,t);
 
-        for(l=u, lj=0; l <= o; l++, lj++)
-          ths->psi[(j*ths->d+t)*(2*ths->m+2)+lj]=
-            (PHI(ths->n[t],(-ths->v[j*ths->d+t]+((double)l)/((double)ths->N1[t])),t));
+        /* the window is even and n = N1 */
+        PHI_ROW(ths->n[t],ths->v[j*ths->d+t],u,t,
+          &ths->psi[(j*ths->d+t)*(2*ths->m+2)]);
       } /* for(j) */
 
   for(j=0;j<ths->M_total;j++) {
@@ -491,12 +511,51 @@ void nnfft_precompute_one_psi(nnfft_plan *ths)
 	  nnfft_precompute_phi_hut(ths);
 }
 
+/** Factor a, length aN1 of the enlarged grid and oversampled size N2 of the
+ *  inner NFFT in one dimension. */
+static void nnfft_inner_sizes(const int N, const int N1, const int m,
+  double *a, int *aN1, int *N2)
+{
+  *a = 1.0 + (2.0*((double)m))/((double)N1);
+  *aN1 = *a * ((double)N1);
+  /* aN1 should be even */
+  if(*aN1%2 != 0)
+    *aN1 = *aN1 +1;
+
+  /* take the same oversampling factor in the inner NFFT */
+  *N2 = ceil((((double)N1)/((double)N))*(*aN1));
+
+  /* N2 should be even */
+  if(*N2%2 != 0)
+    *N2 = *N2 +1;
+}
+
+/** Flags of the inner NFFT for nnfft_init_guru. */
+static unsigned nnfft_nfft_flags(int d, unsigned nnfft_flags)
+{
+  unsigned nfft_flags= PRE_PHI_HUT| MALLOC_F_HAT| FFTW_INIT|
+      ((d == 1) ? FFT_OUT_OF_PLACE : 0U) | NFFT_OMP_BLOCKWISE_ADJOINT;
+
+  if(nnfft_flags & PRE_PSI)
+    nfft_flags = nfft_flags | PRE_PSI;
+
+  if(nnfft_flags & PRE_FULL_PSI)
+    nfft_flags = nfft_flags | PRE_FULL_PSI;
+
+  if(nnfft_flags & PRE_LIN_PSI)
+    nfft_flags = nfft_flags | PRE_LIN_PSI;
+
+  return nfft_flags;
+}
+
 static void nnfft_init_help(nnfft_plan *ths, int m2, unsigned nfft_flags, unsigned fftw_flags)
 {
   int t;                                /**< index over all dimensions       */
   int lprod;                            /**< 'bandwidth' of matrix B         */
   int N2[ths->d];
 
+  memset(&ths->stats, 0, sizeof(ths->stats));
+
   ths->aN1 = (int*) nfft_malloc(ths->d*sizeof(int));
 
   ths->a = (double*) nfft_malloc(ths->d*sizeof(double));
@@ -508,21 +567,11 @@ static void nnfft_init_help(nnfft_plan *ths, int m2, unsigned nfft_flags, unsign
   ths->aN1_total=1;
 
   for(t = 0; t<ths->d; t++) {
-    ths->a[t] = 1.0 + (2.0*((double)ths->m))/((double)ths->N1[t]);
-    ths->aN1[t] = ths->a[t] * ((double)ths->N1[t]);
-    /* aN1 should be even */
-    if(ths->aN1[t]%2 != 0)
-      ths->aN1[t] = ths->aN1[t] +1;
+    nnfft_inner_sizes(ths->N[t], ths->N1[t], ths->m, &ths->a[t], &ths->aN1[t],
+      &N2[t]);
 
     ths->aN1_total*=ths->aN1[t];
     ths->sigma[t] = ((double) ths->N1[t] )/((double) ths->N[t]);;
-    
-    /* take the same oversampling factor in the inner NFFT */
-    N2[t] = ceil(ths->sigma[t]*(ths->aN1[t]));
-    
-    /* N2 should be even */
-    if(N2[t]%2 != 0)
-      N2[t] = N2[t] +1;
   }
 
   WINDOW_HELP_INIT
@@ -563,8 +612,8 @@ static void nnfft_init_help(nnfft_plan *ths, int m2, unsigned nfft_flags, unsign
       ths->psi_index_g = (int*) nfft_malloc(ths->N_total*lprod*sizeof(int));
   }
   ths->direct_plan = (nfft_plan*)nfft_malloc(sizeof(nfft_plan));
-  nfft_init_guru(ths->direct_plan, ths->d, ths->aN1, ths->M_total, N2, m2,
-		 nfft_flags, fftw_flags);
+  nfft_init_guru_window(ths->direct_plan, ths->d, ths->aN1, ths->M_total, N2,
+		 m2, nfft_flags, fftw_flags, ths->window);
   ths->direct_plan->x = ths->x;
 
   ths->direct_plan->f = ths->f;
@@ -576,6 +625,13 @@ static void nnfft_init_help(nnfft_plan *ths, int m2, unsigned nfft_flags, unsign
 
 void nnfft_init_guru(nnfft_plan *ths, int d, int N_total, int M_total, int *N, int *N1,
 		     int m, unsigned nnfft_flags)
+{
+  nnfft_init_guru_window(ths, d, N_total, M_total, N, N1, m, nnfft_flags,
+    NFFT_WINDOW_DEFAULT);
+}
+
+void nnfft_init_guru_window(nnfft_plan *ths, int d, int N_total, int M_total,
+		     int *N, int *N1, int m, unsigned nnfft_flags, unsigned window)
 {
   int t;                             /**< index over all dimensions        */
 
@@ -586,19 +642,10 @@ void nnfft_init_guru(nnfft_plan *ths, int d, int N_total, int M_total, int *N, i
   ths->M_total= M_total;
   ths->N_total= N_total;
   ths->m= m;
+  ths->window= Y(window_resolve)(window);
   ths->nnfft_flags= nnfft_flags;
   fftw_flags= FFTW_ESTIMATE| FFTW_DESTROY_INPUT;
-  nfft_flags= PRE_PHI_HUT| MALLOC_F_HAT| FFTW_INIT|
-      ((d == 1) ? FFT_OUT_OF_PLACE : 0U) | NFFT_OMP_BLOCKWISE_ADJOINT;
-
-  if(ths->nnfft_flags & PRE_PSI)
-    nfft_flags = nfft_flags | PRE_PSI;
-
-  if(ths->nnfft_flags & PRE_FULL_PSI)
-    nfft_flags = nfft_flags | PRE_FULL_PSI;
-
-  if(ths->nnfft_flags & PRE_LIN_PSI)
-    nfft_flags = nfft_flags | PRE_LIN_PSI;
+  nfft_flags= nnfft_nfft_flags(d, ths->nnfft_flags);
 
   ths->N = (int*) nfft_malloc(ths->d*sizeof(int));
   ths->N1 = (int*) nfft_malloc(ths->d*sizeof(int));
@@ -610,6 +657,49 @@ void nnfft_init_guru(nnfft_plan *ths, int d, int N_total, int M_total, int *N, i
   nnfft_init_help(ths,m,nfft_flags,fftw_flags);
 }
 
+/** Number of bytes nnfft_init_guru and nnfft_precompute_one_psi allocate,
+ *  including the inner NFFT plan, for these parameters and the default window.
+ *  The internal data of the FFTW plans is not included. */
+size_t nnfft_estimate_memory(int d, int N_total, int M_total, int *N, int *N1,
+  int m, unsigned nnfft_flags)
+{
+  const unsigned window = Y(window_resolve)(NFFT_WINDOW_DEFAULT);
+  const size_t M = (size_t)M_total, NT = (size_t)N_total;
+  size_t lprod = 1, bytes;
+  int t, aN1[d], N2[d];
+  double a;
+
+  for(t = 0; t < d; t++) {
+    nnfft_inner_sizes(N[t], N1[t], m, &a, &aN1[t], &N2[t]);
+    lprod *= (size_t)(2*m+2);
+  }
+
+  /* N, N1, aN1, a, sigma, b, the window coefficients and the inner plan */
+  bytes = (size_t)d*(3*sizeof(int) + 3*sizeof(double))
+    + (size_t)(d*Y(window_coeffs_size)(window, m))*sizeof(double)
+    + sizeof(nfft_plan);
+
+  if(nnfft_flags & MALLOC_X)
+    bytes += (size_t)d*M*sizeof(double);
+  if(nnfft_flags & MALLOC_F)
+    bytes += M*sizeof(double _Complex);
+  if(nnfft_flags & MALLOC_V)
+    bytes += (size_t)d*NT*sizeof(double);
+  if(nnfft_flags & MALLOC_F_HAT)
+    bytes += NT*sizeof(double _Complex);
+  if(nnfft_flags & PRE_PHI_HUT)
+    bytes += M*sizeof(double);
+  if(nnfft_flags & PRE_LIN_PSI)
+    bytes += (size_t)(((1U<< 10)*(m+1)+1)*d)*sizeof(double);
+  if(nnfft_flags & PRE_PSI)
+    bytes += NT*(size_t)(d*(2*m+2))*sizeof(double);
+  if(nnfft_flags & PRE_FULL_PSI)
+    bytes += NT*lprod*(sizeof(double) + sizeof(int)) + NT*sizeof(int);
+
+  return bytes + nfft_estimate_memory(d, aN1, M_total, N2, m,
+    nnfft_nfft_flags(d, nnfft_flags));
+}
+
 void nnfft_init(nnfft_plan *ths, int d, int N_total, int M_total, int *N)
 {
   int t;                            /**< index over all dimensions        */
@@ -626,6 +716,7 @@ void nnfft_init(nnfft_plan *ths, int d, int N_total, int M_total, int *N)
 */
   //BUGFIX SUSE 1
 ths->m=WINDOW_HELP_ESTIMATE_m;
+  ths->window=WINDOW_DEFAULT;
 
 
   ths->N = (int*) nfft_malloc(ths->d*sizeof(int));
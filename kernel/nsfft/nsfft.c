@@ -1540,18 +1540,26 @@ static void nsfft_adjoint_3d(nsfft_plan *ths)
 
 void nsfft_trafo(nsfft_plan *ths)
 {
+  TIC(NFFT_STATS_TRAFO)
   if(ths->d==2)
     nsfft_trafo_2d(ths);
   else
     nsfft_trafo_3d(ths);
+  if (ths->stats.enabled)
+    ths->stats.nodes += (double)ths->M_total;
+  TOC(NFFT_STATS_TRAFO)
 }
 
 void nsfft_adjoint(nsfft_plan *ths)
 {
+  TIC(NFFT_STATS_TRAFO)
   if(ths->d==2)
     nsfft_adjoint_2d(ths);
   else
     nsfft_adjoint_3d(ths);
+  if (ths->stats.enabled)
+    ths->stats.nodes += (double)ths->M_total;
+  TOC(NFFT_STATS_TRAFO)
 }
 
 
@@ -1764,6 +1772,7 @@ static void nsfft_init_3d(nsfft_plan *ths, int J, int M, int m, unsigned snfft_f
 void nsfft_init(nsfft_plan *ths, int d, int J, int M, int m, unsigned flags)
 {
   ths->d=d;
+  memset(&ths->stats, 0, sizeof(ths->stats));
 
   if(ths->d==2)
     nsfft_init_2d(ths, J, M, m, flags);
@@ -1783,6 +1792,7 @@ void nsfft_init(nsfft_plan *ths, int d, int J, int M, int m, unsigned flags)
   UNUSED(M);
   UNUSED(m);
   UNUSED(flags);
+  memset(&ths->stats, 0, sizeof(ths->stats));
   fprintf(stderr,
 	  "\nError in kernel/nsfft_init: require GAUSSIAN window function\n");
 }
@@ -346,6 +346,7 @@ static void solver_loop_one_step_cgne_complex(X(plan_complex) *ths)
 /** void solver_loop_one_step */
 void X(loop_one_step_complex)(X(plan_complex) *ths)
 {
+  TRACE_BEGIN(NFFT_TRACE_SOLVER, ths, ths->mv->M_total, ths->mv->N_total)
   if(ths->flags & LANDWEBER)
     solver_loop_one_step_landweber_complex(ths);
 
@@ -357,6 +358,7 @@ void X(loop_one_step_complex)(X(plan_complex) *ths)
 
   if(ths->flags & CGNE)
     solver_loop_one_step_cgne_complex(ths);
+  TRACE_END(NFFT_TRACE_SOLVER, ths, ths->mv->M_total, ths->mv->N_total)
 } /* void solver_loop_one_step */
 
 /** void solver_finalize */
@@ -697,6 +699,7 @@ static void solver_loop_one_step_cgne_double(X(plan_double) *ths)
 /** void solver_loop_one_step */
 void X(loop_one_step_double)(X(plan_double) *ths)
 {
+  TRACE_BEGIN(NFFT_TRACE_SOLVER, ths, ths->mv->M_total, ths->mv->N_total)
   if(ths->flags & LANDWEBER)
     solver_loop_one_step_landweber_double(ths);
 
@@ -708,6 +711,7 @@ void X(loop_one_step_double)(X(plan_double) *ths)
 
   if(ths->flags & CGNE)
     solver_loop_one_step_cgne_double(ths);
+  TRACE_END(NFFT_TRACE_SOLVER, ths, ths->mv->M_total, ths->mv->N_total)
 } /* void solver_loop_one_step */
 
 /** void solver_finalize */
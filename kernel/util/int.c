@@ -131,6 +131,28 @@ INT Y(next_power_of_2)(const INT x)
     }
 }
 
+/** Returns the smallest even \f$n\ge N\f$ of the form \f$2^a3^b5^c7^d\f$,
+ *  the sizes FFTW transforms fastest besides powers of two.
+ */
+INT Y(next_fft_size)(const INT N)
+{
+  static const INT p[] = {2, 3, 5, 7};
+  INT n = MAX(N, 2) + MAX(N, 2) % 2;
+
+  for (;; n += 2)
+  {
+    INT r = n;
+    size_t i;
+
+    for (i = 0; i < SIZE(p); i++)
+      while (r % p[i] == 0)
+        r /= p[i];
+
+    if (r == 1)
+      return n;
+  }
+}
+
 /** Computes /f$n\ge N/f$ such that /f$n=2^j,\, j\in\mathhb{N}_0/f$.
  */
 void Y(next_power_of_2_exp)(const INT N, INT *N2, INT *t)
@@ -20,6 +20,16 @@
 
 #include "api.h"
 
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP) && defined(HAVE_MUNMAP)
+#include <sys/mman.h>
+#if defined(MAP_ANONYMOUS) && defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+#define ARENA_HUGE_PAGES
+#endif
+#endif
+
+/** Size of a transparent huge page. */
+#define ARENA_HUGE_PAGE_SIZE ((size_t)(2) << 20)
+
 Y(malloc_type_function) Y(malloc_hook) = 0;
 Y(free_type_function) Y(free_hook) = 0;
 Y(die_type_function) Y(die_hook) = 0;
@@ -62,3 +72,122 @@ void Y(die)(const char *s)
 
   exit(EXIT_FAILURE);
 }
+
+struct Y(arena_s)
+{
+  char *base; /**< Slab, aligned to ARENA_ALIGN bytes */
+  void *block; /**< Allocation holding the slab */
+  size_t size; /**< Usable bytes of the slab */
+  size_t used; /**< Bytes of the slab handed out since the last reset */
+  size_t last; /**< Offset of the most recent block */
+  size_t passed; /**< Bytes passed on to Y(malloc) since the last reset */
+  size_t peak; /**< Largest used + passed */
+  int mapped; /**< Slab is an anonymous mapping with huge pages */
+};
+
+static size_t arena_round(const size_t n, const size_t align)
+{
+  return (n + align - 1) / align * align;
+}
+
+Y(arena) *Y(arena_create)(size_t size, unsigned flags)
+{
+  Y(arena) *a = (Y(arena)*) Y(malloc)(sizeof(Y(arena)));
+
+  a->size = arena_round(size, ARENA_ALIGN);
+  a->used = a->last = a->passed = a->peak = 0;
+  a->mapped = 0;
+  a->block = NULL;
+
+#ifdef ARENA_HUGE_PAGES
+  if ((flags & NFFT_ARENA_HUGE_PAGES) && a->size > 0)
+  {
+    void *p;
+
+    a->size = arena_round(a->size, ARENA_HUGE_PAGE_SIZE);
+    p = mmap(NULL, a->size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (p != MAP_FAILED)
+    {
+      /* only a hint, the slab works with normal pages as well */
+      madvise(p, a->size, MADV_HUGEPAGE);
+      a->block = p;
+      a->base = (char*) p;
+      a->mapped = 1;
+      return a;
+    }
+
+    a->size = arena_round(size, ARENA_ALIGN);
+  }
+#else
+  UNUSED(flags);
+#endif
+
+  a->block = Y(malloc)(a->size + ARENA_ALIGN - 1);
+  a->base = (char*)(a->block) + (arena_round((size_t)(a->block), ARENA_ALIGN)
+    - (size_t)(a->block));
+
+  return a;
+}
+
+void *Y(arena_malloc)(Y(arena) *a, size_t n)
+{
+  size_t k = arena_round(n == 0 ? 1 : n, ARENA_ALIGN);
+
+  if (k > a->size - a->used)
+  {
+    a->passed += k;
+    a->peak = MAX(a->peak, a->used + a->passed);
+    return Y(malloc)(n);
+  }
+
+  a->last = a->used;
+  a->used += k;
+  a->peak = MAX(a->peak, a->used + a->passed);
+
+  return a->base + a->last;
+}
+
+void Y(arena_free)(Y(arena) *a, void *p)
+{
+  char *q = (char*) p;
+
+  if (q == NULL)
+    return;
+
+  if (q < a->base || q >= a->base + a->size)
+  {
+    Y(free)(p);
+    return;
+  }
+
+  /* the most recent block can be given back, e.g. temporary buffers */
+  if (q == a->base + a->last && a->last < a->used)
+    a->used = a->last;
+}
+
+void Y(arena_reset)(Y(arena) *a)
+{
+  a->used = a->last = a->passed = 0;
+}
+
+size_t Y(arena_peak)(const Y(arena) *a)
+{
+  return a->peak;
+}
+
+void Y(arena_destroy)(Y(arena) *a)
+{
+  if (a == NULL)
+    return;
+
+#ifdef ARENA_HUGE_PAGES
+  if (a->mapped)
+    munmap(a->block, a->size);
+  else
+#endif
+    Y(free)(a->block);
+
+  Y(free)(a);
+}
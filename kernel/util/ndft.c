@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) 2002, 2017 Jens Keiner, Stefan Kunis, Daniel Potts
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Direct transforms on a tensor product grid of frequencies
+ *   k_t = k0[t], ..., k0[t] + L[t] - 1,   t = 0, ..., d-1,
+ * with the coefficients stored row-major. The nodes are processed in blocks
+ * of NDFT_BLOCK. For each block and dimension the factors exp(2 pi i s k x)
+ * are tabulated by the recurrence e_{k+1} = e_k exp(2 pi i s x), so that
+ * every term of the sum costs one multiply-add instead of an exponential.
+ * The tables hold the real and imaginary parts of a block contiguously, and
+ * the innermost loops run over the nodes of a block, which vectorizes. */
+
+#include "api.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** Number of nodes per block. */
+#define NDFT_BLOCK 8
+/** The recurrence is restarted from an exact value every NDFT_RESEED steps,
+ *  which keeps its rounding error at that of a few products. */
+#define NDFT_RESEED 32
+
+/** Tables re, im of the d dimensions, dimension t at offset
+ *  NDFT_BLOCK * (L[0] + ... + L[t-1]), of the block of nb nodes x. The last
+ *  dimension is only tabulated for the indices kl0 <= k < kl1. */
+static void ndft_tables(const INT d, const INT *L, const INT *k0, const R *x,
+  const INT nb, const R s, R *re, R *im, const INT kl0, const INT kl1)
+{
+  INT t, b, k, off = 0;
+
+  for (t = 0; t < d; t++)
+  {
+    const INT ka = t == d - 1 ? kl0 : 0, kb = t == d - 1 ? kl1 : L[t];
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+    {
+      const R xb = b < nb ? K2PI * s * x[b * d + t] : K(0.0);
+      const C w = CEXP(II * xb);
+      C z = K(1.0);
+
+      for (k = ka; k < kb; k++)
+      {
+        if (k % NDFT_RESEED == 0 || k == ka)
+          z = CEXP(II * xb * (R)(k0[t] + k));
+        else
+          z *= w;
+
+        re[off + k * NDFT_BLOCK + b] = CREAL(z);
+        im[off + k * NDFT_BLOCK + b] = CIMAG(z);
+      }
+    }
+    off += L[t] * NDFT_BLOCK;
+  }
+}
+
+/** Sets the row factors pr, pi of the dimensions t0, ..., d-2 from the
+ *  frequency indices k, pr[t+1] = pr[t] e_t[k[t]]. */
+static void ndft_row_factors(const INT d, const INT *L, const INT *k,
+  const INT t0, const R *re, const R *im, R *pr, R *pi)
+{
+  INT t, b, off = 0;
+
+  for (t = 0; t < t0; t++)
+    off += L[t] * NDFT_BLOCK;
+
+  for (t = t0; t < d - 1; t++)
+  {
+    const R *er = re + off + k[t] * NDFT_BLOCK;
+    const R *ei = im + off + k[t] * NDFT_BLOCK;
+    const R *ar = pr + t * NDFT_BLOCK, *ai = pi + t * NDFT_BLOCK;
+    R *cr = pr + (t + 1) * NDFT_BLOCK, *ci = pi + (t + 1) * NDFT_BLOCK;
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+    {
+      cr[b] = ar[b] * er[b] - ai[b] * ei[b];
+      ci[b] = ar[b] * ei[b] + ai[b] * er[b];
+    }
+
+    off += L[t] * NDFT_BLOCK;
+  }
+}
+
+/** Advances the indices k of the dimensions 0, ..., d-2 like an odometer and
+ *  returns the first dimension that changed. */
+static INT ndft_next_row(const INT d, const INT *L, INT *k)
+{
+  INT t = d - 2;
+
+  while (t > 0 && k[t] == L[t] - 1)
+    k[t--] = 0;
+
+  k[t]++;
+
+  return t;
+}
+
+static INT ndft_rows(const INT d, const INT *L)
+{
+  INT t, rows = 1;
+
+  for (t = 0; t < d - 1; t++)
+    rows *= L[t];
+
+  return rows;
+}
+
+/** Sets the indices k of the dimensions 0, ..., d-2 of row r. */
+static void ndft_row_index(const INT d, const INT *L, INT r, INT *k)
+{
+  INT t;
+
+  for (t = d - 2; t >= 0; t--)
+  {
+    k[t] = r % L[t];
+    r /= L[t];
+  }
+}
+
+/**
+ * Coefficients of the adjoint that thread tid of nthreads owns: the entries
+ * kk0 <= kk < kk1 of the rows r0 <= r < r1. The rows are split if there are
+ * at least as many as threads, the last dimension otherwise.
+ */
+static void ndft_partition(const INT d, const INT *L, const INT tid,
+  const INT nthreads, INT *r0, INT *r1, INT *kk0, INT *kk1)
+{
+  const INT rows = ndft_rows(d, L), last = L[d - 1];
+
+  if (rows >= nthreads)
+  {
+    *r0 = (rows * tid) / nthreads;
+    *r1 = (rows * (tid + 1)) / nthreads;
+    *kk0 = 0;
+    *kk1 = last;
+  }
+  else
+  {
+    *r0 = 0;
+    *r1 = rows;
+    *kk0 = (last * tid) / nthreads;
+    *kk1 = (last * (tid + 1)) / nthreads;
+  }
+}
+
+/** f[b] = sum_k f_hat[k] prod_t e_t[k_t][b] for the nb nodes of a block. */
+static void ndft_trafo_block(const INT d, const INT *L, const R *re,
+  const R *im, const C *f_hat, C *f, const INT nb)
+{
+  const INT last = L[d - 1], rows = ndft_rows(d, L);
+  const R *er = re, *ei = im;
+  R pr[d * NDFT_BLOCK], pi[d * NDFT_BLOCK];
+  R ar[NDFT_BLOCK], ai[NDFT_BLOCK];
+  INT k[d], t, b, r, kk;
+
+  for (t = 0; t < d - 1; t++)
+  {
+    k[t] = 0;
+    er += L[t] * NDFT_BLOCK;
+    ei += L[t] * NDFT_BLOCK;
+  }
+
+  for (b = 0; b < NDFT_BLOCK; b++)
+  {
+    pr[b] = K(1.0);
+    pi[b] = K(0.0);
+    ar[b] = ai[b] = K(0.0);
+  }
+
+  ndft_row_factors(d, L, k, 0, re, im, pr, pi);
+
+  for (r = 0; r < rows; r++)
+  {
+    const C *fh = f_hat + r * last;
+    const R *qr = pr + (d - 1) * NDFT_BLOCK, *qi = pi + (d - 1) * NDFT_BLOCK;
+    R sr[NDFT_BLOCK], si[NDFT_BLOCK];
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+      sr[b] = si[b] = K(0.0);
+
+    for (kk = 0; kk < last; kk++)
+    {
+      const R fr = CREAL(fh[kk]), fi = CIMAG(fh[kk]);
+      const R *wr = er + kk * NDFT_BLOCK, *wi = ei + kk * NDFT_BLOCK;
+
+      for (b = 0; b < NDFT_BLOCK; b++)
+      {
+        sr[b] += fr * wr[b] - fi * wi[b];
+        si[b] += fr * wi[b] + fi * wr[b];
+      }
+    }
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+    {
+      ar[b] += qr[b] * sr[b] - qi[b] * si[b];
+      ai[b] += qr[b] * si[b] + qi[b] * sr[b];
+    }
+
+    if (r + 1 < rows)
+      ndft_row_factors(d, L, k, ndft_next_row(d, L, k), re, im, pr, pi);
+  }
+
+  for (b = 0; b < nb; b++)
+    f[b] = ar[b] + II * ai[b];
+}
+
+/** f_hat[k] += sum_b f[b] prod_t e_t[k_t][b] for the nb nodes of a block and
+ *  the coefficients of ndft_partition. */
+static void ndft_adjoint_block(const INT d, const INT *L, const R *re,
+  const R *im, const C *f, C *f_hat, const INT nb, const INT r0, const INT r1,
+  const INT kk0, const INT kk1)
+{
+  const INT last = L[d - 1];
+  const R *er = re, *ei = im;
+  R pr[d * NDFT_BLOCK], pi[d * NDFT_BLOCK];
+  R fr[NDFT_BLOCK], fi[NDFT_BLOCK];
+  INT k[d], t, b, r, kk;
+
+  ndft_row_index(d, L, r0, k);
+
+  for (t = 0; t < d - 1; t++)
+  {
+    er += L[t] * NDFT_BLOCK;
+    ei += L[t] * NDFT_BLOCK;
+  }
+
+  for (b = 0; b < NDFT_BLOCK; b++)
+  {
+    pr[b] = K(1.0);
+    pi[b] = K(0.0);
+    fr[b] = b < nb ? CREAL(f[b]) : K(0.0);
+    fi[b] = b < nb ? CIMAG(f[b]) : K(0.0);
+  }
+
+  ndft_row_factors(d, L, k, 0, re, im, pr, pi);
+
+  for (r = r0; r < r1; r++)
+  {
+    C *fh = f_hat + r * last;
+    const R *qr = pr + (d - 1) * NDFT_BLOCK, *qi = pi + (d - 1) * NDFT_BLOCK;
+    R gr[NDFT_BLOCK], gi[NDFT_BLOCK];
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+    {
+      gr[b] = fr[b] * qr[b] - fi[b] * qi[b];
+      gi[b] = fr[b] * qi[b] + fi[b] * qr[b];
+    }
+
+    for (kk = kk0; kk < kk1; kk++)
+    {
+      const R *wr = er + kk * NDFT_BLOCK, *wi = ei + kk * NDFT_BLOCK;
+      R sr = K(0.0), si = K(0.0);
+
+      for (b = 0; b < NDFT_BLOCK; b++)
+      {
+        sr += gr[b] * wr[b] - gi[b] * wi[b];
+        si += gr[b] * wi[b] + gi[b] * wr[b];
+      }
+
+      fh[kk] += sr + II * si;
+    }
+
+    if (r + 1 < r1)
+      ndft_row_factors(d, L, k, ndft_next_row(d, L, k), re, im, pr, pi);
+  }
+}
+
+static INT ndft_table_size(const INT d, const INT *L)
+{
+  INT t, size = 0;
+
+  for (t = 0; t < d; t++)
+    size += L[t];
+
+  return size * NDFT_BLOCK;
+}
+
+void Y(ndft_trafo)(const INT d, const INT *L, const INT *k0, const INT M,
+  const R *x, const C *f_hat, C *f, const R sign)
+{
+  const INT size = ndft_table_size(d, L);
+
+#ifdef _OPENMP
+  #pragma omp parallel default(shared)
+#endif
+  {
+    R *re = (R*) Y(malloc)(2 * (size_t)(size) * sizeof(R)), *im = re + size;
+    INT j0;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (j0 = 0; j0 < M; j0 += NDFT_BLOCK)
+    {
+      const INT nb = MIN(NDFT_BLOCK, M - j0);
+
+      ndft_tables(d, L, k0, x + j0 * d, nb, sign, re, im, 0, L[d - 1]);
+      ndft_trafo_block(d, L, re, im, f_hat, f + j0, nb);
+    }
+
+    Y(free)(re);
+  }
+}
+
+void Y(ndft_adjoint)(const INT d, const INT *L, const INT *k0, const INT M,
+  const R *x, const C *f, C *f_hat, const R sign)
+{
+  const INT size = ndft_table_size(d, L);
+  INT N_total = 1, t;
+
+  for (t = 0; t < d; t++)
+    N_total *= L[t];
+
+  memset(f_hat, 0, (size_t)(N_total) * sizeof(C));
+
+  /* Every thread owns a part of the coefficients and sums all nodes into it,
+   * so that no two threads write to the same coefficient. */
+#ifdef _OPENMP
+  #pragma omp parallel default(shared)
+#endif
+  {
+#ifdef _OPENMP
+    const INT nthreads = omp_get_num_threads(), tid = omp_get_thread_num();
+#else
+    const INT nthreads = 1, tid = 0;
+#endif
+    INT r0, r1, kk0, kk1, j0;
+
+    ndft_partition(d, L, tid, nthreads, &r0, &r1, &kk0, &kk1);
+
+    if (r0 < r1 && kk0 < kk1)
+    {
+      R *re = (R*) Y(malloc)(2 * (size_t)(size) * sizeof(R)), *im = re + size;
+
+      for (j0 = 0; j0 < M; j0 += NDFT_BLOCK)
+      {
+        const INT nb = MIN(NDFT_BLOCK, M - j0);
+
+        ndft_tables(d, L, k0, x + j0 * d, nb, sign, re, im, kk0, kk1);
+        ndft_adjoint_block(d, L, re, im, f + j0, f_hat, nb, r0, r1, kk0, kk1);
+      }
+
+      Y(free)(re);
+    }
+  }
+}
+
+/* Real versions for the cosine and sine transforms. The tables hold
+ * cos(2 pi k x) or sin(2 pi k x), the real or imaginary part of the complex
+ * recurrence. */
+
+static void ndft_row_factors_real(const INT d, const INT *L, const INT *k,
+  const INT t0, const R *e, R *p)
+{
+  INT t, b, off = 0;
+
+  for (t = 0; t < t0; t++)
+    off += L[t] * NDFT_BLOCK;
+
+  for (t = t0; t < d - 1; t++)
+  {
+    const R *w = e + off + k[t] * NDFT_BLOCK;
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+      p[(t + 1) * NDFT_BLOCK + b] = p[t * NDFT_BLOCK + b] * w[b];
+
+    off += L[t] * NDFT_BLOCK;
+  }
+}
+
+static void ndft_trafo_block_real(const INT d, const INT *L, const R *e,
+  const R *f_hat, R *f, const INT nb)
+{
+  const INT last = L[d - 1], rows = ndft_rows(d, L);
+  const R *el = e;
+  R p[d * NDFT_BLOCK], a[NDFT_BLOCK];
+  INT k[d], t, b, r, kk;
+
+  for (t = 0; t < d - 1; t++)
+  {
+    k[t] = 0;
+    el += L[t] * NDFT_BLOCK;
+  }
+
+  for (b = 0; b < NDFT_BLOCK; b++)
+  {
+    p[b] = K(1.0);
+    a[b] = K(0.0);
+  }
+
+  ndft_row_factors_real(d, L, k, 0, e, p);
+
+  for (r = 0; r < rows; r++)
+  {
+    const R *fh = f_hat + r * last, *q = p + (d - 1) * NDFT_BLOCK;
+    R s[NDFT_BLOCK];
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+      s[b] = K(0.0);
+
+    for (kk = 0; kk < last; kk++)
+    {
+      const R *w = el + kk * NDFT_BLOCK;
+
+      for (b = 0; b < NDFT_BLOCK; b++)
+        s[b] += fh[kk] * w[b];
+    }
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+      a[b] += q[b] * s[b];
+
+    if (r + 1 < rows)
+      ndft_row_factors_real(d, L, k, ndft_next_row(d, L, k), e, p);
+  }
+
+  for (b = 0; b < nb; b++)
+    f[b] = a[b];
+}
+
+static void ndft_adjoint_block_real(const INT d, const INT *L, const R *e,
+  const R *f, R *f_hat, const INT nb, const INT r0, const INT r1,
+  const INT kk0, const INT kk1)
+{
+  const INT last = L[d - 1];
+  const R *el = e;
+  R p[d * NDFT_BLOCK], fb[NDFT_BLOCK];
+  INT k[d], t, b, r, kk;
+
+  ndft_row_index(d, L, r0, k);
+
+  for (t = 0; t < d - 1; t++)
+    el += L[t] * NDFT_BLOCK;
+
+  for (b = 0; b < NDFT_BLOCK; b++)
+  {
+    p[b] = K(1.0);
+    fb[b] = b < nb ? f[b] : K(0.0);
+  }
+
+  ndft_row_factors_real(d, L, k, 0, e, p);
+
+  for (r = r0; r < r1; r++)
+  {
+    R *fh = f_hat + r * last;
+    const R *q = p + (d - 1) * NDFT_BLOCK;
+    R g[NDFT_BLOCK];
+
+    for (b = 0; b < NDFT_BLOCK; b++)
+      g[b] = fb[b] * q[b];
+
+    for (kk = kk0; kk < kk1; kk++)
+    {
+      const R *w = el + kk * NDFT_BLOCK;
+      R s = K(0.0);
+
+      for (b = 0; b < NDFT_BLOCK; b++)
+        s += g[b] * w[b];
+
+      fh[kk] += s;
+    }
+
+    if (r + 1 < r1)
+      ndft_row_factors_real(d, L, k, ndft_next_row(d, L, k), e, p);
+  }
+}
+
+void Y(ndft_trafo_real)(const INT d, const INT *L, const INT *k0,
+  const INT M, const R *x, const R *f_hat, R *f, const int basis)
+{
+  const INT size = ndft_table_size(d, L);
+
+#ifdef _OPENMP
+  #pragma omp parallel default(shared)
+#endif
+  {
+    R *c = (R*) Y(malloc)(2 * (size_t)(size) * sizeof(R)), *s = c + size;
+    INT j0;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (j0 = 0; j0 < M; j0 += NDFT_BLOCK)
+    {
+      const INT nb = MIN(NDFT_BLOCK, M - j0);
+
+      ndft_tables(d, L, k0, x + j0 * d, nb, K(1.0), c, s, 0, L[d - 1]);
+      ndft_trafo_block_real(d, L, basis == NDFT_SIN ? s : c, f_hat, f + j0,
+        nb);
+    }
+
+    Y(free)(c);
+  }
+}
+
+void Y(ndft_adjoint_real)(const INT d, const INT *L, const INT *k0,
+  const INT M, const R *x, const R *f, R *f_hat, const int basis)
+{
+  const INT size = ndft_table_size(d, L);
+  INT N_total = 1, t;
+
+  for (t = 0; t < d; t++)
+    N_total *= L[t];
+
+  memset(f_hat, 0, (size_t)(N_total) * sizeof(R));
+
+  /* as in Y(ndft_adjoint) */
+#ifdef _OPENMP
+  #pragma omp parallel default(shared)
+#endif
+  {
+#ifdef _OPENMP
+    const INT nthreads = omp_get_num_threads(), tid = omp_get_thread_num();
+#else
+    const INT nthreads = 1, tid = 0;
+#endif
+    INT r0, r1, kk0, kk1, j0;
+
+    ndft_partition(d, L, tid, nthreads, &r0, &r1, &kk0, &kk1);
+
+    if (r0 < r1 && kk0 < kk1)
+    {
+      R *c = (R*) Y(malloc)(2 * (size_t)(size) * sizeof(R)), *s = c + size;
+
+      for (j0 = 0; j0 < M; j0 += NDFT_BLOCK)
+      {
+        const INT nb = MIN(NDFT_BLOCK, M - j0);
+
+        ndft_tables(d, L, k0, x + j0 * d, nb, K(1.0), c, s, kk0, kk1);
+        ndft_adjoint_block_real(d, L, basis == NDFT_SIN ? s : c, f + j0, f_hat,
+          nb, r0, r1, kk0, kk1);
+      }
+
+      Y(free)(c);
+    }
+  }
+}
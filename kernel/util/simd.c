@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2002, 2017 Jens Keiner, Stefan Kunis, Daniel Potts
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Kernels of the B step, i.e. sums and updates of a contiguous run of
+ * complex coefficients g weighted with real window values psi. On x86 the
+ * SSE2, AVX2 and AVX-512 versions are compiled with target attributes and the
+ * best one supported by the running CPU is selected when the library is
+ * loaded, so the same binary runs everywhere. */
+
+#include "infft.h"
+
+#if defined(HAVE_SIMD_DISPATCH) && !defined(NFFT_LDOUBLE)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+typedef C (*sum_wx_t)(const R *w, const C *x, const INT n);
+typedef void (*upd_xpaw_t)(C *x, const C a, const R *w, const INT n);
+
+static C sum_wx_scalar(const R *w, const C *x, const INT n)
+{
+  C s = K(0.0);
+  INT k;
+
+  for (k = 0; k < n; k++)
+    s += w[k] * x[k];
+
+  return s;
+}
+
+static void upd_xpaw_scalar(C *x, const C a, const R *w, const INT n)
+{
+  INT k;
+
+  for (k = 0; k < n; k++)
+    x[k] += w[k] * a;
+}
+
+#if defined(SIMD_X86) && !defined(NFFT_SINGLE)
+
+/* double precision, one complex number per 128 bit */
+
+__attribute__((target("sse2")))
+static C sum_wx_sse2(const R *w, const C *x, const INT n)
+{
+  const double *xr = (const double*) x;
+  __m128d s = _mm_setzero_pd();
+  C r;
+  INT k;
+
+  for (k = 0; k < n; k++)
+    s = _mm_add_pd(s, _mm_mul_pd(_mm_set1_pd(w[k]), _mm_loadu_pd(xr + 2 * k)));
+
+  _mm_storeu_pd((double*) &r, s);
+  return r;
+}
+
+__attribute__((target("sse2")))
+static void upd_xpaw_sse2(C *x, const C a, const R *w, const INT n)
+{
+  double *xr = (double*) x;
+  const __m128d av = _mm_loadu_pd((const double*) &a);
+  INT k;
+
+  for (k = 0; k < n; k++)
+    _mm_storeu_pd(xr + 2 * k, _mm_add_pd(_mm_loadu_pd(xr + 2 * k),
+      _mm_mul_pd(_mm_set1_pd(w[k]), av)));
+}
+
+__attribute__((target("avx2,fma")))
+static C sum_wx_avx2(const R *w, const C *x, const INT n)
+{
+  const double *xr = (const double*) x;
+  __m256d s4 = _mm256_setzero_pd();
+  __m128d s;
+  C r;
+  INT k;
+
+  for (k = 0; k + 2 <= n; k += 2)
+  {
+    const __m256d wk = _mm256_permute4x64_pd(
+      _mm256_castpd128_pd256(_mm_loadu_pd(w + k)), 0x50);
+    s4 = _mm256_fmadd_pd(wk, _mm256_loadu_pd(xr + 2 * k), s4);
+  }
+
+  s = _mm_add_pd(_mm256_castpd256_pd128(s4), _mm256_extractf128_pd(s4, 1));
+  for (; k < n; k++)
+    s = _mm_fmadd_pd(_mm_set1_pd(w[k]), _mm_loadu_pd(xr + 2 * k), s);
+
+  _mm_storeu_pd((double*) &r, s);
+  return r;
+}
+
+__attribute__((target("avx2,fma")))
+static void upd_xpaw_avx2(C *x, const C a, const R *w, const INT n)
+{
+  double *xr = (double*) x;
+  const __m128d av = _mm_loadu_pd((const double*) &a);
+  const __m256d av4 = _mm256_broadcast_pd(&av);
+  INT k;
+
+  for (k = 0; k + 2 <= n; k += 2)
+  {
+    const __m256d wk = _mm256_permute4x64_pd(
+      _mm256_castpd128_pd256(_mm_loadu_pd(w + k)), 0x50);
+    _mm256_storeu_pd(xr + 2 * k, _mm256_fmadd_pd(wk, av4,
+      _mm256_loadu_pd(xr + 2 * k)));
+  }
+
+  for (; k < n; k++)
+    _mm_storeu_pd(xr + 2 * k, _mm_fmadd_pd(_mm_set1_pd(w[k]), av,
+      _mm_loadu_pd(xr + 2 * k)));
+}
+
+__attribute__((target("avx512f")))
+static C sum_wx_avx512(const R *w, const C *x, const INT n)
+{
+  const double *xr = (const double*) x;
+  const __m512i idx = _mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0);
+  __m512d s8 = _mm512_setzero_pd();
+  __m256d s4;
+  __m128d s;
+  C r;
+  INT k;
+
+  for (k = 0; k + 4 <= n; k += 4)
+  {
+    const __m512d wk = _mm512_permutexvar_pd(idx,
+      _mm512_castpd256_pd512(_mm256_loadu_pd(w + k)));
+    s8 = _mm512_fmadd_pd(wk, _mm512_loadu_pd(xr + 2 * k), s8);
+  }
+
+  s4 = _mm256_add_pd(_mm512_castpd512_pd256(s8), _mm512_extractf64x4_pd(s8, 1));
+  s = _mm_add_pd(_mm256_castpd256_pd128(s4), _mm256_extractf128_pd(s4, 1));
+  for (; k < n; k++)
+    s = _mm_fmadd_pd(_mm_set1_pd(w[k]), _mm_loadu_pd(xr + 2 * k), s);
+
+  _mm_storeu_pd((double*) &r, s);
+  return r;
+}
+
+__attribute__((target("avx512f")))
+static void upd_xpaw_avx512(C *x, const C a, const R *w, const INT n)
+{
+  double *xr = (double*) x;
+  const __m512i idx = _mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0);
+  const __m128d av = _mm_loadu_pd((const double*) &a);
+  const __m512d av8 = _mm512_broadcast_f64x4(_mm256_broadcast_pd(&av));
+  INT k;
+
+  for (k = 0; k + 4 <= n; k += 4)
+  {
+    const __m512d wk = _mm512_permutexvar_pd(idx,
+      _mm512_castpd256_pd512(_mm256_loadu_pd(w + k)));
+    _mm512_storeu_pd(xr + 2 * k, _mm512_fmadd_pd(wk, av8,
+      _mm512_loadu_pd(xr + 2 * k)));
+  }
+
+  for (; k < n; k++)
+    _mm_storeu_pd(xr + 2 * k, _mm_fmadd_pd(_mm_set1_pd(w[k]), av,
+      _mm_loadu_pd(xr + 2 * k)));
+}
+
+#elif defined(SIMD_X86)
+
+/* single precision, two complex numbers per 128 bit */
+
+__attribute__((target("sse2")))
+static inline __m128 dup2_sse2(const float *w)
+{
+  const __m128 wk = _mm_castpd_ps(_mm_load_sd((const double*) w));
+  return _mm_unpacklo_ps(wk, wk);
+}
+
+__attribute__((target("sse2")))
+static C sum_wx_sse2(const R *w, const C *x, const INT n)
+{
+  const float *xr = (const float*) x;
+  __m128 s = _mm_setzero_ps();
+  C r;
+  INT k;
+
+  for (k = 0; k + 2 <= n; k += 2)
+    s = _mm_add_ps(s, _mm_mul_ps(dup2_sse2(w + k), _mm_loadu_ps(xr + 2 * k)));
+
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  _mm_storel_pi((__m64*) &r, s);
+  for (; k < n; k++)
+    r += w[k] * x[k];
+
+  return r;
+}
+
+__attribute__((target("sse2")))
+static void upd_xpaw_sse2(C *x, const C a, const R *w, const INT n)
+{
+  float *xr = (float*) x;
+  const __m128 av = _mm_set_ps(CIMAG(a), CREAL(a), CIMAG(a), CREAL(a));
+  INT k;
+
+  for (k = 0; k + 2 <= n; k += 2)
+    _mm_storeu_ps(xr + 2 * k, _mm_add_ps(_mm_loadu_ps(xr + 2 * k),
+      _mm_mul_ps(dup2_sse2(w + k), av)));
+
+  for (; k < n; k++)
+    x[k] += w[k] * a;
+}
+
+__attribute__((target("avx2,fma")))
+static C sum_wx_avx2(const R *w, const C *x, const INT n)
+{
+  const float *xr = (const float*) x;
+  const __m256i idx = _mm256_set_epi32(3, 3, 2, 2, 1, 1, 0, 0);
+  __m256 s8 = _mm256_setzero_ps();
+  __m128 s;
+  C r;
+  INT k;
+
+  for (k = 0; k + 4 <= n; k += 4)
+  {
+    const __m256 wk = _mm256_permutevar8x32_ps(
+      _mm256_castps128_ps256(_mm_loadu_ps(w + k)), idx);
+    s8 = _mm256_fmadd_ps(wk, _mm256_loadu_ps(xr + 2 * k), s8);
+  }
+
+  s = _mm_add_ps(_mm256_castps256_ps128(s8), _mm256_extractf128_ps(s8, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  _mm_storel_pi((__m64*) &r, s);
+  for (; k < n; k++)
+    r += w[k] * x[k];
+
+  return r;
+}
+
+__attribute__((target("avx2,fma")))
+static void upd_xpaw_avx2(C *x, const C a, const R *w, const INT n)
+{
+  float *xr = (float*) x;
+  const __m256i idx = _mm256_set_epi32(3, 3, 2, 2, 1, 1, 0, 0);
+  const __m256 av = _mm256_set_ps(CIMAG(a), CREAL(a), CIMAG(a), CREAL(a),
+    CIMAG(a), CREAL(a), CIMAG(a), CREAL(a));
+  INT k;
+
+  for (k = 0; k + 4 <= n; k += 4)
+  {
+    const __m256 wk = _mm256_permutevar8x32_ps(
+      _mm256_castps128_ps256(_mm_loadu_ps(w + k)), idx);
+    _mm256_storeu_ps(xr + 2 * k, _mm256_fmadd_ps(wk, av,
+      _mm256_loadu_ps(xr + 2 * k)));
+  }
+
+  for (; k < n; k++)
+    x[k] += w[k] * a;
+}
+
+__attribute__((target("avx512f")))
+static C sum_wx_avx512(const R *w, const C *x, const INT n)
+{
+  const float *xr = (const float*) x;
+  const __m512i idx = _mm512_set_epi32(7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2,
+    1, 1, 0, 0);
+  __m512 s16 = _mm512_setzero_ps();
+  __m256 s8;
+  __m128 s;
+  C r;
+  INT k;
+
+  for (k = 0; k + 8 <= n; k += 8)
+  {
+    const __m512 wk = _mm512_permutexvar_ps(idx,
+      _mm512_castps256_ps512(_mm256_loadu_ps(w + k)));
+    s16 = _mm512_fmadd_ps(wk, _mm512_loadu_ps(xr + 2 * k), s16);
+  }
+
+  s8 = _mm256_add_ps(_mm512_castps512_ps256(s16), _mm256_castpd_ps(
+    _mm512_extractf64x4_pd(_mm512_castps_pd(s16), 1)));
+  s = _mm_add_ps(_mm256_castps256_ps128(s8), _mm256_extractf128_ps(s8, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  _mm_storel_pi((__m64*) &r, s);
+  for (; k < n; k++)
+    r += w[k] * x[k];
+
+  return r;
+}
+
+__attribute__((target("avx512f")))
+static void upd_xpaw_avx512(C *x, const C a, const R *w, const INT n)
+{
+  float *xr = (float*) x;
+  const __m512i idx = _mm512_set_epi32(7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2,
+    1, 1, 0, 0);
+  const __m512 av = _mm512_broadcast_f32x4(_mm_set_ps(CIMAG(a), CREAL(a),
+    CIMAG(a), CREAL(a)));
+  INT k;
+
+  for (k = 0; k + 8 <= n; k += 8)
+  {
+    const __m512 wk = _mm512_permutexvar_ps(idx,
+      _mm512_castps256_ps512(_mm256_loadu_ps(w + k)));
+    _mm512_storeu_ps(xr + 2 * k, _mm512_fmadd_ps(wk, av,
+      _mm512_loadu_ps(xr + 2 * k)));
+  }
+
+  for (; k < n; k++)
+    x[k] += w[k] * a;
+}
+
+#endif
+
+/* The scalar kernels are valid before and without dispatch. */
+static sum_wx_t sum_wx_ = sum_wx_scalar;
+static upd_xpaw_t upd_xpaw_ = upd_xpaw_scalar;
+static int simd_level_ = SIMD_NONE;
+
+/** Returns the highest SIMD_* level supported by the running CPU. */
+static int simd_detect(void)
+{
+#if defined(SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return SIMD_AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return SIMD_AVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return SIMD_SSE2;
+#endif
+  return SIMD_NONE;
+}
+
+/**
+ * Selects the B step kernels for at most the given SIMD_* level and returns
+ * the level actually used, which is limited by the CPU and the build. Must not
+ * be called while a transform runs.
+ */
+int Y(simd_set_level)(const int level)
+{
+  const int l = MIN(level, simd_detect());
+
+  switch (l)
+  {
+#if defined(SIMD_X86)
+    case SIMD_AVX512:
+      sum_wx_ = sum_wx_avx512;
+      upd_xpaw_ = upd_xpaw_avx512;
+      break;
+    case SIMD_AVX2:
+      sum_wx_ = sum_wx_avx2;
+      upd_xpaw_ = upd_xpaw_avx2;
+      break;
+    case SIMD_SSE2:
+      sum_wx_ = sum_wx_sse2;
+      upd_xpaw_ = upd_xpaw_sse2;
+      break;
+#endif
+    default:
+      sum_wx_ = sum_wx_scalar;
+      upd_xpaw_ = upd_xpaw_scalar;
+      break;
+  }
+
+  simd_level_ = l;
+  return simd_level_;
+}
+
+#if defined(SIMD_X86)
+/* Selects the kernels once while the library is loaded, before any transform
+ * can run, so that the calls below need no synchronization. */
+__attribute__((constructor))
+static void simd_init(void)
+{
+  Y(simd_set_level)(SIMD_AVX512);
+}
+#endif
+
+/** Returns the SIMD_* level of the B step kernels. */
+int Y(simd_level)(void)
+{
+  return simd_level_;
+}
+
+/** Computes \f$\sum_k w_k x_k\f$ for real w and complex x. */
+C Y(sum_wx_complex)(const R *w, const C *x, const INT n)
+{
+  return sum_wx_(w, x, n);
+}
+
+/** Updates \f$x \leftarrow x + a w\f$ for real w and complex x and a. */
+void Y(upd_xpaw_complex)(C *x, const C a, const R *w, const INT n)
+{
+  upd_xpaw_(x, a, w, n);
+}
@@ -83,15 +83,24 @@ static inline void sort_node_indices_radix_rearrange(INT n, INT *keys_in, INT *k
 #define rwidth 9
 #define radix_n (1 << rwidth)
 
+/** smallest number of keys for which the lsdf passes run in parallel */
+#define radix_omp_min (1 << 12)
+
 /**
  * Radix sort for node indices with OpenMP support.
  *
+ * All passes run in one parallel region. Every thread counts the digits of
+ * its contiguous part of the keys into a private histogram and scatters this
+ * part to the offsets given by the prefix sum over all histograms, which keeps
+ * the sort stable. Passes in which all keys share the same digit are skipped.
+ * keys1 is a workspace of 2n INT, the result is returned in keys0.
+ *
  * \author Michael Hofmann
  */
 void Y(sort_node_indices_radix_lsdf)(INT n, INT *keys0, INT *keys1, INT rhigh)
 {
   const INT radix_mask = radix_n - 1;
-  const INT rhigh_in = rhigh;
+  const INT npass = (rhigh >= 0) ? rhigh / rwidth + 1 : 0;
 
   const INT tmax =
 #ifdef _OPENMP
@@ -100,69 +109,71 @@ void Y(sort_node_indices_radix_lsdf)(INT n, INT *keys0, INT *keys1, INT rhigh)
     1;
 #endif
 
-  INT *from, *to, *tmp;
-
-  INT i, k, l, h;
+  INT *from = keys0, *to = keys1;
   INT *lcounts;
-
-  INT tid = 0, tnum = 1;
+  int trivial = 0;
 
   STACK_MALLOC(INT*, lcounts, (size_t)(tmax * radix_n) * sizeof(INT));
 
-  from = keys0;
-  to = keys1;
-
-  while (rhigh >= 0)
-  {
 #ifdef _OPENMP
-    #pragma omp parallel private(tid, tnum, i, l, h)
-    {
-      tid = omp_get_thread_num();
-      tnum = omp_get_num_threads();
+  #pragma omp parallel default(shared) if(n >= radix_omp_min)
 #endif
+  {
+    INT tid = 0, tnum = 1, i, l, h, pass;
 
-      for (i = 0; i < radix_n; ++i) lcounts[tid * radix_n + i] = 0;
-
-      l = (tid * n) / tnum;
-      h = ((tid + 1) * n) / tnum;
-
-      sort_node_indices_radix_count(h - l, from + (2 * l), rhigh_in - rhigh, radix_mask, &lcounts[tid * radix_n]);
 #ifdef _OPENMP
-    }
+    tid = omp_get_thread_num();
+    tnum = omp_get_num_threads();
 #endif
 
-    k = 0;
-    for (i = 0; i < radix_n; ++i)
-    {
-      for (l = 0; l < tmax; ++l) lcounts[l * radix_n + i] = (k += lcounts[l * radix_n + i]) - lcounts[l * radix_n + i];
-    }
+    l = (tid * n) / tnum;
+    h = ((tid + 1) * n) / tnum;
 
-#ifdef _OPENMP
-    #pragma omp parallel private(tid, tnum, i, l, h)
+    for (pass = 0; pass < npass; ++pass)
     {
-      tid = omp_get_thread_num();
-      tnum = omp_get_num_threads();
-#endif
+      for (i = 0; i < radix_n; ++i) lcounts[tid * radix_n + i] = 0;
 
-      l = (tid * n) / tnum;
-      h = ((tid + 1) * n) / tnum;
+      sort_node_indices_radix_count(h - l, from + (2 * l), pass * rwidth, radix_mask, &lcounts[tid * radix_n]);
 
-      sort_node_indices_radix_rearrange(h - l, from + (2 * l), to, rhigh_in - rhigh, radix_mask, &lcounts[tid * radix_n]);
 #ifdef _OPENMP
-    }
+      #pragma omp barrier
+      #pragma omp single
 #endif
+      {
+        INT k = 0, j, c;
+
+        trivial = 0;
+        for (i = 0; i < radix_n; ++i)
+        {
+          for (j = 0; j < tnum; ++j)
+          {
+            c = lcounts[j * radix_n + i];
+            lcounts[j * radix_n + i] = k;
+            k += c;
+          }
+          if (k == n && lcounts[i] == 0) trivial = 1;
+        }
+      }
 
-/*    print_keys(n, to);*/
+      if (!trivial)
+        sort_node_indices_radix_rearrange(h - l, from + (2 * l), to, pass * rwidth, radix_mask, &lcounts[tid * radix_n]);
 
-    tmp = from;
-    from = to;
-    to = tmp;
+#ifdef _OPENMP
+      #pragma omp barrier
+      #pragma omp single
+#endif
+      if (!trivial)
+      {
+        INT *tmp = from;
+        from = to;
+        to = tmp;
+      }
+    }
 
-    rhigh -= rwidth;
+    if (from != keys0)
+      memcpy(keys0 + 2 * l, from + 2 * l, (size_t)(h - l) * 2 * sizeof(INT));
   }
 
-  if (to == keys0) memcpy(to, from, (size_t)(n) * 2 * sizeof(INT));
-
   STACK_FREE(lcounts);
 }
 
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2002, 2017 Jens Keiner, Stefan Kunis, Daniel Potts
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Statistics of the transforms. The phases are timed by the macros TIC and
+ * TOC of infft.h, which cost two branches while the statistics of a plan are
+ * disabled. The OpenMP loops of the B and D steps time the share of every
+ * thread with STATS_THREAD_BEGIN and STATS_THREAD_END, and TOC turns these
+ * times into the largest and the mean busy time of the run. */
+
+#include "api.h"
+
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+void Y(stats_enable)(nfft_stats *s, int on)
+{
+  s->enabled = on != 0;
+}
+
+void Y(stats_reset)(nfft_stats *s)
+{
+  const int enabled = s->enabled;
+
+  memset(s, 0, sizeof(nfft_stats));
+  s->enabled = enabled;
+}
+
+double Y(stats_imbalance)(const nfft_stats *s, int phase)
+{
+  if (phase < 0 || phase >= NFFT_STATS_PHASES || s->busy_mean[phase] <= 0.0)
+    return 0.0;
+
+  return s->busy_max[phase] / s->busy_mean[phase];
+}
+
+double Y(stats_nodes_per_second)(const nfft_stats *s)
+{
+  const double t = s->time[NFFT_STATS_D] + s->time[NFFT_STATS_FFT]
+    + s->time[NFFT_STATS_B];
+
+  return t > 0.0 ? s->nodes / t : 0.0;
+}
+
+double Y(stats_seconds)(void)
+{
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+  struct timespec tp;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &tp) != 0)
+    return 0.0;
+
+  return (double)tp.tv_sec + (double)tp.tv_nsec * 1e-9;
+#else
+  return (double)Y(clock_gettime_seconds)();
+#endif
+}
+
+void Y(stats_add)(struct nfft_stats_s *s, const int phase,
+  const double seconds)
+{
+  const int n = s->busy_threads[phase];
+
+  s->calls[phase]++;
+  s->time[phase] += seconds;
+
+  if (n > 0)
+  {
+    double busy_max = 0.0, busy_sum = 0.0;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+      busy_max = MAX(busy_max, s->busy[phase][i]);
+      busy_sum += s->busy[phase][i];
+    }
+
+    s->busy_max[phase] += busy_max;
+    s->busy_mean[phase] += busy_sum / (double)n;
+
+    memset(s->busy[phase], 0, sizeof(s->busy[phase]));
+    s->busy_threads[phase] = 0;
+  }
+}
+
+void Y(stats_thread_add)(struct nfft_stats_s *s, const int phase,
+  const double seconds)
+{
+#ifdef _OPENMP
+  const int t = omp_get_thread_num();
+  const int n = MIN(omp_get_num_threads(), NFFT_STATS_THREADS);
+
+  #pragma omp atomic
+  s->busy[phase][t % NFFT_STATS_THREADS] += seconds;
+
+  if (t == 0)
+    s->busy_threads[phase] = MAX(s->busy_threads[phase], n);
+#else
+  UNUSED(s);
+  UNUSED(phase);
+  UNUSED(seconds);
+#endif
+}
@@ -57,3 +57,23 @@ INT Y(has_threads_enabled)(void)
 #endif
 }
 
+void Y(zero_omp)(void *p, const INT n, const size_t size)
+{
+#ifdef _OPENMP
+  /* The blocks of thread id are those of a static schedule of 0..n-1, i.e. of
+   * "#pragma omp for schedule(static)" and of the blockwise adjoint. */
+  #pragma omp parallel default(shared)
+  {
+    const INT nthreads = (INT)omp_get_num_threads();
+    const INT id = (INT)omp_get_thread_num();
+    const INT q = n / nthreads, r = n % nthreads;
+    const INT i0 = id * q + MIN(id, r);
+    const INT len = q + (id < r ? 1 : 0);
+
+    if (len > 0)
+      memset((char*)p + (size_t)(i0) * size, 0, (size_t)(len) * size);
+  }
+#else
+  memset(p, 0, (size_t)(n) * size);
+#endif
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2002, 2017 Jens Keiner, Stefan Kunis, Daniel Potts
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Tracing of the transforms. The macros TRACE_BEGIN and TRACE_END of infft.h
+ * test Y(trace_hook) and call Y(trace_emit) only if a hook is installed. The
+ * Chrome trace writer below is a reference consumer of the events. */
+
+#include <stdio.h>
+
+#include "api.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+Y(trace_type_function) Y(trace_hook) = 0;
+void *Y(trace_data) = 0;
+
+static const char *trace_phase_names[NFFT_STATS_PHASES] = {"D", "FFT", "B",
+  "precompute", "sort", "transform", "fpt", "solver"};
+
+const char *Y(trace_phase_name)(int phase)
+{
+  if (phase < 0 || phase >= NFFT_STATS_PHASES)
+    return "unknown";
+
+  return trace_phase_names[phase];
+}
+
+void Y(trace_emit)(const int begin, const int phase, const void *plan,
+  const double size0, const double size1)
+{
+  /* TRACE_BEGIN tested the hook; it is only replaced while no transform runs,
+   * see nfft3.h */
+  const Y(trace_type_function) hook = Y(trace_hook);
+  nfft_trace_event e;
+
+  if (hook == 0)
+    return;
+
+  e.begin = begin;
+  e.phase = phase;
+  e.plan = plan;
+#ifdef _OPENMP
+  e.thread = omp_get_thread_num();
+#else
+  e.thread = 0;
+#endif
+  e.time = Y(stats_seconds)();
+  e.size0 = size0;
+  e.size1 = size1;
+
+  hook(&e, Y(trace_data));
+}
+
+/** Chrome trace event format: a JSON object whose array traceEvents holds one
+ *  duration event "B" or "E" per begin and end, with times in microseconds. */
+typedef struct
+{
+  FILE *file;
+  double t0; /**< time of X(trace_chrome_open) */
+  int events; /**< events written so far */
+} chrome_trace;
+
+static chrome_trace chrome = {NULL, 0.0, 0};
+
+static void chrome_hook(const nfft_trace_event *e, void *data)
+{
+  chrome_trace *c = (chrome_trace*)data;
+
+#ifdef _OPENMP
+  #pragma omp critical (nfft_omp_critical_trace)
+#endif
+  if (c->file != NULL)
+  {
+    fprintf(c->file, "%s\n{\"name\":\"%s\",\"cat\":\"nfft\",\"ph\":\"%s\","
+      "\"ts\":%.3f,\"pid\":0,\"tid\":%d,\"args\":{\"plan\":\"%p\","
+      "\"size0\":%.0f,\"size1\":%.0f}}", c->events > 0 ? "," : "",
+      Y(trace_phase_name)(e->phase), e->begin ? "B" : "E",
+      (e->time - c->t0) * 1e6, e->thread, (void*)e->plan, e->size0, e->size1);
+    c->events++;
+  }
+}
+
+int Y(trace_chrome_open)(const char *filename)
+{
+  FILE *f;
+
+  Y(trace_chrome_close)();
+
+  f = fopen(filename, "w");
+  if (f == NULL)
+    return 0;
+
+  fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+  chrome.file = f;
+  chrome.t0 = Y(stats_seconds)();
+  chrome.events = 0;
+  Y(trace_data) = &chrome;
+  Y(trace_hook) = chrome_hook;
+
+  return 1;
+}
+
+void Y(trace_chrome_close)(void)
+{
+  /* the same critical section as the hook, so that no event is written
+   * while the file is completed */
+#ifdef _OPENMP
+  #pragma omp critical (nfft_omp_critical_trace)
+#endif
+  if (chrome.file != NULL)
+  {
+    if (Y(trace_hook) == chrome_hook)
+    {
+      Y(trace_hook) = 0;
+      Y(trace_data) = 0;
+    }
+
+    fprintf(chrome.file, "\n]}\n");
+    fclose(chrome.file);
+    chrome.file = NULL;
+  }
+}
@@ -18,28 +18,438 @@
 
 #include "api.h"
 
-#if defined(DIRAC_DELTA)
-  static const INT m2K_[] = {0};
-#elif defined(GAUSSIAN)
-  static const INT m2K_[] = {0, 1, 3, 6, 7, 9, 11, 13, 15, 17, 19, 21, 22, 23, 24};
-#elif defined(B_SPLINE)
-  static const INT m2K_[] = {0, 0, 4, 7, 10, 13, 15, 17, 19, 22, 24};
-#elif defined(SINC_POWER)
-  static const INT m2K_[] = {0, 0, 2, 5, 8, 11, 12, 14, 16, 18, 21, 23, 24, 24};
-#else /* Kaiser-Bessel is the default. */
-  static const INT m2K_[] = {1, 3, 7, 9, 14, 17, 20, 23, 24};
+static const INT m2K_dirac_delta_[] = {0};
+static const INT m2K_gaussian_[] = {0, 1, 3, 6, 7, 9, 11, 13, 15, 17, 19, 21, 22, 23, 24};
+static const INT m2K_b_spline_[] = {0, 0, 4, 7, 10, 13, 15, 17, 19, 22, 24};
+static const INT m2K_sinc_power_[] = {0, 0, 2, 5, 8, 11, 12, 14, 16, 18, 21, 23, 24, 24};
+static const INT m2K_kaiser_bessel_[] = {1, 3, 7, 9, 14, 17, 20, 23, 24};
+
+/* Default cut-off parameters m, indexed by NFFT_WINDOW_*. */
+#if defined(NFFT_LDOUBLE)
+  static const INT window_m_[] = {WINDOW_HELP_ESTIMATE_m, 9, 17, 11, 13, 0, 9};
+#elif defined(NFFT_SINGLE)
+  static const INT window_m_[] = {WINDOW_HELP_ESTIMATE_m, 4, 5, 11, 11, 0, 4};
+#else
+  static const INT window_m_[] = {WINDOW_HELP_ESTIMATE_m, 8, 13, 11, 11, 0, 8};
 #endif
 
+static const char *window_name_[] = {STRINGIZE(WINDOW_NAME), "kaiserbessel",
+  "gaussian", "bspline", "sinc", "delta", "expsemicircle"};
+
+#define WINDOW_COUNT (sizeof(window_m_) / sizeof(window_m_[0]))
+
+/** largest cut-off chosen by Y(window_m) */
+#define WINDOW_MAX_m 32
+
+/**
+ * Maps NFFT_WINDOW_DEFAULT to the window function selected at configure time.
+ */
+unsigned Y(window_resolve)(const unsigned window)
+{
+  if (window == NFFT_WINDOW_DEFAULT)
+    return WINDOW_DEFAULT;
+  if (window >= WINDOW_COUNT)
+    Y(die)("nfft: unknown window function.\n");
+  return window;
+}
+
 /**
  * Returns an appropriate value of the parameter K used with the PRE_LIN_PSI
  * flag for a given value of the cut-off parameter m.
  */
-INT Y(m2K)(const INT m)
+INT Y(m2K)(const unsigned window, const INT m)
 {
-  int j = MIN(((int)(m)), ((int)((sizeof(m2K_) / sizeof(m2K_[0])) - 1)));
+  const INT *m2K_;
+  size_t size;
+  int j;
+
+#define WINDOW_M2K(table) {m2K_ = table; size = sizeof(table) / sizeof(table[0]);}
+  switch (Y(window_resolve)(window))
+  {
+    case NFFT_WINDOW_DIRAC_DELTA: WINDOW_M2K(m2K_dirac_delta_); break;
+    case NFFT_WINDOW_GAUSSIAN: WINDOW_M2K(m2K_gaussian_); break;
+    case NFFT_WINDOW_B_SPLINE: WINDOW_M2K(m2K_b_spline_); break;
+    case NFFT_WINDOW_SINC_POWER: WINDOW_M2K(m2K_sinc_power_); break;
+    case NFFT_WINDOW_EXP_SEMICIRCLE: WINDOW_M2K(m2K_kaiser_bessel_); break;
+    default: WINDOW_M2K(m2K_kaiser_bessel_); break;
+  }
+#undef WINDOW_M2K
+
+  j = MIN(((int)(m)), ((int)(size - 1)));
   return (INT)((1U << m2K_[j]) * (m + 2));
 }
 
+/**
+ * Returns the shape parameter b of the window function for cut-off m and
+ * oversampling factor sigma. Windows without shape parameter return zero.
+ */
+R Y(window_b)(const unsigned window, const INT m, const R sigma)
+{
+  switch (Y(window_resolve)(window))
+  {
+    case NFFT_WINDOW_GAUSSIAN:
+      return (K(2.0) * sigma) / (K(2.0) * sigma - K(1.0)) * (((R)m) / KPI);
+    case NFFT_WINDOW_KAISER_BESSEL:
+      return KPI * (K(2.0) - K(1.0) / sigma);
+    case NFFT_WINDOW_EXP_SEMICIRCLE:
+      return KPI * (K(2.0) - K(1.0) / sigma) * (R)m;
+    default:
+      return K(0.0);
+  }
+}
+
+/**
+ * Returns an estimate of the relative error of the NFFT, measured in the
+ * l_infty norm relative to the l_1 norm of the coefficients, for the window
+ * function with cut-off m and oversampling factor sigma.
+ */
+R Y(window_error)(const unsigned window, const INT m, const R sigma)
+{
+  const R mm = (R)(m);
+
+  switch (Y(window_resolve)(window))
+  {
+    case NFFT_WINDOW_GAUSSIAN:
+      return K(4.0) * EXP(-mm * KPI * (K(1.0) - K(1.0) / (K(2.0) * sigma
+        - K(1.0))));
+    case NFFT_WINDOW_B_SPLINE:
+      return K(4.0) * POW(K(1.0) / (K(2.0) * sigma - K(1.0)), K(2.0) * mm);
+    case NFFT_WINDOW_SINC_POWER:
+      if (m < 2)
+        return K(1.0);
+      return (K(1.0) / (mm - K(1.0))) * ((K(2.0) / POW(sigma, K(2.0) * mm))
+        + POW(sigma / (K(2.0) * sigma - K(1.0)), K(2.0) * mm));
+    case NFFT_WINDOW_DIRAC_DELTA:
+      return K(1.0);
+    default:
+      return K(4.0) * KPI * (SQRT(mm) + mm) * SQRT(SQRT(K(1.0) - K(1.0)
+        / sigma)) * EXP(-K(2.0) * KPI * mm * SQRT(K(1.0) - K(1.0) / sigma));
+  }
+}
+
+/**
+ * Returns the ratio of the Fourier transformed window at the centre and at
+ * the edge of the frequency band, by which the deconvolution amplifies
+ * rounding errors.
+ */
+R Y(window_amplification)(const unsigned window, const INT m, const R sigma)
+{
+  const INT n = 1000;
+  const R b = Y(window_b)(window, m, sigma);
+
+  return Y(window_phi_hut)(window, n, K(0.0), m, b, sigma)
+    / Y(window_phi_hut)(window, n, (R)(n) / (K(2.0) * sigma), m, b, sigma);
+}
+
+/**
+ * Returns the smallest cut-off m up to WINDOW_MAX_m for which the error
+ * estimate Y(window_error), plus the rounding errors amplified by the
+ * deconvolution, does not exceed eps at oversampling factor sigma. The latter
+ * grow with m and matter for sigma well below 2; if eps cannot be reached,
+ * the m with the smallest sum is returned. If eps is not positive, it is
+ * replaced by the error estimate of the default cut-off at sigma = 2.
+ */
+INT Y(window_m)(const unsigned window, const R sigma, R eps)
+{
+  const R eps_float = Y(float_property)(NFFT_EPSILON);
+  R err_min = K(0.0);
+  INT m, m_min = 1;
+
+  if (eps <= K(0.0))
+    eps = Y(window_error)(window, window_m_[Y(window_resolve)(window)],
+      K(2.0));
+
+  for (m = 1; m <= WINDOW_MAX_m; m++)
+  {
+    const R err = Y(window_error)(window, m, sigma) + eps_float
+      * Y(window_amplification)(window, m, sigma);
+
+    if (err <= eps)
+      return m;
+
+    if (m == 1 || err < err_min)
+    {
+      err_min = err;
+      m_min = m;
+    }
+  }
+
+  return m_min;
+}
+
+/* Window functions in time/spatial domain. */
+
+static inline R phi_kaiser_bessel(const INT n, const R x, const INT m, const R b)
+{
+  const R mm = (R)(m), xn = x * (R)(n);
+  const R r = mm * mm - xn * xn;
+
+  if (r > K(0.0))
+    return SINH(b * SQRT(r)) / (KPI * SQRT(r));
+  else if (r < K(0.0))
+    return SIN(b * SQRT(-r)) / (KPI * SQRT(-r));
+  else
+    return b / KPI;
+}
+
+static inline R phi_gaussian(const INT n, const R x, const R b)
+{
+  return (R)EXP(-POW(x * ((R)n), K(2.0)) / b) / SQRT(KPI * b);
+}
+
+static inline R phi_b_spline(const INT n, const R x, const INT m)
+{
+  return Y(bsplines)(2 * m, (x * (R)n) + (R)m) / (R)n;
+}
+
+static inline R phi_sinc_power(const INT n, const R x, const INT m, const R sigma)
+{
+  const R c = (R)n / sigma * (K(2.0) * sigma - K(1.0)) / (K(2.0) * (R)m);
+  return (R)(c * POW(Y(sinc)(KPI * x * c), (R)(2 * m)) / (R)n);
+}
+
+static inline R phi_dirac_delta(const R x)
+{
+  return IF(FABS(x) < K(10E-8), K(1.0), K(0.0));
+}
+
+/* The exponential of semicircle window exp(b(sqrt(1-(z/m)^2)-1)), z = xn, is
+ * not evaluated directly in the B step. Its support [-m,m] is split into the
+ * 2m unit intervals [m-1-j,m-j], j = 0,...,2m-1, and on each of them the
+ * window is replaced by a polynomial of degree ES_DEGREE(m) in
+ * s = 1-2(m-z-j) in [-1,1]. The coefficient of s^p on interval j is stored
+ * in coeffs[p*2m+j], so the 2m+2 values of one row share the same s and are
+ * computed by a single vectorisable Horner scheme. */
+#define ES_DEGREE(m) ((m) + 4)
+
+static inline R phi_exp_semicircle(const R z, const INT m, const R b)
+{
+  const R u = z / (R)(m);
+
+  if (FABS(u) > K(1.0))
+    return K(0.0);
+  return EXP(b * (SQRT(K(1.0) - u * u) - K(1.0)));
+}
+
+static inline R phi_exp_semicircle_horner(const R z, const INT m,
+  const R *coeffs)
+{
+  const INT n_int = 2 * m, deg = ES_DEGREE(m);
+  const R y = (R)(m) - z;
+  R s, acc;
+  INT j, p;
+
+  if (y < K(0.0) || y > (R)(n_int))
+    return K(0.0);
+
+  j = MIN((INT)(FLOOR(y)), n_int - 1);
+  s = K(1.0) - K(2.0) * (y - (R)(j));
+  acc = coeffs[deg * n_int + j];
+  for (p = deg - 1; p >= 0; p--)
+    acc = acc * s + coeffs[p * n_int + j];
+  return acc;
+}
+
+/**
+ * Returns the number of piecewise polynomial coefficients per dimension that
+ * the window function needs, zero for windows evaluated directly.
+ */
+INT Y(window_coeffs_size)(const unsigned window, const INT m)
+{
+  if (Y(window_resolve)(window) != NFFT_WINDOW_EXP_SEMICIRCLE)
+    return 0;
+  return 2 * m * (ES_DEGREE(m) + 1);
+}
+
+/**
+ * Computes the piecewise polynomial coefficients of the window function for
+ * cut-off m and shape parameter b by Chebyshev interpolation on each interval.
+ */
+void Y(window_coeffs_init)(const unsigned window, const INT m, const R b,
+  R *coeffs)
+{
+  const INT n_int = 2 * m, np = ES_DEGREE(m) + 1;
+  R *f, *a, *t0, *t1, *t2, *t;
+  INT i, j, k, p;
+
+  if (Y(window_coeffs_size)(window, m) == 0)
+    return;
+
+  f = (R*) Y(malloc)((size_t)(5 * np) * sizeof(R));
+  a = f + np;
+
+  for (j = 0; j < n_int; j++)
+  {
+    R *c = coeffs + j;
+
+    /* Chebyshev coefficients of the window on [m-1-j,m-j]. */
+    for (i = 0; i < np; i++)
+      f[i] = phi_exp_semicircle((R)(m - j) - K(0.5)
+        + COS(KPI * ((R)(i) + K(0.5)) / (R)(np)) / K(2.0), m, b);
+
+    for (k = 0; k < np; k++)
+    {
+      R acc = K(0.0);
+      for (i = 0; i < np; i++)
+        acc += f[i] * COS(KPI * (R)(k) * ((R)(i) + K(0.5)) / (R)(np));
+      a[k] = K(2.0) * acc / (R)(np);
+    }
+    a[0] /= K(2.0);
+
+    /* Convert to monomials using T_{k+1}(s) = 2sT_k(s) - T_{k-1}(s). */
+    t0 = a + np; t1 = t0 + np; t2 = t1 + np;
+    for (p = 0; p < np; p++)
+    {
+      t0[p] = K(0.0);
+      t1[p] = K(0.0);
+      c[p * n_int] = K(0.0);
+    }
+    t0[0] = K(1.0);
+    c[0] = a[0];
+    if (np > 1)
+    {
+      t1[1] = K(1.0);
+      c[n_int] += a[1];
+    }
+    for (k = 2; k < np; k++)
+    {
+      for (p = 0; p < np; p++)
+      {
+        t2[p] = ((p > 0) ? K(2.0) * t1[p - 1] : K(0.0)) - t0[p];
+        c[p * n_int] += a[k] * t2[p];
+      }
+      t = t0; t0 = t1; t1 = t2; t2 = t;
+    }
+  }
+
+  Y(free)(f);
+}
+
+R Y(window_phi)(const unsigned window, const INT n, const R x, const INT m,
+  const R b, const R sigma, const R *coeffs)
+{
+  switch (window)
+  {
+    case NFFT_WINDOW_EXP_SEMICIRCLE:
+      return (coeffs == NULL) ? phi_exp_semicircle(x * (R)(n), m, b)
+        : phi_exp_semicircle_horner(x * (R)(n), m, coeffs);
+    case NFFT_WINDOW_GAUSSIAN: return phi_gaussian(n, x, b);
+    case NFFT_WINDOW_B_SPLINE: return phi_b_spline(n, x, m);
+    case NFFT_WINDOW_SINC_POWER: return phi_sinc_power(n, x, m, sigma);
+    case NFFT_WINDOW_DIRAC_DELTA: return phi_dirac_delta(x);
+    default: return phi_kaiser_bessel(n, x, m, b);
+  }
+}
+
+/**
+ * Evaluates the window at the 2m+2 points x - (u+l)/n, l = 0,...,2m+1, that
+ * one node contributes to. The window is dispatched once per row so that the
+ * inner loops are free of branches on the window type.
+ */
+void Y(window_phi_row)(const unsigned window, const INT n, const R x,
+  const INT u, const INT m, const R b, const R sigma, const R *coeffs, R *psi)
+{
+  const INT m2p2 = 2 * m + 2;
+  INT l;
+
+  if (window == NFFT_WINDOW_EXP_SEMICIRCLE && coeffs != NULL)
+  {
+    /* psi[l] lies in interval j0+l at the common local coordinate s. */
+    const INT n_int = 2 * m, deg = ES_DEGREE(m);
+    const R y0 = (R)(m) - (x * (R)(n) - (R)(u));
+    const INT j0 = (INT)(FLOOR(y0));
+    const R s = K(1.0) - K(2.0) * (y0 - (R)(j0));
+    const INT lo = MAX(0, -j0), hi = MIN(m2p2, n_int - j0);
+    INT p;
+
+    for (l = 0; l < m2p2; l++)
+      psi[l] = K(0.0);
+    for (l = lo; l < hi; l++)
+      psi[l] = coeffs[deg * n_int + j0 + l];
+    for (p = deg - 1; p >= 0; p--)
+    {
+      const R *cp = coeffs + p * n_int + j0;
+      for (l = lo; l < hi; l++)
+        psi[l] = psi[l] * s + cp[l];
+    }
+    return;
+  }
+
+  switch (window)
+  {
+    case NFFT_WINDOW_EXP_SEMICIRCLE:
+      for (l = 0; l < m2p2; l++)
+        psi[l] = phi_exp_semicircle(x * (R)(n) - (R)(u + l), m, b);
+      break;
+    case NFFT_WINDOW_GAUSSIAN:
+      for (l = 0; l < m2p2; l++)
+        psi[l] = phi_gaussian(n, x - ((R)(u + l)) / ((R)n), b);
+      break;
+    case NFFT_WINDOW_B_SPLINE:
+      for (l = 0; l < m2p2; l++)
+        psi[l] = phi_b_spline(n, x - ((R)(u + l)) / ((R)n), m);
+      break;
+    case NFFT_WINDOW_SINC_POWER:
+      for (l = 0; l < m2p2; l++)
+        psi[l] = phi_sinc_power(n, x - ((R)(u + l)) / ((R)n), m, sigma);
+      break;
+    case NFFT_WINDOW_DIRAC_DELTA:
+      for (l = 0; l < m2p2; l++)
+        psi[l] = phi_dirac_delta(x - ((R)(u + l)) / ((R)n));
+      break;
+    default:
+      for (l = 0; l < m2p2; l++)
+        psi[l] = phi_kaiser_bessel(n, x - ((R)(u + l)) / ((R)n), m, b);
+      break;
+  }
+}
+
+/* Fourier coefficients of the window functions. */
+
+/* The exponential of semicircle window has no closed-form Fourier transform.
+ * With z = m sin(theta) the integrand is smooth and the trapezoidal rule in
+ * theta converges spectrally. */
+static R phi_hut_exp_semicircle(const INT n, const R k, const INT m,
+  const R b)
+{
+  const INT q = 4 * m + 8;
+  const R h = KPI / (K(2.0) * (R)(q));
+  const R w = K(2.0) * KPI * k * (R)(m) / (R)(n);
+  R sum = K(0.5);
+  INT i;
+
+  for (i = 1; i < q; i++)
+  {
+    const R c = COS((R)(i) * h);
+    sum += EXP(b * (c - K(1.0))) * COS(w * SIN((R)(i) * h)) * c;
+  }
+
+  return K(2.0) * (R)(m) * h * sum;
+}
+
+R Y(window_phi_hut)(const unsigned window, const INT n, const R k,
+  const INT m, const R b, const R sigma)
+{
+  switch (window)
+  {
+    case NFFT_WINDOW_GAUSSIAN:
+      return (R)EXP(-(POW(KPI * k / (R)n, K(2.0)) * b));
+    case NFFT_WINDOW_B_SPLINE:
+      return (R)((k == K(0.0)) ? K(1.0) / (R)n :
+        POW(SIN(k * KPI / (R)n) / (k * KPI / (R)n), K(2.0) * (R)m) / (R)n);
+    case NFFT_WINDOW_SINC_POWER:
+      return Y(bsplines)(2 * m, (K(2.0) * (R)m * k) /
+        ((K(2.0) * sigma - K(1.0)) * (R)n / sigma) + (R)m);
+    case NFFT_WINDOW_DIRAC_DELTA:
+      return K(1.0);
+    case NFFT_WINDOW_EXP_SEMICIRCLE:
+      return phi_hut_exp_semicircle(n, k, m, b);
+    default:
+      return Y(bessel_i0)((R)(m) * SQRT(b * b - (K(2.0) * KPI * k / (R)(n))
+        * (K(2.0) * KPI * k / (R)(n))));
+  }
+}
+
 /**
  * Returns the default window cut off m for the selected window
  */
@@ -52,3 +462,13 @@ const char *Y(get_window_name)()
 {
   return STRINGIZE(WINDOW_NAME);
 }
+
+NFFT_INT Y(get_default_window_cut_off_of)(unsigned window)
+{
+  return (NFFT_INT)(window_m_[Y(window_resolve)(window)]);
+}
+
+const char *Y(get_window_name_of)(unsigned window)
+{
+  return window_name_[Y(window_resolve)(window)];
+}
@@ -29,10 +29,11 @@
 #include "nfft.h"
 #include "nfct.h"
 #include "nfst.h"
+#include "nnfft.h"
 
 int main(void)
 {
-  CU_pSuite util, nfft, nfct, nfst;
+  CU_pSuite util, nfft, nfct, nfst, nnfft;
   CU_initialize_registry();
   /*CU_set_output_filename("nfft");*/
 #ifdef _OPENMP
@@ -48,6 +49,8 @@ int main(void)
   CU_add_test(util, "window_name", X(check_get_window_name));
   CU_add_test(util, "log2i", X(check_log2i));
   CU_add_test(util, "next_power_of_2", X(check_next_power_of_2));
+  CU_add_test(util, "simd", X(check_simd));
+  CU_add_test(util, "sort_node_indices", X(check_sort_node_indices));
 
 #undef X
 #define X(name) NFFT(name)
@@ -77,6 +80,23 @@ int main(void)
   CU_add_test(nfft, "nfft_4d_online", X(check_4d_online));
   CU_add_test(nfft, "nfft_adjoint_4d_online", X(check_adjoint_4d_online));
 #endif
+  CU_add_test(nfft, "nfft_nd_online", X(check_nd_online));
+  CU_add_test(nfft, "nfft_adjoint_nd_online", X(check_adjoint_nd_online));
+
+  CU_add_test(nfft, "nfft_window_online", X(check_window_online));
+  CU_add_test(nfft, "nfft_adjoint_window_online", X(check_adjoint_window_online));
+  CU_add_test(nfft, "nfft_many_online", X(check_many_online));
+  CU_add_test(nfft, "nfft_adjoint_many_online", X(check_adjoint_many_online));
+  CU_add_test(nfft, "nfft_many_flags", X(check_many_flags));
+  CU_add_test(nfft, "nfft_spread_interp", X(check_spread_interp));
+  CU_add_test(nfft, "nfft_real", X(check_real));
+  CU_add_test(nfft, "nfft_estimate_memory", X(check_estimate_memory));
+  CU_add_test(nfft, "nfft_budget", X(check_budget));
+  CU_add_test(nfft, "nfft_tune", X(check_tune));
+  CU_add_test(nfft, "nfft_save_plan", X(check_save_plan));
+  CU_add_test(nfft, "nfft_arena", X(check_arena));
+  CU_add_test(nfft, "nfft_stats", X(check_stats));
+  CU_add_test(nfft, "nfft_trace", X(check_trace));
 #ifdef HAVE_NFCT
 #undef X
 #define X(name) NFCT(name)
@@ -107,6 +127,7 @@ int main(void)
   CU_add_test(nfct, "nfct_4d_online", X(check_4d_online));
   CU_add_test(nfct, "nfct_adjoint_4d_online", X(check_adjoint_4d_online));
 #endif
+  CU_add_test(nfct, "nfct_estimate_memory", X(check_estimate_memory));
 #endif
 #endif
 #ifdef HAVE_NFST
@@ -138,8 +159,15 @@ int main(void)
 
   CU_add_test(nfst, "nfst_4d_online", X(check_4d_online));
   CU_add_test(nfst, "nfst_adjoint_4d_online", X(check_adjoint_4d_online));
+#endif
+  CU_add_test(nfst, "nfst_estimate_memory", X(check_estimate_memory));
 #endif
 #endif
+#ifdef HAVE_NNFFT
+#undef X
+#define X(name) CONCAT(nnfft_,name)
+  nnfft = CU_add_suite("nnfft", 0, 0);
+  CU_add_test(nnfft, "nnfft_estimate_memory", X(check_estimate_memory));
 #endif
   CU_automated_run_tests();
   //CU_basic_run_tests();
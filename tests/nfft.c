@@ -19,6 +19,8 @@
 /* Standard headers. */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include <complex.h>
 #include <CUnit/CUnit.h>
@@ -77,6 +79,7 @@ struct init_delegate_s
   const unsigned flags;
   const unsigned fftw_flags;
   const int K;
+  const unsigned window;
 };
 
 /* Prepare delegate. */
@@ -127,6 +130,9 @@ static void init_2d_(init_delegate_t *ego, X(plan) *p, const int d, const int *N
 static void init_3d_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M);
 static void init_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M);
 static void init_advanced_pre_psi_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M);
+static void init_window_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M);
+static void init_many_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M);
+static void init_sigma_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M);
 
 #define DEFAULT_NFFT_FLAGS MALLOC_X | MALLOC_F | MALLOC_F_HAT | FFTW_INIT | FFT_OUT_OF_PLACE
 #define DEFAULT_FFTW_FLAGS FFTW_ESTIMATE | FFTW_DESTROY_INPUT
@@ -135,9 +141,15 @@ static init_delegate_t init_1d;
 static init_delegate_t init_2d;
 static init_delegate_t init_3d;
 static init_delegate_t init;
+static init_delegate_t init_sigma;
 static init_delegate_t init_advanced_pre_psi;
 static init_delegate_t init_advanced_pre_full_psi;
+static init_delegate_t init_advanced_pre_full_psi_float;
 static init_delegate_t init_advanced_pre_lin_psi;
+static init_delegate_t init_advanced_tiled;
+static init_delegate_t init_advanced_pre_psi_tiled;
+static init_delegate_t init_advanced_sort;
+static init_delegate_t init_advanced_pre_psi_pruned;
 #if defined(GAUSSIAN)
 static init_delegate_t init_advanced_pre_fg_psi;
 #endif
@@ -225,7 +237,9 @@ static R err_trafo(X(plan) *p)
   int i;
   for (i = 0, s = ((R)p->sigma[0]); i < p->d; i++)
     s = FMIN(s, ((R)p->sigma[i]));
-#if defined(GAUSSIAN)
+  switch (p->window)
+  {
+    case NFFT_WINDOW_GAUSSIAN:
 #if defined(NFFT_LDOUBLE)
     a = K(0.6);
     b = K(50.0);
@@ -237,10 +251,8 @@ static R err_trafo(X(plan) *p)
     b = K(50.0);
 #endif
     err = EXP(-m*KPI*(K(1.0)-K(1.0)/(K(2.0)*K(2.0) - K(1.0))));
-#elif defined(B_SPLINE)
-    //printf("m = %E, s = %E, a1 = %E, a2 = %E, z = %E\n", m, s, K(1.0)/(K(2.0)*s-K(1.0)), K(2.0)*m, K(4.0) * POW(K(1.0)/(K(2.0)*s-K(1.0)),K(2.0)*m));
-    //printf("\n<s = %E>\n", s);
-    //fflush(stdout);
+    break;
+    case NFFT_WINDOW_B_SPLINE:
 #if defined(NFFT_LDOUBLE)
     a = K(0.3);
     b = K(50.0);
@@ -252,7 +264,8 @@ static R err_trafo(X(plan) *p)
     b = K(2000.0);
 #endif
     err = K(3000.0) * K(4.0) * POW(K(1.0)/(K(2.0)*s-K(1.0)),K(2.0)*m);
-  #elif defined(SINC_POWER)
+    break;
+    case NFFT_WINDOW_SINC_POWER:
 #if defined(NFFT_LDOUBLE)
     a = K(0.3);
     b = K(50.0);
@@ -264,7 +277,9 @@ static R err_trafo(X(plan) *p)
     b = K(2000.0);
 #endif
     err = (K(1.0)/(m-K(1.0))) * ((K(2.0)/(POW(s,K(2.0)*m))) + POW(s/(K(2.0)*s-K(1.0)),K(2.0)*m));
-  #elif defined(KAISER_BESSEL)
+    break;
+    case NFFT_WINDOW_KAISER_BESSEL:
+    case NFFT_WINDOW_EXP_SEMICIRCLE:
 #if defined(NFFT_LDOUBLE)
     a = K(1.5);
     b = K(50.0);
@@ -275,12 +290,32 @@ static R err_trafo(X(plan) *p)
     a = K(0.3);
     b = K(2100.0);
 #endif
-    err = KPI * (SQRT(m) + m) * SQRT(SQRT(K(1.0) - K(1.0)/K(2.0))) * EXP(-K2PI * m * SQRT(K(1.0) - K(1.0) / K(2.0)));
-  #else
-    #error Unsupported window function.
-  #endif
+    err = KPI * (SQRT(m) + m) * SQRT(SQRT(K(1.0) - K(1.0)/FMIN(s, K(2.0)))) * EXP(-K2PI * m * SQRT(K(1.0) - K(1.0) / FMIN(s, K(2.0))));
+    break;
+    default:
+      CU_FAIL("Unsupported window function.");
+      return K(0.0);
+  }
+
+  err = FMAX(FMAX(a * err, b * eps), err_trafo_direct(p));
+
+  /* Below sigma = 2 the range of the deconvolution factors 1/phi_hut
+   * amplifies the rounding errors noticeably. */
+  if (s < K(2.0))
+  {
+    R amp = K(1.0);
+    for (i = 0; i < p->d; i++)
+      amp *= Y(window_phi_hut)(p->window, p->n[i], K(0.0), p->m, p->b[i],
+        p->sigma[i]) / Y(window_phi_hut)(p->window, p->n[i],
+        (R)(p->N[i] / 2), p->m, p->b[i], p->sigma[i]);
+    err = FMAX(err, K(20.0) * amp * eps);
+  }
 
-  return FMAX(FMAX(a * err, b * eps), err_trafo_direct(p));
+  /* NFFT_FULL_PSI_FLOAT rounds the window values to single precision. */
+  if (p->flags & NFFT_FULL_PSI_FLOAT)
+    err = FMAX(err, K(1.0) * (R)FLT_EPSILON);
+
+  return err;
 }
 
 #define MAX_SECONDS 0.1
@@ -666,6 +701,12 @@ static void init_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, c
   X(init)(p, d, N, M);
 }
 
+static void init_sigma_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M)
+{
+  UNUSED(ego);
+  X(init_sigma)(p, d, N, M, K(1.25));
+}
+
 static void init_advanced_pre_psi_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M)
 {
   int *n = Y(malloc)((size_t)(d)*sizeof(int));
@@ -676,6 +717,29 @@ static void init_advanced_pre_psi_(init_delegate_t *ego, X(plan) *p, const int d
   Y(free)(n);
 }
 
+static void init_window_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M)
+{
+  int *n = Y(malloc)((size_t)(d)*sizeof(int));
+  int i;
+  for (i = 0; i < d; i++)
+    n[i] = 2 * (int)(Y(next_power_of_2)(N[i]));
+  X(init_guru_window)(p, d, N, M, n, (ego->m > 0) ? ego->m
+    : (int)Y(get_default_window_cut_off_of)(ego->window), ego->flags,
+    ego->fftw_flags, ego->window);
+  Y(free)(n);
+}
+
+static void init_many_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M)
+{
+  int *n = Y(malloc)((size_t)(d)*sizeof(int));
+  int i;
+  for (i = 0; i < d; i++)
+    n[i] = 2 * (int)(Y(next_power_of_2)(N[i]));
+  X(init_guru_many)(p, d, N, M, n, ego->m, 3, ego->flags, ego->fftw_flags,
+    NFFT_WINDOW_DEFAULT);
+  Y(free)(n);
+}
+
 //static void init_advanced_pre_lin_psi_(init_delegate_t *ego, X(plan) *p, const int d, const int *N, const int M)
 //{
 //  int *n = Y(malloc)((size_t)(d)*sizeof(int));
@@ -693,8 +757,10 @@ static init_delegate_t init_1d = {"init_1d", init_1d_, 0, 0, 0};
 static init_delegate_t init_2d = {"init_2d", init_2d_, 0, 0, 0};
 static init_delegate_t init_3d = {"init_3d", init_3d_, 0, 0, 0};
 static init_delegate_t init = {"init", init_, 0, 0, 0};
+static init_delegate_t init_sigma = {"init_sigma (1.25)", init_sigma_, 0, 0, 0};
 static init_delegate_t init_advanced_pre_psi = {"init_guru (PRE PSI)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
 static init_delegate_t init_advanced_pre_full_psi = {"init_guru (PRE FULL PSI)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_FULL_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_advanced_pre_full_psi_float = {"init_guru (PRE FULL PSI, FLOAT)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_FULL_PSI | NFFT_FULL_PSI_FLOAT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
 static init_delegate_t init_advanced_pre_lin_psi = {"init_guru (PRE LIN PSI)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
 //static init_delegate_t init_advanced_pre_lin_psi_00 = {"init_guru (PRE LIN PSI) 00", init_advanced_pre_lin_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, (1U << 23)};
 //static init_delegate_t init_advanced_pre_lin_psi_01 = {"init_guru (PRE LIN PSI) 01", init_advanced_pre_lin_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, (1U << 24)};
@@ -703,6 +769,10 @@ static init_delegate_t init_advanced_pre_lin_psi = {"init_guru (PRE LIN PSI)", i
 //static init_delegate_t init_advanced_pre_lin_psi_04 = {"init_guru (PRE LIN PSI) 04", init_advanced_pre_lin_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, (1U << 27)};
 //static init_delegate_t init_advanced_pre_lin_psi_05 = {"init_guru (PRE LIN PSI) 05", init_advanced_pre_lin_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, (1U << 28)};
 //static init_delegate_t init_advanced_pre_lin_psi_06 = {"init_guru (PRE LIN PSI) 06", init_advanced_pre_lin_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, (1U << 29)};
+static init_delegate_t init_advanced_tiled = {"init_guru (TILED)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | NFFT_OMP_TILED_ADJOINT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_advanced_pre_psi_tiled = {"init_guru (PRE PSI, TILED)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_PSI | NFFT_OMP_TILED_ADJOINT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_advanced_sort = {"init_guru (SORT, BLOCKWISE)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_advanced_pre_psi_pruned = {"init_guru (PRE PSI, PRUNED FFT)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_PSI | NFFT_PRUNED_FFT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
 #if defined(GAUSSIAN)
 static init_delegate_t init_advanced_pre_fg_psi = {"init_guru (PRE FG PSI)", init_advanced_pre_psi_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | FG_PSI | PRE_FG_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
 #endif
@@ -795,6 +865,282 @@ static trafo_delegate_t adjoint_1d = {"adjoint_1d", X(adjoint_1d), X(check), 0,
 static trafo_delegate_t adjoint_2d = {"adjoint_2d", X(adjoint_2d), X(check), 0, err_trafo};
 static trafo_delegate_t adjoint_3d = {"adjoint_3d", X(adjoint_3d), X(check), 0, err_trafo};
 
+/* The batched transforms are run on howmany+1 scaled copies of the input, one
+ * full batch and a remainder, and the rescaled mean is checked. The pipelined
+ * transforms of depth > 0 run on five copies, so that the pipeline fills, and
+ * check that the occupancy of the stages is a fraction of the time. */
+static void check_occupancy(const R *occupancy)
+{
+  int k;
+
+  for (k = 0; k < 3; k++)
+    CU_ASSERT(occupancy[k] >= K(0.0) && occupancy[k] <= K(1.01))
+}
+
+static void trafo_copies(X(plan) *p, const int howmany, const int depth)
+{
+  R occupancy[3];
+  C *f_hat = Y(malloc)((size_t)(howmany * p->N_total) * sizeof(C));
+  C *f = Y(malloc)((size_t)(howmany * p->M_total) * sizeof(C));
+  int v, j;
+
+  for (v = 0; v < howmany; v++)
+    for (j = 0; j < p->N_total; j++)
+      f_hat[v * p->N_total + j] = (R)(v + 1) * p->f_hat[j];
+
+  if (depth > 0)
+  {
+    X(trafo_pipeline)(p, howmany, f_hat, (int)p->N_total, f, (int)p->M_total,
+      depth, occupancy);
+    check_occupancy(occupancy);
+  }
+  else
+    X(trafo_many)(p, howmany, f_hat, (int)p->N_total, f, (int)p->M_total);
+
+  for (j = 0; j < p->M_total; j++)
+  {
+    p->f[j] = K(0.0);
+    for (v = 0; v < howmany; v++)
+      p->f[j] += f[v * p->M_total + j] / (R)(v + 1);
+    p->f[j] /= (R)howmany;
+  }
+
+  Y(free)(f);
+  Y(free)(f_hat);
+}
+
+static void trafo_many_(X(plan) *p)
+{
+  trafo_copies(p, (int)p->howmany + 1, 0);
+}
+
+static void trafo_pipeline_2(X(plan) *p)
+{
+  trafo_copies(p, 5, 2);
+}
+
+static void trafo_pipeline_3(X(plan) *p)
+{
+  trafo_copies(p, 5, 3);
+}
+
+static void adjoint_copies(X(plan) *p, const int howmany, const int depth)
+{
+  R occupancy[3];
+  C *f_hat = Y(malloc)((size_t)(howmany * p->N_total) * sizeof(C));
+  C *f = Y(malloc)((size_t)(howmany * p->M_total) * sizeof(C));
+  int v, k;
+
+  for (v = 0; v < howmany; v++)
+    for (k = 0; k < p->M_total; k++)
+      f[v * p->M_total + k] = (R)(v + 1) * p->f[k];
+
+  if (depth > 0)
+  {
+    X(adjoint_pipeline)(p, howmany, f_hat, (int)p->N_total, f,
+      (int)p->M_total, depth, occupancy);
+    check_occupancy(occupancy);
+  }
+  else
+    X(adjoint_many)(p, howmany, f_hat, (int)p->N_total, f, (int)p->M_total);
+
+  for (k = 0; k < p->N_total; k++)
+  {
+    p->f_hat[k] = K(0.0);
+    for (v = 0; v < howmany; v++)
+      p->f_hat[k] += f_hat[v * p->N_total + k] / (R)(v + 1);
+    p->f_hat[k] /= (R)howmany;
+  }
+
+  Y(free)(f);
+  Y(free)(f_hat);
+}
+
+static void adjoint_many_(X(plan) *p)
+{
+  adjoint_copies(p, (int)p->howmany + 1, 0);
+}
+
+static void adjoint_pipeline_2(X(plan) *p)
+{
+  adjoint_copies(p, 5, 2);
+}
+
+static void adjoint_pipeline_3(X(plan) *p)
+{
+  adjoint_copies(p, 5, 3);
+}
+
+/* The streamed transforms read the nodes and samples from copies in chunks of
+ * STREAM_CHUNK nodes, while the plan holds only STREAM_CAPACITY of them, so
+ * every chunk is processed in two parts. */
+#define STREAM_CHUNK 23
+#define STREAM_CAPACITY 16
+
+static void trafo_stream_(X(plan) *p)
+{
+  const int M = (int)p->M_total;
+  R *x = Y(malloc)((size_t)(p->d * M) * sizeof(R));
+  C *f = Y(malloc)((size_t)(M) * sizeof(C));
+  int j;
+
+  memcpy(x, p->x, (size_t)(p->d * M) * sizeof(R));
+
+  p->M_total = MIN(M, STREAM_CAPACITY);
+  X(trafo_stream_begin)(p);
+  for (j = 0; j < M; j += STREAM_CHUNK)
+    X(trafo_stream_chunk)(p, MIN(STREAM_CHUNK, M - j), x + j * p->d, f + j);
+  p->M_total = M;
+
+  memcpy(p->f, f, (size_t)(M) * sizeof(C));
+
+  Y(free)(f);
+  Y(free)(x);
+}
+
+static void adjoint_stream_(X(plan) *p)
+{
+  const int M = (int)p->M_total;
+  R *x = Y(malloc)((size_t)(p->d * M) * sizeof(R));
+  C *f = Y(malloc)((size_t)(M) * sizeof(C));
+  int j;
+
+  memcpy(x, p->x, (size_t)(p->d * M) * sizeof(R));
+  memcpy(f, p->f, (size_t)(M) * sizeof(C));
+
+  p->M_total = MIN(M, STREAM_CAPACITY);
+  X(adjoint_stream_begin)(p);
+  for (j = 0; j < M; j += STREAM_CHUNK)
+    X(adjoint_stream_chunk)(p, MIN(STREAM_CHUNK, M - j), x + j * p->d, f + j);
+  X(adjoint_stream_end)(p);
+  p->M_total = M;
+
+  Y(free)(f);
+  Y(free)(x);
+}
+
+/* The transforms are run once on other nodes, whose psi is precomputed
+ * afterwards, then again after the original nodes have been restored by
+ * set_nodes, which leaves the precomputation of psi to the transform. */
+static void trafo_set_nodes_(X(plan) *p)
+{
+  R *x = Y(malloc)((size_t)(p->d * p->M_total) * sizeof(R));
+  memcpy(x, p->x, (size_t)(p->d * p->M_total) * sizeof(R));
+
+  Y(vrand_shifted_unit_double)(p->x, p->d * p->M_total);
+  X(set_nodes)(p, NULL);
+  X(trafo)(p);
+  X(precompute_one_psi)(p);
+
+  X(set_nodes)(p, x);
+  X(trafo)(p);
+
+  Y(free)(x);
+}
+
+static void adjoint_set_nodes_(X(plan) *p)
+{
+  R *x = Y(malloc)((size_t)(p->d * p->M_total) * sizeof(R));
+  memcpy(x, p->x, (size_t)(p->d * p->M_total) * sizeof(R));
+
+  Y(vrand_shifted_unit_double)(p->x, p->d * p->M_total);
+  X(set_nodes)(p, NULL);
+  X(adjoint)(p);
+  X(precompute_one_psi)(p);
+
+  X(set_nodes)(p, x);
+  X(adjoint)(p);
+
+  Y(free)(x);
+}
+
+static trafo_delegate_t trafo_set_nodes = {"trafo (set_nodes)", trafo_set_nodes_, X(check), 0, err_trafo};
+static trafo_delegate_t adjoint_set_nodes = {"adjoint (set_nodes)", adjoint_set_nodes_, X(check), 0, err_trafo};
+
+/* The reentrant transforms are run concurrently on the shared plan, each with
+ * its own output and workspace, and the mean of the results is checked. */
+#define EXECUTE_COPIES 4
+
+static void trafo_execute_(X(plan) *p)
+{
+  const size_t size = X(workspace_size)(p);
+  void *work[EXECUTE_COPIES];
+  C *f[EXECUTE_COPIES];
+  int i, j;
+
+  for (i = 0; i < EXECUTE_COPIES; i++)
+  {
+    work[i] = Y(malloc)(size);
+    f[i] = Y(malloc)((size_t)(p->M_total) * sizeof(C));
+  }
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(EXECUTE_COPIES)
+#endif
+  for (i = 0; i < EXECUTE_COPIES; i++)
+    X(execute_trafo)(p, p->f_hat, f[i], work[i]);
+
+  for (j = 0; j < p->M_total; j++)
+  {
+    p->f[j] = K(0.0);
+    for (i = 0; i < EXECUTE_COPIES; i++)
+      p->f[j] += f[i][j];
+    p->f[j] /= (R)EXECUTE_COPIES;
+  }
+
+  for (i = 0; i < EXECUTE_COPIES; i++)
+  {
+    Y(free)(f[i]);
+    Y(free)(work[i]);
+  }
+}
+
+static void adjoint_execute_(X(plan) *p)
+{
+  const size_t size = X(workspace_size)(p);
+  void *work[EXECUTE_COPIES];
+  C *f_hat[EXECUTE_COPIES];
+  int i, k;
+
+  for (i = 0; i < EXECUTE_COPIES; i++)
+  {
+    work[i] = Y(malloc)(size);
+    f_hat[i] = Y(malloc)((size_t)(p->N_total) * sizeof(C));
+  }
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(EXECUTE_COPIES)
+#endif
+  for (i = 0; i < EXECUTE_COPIES; i++)
+    X(execute_adjoint)(p, f_hat[i], p->f, work[i]);
+
+  for (k = 0; k < p->N_total; k++)
+  {
+    p->f_hat[k] = K(0.0);
+    for (i = 0; i < EXECUTE_COPIES; i++)
+      p->f_hat[k] += f_hat[i][k];
+    p->f_hat[k] /= (R)EXECUTE_COPIES;
+  }
+
+  for (i = 0; i < EXECUTE_COPIES; i++)
+  {
+    Y(free)(f_hat[i]);
+    Y(free)(work[i]);
+  }
+}
+
+static trafo_delegate_t trafo_execute = {"execute_trafo", trafo_execute_, X(check), 0, err_trafo};
+static trafo_delegate_t adjoint_execute = {"execute_adjoint", adjoint_execute_, X(check), 0, err_trafo};
+
+static trafo_delegate_t trafo_many = {"trafo_many", trafo_many_, X(check), 0, err_trafo};
+static trafo_delegate_t adjoint_many = {"adjoint_many", adjoint_many_, X(check), 0, err_trafo};
+static trafo_delegate_t trafo_pipeline2 = {"trafo_pipeline (2)", trafo_pipeline_2, X(check), 0, err_trafo};
+static trafo_delegate_t trafo_pipeline3 = {"trafo_pipeline (3)", trafo_pipeline_3, X(check), 0, err_trafo};
+static trafo_delegate_t adjoint_pipeline2 = {"adjoint_pipeline (2)", adjoint_pipeline_2, X(check), 0, err_trafo};
+static trafo_delegate_t adjoint_pipeline3 = {"adjoint_pipeline (3)", adjoint_pipeline_3, X(check), 0, err_trafo};
+static trafo_delegate_t trafo_stream = {"trafo_stream", trafo_stream_, X(check), 0, err_trafo};
+static trafo_delegate_t adjoint_stream = {"adjoint_stream", adjoint_stream_, X(check), 0, err_trafo};
+
 /* 1D */
 
 /* Initializers. */
@@ -807,8 +1153,13 @@ static const init_delegate_t* initializers_1d[] =
 {
   &init_1d,
   &init,
+  &init_sigma,
   &init_advanced_pre_psi,
   &init_advanced_pre_full_psi,
+  &init_advanced_pre_full_psi_float,
+  &init_advanced_tiled,
+  &init_advanced_pre_psi_tiled,
+  &init_advanced_sort,
 //  &init_advanced_pre_lin_psi,
 //  &init_advanced_pre_lin_psi_00,
 //  &init_advanced_pre_lin_psi_01,
@@ -987,7 +1338,7 @@ static const testcase_delegate_online_t *testcases_1d_online[] =
 #endif
 };
 
-static const trafo_delegate_t* trafos_1d_online[] = {&trafo, &trafo_1d};
+static const trafo_delegate_t* trafos_1d_online[] = {&trafo, &trafo_1d, &trafo_set_nodes, &trafo_execute};
 
 void X(check_1d_online)(void)
 {
@@ -1018,7 +1369,7 @@ static const testcase_delegate_online_t *testcases_adjoint_1d_online[] =
 #endif
 };
 
-static const trafo_delegate_t* trafos_adjoint_1d_online[] = {&adjoint, &adjoint_1d};
+static const trafo_delegate_t* trafos_adjoint_1d_online[] = {&adjoint, &adjoint_1d, &adjoint_set_nodes, &adjoint_execute};
 
 void X(check_adjoint_1d_online)(void)
 {
@@ -1033,8 +1384,14 @@ static const init_delegate_t* initializers_2d[] =
 {
   &init_2d,
   &init,
+  &init_sigma,
   &init_advanced_pre_psi,
   &init_advanced_pre_full_psi,
+  &init_advanced_pre_full_psi_float,
+  &init_advanced_tiled,
+  &init_advanced_pre_psi_tiled,
+  &init_advanced_sort,
+  &init_advanced_pre_psi_pruned,
 //  &init_advanced_pre_lin_psi,
 //  &init_advanced_pre_lin_psi_00,
 //  &init_advanced_pre_lin_psi_01,
@@ -1143,7 +1500,7 @@ static const testcase_delegate_online_t *testcases_2d_online[] =
 #endif
 };
 
-static const trafo_delegate_t* trafos_2d_online[] = {&trafo, &trafo_2d};
+static const trafo_delegate_t* trafos_2d_online[] = {&trafo, &trafo_2d, &trafo_set_nodes, &trafo_execute};
 
 void X(check_2d_online)(void)
 {
@@ -1168,7 +1525,7 @@ static const testcase_delegate_online_t *testcases_adjoint_2d_online[] =
 #endif
 };
 
-static const trafo_delegate_t* trafos_adjoint_2d_online[] = {&adjoint, &adjoint_2d};
+static const trafo_delegate_t* trafos_adjoint_2d_online[] = {&adjoint, &adjoint_2d, &adjoint_set_nodes, &adjoint_execute};
 
 void X(check_adjoint_2d_online)(void)
 {
@@ -1183,8 +1540,14 @@ static const init_delegate_t* initializers_3d[] =
 {
   &init_3d,
   &init,
+  &init_sigma,
   &init_advanced_pre_psi,
   &init_advanced_pre_full_psi,
+  &init_advanced_pre_full_psi_float,
+  &init_advanced_tiled,
+  &init_advanced_pre_psi_tiled,
+  &init_advanced_sort,
+  &init_advanced_pre_psi_pruned,
 //  &init_advanced_pre_lin_psi,
 //  &init_advanced_pre_lin_psi_00,
 //  &init_advanced_pre_lin_psi_01,
@@ -1286,8 +1649,12 @@ void X(check_adjoint_3d_online)(void)
 static const init_delegate_t* initializers_4d[] =
 {
   &init,
+  &init_sigma,
   &init_advanced_pre_psi,
   &init_advanced_pre_full_psi,
+  &init_advanced_pre_full_psi_float,
+  &init_advanced_pre_psi_tiled,
+  &init_advanced_pre_psi_pruned,
 //  &init_advanced_pre_lin_psi,
 //  &init_advanced_pre_lin_psi_00,
 //  &init_advanced_pre_lin_psi_01,
@@ -1333,6 +1700,1261 @@ void X(check_adjoint_4d_online)(void)
 }
 #endif
 
+/* d >= 4 with a short window, so that the oversampled grids of the 5D and 6D
+ * test cases stay small. */
+
+#define ND_m 2
+
+static init_delegate_t init_nd = {"init_guru (m = 2)", init_advanced_pre_psi_, ND_m, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_nd_pre_psi = {"init_guru (m = 2, PRE PSI)", init_advanced_pre_psi_, ND_m, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_nd_sort = {"init_guru (m = 2, SORT, BLOCKWISE)", init_advanced_pre_psi_, ND_m, PRE_PHI_HUT | NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_nd_pre_psi_sort = {"init_guru (m = 2, PRE PSI, SORT, BLOCKWISE)", init_advanced_pre_psi_, ND_m, PRE_PHI_HUT | PRE_PSI | NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_nd_pre_psi_tiled = {"init_guru (m = 2, PRE PSI, TILED)", init_advanced_pre_psi_, ND_m, PRE_PHI_HUT | PRE_PSI | NFFT_OMP_TILED_ADJOINT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_nd_pre_full_psi = {"init_guru (m = 2, PRE FULL PSI)", init_advanced_pre_psi_, ND_m, PRE_PHI_HUT | PRE_FULL_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+
+static const init_delegate_t* initializers_nd[] =
+{
+  &init_nd,
+  &init_nd_pre_psi,
+  &init_nd_sort,
+  &init_nd_pre_psi_sort,
+  &init_nd_pre_psi_tiled,
+  &init_nd_pre_full_psi,
+};
+
+static const testcase_delegate_online_t nfft_online_4d_8_50 = {setup_online, destroy_online, 4, 8, 50};
+static const testcase_delegate_online_t nfft_online_5d_4_50 = {setup_online, destroy_online, 5, 4, 50};
+static const testcase_delegate_online_t nfft_online_6d_4_50 = {setup_online, destroy_online, 6, 4, 50};
+
+static const testcase_delegate_online_t *testcases_nd_online[] =
+{
+  &nfft_online_4d_8_50,
+  &nfft_online_5d_4_50,
+  &nfft_online_6d_4_50,
+};
+
+/* The window error of the tensor product window adds up over the dimensions. */
+static R err_trafo_nd(X(plan) *p)
+{
+  return ((R)p->d) * err_trafo(p);
+}
+
+static trafo_delegate_t trafo_nd = {"trafo", X(trafo), X(check), 0, err_trafo_nd};
+static trafo_delegate_t trafo_nd_execute = {"execute_trafo", trafo_execute_, X(check), 0, err_trafo_nd};
+static trafo_delegate_t adjoint_nd = {"adjoint", X(adjoint), X(check), 0, err_trafo_nd};
+static trafo_delegate_t adjoint_nd_execute = {"execute_adjoint", adjoint_execute_, X(check), 0, err_trafo_nd};
+
+static const trafo_delegate_t* trafos_nd_online[] = {&trafo_nd, &trafo_nd_execute};
+
+void X(check_nd_online)(void)
+{
+  check_many(SIZE(testcases_nd_online), SIZE(initializers_nd), SIZE(trafos_nd_online),
+    testcases_nd_online, initializers_nd, &check_trafo, trafos_nd_online);
+}
+
+static const testcase_delegate_online_t nfft_adjoint_online_4d_8_50 = {setup_adjoint_online, destroy_online, 4, 8, 50};
+static const testcase_delegate_online_t nfft_adjoint_online_5d_4_50 = {setup_adjoint_online, destroy_online, 5, 4, 50};
+static const testcase_delegate_online_t nfft_adjoint_online_6d_4_50 = {setup_adjoint_online, destroy_online, 6, 4, 50};
+
+static const testcase_delegate_online_t *testcases_adjoint_nd_online[] =
+{
+  &nfft_adjoint_online_4d_8_50,
+  &nfft_adjoint_online_5d_4_50,
+  &nfft_adjoint_online_6d_4_50,
+};
+
+static const trafo_delegate_t* trafos_adjoint_nd_online[] = {&adjoint_nd, &adjoint_nd_execute};
+
+void X(check_adjoint_nd_online)(void)
+{
+  check_many(SIZE(testcases_adjoint_nd_online), SIZE(initializers_nd), SIZE(trafos_adjoint_nd_online),
+    testcases_adjoint_nd_online, initializers_nd, &check_adjoint, trafos_adjoint_nd_online);
+}
+
+/* Window functions selected at runtime. */
+
+static init_delegate_t init_window_kaiser_bessel = {"init_guru_window (KB)", init_window_, 0, DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_KAISER_BESSEL};
+static init_delegate_t init_window_kaiser_bessel_pre_psi = {"init_guru_window (KB, PSI)", init_window_, 0, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_KAISER_BESSEL};
+static init_delegate_t init_window_gaussian = {"init_guru_window (GAUSS)", init_window_, 0, DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_GAUSSIAN};
+static init_delegate_t init_window_gaussian_pre_psi = {"init_guru_window (GAUSS, PSI)", init_window_, 0, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_GAUSSIAN};
+static init_delegate_t init_window_gaussian_fg_psi = {"init_guru_window (GAUSS, FG)", init_window_, 0, PRE_PHI_HUT | FG_PSI | PRE_FG_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_GAUSSIAN};
+static init_delegate_t init_window_b_spline = {"init_guru_window (BSPLINE)", init_window_, 0, DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_B_SPLINE};
+static init_delegate_t init_window_b_spline_pre_psi = {"init_guru_window (BSPLINE, PSI)", init_window_, 0, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_B_SPLINE};
+static init_delegate_t init_window_sinc_power = {"init_guru_window (SINC)", init_window_, 0, DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_SINC_POWER};
+static init_delegate_t init_window_sinc_power_pre_psi = {"init_guru_window (SINC, PSI)", init_window_, 0, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_SINC_POWER};
+static init_delegate_t init_window_exp_semicircle = {"init_guru_window (ES)", init_window_, 0, DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_window_exp_semicircle_pre_psi = {"init_guru_window (ES, PSI)", init_window_, 0, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_window_exp_semicircle_pre_lin_psi = {"init_guru_window (ES, LIN PSI)", init_window_, 0, PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+
+static const init_delegate_t* initializers_window[] =
+{
+  &init_window_kaiser_bessel,
+  &init_window_kaiser_bessel_pre_psi,
+  &init_window_gaussian,
+  &init_window_gaussian_pre_psi,
+  &init_window_gaussian_fg_psi,
+  &init_window_b_spline,
+  &init_window_b_spline_pre_psi,
+  &init_window_sinc_power,
+  &init_window_sinc_power_pre_psi,
+  &init_window_exp_semicircle,
+  &init_window_exp_semicircle_pre_psi,
+  &init_window_exp_semicircle_pre_lin_psi,
+};
+
+static const testcase_delegate_online_t *testcases_window_online[] =
+{
+  &nfft_online_1d_200_50,
+  &nfft_online_2d_50_50,
+};
+
+static const trafo_delegate_t* trafos_window_online[] = {&trafo};
+
+void X(check_window_online)(void)
+{
+  check_many(SIZE(testcases_window_online), SIZE(initializers_window), SIZE(trafos_window_online),
+    testcases_window_online, initializers_window, &check_trafo, trafos_window_online);
+}
+
+static const testcase_delegate_online_t *testcases_adjoint_window_online[] =
+{
+  &nfft_adjoint_online_1d_200_50,
+  &nfft_adjoint_online_2d_50_50,
+};
+
+static const trafo_delegate_t* trafos_adjoint_window_online[] = {&adjoint};
+
+void X(check_adjoint_window_online)(void)
+{
+  check_many(SIZE(testcases_adjoint_window_online), SIZE(initializers_window), SIZE(trafos_adjoint_window_online),
+    testcases_adjoint_window_online, initializers_window, &check_adjoint, trafos_adjoint_window_online);
+}
+
+/* Batched transforms. */
+
+static init_delegate_t init_many = {"init_guru_many", init_many_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+static init_delegate_t init_many_pre_psi = {"init_guru_many (PRE PSI)", init_many_, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS};
+
+static const init_delegate_t* initializers_many[] =
+{
+  &init_many,
+  &init_many_pre_psi,
+};
+
+static const testcase_delegate_online_t nfft_online_3d_10_50 = {setup_online, destroy_online, 3, 10 ,50};
+static const testcase_delegate_online_t nfft_online_4d_10_50 = {setup_online, destroy_online, 4, 10 ,50};
+
+static const testcase_delegate_online_t *testcases_many_online[] =
+{
+  &nfft_online_1d_200_50,
+  &nfft_online_2d_50_50,
+  &nfft_online_3d_10_50,
+  &nfft_online_4d_10_50,
+};
+
+static const trafo_delegate_t* trafos_many_online[] = {&trafo_many,
+  &trafo_pipeline2, &trafo_pipeline3, &trafo_stream};
+
+void X(check_many_online)(void)
+{
+  check_many(SIZE(testcases_many_online), SIZE(initializers_many), SIZE(trafos_many_online),
+    testcases_many_online, initializers_many, &check_trafo, trafos_many_online);
+}
+
+static const testcase_delegate_online_t nfft_adjoint_online_3d_10_50 = {setup_adjoint_online, destroy_online, 3, 10 ,50};
+static const testcase_delegate_online_t nfft_adjoint_online_4d_10_50 = {setup_adjoint_online, destroy_online, 4, 10 ,50};
+
+static const testcase_delegate_online_t *testcases_adjoint_many_online[] =
+{
+  &nfft_adjoint_online_1d_200_50,
+  &nfft_adjoint_online_2d_50_50,
+  &nfft_adjoint_online_3d_10_50,
+  &nfft_adjoint_online_4d_10_50,
+};
+
+static const trafo_delegate_t* trafos_adjoint_many_online[] = {&adjoint_many,
+  &adjoint_pipeline2, &adjoint_pipeline3, &adjoint_stream};
+
+void X(check_adjoint_many_online)(void)
+{
+  check_many(SIZE(testcases_adjoint_many_online), SIZE(initializers_many), SIZE(trafos_adjoint_many_online),
+    testcases_adjoint_many_online, initializers_many, &check_adjoint, trafos_adjoint_many_online);
+}
+
+/* The batched transforms have to agree with the single ones for every
+ * precomputation flag, and leave the pointers g_hat and g of the plan as they
+ * were. Four vectors are one full batch of three and a remainder. */
+static int check_many_flags_single(const int d, const int NN,
+  const unsigned flags)
+{
+  const int M = 50, howmany = 4;
+  int N[3], n[3], t, v, j;
+  X(plan) p;
+  C *f_hat, *f, *g_hat, *g;
+  R err = K(0.0), err_adj = K(0.0), norm = K(0.0), norm_adj = K(0.0);
+  const R eps = K(1.0E4) * Y(float_property)(NFFT_EPSILON);
+  int restored, ok;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = NN;
+    n[t] = 2 * (int)(Y(next_power_of_2)(NN));
+  }
+
+  X(init_guru_many)(&p, d, N, M, n, WINDOW_HELP_ESTIMATE_m, 3, flags,
+    FFTW_ESTIMATE | FFTW_DESTROY_INPUT, NFFT_WINDOW_DEFAULT);
+
+  f_hat = Y(malloc)((size_t)(howmany * p.N_total) * sizeof(C));
+  f = Y(malloc)((size_t)(howmany * M) * sizeof(C));
+  g_hat = p.g_hat;
+  g = p.g;
+
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  Y(vrand_unit_complex)(f_hat, howmany * p.N_total);
+  X(trafo_many)(&p, howmany, f_hat, (int)p.N_total, f, M);
+  restored = p.g_hat == g_hat && p.g == g;
+
+  for (v = 0; v < howmany; v++)
+  {
+    memcpy(p.f_hat, f_hat + v * p.N_total, (size_t)(p.N_total) * sizeof(C));
+    X(trafo)(&p);
+    for (j = 0; j < M; j++)
+    {
+      err = MAX(err, CABS(f[v * M + j] - p.f[j]));
+      norm = MAX(norm, CABS(p.f[j]));
+    }
+  }
+  err /= norm;
+
+  g_hat = p.g_hat;
+  g = p.g;
+  Y(vrand_unit_complex)(f, howmany * M);
+  X(adjoint_many)(&p, howmany, f_hat, (int)p.N_total, f, M);
+  restored = restored && p.g_hat == g_hat && p.g == g;
+
+  for (v = 0; v < howmany; v++)
+  {
+    memcpy(p.f, f + v * M, (size_t)(M) * sizeof(C));
+    X(adjoint)(&p);
+    for (j = 0; j < p.N_total; j++)
+    {
+      err_adj = MAX(err_adj, CABS(f_hat[v * p.N_total + j] - p.f_hat[j]));
+      norm_adj = MAX(norm_adj, CABS(p.f_hat[j]));
+    }
+  }
+  err_adj /= norm_adj;
+
+  ok = restored && err < eps && err_adj < eps;
+  printf("nfft_many_flags d = %d, N = %4d, flags = %8u, trafo " __FE__
+    ", adjoint " __FE__ ", g restored %d -> %s\n", d, NN, flags, err, err_adj,
+    restored, ok ? "OK" : "FAIL");
+
+  Y(free)(f);
+  Y(free)(f_hat);
+  X(finalize)(&p);
+
+  return ok;
+}
+
+void X(check_many_flags)(void)
+{
+  static const unsigned flags[] =
+  {
+    PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_FULL_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_FULL_PSI | NFFT_FULL_PSI_FLOAT | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_FG_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | FG_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | DEFAULT_NFFT_FLAGS,
+  };
+  static const int NN[] = {0, 200, 50, 10};
+  int d;
+  size_t i;
+
+  for (d = 1; d <= 3; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      CU_ASSERT(check_many_flags_single(d, NN[d], flags[i]))
+}
+
+/* Spreading and interpolation. Interpolation from the grid that the fast
+ * transform leaves in g2 has to reproduce its result, and spreading has to be
+ * the adjoint of interpolation, <B g, f> = <g, B^T f>. */
+
+static int check_spread_interp_single(const int d, const int NN,
+  const unsigned flags)
+{
+  const int M = 50;
+  int N[4], n[4], t, j;
+  X(plan) p;
+  C *f, *g, *gt;
+  C s1 = K(0.0), s2 = K(0.0);
+  R err_interp = K(0.0), err_adj, norm = K(0.0);
+  const R eps = K(1.0E4) * Y(float_property)(NFFT_EPSILON);
+  int ok;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = NN;
+    n[t] = 2 * (int)(Y(next_power_of_2)(NN));
+  }
+
+  if (flags)
+    X(init_guru)(&p, d, N, M, n, WINDOW_HELP_ESTIMATE_m, flags,
+      FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+  else
+    X(init)(&p, d, N, M);
+
+  f = Y(malloc)((size_t)(M) * sizeof(C));
+  g = Y(malloc)((size_t)(p.n_total) * sizeof(C));
+  gt = Y(malloc)((size_t)(p.n_total) * sizeof(C));
+
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  Y(vrand_unit_complex)(p.f_hat, p.N_total);
+  X(trafo)(&p);
+  X(interp)(&p, p.g2, f);
+
+  for (j = 0; j < M; j++)
+  {
+    err_interp = MAX(err_interp, CABS(f[j] - p.f[j]));
+    norm = MAX(norm, CABS(p.f[j]));
+  }
+  err_interp /= norm;
+
+  Y(vrand_unit_complex)(g, p.n_total);
+  Y(vrand_unit_complex)(f, M);
+
+  X(interp)(&p, g, p.f);
+  X(spread)(&p, f, gt);
+
+  for (j = 0; j < M; j++)
+    s1 += p.f[j] * CONJ(f[j]);
+  for (j = 0; j < p.n_total; j++)
+    s2 += g[j] * CONJ(gt[j]);
+  err_adj = CABS(s1 - s2) / CABS(s1);
+
+  ok = err_interp < eps && err_adj < eps;
+  printf("nfft_spread_interp d = %d, N = %4d, flags = %5u, interp " __FE__
+    ", adjoint " __FE__ " -> %s\n", d, NN, flags, err_interp, err_adj,
+    ok ? "OK" : "FAIL");
+
+  Y(free)(gt);
+  Y(free)(g);
+  Y(free)(f);
+  X(finalize)(&p);
+
+  return ok;
+}
+
+void X(check_spread_interp)(void)
+{
+  static const unsigned flags[] =
+  {
+    0,
+    PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_FULL_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | DEFAULT_NFFT_FLAGS,
+  };
+  static const int NN[] = {0, 200, 50, 10, 10};
+  int d;
+  size_t i;
+
+  for (d = 1; d <= 4; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      if (d < 4 || !(flags[i] & PRE_FULL_PSI))
+        CU_ASSERT(check_spread_interp_single(d, NN[d], flags[i]))
+}
+
+/* Real-valued transforms. With the coefficients outside the half spectrum set
+ * to zero, the real transform has to agree with the real part of the complex
+ * one, and the real adjoint with the half spectrum of the complex adjoint. */
+
+static int check_real_single(const int d, const int NN, const unsigned flags)
+{
+  const int M = 50;
+  int N[4], n[4], t, j, k_L;
+  X(plan) p;
+  X(real_plan) rp;
+  C *f_hat;
+  R err, err_adj, sum = K(0.0), eps;
+  int ok, NH, NT;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = NN;
+    n[t] = 2 * (int)(Y(next_power_of_2)(NN));
+  }
+
+  if (flags)
+    X(real_init_guru)(&rp, d, N, M, n, WINDOW_HELP_ESTIMATE_m, flags,
+      FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+  else
+    X(real_init)(&rp, d, N, M);
+
+  X(init_guru)(&p, d, N, M, n, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_PSI
+    | DEFAULT_NFFT_FLAGS, FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+
+  eps = err_trafo(&rp.plan_nfft);
+  f_hat = (C*)rp.f_hat;
+  NH = (int)rp.N_half;
+  NT = (int)rp.N_total / 2;
+
+  Y(vrand_shifted_unit_double)(rp.x, d * M);
+  for (j = 0; j < d * M; j++)
+    p.x[j] = rp.x[j];
+  X(real_precompute_one_psi)(&rp);
+
+  /* trafo */
+  Y(vrand_unit_complex)(f_hat, NT);
+  memset(p.f_hat, 0, (size_t)(p.N_total) * sizeof(C));
+  for (k_L = 0; k_L < NT; k_L++)
+  {
+    p.f_hat[(k_L / NH) * NN + NN / 2 + k_L % NH] = f_hat[k_L];
+    sum += CABS(f_hat[k_L]);
+  }
+
+  X(trafo_direct)(&p);
+  X(real_trafo)(&rp);
+
+  err = K(0.0);
+  for (j = 0; j < M; j++)
+    err = MAX(err, FABS(CREAL(p.f[j]) - rp.f[j]));
+  err /= sum;
+
+  /* adjoint */
+  Y(vrand_unit_complex)(p.f, M);
+  sum = K(0.0);
+  for (j = 0; j < M; j++)
+  {
+    p.f[j] = CREAL(p.f[j]);
+    rp.f[j] = CREAL(p.f[j]);
+    sum += FABS(rp.f[j]);
+  }
+
+  X(adjoint_direct)(&p);
+  X(real_adjoint)(&rp);
+
+  err_adj = K(0.0);
+  for (k_L = 0; k_L < NT; k_L++)
+    err_adj = MAX(err_adj, CABS(f_hat[k_L]
+      - p.f_hat[(k_L / NH) * NN + NN / 2 + k_L % NH]));
+  err_adj /= sum;
+
+  ok = err < eps && err_adj < eps;
+  printf("nfft_real d = %d, N = %4d, flags = %5u, trafo " __FE__
+    ", adjoint " __FE__ " (" __FE__ ") -> %s\n", d, NN, flags, err, err_adj,
+    eps, ok ? "OK" : "FAIL");
+
+  X(finalize)(&p);
+  X(real_finalize)(&rp);
+
+  return ok;
+}
+
+void X(check_real)(void)
+{
+  static const unsigned flags[] =
+  {
+    0,
+    PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS,
+    DEFAULT_NFFT_FLAGS,
+  };
+  static const int NN[] = {0, 200, 50, 10, 10};
+  int d;
+  size_t i;
+
+  for (d = 1; d <= 4; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      CU_ASSERT(check_real_single(d, NN[d], flags[i]))
+}
+
+/* Memory estimate and budget. The estimate is compared with the bytes the
+ * plan requests through the malloc hook during init and precomputation. The
+ * hooks stay installed until X(finalize), so that malloc and free match. */
+
+static size_t malloc_bytes, malloc_calls;
+
+static void *malloc_counting(size_t n)
+{
+  malloc_bytes += n;
+  malloc_calls++;
+  return malloc(n == 0 ? 1 : n);
+}
+
+static int check_estimate_memory_single(const int d, const int NN,
+  const unsigned flags)
+{
+  const int M = 100, m = WINDOW_HELP_ESTIMATE_m;
+  int N[4], n[4], t, ok;
+  X(plan) p;
+  size_t est;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = NN;
+    n[t] = 2 * (int)(Y(next_power_of_2)(NN));
+  }
+
+  malloc_bytes = 0;
+  Y(malloc_hook) = malloc_counting;
+  Y(free_hook) = free;
+  X(init_guru)(&p, d, N, M, n, m, flags, FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  est = X(estimate_memory)(d, N, M, n, m, flags);
+
+  /* the FFTW setup allocates d ints temporarily */
+  ok = IF(est <= malloc_bytes && malloc_bytes - est <= (size_t)(d) * sizeof(int), 1, 0);
+
+  printf("estimate_memory d = %d, N = %-4d, flags = %-6u -> %-4s %zu (%zu)\n",
+    d, NN, flags, IF(ok == 0, "FAIL", "OK"), est, malloc_bytes);
+
+  X(finalize)(&p);
+  Y(malloc_hook) = 0;
+  Y(free_hook) = 0;
+
+  return ok;
+}
+
+void X(check_estimate_memory)(void)
+{
+  static const unsigned flags[] =
+  {
+    PRE_PHI_HUT | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_FULL_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_FULL_PSI | NFFT_FULL_PSI_FLOAT | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_PSI | NFFT_SORT_NODES | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_PSI | NFFT_PRUNED_FFT | MALLOC_X | MALLOC_F
+      | MALLOC_F_HAT | FFTW_INIT,
+  };
+  static const int NN[] = {0, 64, 16, 8};
+  int d;
+  size_t i;
+
+  for (d = 1; d <= 3; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      CU_ASSERT(check_estimate_memory_single(d, NN[d], flags[i]))
+}
+
+/* The budget has to select PRE_FULL_PSI when everything fits, fall back to
+ * cheaper schemes as the budget shrinks, and the plan has to stay accurate. */
+static int check_budget_single(const int d, const size_t budget)
+{
+  const int M = 100, m = WINDOW_HELP_ESTIMATE_m;
+  const unsigned base = PRE_PHI_HUT | DEFAULT_NFFT_FLAGS;
+  int N[3], n[3], t, j, ok;
+  X(plan) p;
+  C *f;
+  R err;
+  unsigned flags;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = 16;
+    n[t] = 32;
+  }
+
+  flags = X(budget_flags)(d, N, M, n, m, base, budget);
+  X(init_guru_budget)(&p, d, N, M, n, m, base, FFTW_ESTIMATE | FFTW_DESTROY_INPUT,
+    budget);
+
+  ok = IF(p.flags == flags, 1, 0);
+  ok = ok && IF(X(estimate_memory)(d, N, M, n, m, flags) <= budget
+    || flags == base, 1, 0);
+
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  Y(vrand_unit_complex)(p.f_hat, p.N_total);
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  f = (C*)Y(malloc)((size_t)(M) * sizeof(C));
+  X(trafo_direct)(&p);
+  for (j = 0; j < M; j++)
+    f[j] = p.f[j];
+  X(trafo)(&p);
+
+  err = Y(error_l_infty_1_complex)(f, p.f, M, p.f_hat, p.N_total);
+  ok = ok && IF(err < err_trafo(&p), 1, 0);
+
+  printf("budget d = %d, budget = %-9zu -> %-4s flags = %u, " __FE__ "\n", d,
+    budget, IF(ok == 0, "FAIL", "OK"), flags, err);
+
+  Y(free)(f);
+  X(finalize)(&p);
+
+  return ok;
+}
+
+void X(check_budget)(void)
+{
+  const int M = 100, m = WINDOW_HELP_ESTIMATE_m;
+  const unsigned base = PRE_PHI_HUT | DEFAULT_NFFT_FLAGS;
+#ifdef _OPENMP
+  const unsigned sort = NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT;
+#else
+  const unsigned sort = NFFT_SORT_NODES;
+#endif
+  int N[3], n[3], t, d;
+
+  for (d = 1; d <= 3; d++)
+  {
+    size_t full, psi, none;
+    const unsigned s = (d > 1) ? sort : 0U;
+
+    for (t = 0; t < d; t++)
+    {
+      N[t] = 16;
+      n[t] = 32;
+    }
+
+    full = X(estimate_memory)(d, N, M, n, m, base | PRE_FULL_PSI | s);
+    psi = X(estimate_memory)(d, N, M, n, m, base | PRE_PSI | s);
+    none = X(estimate_memory)(d, N, M, n, m, base);
+
+    CU_ASSERT(X(budget_flags)(d, N, M, n, m, base, full)
+      == (base | PRE_FULL_PSI | s))
+    CU_ASSERT(X(budget_flags)(d, N, M, n, m, base, psi)
+      == (base | PRE_PSI | s))
+    CU_ASSERT(X(budget_flags)(d, N, M, n, m, base, none) == base)
+    CU_ASSERT(X(budget_flags)(d, N, M, n, m, base | PRE_FULL_PSI, 0) == base)
+    CU_ASSERT(check_budget_single(d, full))
+    CU_ASSERT(check_budget_single(d, psi))
+    CU_ASSERT(check_budget_single(d, none))
+    CU_ASSERT(check_budget_single(d, 0))
+  }
+}
+
+static int check_tune_single(const int d, const R eps, const char *filename)
+{
+  const int M = 100;
+  const unsigned base = PRE_PHI_HUT | DEFAULT_NFFT_FLAGS;
+  int N[3], n[3], n2[3], m, m2, t, j, ok;
+  unsigned flags = base, flags2 = base, fftw_flags, fftw_flags2;
+  X(plan) p;
+  C *f;
+  R err;
+
+  for (t = 0; t < d; t++)
+    N[t] = 16;
+
+  X(forget_tune_wisdom)();
+  ok = IF(X(tune)(d, N, M, eps, SIZE_MAX, n, &m, &flags, &fftw_flags) == 0,
+    1, 0);
+  ok = ok && IF((flags & base) == base, 1, 0);
+
+  /* The result is stored in the wisdom and survives export and import. */
+  ok = ok && IF(X(export_tune_wisdom_to_filename)(filename) == 1, 1, 0);
+  X(forget_tune_wisdom)();
+  ok = ok && IF(X(import_tune_wisdom_from_filename)(filename) == 1, 1, 0);
+  ok = ok && IF(X(tune)(d, N, M, eps, SIZE_MAX, n2, &m2, &flags2, &fftw_flags2)
+    == 1, 1, 0);
+  ok = ok && IF(m2 == m && flags2 == flags && fftw_flags2 == fftw_flags, 1, 0);
+  for (t = 0; t < d; t++)
+    ok = ok && IF(n2[t] == n[t], 1, 0);
+  remove(filename);
+
+  X(init_guru)(&p, d, N, M, n, m, flags, fftw_flags);
+
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  Y(vrand_unit_complex)(p.f_hat, p.N_total);
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  f = (C*)Y(malloc)((size_t)(M) * sizeof(C));
+  X(trafo_direct)(&p);
+  for (j = 0; j < M; j++)
+    f[j] = p.f[j];
+  X(trafo)(&p);
+
+  err = Y(error_l_infty_1_complex)(f, p.f, M, p.f_hat, p.N_total);
+  ok = ok && IF(err < K(10.0) * eps, 1, 0);
+
+  printf("tune d = %d, eps = " __FE__ " -> %-4s m = %d, n[0] = %d, flags = %u, "
+    "fftw_flags = %u, " __FE__ "\n", d, eps, IF(ok == 0, "FAIL", "OK"), m,
+    n[0], flags, fftw_flags, err);
+
+  Y(free)(f);
+  X(finalize)(&p);
+
+  return ok;
+}
+
+void X(check_tune)(void)
+{
+  static const R eps[] = {K(1.0E-03), K(1.0E-08)};
+  const char *filename = "check_tune_wisdom.txt";
+  size_t i;
+  int d;
+
+  for (i = 0; i < SIZE(eps); i++)
+  {
+    /* Accuracies close to the machine precision cannot be reached. */
+    if (eps[i] < K(1000.0) * Y(float_property)(NFFT_EPSILON))
+      continue;
+
+    for (d = 1; d <= 3; d++)
+      CU_ASSERT(check_tune_single(d, eps[i], filename))
+  }
+
+  X(forget_tune_wisdom)();
+}
+
+static int check_save_plan_single(const int d, const unsigned flags,
+  const char *filename)
+{
+  const int M = 100, m = WINDOW_HELP_ESTIMATE_m;
+  int N[3], n[3], t, ok;
+  X(plan) p, q;
+  R err_trafo_, err_adjoint;
+  C *f_hat;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = 16;
+    n[t] = 32;
+  }
+
+  X(init_guru)(&p, d, N, M, n, m, flags, DEFAULT_FFTW_FLAGS);
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  ok = IF(X(save_plan)(&p, filename) == 1, 1, 0);
+
+  /* A file for other nodes is refused. */
+  p.x[0] = -p.x[0];
+  ok = ok && IF(X(load_plan)(&q, filename, p.x) == 0, 1, 0);
+  p.x[0] = -p.x[0];
+
+  ok = ok && IF(X(load_plan)(&q, filename, p.x) == 1, 1, 0);
+  remove(filename);
+
+  if (!ok)
+  {
+    X(finalize)(&p);
+    printf("save plan d = %d, flags = %-6u -> FAIL\n", d, flags);
+    return 0;
+  }
+
+  ok = IF(q.d == p.d && q.M_total == p.M_total && q.m == p.m
+    && (q.flags & ~MALLOC_X) == (p.flags & ~MALLOC_X), 1, 0);
+  for (t = 0; t < d; t++)
+    ok = ok && IF(q.N[t] == p.N[t] && q.n[t] == p.n[t], 1, 0);
+
+  f_hat = (C*)Y(malloc)((size_t)(p.N_total) * sizeof(C));
+  Y(vrand_unit_complex)(f_hat, p.N_total);
+  memcpy(p.f_hat, f_hat, (size_t)(p.N_total) * sizeof(C));
+  memcpy(q.f_hat, f_hat, (size_t)(p.N_total) * sizeof(C));
+  X(trafo)(&p);
+  X(trafo)(&q);
+  err_trafo_ = Y(error_l_infty_1_complex)(p.f, q.f, M, f_hat, p.N_total);
+
+  X(adjoint)(&p);
+  X(adjoint)(&q);
+  err_adjoint = Y(error_l_infty_1_complex)(p.f_hat, q.f_hat, p.N_total, p.f, M);
+
+  ok = ok && IF(err_trafo_ < err_trafo_direct(&p)
+    && err_adjoint < err_trafo_direct(&p), 1, 0);
+
+  /* New nodes copy the mapped tables before they are precomputed again. */
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  X(set_nodes)(&q, p.x);
+  X(set_nodes)(&p, NULL);
+  memcpy(p.f_hat, f_hat, (size_t)(p.N_total) * sizeof(C));
+  memcpy(q.f_hat, f_hat, (size_t)(p.N_total) * sizeof(C));
+  X(trafo)(&p);
+  X(trafo)(&q);
+  ok = ok && IF(q.map == NULL && Y(error_l_infty_1_complex)(p.f, q.f, M,
+    f_hat, p.N_total) < err_trafo_direct(&p), 1, 0);
+
+  printf("save plan d = %d, flags = %-6u -> %-4s " __FE__ " " __FE__ "\n", d,
+    flags, IF(ok == 0, "FAIL", "OK"), err_trafo_, err_adjoint);
+
+  Y(free)(f_hat);
+  X(finalize)(&q);
+  X(finalize)(&p);
+
+  return ok;
+}
+
+/* Writes size bytes of a plan file and tests if X(load_plan) accepts them. */
+static int save_plan_loads(const unsigned char *data, const size_t size,
+  const char *filename)
+{
+  X(plan) q;
+  FILE *f = fopen(filename, "wb");
+  int ok;
+
+  if (f == NULL)
+    return -1;
+
+  ok = IF(fwrite(data, 1, size, f) == size, 1, 0);
+  fclose(f);
+  if (!ok)
+    return -1;
+
+  ok = X(load_plan)(&q, filename, NULL);
+  if (ok)
+    X(finalize)(&q);
+  remove(filename);
+
+  return ok;
+}
+
+/* Damaged files are refused: truncated, with another magic, or with a header
+ * whose wisdom does not fit into the file. */
+static int check_save_plan_corrupt(const char *filename)
+{
+  const int d = 2, M = 100;
+  int N[2] = {16, 16}, n[2] = {32, 32}, ok;
+  unsigned char *data;
+  uint64_t v, size64, *file_size = NULL;
+  size_t size, i;
+  X(plan) p;
+  FILE *f;
+
+  X(init_guru)(&p, d, N, M, n, WINDOW_HELP_ESTIMATE_m, PRE_PHI_HUT | PRE_PSI
+    | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS);
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  X(precompute_one_psi)(&p);
+  ok = IF(X(save_plan)(&p, filename) == 1, 1, 0);
+  X(finalize)(&p);
+
+  f = fopen(filename, "rb");
+  if (!ok || f == NULL)
+    return 0;
+  fseek(f, 0, SEEK_END);
+  size = (size_t)(ftell(f));
+  rewind(f);
+  data = (unsigned char*)Y(malloc)(size);
+  ok = IF(fread(data, 1, size, f) == size, 1, 0);
+  fclose(f);
+
+  ok = ok && IF(save_plan_loads(data, size, filename) == 1, 1, 0);
+  ok = ok && IF(save_plan_loads(data, size - 1, filename) == 0, 1, 0);
+
+  data[0] ^= 0xFF;
+  ok = ok && IF(save_plan_loads(data, size, filename) == 0, 1, 0);
+  data[0] ^= 0xFF;
+
+  /* The header ends with the wisdom length and the file size. */
+  size64 = (uint64_t)(size);
+  for (i = 8; i + sizeof(v) <= 128 && i + sizeof(v) <= size; i += sizeof(v))
+    if (memcmp(data + i, &size64, sizeof(v)) == 0)
+    {
+      file_size = (uint64_t*)(data + i);
+      break;
+    }
+  ok = ok && IF(file_size != NULL, 1, 0);
+  if (ok)
+  {
+    memcpy(&v, file_size - 1, sizeof(v));
+    memcpy(file_size - 1, &size64, sizeof(v));
+    ok = IF(save_plan_loads(data, size, filename) == 0, 1, 0);
+    memcpy(file_size - 1, &v, sizeof(v));
+  }
+
+  printf("save plan corrupt -> %-4s\n", IF(ok == 0, "FAIL", "OK"));
+
+  Y(free)(data);
+
+  return ok;
+}
+
+void X(check_save_plan)(void)
+{
+#ifdef _OPENMP
+  const unsigned sort = NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT;
+#else
+  const unsigned sort = NFFT_SORT_NODES;
+#endif
+  const unsigned flags[] = {PRE_PSI, PRE_PSI | sort, PRE_FULL_PSI,
+    PRE_FULL_PSI | sort, PRE_FULL_PSI | NFFT_FULL_PSI_FLOAT, 0U};
+  const char *filename = "check_save_plan.nfft";
+  size_t i;
+  int d;
+
+  for (d = 1; d <= 3; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      CU_ASSERT(check_save_plan_single(d, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS
+        | flags[i], filename))
+
+  CU_ASSERT(check_save_plan_corrupt(filename))
+}
+
+/* Arena. A plan with flag NFFT_ARENA takes all its buffers from one slab, and
+ * plans created one after another in a context arena reuse its slab. The
+ * calls of the malloc hook are counted during init and precomputation. */
+
+static R arena_error(X(plan) *p, X(plan) *q, C *f_hat)
+{
+  const INT M = p->M_total;
+  R err;
+
+  memcpy(p->f_hat, f_hat, (size_t)(p->N_total) * sizeof(C));
+  memcpy(q->f_hat, f_hat, (size_t)(p->N_total) * sizeof(C));
+  X(trafo)(p);
+  X(trafo)(q);
+  err = Y(error_l_infty_1_complex)(p->f, q->f, M, f_hat, p->N_total);
+
+  X(adjoint)(p);
+  X(adjoint)(q);
+  return MAX(err, Y(error_l_infty_1_complex)(p->f_hat, q->f_hat, p->N_total,
+    p->f, M));
+}
+
+static void arena_init(X(plan) *q, const int d, int *N, const int M, int *n,
+  const R *x, const unsigned flags, X(arena) *a)
+{
+  malloc_calls = 0;
+  Y(malloc_hook) = malloc_counting;
+  Y(free_hook) = free;
+  X(init_guru_arena)(q, d, N, M, n, WINDOW_HELP_ESTIMATE_m, flags,
+    DEFAULT_FFTW_FLAGS, a);
+  memcpy(q->x, x, (size_t)(d * M) * sizeof(R));
+  if (q->flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(q);
+}
+
+static void arena_finalize(X(plan) *q)
+{
+  X(finalize)(q);
+  Y(malloc_hook) = 0;
+  Y(free_hook) = 0;
+}
+
+static int check_arena_single(const int d, const unsigned flags)
+{
+  const int M = 100;
+  int N[3], n[3], t, ok, round;
+  X(plan) p, q;
+  X(arena) *a;
+  size_t peak;
+  R err;
+  C *f_hat;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = 16;
+    n[t] = 32;
+  }
+
+  X(init_guru)(&p, d, N, M, n, WINDOW_HELP_ESTIMATE_m, flags,
+    DEFAULT_FFTW_FLAGS);
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  f_hat = (C*)Y(malloc)((size_t)(p.N_total) * sizeof(C));
+  Y(vrand_unit_complex)(f_hat, p.N_total);
+
+  /* own arena: the arena and its slab are the only allocations */
+  arena_init(&q, d, N, M, n, p.x, flags | NFFT_ARENA, NULL);
+  ok = IF(malloc_calls <= 2 && (q.flags & NFFT_ARENA), 1, 0);
+  err = arena_error(&p, &q, f_hat);
+  ok = ok && IF(X(arena_peak)(q.arena) > 0, 1, 0);
+  arena_finalize(&q);
+
+  arena_init(&q, d, N, M, n, p.x, flags | NFFT_ARENA_HUGE_PAGES, NULL);
+  ok = ok && IF(malloc_calls <= 2, 1, 0);
+  err = MAX(err, arena_error(&p, &q, f_hat));
+  arena_finalize(&q);
+
+  /* An empty arena passes everything on to Y(malloc), and its peak is the
+   * size of a context arena in which the plans need no more allocations. */
+  a = X(arena_create)(0, 0U);
+  arena_init(&q, d, N, M, n, p.x, flags, a);
+  arena_finalize(&q);
+  peak = X(arena_peak)(a);
+  X(arena_destroy)(a);
+
+  a = X(arena_create)(peak, 0U);
+  for (round = 0; round < 3; round++)
+  {
+    arena_init(&q, d, N, M, n, p.x, flags, a);
+    ok = ok && IF(malloc_calls == 0 && !(q.flags & NFFT_ARENA), 1, 0);
+    err = MAX(err, arena_error(&p, &q, f_hat));
+    arena_finalize(&q);
+    X(arena_reset)(a);
+  }
+  ok = ok && IF(X(arena_peak)(a) <= peak, 1, 0);
+  X(arena_destroy)(a);
+
+  ok = ok && IF(err < err_trafo_direct(&p), 1, 0);
+
+  printf("arena d = %d, flags = %-6u -> %-4s %zu " __FE__ "\n", d, flags,
+    IF(ok == 0, "FAIL", "OK"), peak, err);
+
+  Y(free)(f_hat);
+  X(finalize)(&p);
+
+  return ok;
+}
+
+void X(check_arena)(void)
+{
+#ifdef _OPENMP
+  const unsigned sort = NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT;
+#else
+  const unsigned sort = NFFT_SORT_NODES;
+#endif
+  const unsigned flags[] = {PRE_PSI, PRE_PSI | sort, PRE_FULL_PSI | sort,
+    PRE_FULL_PSI | NFFT_FULL_PSI_FLOAT, PRE_PSI | NFFT_PRUNED_FFT, 0U};
+  size_t i;
+  int d;
+
+  for (d = 1; d <= 3; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      CU_ASSERT(check_arena_single(d, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS
+        | flags[i]))
+}
+
+/* Statistics. A plan records nothing until its statistics are enabled, and
+ * then counts every transform and the phases it runs through. */
+
+static int stats_empty(const nfft_stats *s)
+{
+  int i;
+
+  for (i = 0; i < NFFT_STATS_PHASES; i++)
+    if (s->calls[i] != 0 || s->time[i] != 0.0)
+      return 0;
+
+  return IF(s->nodes == 0.0 && s->bytes == 0.0, 1, 0);
+}
+
+/* The imbalance is 0 without OpenMP, 1 with one thread and at least 1 with
+ * more threads. */
+static int stats_imbalance_valid(const nfft_stats *s, const int phase)
+{
+  const R imbalance = X(stats_imbalance)(s, phase);
+
+#ifdef _OPENMP
+  if (Y(get_num_threads)() == 1)
+    return IF(imbalance == 1.0, 1, 0);
+
+  return IF(imbalance >= 1.0, 1, 0);
+#else
+  return IF(imbalance == 0.0, 1, 0);
+#endif
+}
+
+static int check_stats_single(const int d, const unsigned flags)
+{
+  const int M = 100;
+  int N[3], n[3], t, ok;
+  X(plan) p;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = 16;
+    n[t] = 32;
+  }
+
+  X(init_guru)(&p, d, N, M, n, WINDOW_HELP_ESTIMATE_m, flags,
+    DEFAULT_FFTW_FLAGS);
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  Y(vrand_unit_complex)(p.f_hat, p.N_total);
+
+  /* disabled */
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+  X(trafo)(&p);
+  ok = stats_empty(&p.stats);
+
+  X(stats_enable)(&p.stats, 1);
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+  X(trafo)(&p);
+  X(adjoint)(&p);
+
+  ok = ok && IF(p.stats.calls[NFFT_STATS_TRAFO] == 2, 1, 0);
+  ok = ok && IF(p.stats.calls[NFFT_STATS_D] == 2, 1, 0);
+  ok = ok && IF(p.stats.calls[NFFT_STATS_FFT] == 2, 1, 0);
+  ok = ok && IF(p.stats.calls[NFFT_STATS_B] == 2, 1, 0);
+  ok = ok && IF(!(flags & PRE_PSI) || p.stats.calls[NFFT_STATS_PRECOMPUTE] > 0,
+    1, 0);
+  ok = ok && IF(!(flags & NFFT_SORT_NODES) || p.stats.calls[NFFT_STATS_SORT] > 0,
+    1, 0);
+  ok = ok && IF(p.stats.nodes == 2.0 * M && p.stats.bytes > 0.0, 1, 0);
+  /* the whole transforms include their phases */
+  ok = ok && IF(p.stats.time[NFFT_STATS_TRAFO] >= p.stats.time[NFFT_STATS_D]
+    + p.stats.time[NFFT_STATS_FFT] + p.stats.time[NFFT_STATS_B], 1, 0);
+  /* the parallel loops of B and D report the busy time of every thread */
+  ok = ok && stats_imbalance_valid(&p.stats, NFFT_STATS_B)
+    && stats_imbalance_valid(&p.stats, NFFT_STATS_D);
+
+  /* a reset clears the counters and keeps the statistics enabled */
+  X(stats_reset)(&p.stats);
+  ok = ok && stats_empty(&p.stats) && IF(p.stats.enabled, 1, 0);
+
+  printf("stats d = %d, flags = %-6u -> %-4s\n", d, flags,
+    IF(ok == 0, "FAIL", "OK"));
+
+  X(finalize)(&p);
+
+  return ok;
+}
+
+void X(check_stats)(void)
+{
+  const unsigned flags[] = {PRE_PSI, PRE_PSI | NFFT_SORT_NODES, PRE_FULL_PSI,
+    0U};
+  size_t i;
+  int d;
+
+  /* d = 4 runs the generic kernels, with PRE_PSI only as sorting and
+   * PRE_FULL_PSI take too much memory there */
+  for (d = 1; d <= 4; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      if (d < 4 || flags[i] == PRE_PSI)
+        CU_ASSERT(check_stats_single(d, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS
+          | flags[i]))
+
+#ifdef _OPENMP
+  /* the busy times of several threads, also where there is a single core */
+  {
+    const INT nthreads = Y(get_num_threads)();
+
+    Y(set_num_threads)(4);
+    for (d = 1; d <= 3; d++)
+      for (i = 0; i < SIZE(flags); i++)
+        CU_ASSERT(check_stats_single(d, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS
+          | flags[i]))
+    Y(set_num_threads)(nthreads);
+  }
+#endif
+}
+
+/* Tracing. The events of the transforms are counted by a hook, which checks
+ * that they are properly nested, and written by the Chrome trace writer. */
+
+#define TRACE_DEPTH 16
+
+typedef struct
+{
+  const void *plan;
+  int events, depth, nested, phases[TRACE_DEPTH];
+} trace_count;
+
+static void trace_counting(const nfft_trace_event *e, void *data)
+{
+  trace_count *c = (trace_count*)data;
+
+  c->events++;
+  if (e->begin)
+  {
+    if (c->depth < TRACE_DEPTH)
+      c->phases[c->depth] = e->phase;
+    c->depth++;
+  }
+  else
+  {
+    c->depth--;
+    if (c->depth < 0 || c->depth >= TRACE_DEPTH
+      || c->phases[c->depth] != e->phase)
+      c->nested = 0;
+  }
+  if (e->plan != c->plan || e->size0 <= 0.0 || e->size1 <= 0.0)
+    c->nested = 0;
+}
+
+static int check_trace_single(const int d, const unsigned flags,
+  const char *filename)
+{
+  const int M = 100;
+  int N[4], n[4], t, ok, ch, events;
+  trace_count c;
+  X(plan) p;
+  FILE *file;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = 16;
+    n[t] = 32;
+  }
+
+  X(init_guru)(&p, d, N, M, n, WINDOW_HELP_ESTIMATE_m, flags,
+    DEFAULT_FFTW_FLAGS);
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  Y(vrand_unit_complex)(p.f_hat, p.N_total);
+
+  c.plan = &p;
+  c.events = c.depth = 0;
+  c.nested = 1;
+  Y(trace_data) = &c;
+  Y(trace_hook) = trace_counting;
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+  X(trafo)(&p);
+  X(adjoint)(&p);
+  Y(trace_hook) = 0;
+  Y(trace_data) = 0;
+
+  /* begin and end of the transform, D, FFT and B at least */
+  events = c.events;
+  ok = IF(events >= 16 && c.depth == 0 && c.nested, 1, 0);
+
+  /* no events without a hook */
+  c.events = 0;
+  X(trafo)(&p);
+  ok = ok && IF(c.events == 0, 1, 0);
+
+  ok = ok && IF(X(trace_chrome_open)(filename) == 1, 1, 0);
+  X(trafo)(&p);
+  X(trace_chrome_close)();
+  ok = ok && IF(Y(trace_hook) == 0, 1, 0);
+
+  file = fopen(filename, "r");
+  ok = ok && IF(file != NULL && fgetc(file) == '{', 1, 0);
+  if (file != NULL)
+  {
+    int last = 0, braces = 1;
+    while ((ch = fgetc(file)) != EOF)
+    {
+      if (ch == '{')
+        braces++;
+      else if (ch == '}')
+        braces--;
+      if (ch != '\n')
+        last = ch;
+    }
+    ok = ok && IF(braces == 0 && last == '}', 1, 0);
+    fclose(file);
+  }
+  remove(filename);
+
+  printf("trace d = %d, flags = %-6u -> %-4s %d\n", d, flags,
+    IF(ok == 0, "FAIL", "OK"), events);
+
+  X(finalize)(&p);
+
+  return ok;
+}
+
+void X(check_trace)(void)
+{
+  const unsigned flags[] = {PRE_PSI, PRE_PSI | NFFT_SORT_NODES, 0U};
+  const char *filename = "check_trace.json";
+  size_t i;
+  int d;
+
+  for (d = 1; d <= 4; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      if (d < 4 || flags[i] == PRE_PSI)
+        CU_ASSERT(check_trace_single(d, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS
+          | flags[i], filename))
+}
+
 /* accuracy */
 
 static int check_single_file(const testcase_delegate_t *testcase,
@@ -1453,6 +3075,22 @@ static init_delegate_t init_acc_22 = {"init_guru (PRE PSI)", init_advanced_pre_p
 static init_delegate_t init_acc_23 = {"init_guru (PRE PSI)", init_advanced_pre_psi_, 23, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0};
 static init_delegate_t init_acc_24 = {"init_guru (PRE PSI)", init_advanced_pre_psi_, 24, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0};
 static init_delegate_t init_acc_25 = {"init_guru (PRE PSI)", init_advanced_pre_psi_, 25, PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0};
+static init_delegate_t init_acc_es_1 = {"init_guru_window (ES)", init_window_, 1, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_2 = {"init_guru_window (ES)", init_window_, 2, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_3 = {"init_guru_window (ES)", init_window_, 3, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_4 = {"init_guru_window (ES)", init_window_, 4, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_5 = {"init_guru_window (ES)", init_window_, 5, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_6 = {"init_guru_window (ES)", init_window_, 6, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_7 = {"init_guru_window (ES)", init_window_, 7, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_8 = {"init_guru_window (ES)", init_window_, 8, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_9 = {"init_guru_window (ES)", init_window_, 9, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_10 = {"init_guru_window (ES)", init_window_, 10, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_11 = {"init_guru_window (ES)", init_window_, 11, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_12 = {"init_guru_window (ES)", init_window_, 12, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_13 = {"init_guru_window (ES)", init_window_, 13, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_14 = {"init_guru_window (ES)", init_window_, 14, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_15 = {"init_guru_window (ES)", init_window_, 15, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
+static init_delegate_t init_acc_es_16 = {"init_guru_window (ES)", init_window_, 16, PRE_PHI_HUT | DEFAULT_NFFT_FLAGS, DEFAULT_FFTW_FLAGS, 0, NFFT_WINDOW_EXP_SEMICIRCLE};
 
 /* Initializers. */
 static const init_delegate_t* initializers_acc[] =
@@ -1483,6 +3121,22 @@ static const init_delegate_t* initializers_acc[] =
     &init_acc_23,
     &init_acc_24,
     &init_acc_25,
+    &init_acc_es_1,
+    &init_acc_es_2,
+    &init_acc_es_3,
+    &init_acc_es_4,
+    &init_acc_es_5,
+    &init_acc_es_6,
+    &init_acc_es_7,
+    &init_acc_es_8,
+    &init_acc_es_9,
+    &init_acc_es_10,
+    &init_acc_es_11,
+    &init_acc_es_12,
+    &init_acc_es_13,
+    &init_acc_es_14,
+    &init_acc_es_15,
+    &init_acc_es_16,
 };
 
 static const testcase_delegate_online_t nfft_acc = {setup_online, destroy_online, 1, 1000 ,10000};
@@ -31,6 +31,7 @@ void X(check_3d_direct_file)(void);
 void X(check_3d_fast_file)(void);
 void X(check_3d_online)(void);
 void X(check_4d_online)(void);
+void X(check_nd_online)(void);
 
 void X(check_adjoint_1d_direct_file)(void);
 void X(check_adjoint_1d_fast_file)(void);
@@ -42,5 +43,22 @@ void X(check_adjoint_3d_direct_file)(void);
 void X(check_adjoint_3d_fast_file)(void);
 void X(check_adjoint_3d_online)(void);
 void X(check_adjoint_4d_online)(void);
+void X(check_adjoint_nd_online)(void);
+
+void X(check_window_online)(void);
+void X(check_adjoint_window_online)(void);
+
+void X(check_many_online)(void);
+void X(check_adjoint_many_online)(void);
+void X(check_many_flags)(void);
+void X(check_spread_interp)(void);
+void X(check_real)(void);
+void X(check_estimate_memory)(void);
+void X(check_budget)(void);
+void X(check_tune)(void);
+void X(check_save_plan)(void);
+void X(check_arena)(void);
+void X(check_stats)(void);
+void X(check_trace)(void);
 
 void X(check_acc)(void);
@@ -1264,3 +1264,70 @@ void X(check_adjoint_4d_online)(void)
     testcases_adjoint_4d_online, initializers_4d, &check_adjoint, trafos_adjoint_4d_online);
 }
 #endif
+
+/* Memory estimate. The estimate is compared with the bytes the plan requests
+ * through the malloc hook during init and precomputation. */
+
+static size_t malloc_bytes;
+
+static void *malloc_counting(size_t n)
+{
+  malloc_bytes += n;
+  return malloc(n == 0 ? 1 : n);
+}
+
+static int check_estimate_memory_single(const int d, const int NN,
+  const unsigned flags)
+{
+  const int M = 100, m = WINDOW_HELP_ESTIMATE_m;
+  int N[3], n[3], t, j, ok;
+  X(plan) p;
+  size_t est;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = NN;
+    n[t] = 2 * (int)(Y(next_power_of_2)(NN));
+  }
+
+  malloc_bytes = 0;
+  Y(malloc_hook) = malloc_counting;
+  Y(free_hook) = free;
+  X(init_guru)(&p, d, N, M, n, m, flags, FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+  for (j = 0; j < d * M; j++)
+    p.x[j] = K(0.5) * Y(drand48)();
+  if (p.flags & PRE_ONE_PSI)
+    X(precompute_one_psi)(&p);
+
+  est = X(estimate_memory)(d, N, M, n, m, flags);
+
+  /* the FFTW setup allocates d ints temporarily */
+  ok = IF(est <= malloc_bytes && malloc_bytes - est <= (size_t)(d) * sizeof(int), 1, 0);
+
+  printf("nfst_estimate_memory d = %d, N = %-4d, flags = %-6u -> %-4s %zu (%zu)\n",
+    d, NN, flags, IF(ok == 0, "FAIL", "OK"), est, malloc_bytes);
+
+  X(finalize)(&p);
+  Y(malloc_hook) = 0;
+  Y(free_hook) = 0;
+
+  return ok;
+}
+
+void X(check_estimate_memory)(void)
+{
+  static const unsigned flags[] =
+  {
+    PRE_PHI_HUT | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_FULL_PSI | DEFAULT_NFFT_FLAGS,
+    PRE_PHI_HUT | PRE_LIN_PSI | DEFAULT_NFFT_FLAGS,
+  };
+  static const int NN[] = {0, 64, 16, 8};
+  int d;
+  size_t i;
+
+  for (d = 1; d <= 3; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      CU_ASSERT(check_estimate_memory_single(d, NN[d], flags[i]))
+}
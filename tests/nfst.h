@@ -42,3 +42,5 @@ void X(check_adjoint_3d_direct_file)(void);
 void X(check_adjoint_3d_fast_file)(void);
 void X(check_adjoint_3d_online)(void);
 void X(check_adjoint_4d_online)(void);
+
+void X(check_estimate_memory)(void);
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2002, 2017 Jens Keiner, Stefan Kunis, Daniel Potts
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Standard headers. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <CUnit/CUnit.h>
+
+#include "config.h"
+#include "nfft3.h"
+#include "infft.h"
+#include "nnfft.h"
+
+#define DEFAULT_NNFFT_FLAGS MALLOC_X | MALLOC_V | MALLOC_F | MALLOC_F_HAT | FFTW_INIT | FFT_OUT_OF_PLACE
+
+/* Memory estimate. The estimate is compared with the bytes the plan, including
+ * its inner NFFT plan, requests through the malloc hook during init and
+ * precomputation. */
+
+static size_t malloc_bytes;
+
+static void *malloc_counting(size_t n)
+{
+  malloc_bytes += n;
+  return malloc(n == 0 ? 1 : n);
+}
+
+static int check_estimate_memory_single(const int d, const int NN,
+  const unsigned flags)
+{
+  const int M = 100, N_total = 50, m = WINDOW_HELP_ESTIMATE_m;
+  int N[3], N1[3], t, ok;
+  X(plan) p;
+  size_t est;
+
+  for (t = 0; t < d; t++)
+  {
+    N[t] = NN;
+    N1[t] = 2 * NN;
+  }
+
+  malloc_bytes = 0;
+  Y(malloc_hook) = malloc_counting;
+  Y(free_hook) = free;
+  X(init_guru)(&p, d, N_total, M, N, N1, m, flags);
+  Y(vrand_shifted_unit_double)(p.x, d * M);
+  Y(vrand_shifted_unit_double)(p.v, d * N_total);
+  X(precompute_one_psi)(&p);
+
+  est = X(estimate_memory)(d, N_total, M, N, N1, m, flags);
+
+  /* the FFTW setup of the inner plan allocates d ints temporarily */
+  ok = IF(est <= malloc_bytes && malloc_bytes - est <= (size_t)(d) * sizeof(int), 1, 0);
+
+  printf("nnfft_estimate_memory d = %d, N = %-4d, flags = %-6u -> %-4s %zu (%zu)\n",
+    d, NN, flags, IF(ok == 0, "FAIL", "OK"), est, malloc_bytes);
+
+  X(finalize)(&p);
+  Y(malloc_hook) = 0;
+  Y(free_hook) = 0;
+
+  return ok;
+}
+
+void X(check_estimate_memory)(void)
+{
+  static const unsigned flags[] =
+  {
+    PRE_PHI_HUT | DEFAULT_NNFFT_FLAGS,
+    PRE_PHI_HUT | PRE_PSI | DEFAULT_NNFFT_FLAGS,
+    PRE_PHI_HUT | PRE_FULL_PSI | DEFAULT_NNFFT_FLAGS,
+  };
+  static const int NN[] = {0, 32, 12, 6};
+  int d;
+  size_t i;
+
+  for (d = 1; d <= 3; d++)
+    for (i = 0; i < SIZE(flags); i++)
+      CU_ASSERT(check_estimate_memory_single(d, NN[d], flags[i]))
+}
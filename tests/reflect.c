@@ -46,4 +46,5 @@ void X(check_get_window_name)(void)
 
     /* Just compare what's returned by the method against the literal from config.h. */
     CU_ASSERT(strncmp(window_name1, window_name2, sizeof(window_name1)) == 0);
+    CU_ASSERT(strcmp(window_name2, Y(get_window_name_of)(NFFT_WINDOW_DEFAULT)) == 0);
 }
@@ -151,3 +151,99 @@ void X(check_next_power_of_2)(void)
     }
 }
 
+
+void X(check_simd)(void)
+{
+    const int level = Y(simd_level)();
+    const R eps = K(16.0) * Y(float_property)(NFFT_EPSILON);
+    R w[40];
+    C x[40], y[40], y2[40];
+    const C a = K(0.75) - K(0.5) * II;
+    int l;
+    INT n, k;
+
+    Y(vrand_unit_complex)(x, 40);
+    for (k = 0; k < 40; k++)
+        w[k] = CREAL(x[(k + 7) % 40]);
+
+    for (l = SIMD_NONE; l <= level; l++)
+    {
+        int ok = Y(simd_set_level)(l) == l;
+
+        for (n = 0; n <= 40; n++)
+        {
+            C s = K(0.0), s2 = Y(sum_wx_complex)(w, x, n);
+
+            for (k = 0; k < n; k++)
+            {
+                s += w[k] * x[k];
+                y[k] = x[k];
+                y2[k] = x[k] + w[k] * a;
+            }
+            Y(upd_xpaw_complex)(y, a, w, n);
+
+            ok = ok && CABS(s - s2) <= eps * (R)(n + 1);
+            for (k = 0; k < n; k++)
+                ok = ok && CABS(y[k] - y2[k]) <= eps;
+        }
+
+        printf("simd level %d -> %s\n", l, ok ? "OK" : "FAIL");
+        CU_ASSERT(ok)
+    }
+
+    Y(simd_set_level)(level);
+}
+
+void X(check_sort_node_indices)(void)
+{
+    const INT sizes[] = {0, 1, 100, 5000, 100000};
+    const INT rhighs[] = {0, 8, 9, 20, 29};
+    size_t i, r;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        for (r = 0; r < sizeof(rhighs) / sizeof(rhighs[0]); r++)
+        {
+            const INT n = sizes[i], rhigh = rhighs[r];
+            INT *keys = (INT*) Y(malloc)((size_t)(2 * n + 2) * sizeof(INT));
+            INT *work = (INT*) Y(malloc)((size_t)(2 * n + 2) * sizeof(INT));
+            INT *seen = (INT*) Y(malloc)((size_t)(n + 1) * sizeof(INT));
+            int ok = 1;
+            INT k;
+
+            /* every other set of keys shares the high digits to exercise
+             * skipped passes */
+            for (k = 0; k < n; k++)
+            {
+                INT key = (INT)(rand()) & (((INT)(1) << (rhigh + 1)) - 1);
+                if (r % 2 == 1)
+                    key &= 63;
+                keys[2 * k] = key;
+                keys[2 * k + 1] = k;
+                seen[k] = 0;
+            }
+
+            Y(sort_node_indices_radix_lsdf)(n, keys, work, rhigh);
+
+            for (k = 0; k < n; k++)
+            {
+                const INT j = keys[2 * k + 1];
+                ok = ok && j >= 0 && j < n && seen[j] == 0;
+                if (ok)
+                    seen[j] = 1;
+                if (k > 0)
+                    ok = ok && (keys[2 * (k - 1)] < keys[2 * k]
+                        || (keys[2 * (k - 1)] == keys[2 * k]
+                            && keys[2 * (k - 1) + 1] < j));
+            }
+
+            printf("sort_node_indices_radix_lsdf("__D__", "__D__") -> %s\n", n,
+                rhigh, ok ? "OK" : "FAIL");
+            CU_ASSERT(ok)
+
+            Y(free)(seen);
+            Y(free)(work);
+            Y(free)(keys);
+        }
+    }
+}
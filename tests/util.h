@@ -20,3 +20,5 @@
 
 void X(check_log2i)(void);
 void X(check_next_power_of_2)(void);
+void X(check_simd)(void);
+void X(check_sort_node_indices)(void);